@@ -493,6 +493,173 @@ void free(void *ptr);
 }
 #endif
 
+/* ============== SPAWN.H ============== */
+/* Layout kernel ke src/include/spawn.h jaisa - kernel seedha copy karta hai */
+
+#define POSIX_SPAWN_RESETIDS 0x01
+#define POSIX_SPAWN_SETPGROUP 0x02
+#define POSIX_SPAWN_SETSIGDEF 0x04
+#define POSIX_SPAWN_SETSIGMASK 0x08
+#define POSIX_SPAWN_SETSCHEDPARAM 0x10
+
+#define SPAWN_FA_OPEN 1
+#define SPAWN_FA_CLOSE 2
+#define SPAWN_FA_DUP2 3
+#define SPAWN_MAX_ACTIONS 16
+#define SPAWN_PATH_MAX 128
+
+typedef struct {
+  int type;
+  int fd;
+  int newfd;
+  int oflag;
+  uint32_t mode;
+  char path[SPAWN_PATH_MAX];
+} posix_spawn_file_action_t;
+
+typedef struct {
+  int count;
+  posix_spawn_file_action_t actions[SPAWN_MAX_ACTIONS];
+} posix_spawn_file_actions_t;
+
+typedef struct {
+  uint32_t flags;
+  uint32_t pgroup;
+  uint64_t sigmask;
+  uint64_t sigdefault;
+  int priority;
+} posix_spawnattr_t;
+
+struct sched_param {
+  int sched_priority; /* Kernel priority 0-139, kam = pehle */
+};
+
+/* Error pe errno value return hoti hai (POSIX), -1 nahi */
+static inline int posix_spawn(pid_t *pid, const char *path,
+                              const posix_spawn_file_actions_t *file_actions,
+                              const posix_spawnattr_t *attrp,
+                              char *const argv[], char *const envp[]) {
+  int res = syscall_posix_spawn((int *)pid, path, file_actions, attrp, argv,
+                                envp);
+  return res < 0 ? -res : 0;
+}
+
+static inline int
+posix_spawn_file_actions_init(posix_spawn_file_actions_t *fa) {
+  fa->count = 0;
+  return 0;
+}
+
+static inline int
+posix_spawn_file_actions_destroy(posix_spawn_file_actions_t *fa) {
+  fa->count = 0;
+  return 0;
+}
+
+static inline posix_spawn_file_action_t *
+spawn_fa_next(posix_spawn_file_actions_t *fa, int type, int fd) {
+  if (fa->count == SPAWN_MAX_ACTIONS)
+    return NULL;
+  posix_spawn_file_action_t *a = &fa->actions[fa->count++];
+  memset(a, 0, sizeof(*a));
+  a->type = type;
+  a->fd = fd;
+  return a;
+}
+
+static inline int
+posix_spawn_file_actions_addopen(posix_spawn_file_actions_t *fa, int fd,
+                                 const char *path, int oflag, mode_t mode) {
+  if (fd < 0)
+    return EBADF;
+  if (strlen(path) >= SPAWN_PATH_MAX)
+    return EINVAL;
+  posix_spawn_file_action_t *a = spawn_fa_next(fa, SPAWN_FA_OPEN, fd);
+  if (!a)
+    return ENOMEM;
+  strncpy(a->path, path, SPAWN_PATH_MAX - 1);
+  a->oflag = oflag;
+  a->mode = mode;
+  return 0;
+}
+
+static inline int
+posix_spawn_file_actions_addclose(posix_spawn_file_actions_t *fa, int fd) {
+  if (fd < 0)
+    return EBADF;
+  return spawn_fa_next(fa, SPAWN_FA_CLOSE, fd) ? 0 : ENOMEM;
+}
+
+static inline int
+posix_spawn_file_actions_adddup2(posix_spawn_file_actions_t *fa, int fd,
+                                 int newfd) {
+  if (fd < 0 || newfd < 0)
+    return EBADF;
+  posix_spawn_file_action_t *a = spawn_fa_next(fa, SPAWN_FA_DUP2, fd);
+  if (!a)
+    return ENOMEM;
+  a->newfd = newfd;
+  return 0;
+}
+
+static inline int posix_spawnattr_init(posix_spawnattr_t *attr) {
+  memset(attr, 0, sizeof(*attr));
+  return 0;
+}
+
+static inline int posix_spawnattr_destroy(posix_spawnattr_t *attr) {
+  (void)attr;
+  return 0;
+}
+
+static inline int posix_spawnattr_setflags(posix_spawnattr_t *attr,
+                                           short flags) {
+  attr->flags = (uint16_t)flags;
+  return 0;
+}
+
+static inline int posix_spawnattr_setpgroup(posix_spawnattr_t *attr,
+                                            pid_t pgroup) {
+  attr->pgroup = pgroup;
+  return 0;
+}
+
+static inline int posix_spawnattr_setsigmask(posix_spawnattr_t *attr,
+                                             const uint64_t *mask) {
+  attr->sigmask = *mask;
+  return 0;
+}
+
+static inline int posix_spawnattr_setsigdefault(posix_spawnattr_t *attr,
+                                                const uint64_t *sigs) {
+  attr->sigdefault = *sigs;
+  return 0;
+}
+
+static inline int
+posix_spawnattr_setschedparam(posix_spawnattr_t *attr,
+                              const struct sched_param *param) {
+  if (param->sched_priority < 0 || param->sched_priority > 139)
+    return EINVAL;
+  attr->priority = param->sched_priority;
+  return 0;
+}
+
+static inline int waitpid(int pid, int *status, int options) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_WAITPID), "b"(pid), "c"(status), "d"(options));
+  return res;
+}
+
+/* vfork: child parent ki memory udhaar leta hai aur sirf execve/_exit kare.
+   Function call nahi ho sakta - child ka agla call parent ke vfork frame ka
+   return address kuchal dega - isliye always_inline. */
+static inline __attribute__((always_inline)) int vfork(void) {
+  return syscall_vfork();
+}
+
 /* ============== SETJMP (Simplified) ============== */
 
 typedef int jmp_buf[6]; /* EBX, ESI, EDI, EBP, ESP, EIP */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "gui/surface.h"
 #include "string.hpp"
 #include "syscalls.hpp"
 
@@ -55,12 +56,56 @@ struct gfx_msg_t {
   } data;
 } __attribute__((packed));
 
+// Max ticks to wait for the compositor to release the old front buffer
+constexpr int IPC_FENCE_TIMEOUT = 50;
+
+// Drawing goes into the back buffer of the window's double-buffered SHM
+// surface (gui/surface.h); flush()/invalidate() commit it.
 class IPCClient {
 private:
   int sock_fd;
   int window_id;
-  uint32_t *framebuffer;
+  gui_surface_ctrl_t *surface;
+  uint32_t *framebuffer; // Current back buffer
   int width, height;
+  int dirty_x0, dirty_y0, dirty_x1, dirty_y1; // Drawn since last commit
+
+  void mark_dirty(int x, int y, int w, int h) {
+    if (x < dirty_x0)
+      dirty_x0 = x;
+    if (y < dirty_y0)
+      dirty_y0 = y;
+    if (x + w > dirty_x1)
+      dirty_x1 = x + w;
+    if (y + h > dirty_y1)
+      dirty_y1 = y + h;
+  }
+
+  void clear_dirty() {
+    dirty_x0 = width;
+    dirty_y0 = height;
+    dirty_x1 = 0;
+    dirty_y1 = 0;
+  }
+
+  uint32_t *buffer_pixels(uint32_t i) {
+    return gui_surface_buffer(surface, i)->pixels;
+  }
+
+  // Wait until the compositor has consumed every commit, then bring the
+  // new back buffer (the old front) up to date with the committed rect.
+  void wait_fence(int x, int y, int w, int h) {
+    for (int i = 0; i < IPC_FENCE_TIMEOUT; i++) {
+      if (surface->fence == surface->committed)
+        break;
+      Syscall::sleep(1);
+    }
+    const uint32_t *front = buffer_pixels(surface->front);
+    framebuffer = buffer_pixels(surface->front ^ 1);
+    for (int j = y; j < y + h; j++)
+      String::memcpy(framebuffer + j * width + x, front + j * width + x,
+                     w * 4);
+  }
 
 public:
   bool recv_msg(gfx_msg_t *msg) {
@@ -72,7 +117,10 @@ public:
     return n > 0;
   }
   IPCClient()
-      : sock_fd(-1), window_id(-1), framebuffer(nullptr), width(0), height(0) {}
+      : sock_fd(-1), window_id(-1), surface(nullptr), framebuffer(nullptr),
+        width(0), height(0) {
+    clear_dirty();
+  }
 
   bool connect() {
     sock_fd = Syscall::socket(AF_UNIX, SOCK_STREAM, 0);
@@ -113,19 +161,41 @@ public:
       window_id = resp.data.created.window_id;
       int shm_id = resp.data.created.shm_id;
 
-      framebuffer = (uint32_t *)Syscall::shmat(shm_id);
-      if (!framebuffer)
+      surface = (gui_surface_ctrl_t *)Syscall::shmat(shm_id);
+      if (!surface || surface->magic != SURFACE_MAGIC)
         return false;
 
+      framebuffer = buffer_pixels(surface->front ^ 1);
+      clear_dirty();
       return true;
     }
 
     return false;
   }
 
+  // Commit the back buffer; only (x, y, w, h) is repainted on screen.
   void invalidate(int x, int y, int w, int h) {
-    if (sock_fd < 0)
+    if (sock_fd < 0 || !surface)
       return;
+    if (x < 0) {
+      w += x;
+      x = 0;
+    }
+    if (y < 0) {
+      h += y;
+      y = 0;
+    }
+    if (x + w > width)
+      w = width - x;
+    if (y + h > height)
+      h = height - y;
+    if (w <= 0 || h <= 0)
+      return;
+
+    // Pixels must be visible before the compositor sees the new count
+    asm volatile("" ::: "memory");
+    surface->committed = surface->committed + 1;
+
     gfx_msg_t msg;
     msg.type = MSG_GFX_INVALIDATE_RECT;
     msg.size = sizeof(msg_gfx_invalidate_t);
@@ -135,11 +205,26 @@ public:
     msg.data.invalidate.width = w;
     msg.data.invalidate.height = h;
     Syscall::write(sock_fd, &msg, sizeof(msg));
+
+    // The whole buffer flips, so everything drawn since the last commit
+    // has to be carried over, not just the repainted rect
+    mark_dirty(x, y, w, h);
+    wait_fence(dirty_x0, dirty_y0, dirty_x1 - dirty_x0, dirty_y1 - dirty_y0);
+    clear_dirty();
   }
 
-  void flush() { invalidate(0, 0, width, height); }
+  // Commit whatever was drawn since the last commit
+  void flush() {
+    if (dirty_x1 > dirty_x0 && dirty_y1 > dirty_y0)
+      invalidate(dirty_x0, dirty_y0, dirty_x1 - dirty_x0, dirty_y1 - dirty_y0);
+  }
 
-  uint32_t *get_buffer() const { return framebuffer; }
+  // Raw access: the caller may write anywhere, so the next flush() commits
+  // the whole window. The pointer changes after every commit.
+  uint32_t *get_buffer() {
+    mark_dirty(0, 0, width, height);
+    return framebuffer;
+  }
 
   int get_width() const { return width; }
   int get_height() const { return height; }
@@ -147,6 +232,7 @@ public:
   void put_pixel(int x, int y, uint32_t color) {
     if (framebuffer && x >= 0 && x < width && y >= 0 && y < height) {
       framebuffer[y * width + x] = color;
+      mark_dirty(x, y, 1, 1);
     }
   }
 
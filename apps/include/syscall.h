@@ -155,6 +155,12 @@
 #define SYS_TCSETATTR 132
 #define SYS_SELECT 133
 #define SYS_POLL 134
+#define SYS_EPOLL_CREATE 135
+#define SYS_EPOLL_CTL 136
+#define SYS_EPOLL_WAIT 137
+#define SYS_VFORK 138
+#define SYS_FSYNC 139
+#define SYS_FDATASYNC 140
 
 // Phase 11-12: Memory/Config
 #define SYS_MPROTECT 141
@@ -162,6 +168,12 @@
 #define SYS_MLOCK 143
 #define SYS_SYSCONF 144
 
+// Vectored / in-kernel transfer I/O
+#define SYS_PREADV 145
+#define SYS_PWRITEV 146
+#define SYS_SENDFILE 147
+#define SYS_SPLICE 148
+
 // Graphics / Framebuffer (Added for TextView Contract)
 #define SYS_GET_FRAMEBUFFER 150
 #define SYS_FB_WIDTH 151
@@ -169,9 +181,48 @@
 #define SYS_FB_SWAP 153
 #define SYS_PTY_CREATE 154
 #define SYS_NET_PING 155
+#define SYS_NET_STATS 157
 
 #define AF_UNIX 1
+#define AF_INET 2
 #define SOCK_STREAM 1
+#define SOCK_DGRAM 2
+#define SOCK_NONBLOCK 0x800
+
+#define IPPROTO_TCP 6
+#define IPPROTO_UDP 17
+#define INADDR_ANY 0
+#define INADDR_LOOPBACK 0x0100007F /* 127.0.0.1, network byte order */
+
+/* Socket options */
+#define SOL_SOCKET 1
+#define SO_REUSEADDR 2
+#define SO_TYPE 3
+#define SO_ERROR 4
+#define SO_SNDBUF 7
+#define SO_RCVBUF 8
+#define TCP_NODELAY 1 /* level IPPROTO_TCP */
+
+#define MSG_DONTWAIT 0x40
+
+#define FIONREAD 0x541B
+#define FIONBIO 0x5421
+
+/* IPv4 address: port and address in network byte order */
+struct sockaddr_in {
+  uint16_t sin_family;
+  uint16_t sin_port;
+  uint32_t sin_addr;
+  uint8_t sin_zero[8];
+};
+
+static inline uint16_t net_htons(uint16_t x) { return (x << 8) | (x >> 8); }
+
+/* a.b.c.d -> sin_addr value */
+static inline uint32_t net_ipv4(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+  return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) |
+         ((uint32_t)d << 24);
+}
 
 /* Open flags */
 #define O_RDONLY 0x00
@@ -313,6 +364,35 @@ static inline int syscall_fork(void) {
   return res;
 }
 
+/* vfork - child borrows the parent's address space until execve/_exit.
+   Must be inlined: a real call frame would be clobbered by the child. */
+static inline __attribute__((always_inline)) int syscall_vfork(void) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_VFORK) : "memory");
+  return res;
+}
+
+/* posix_spawn - 6th argument (envp) goes in ebp, like Linux i386. ebp is the
+   frame pointer, so it is saved around the trap; envp is pushed first while
+   its memory operand is still addressed against the original esp. */
+static inline int syscall_posix_spawn(int *pid, const char *path,
+                                      const void *file_actions,
+                                      const void *attrp, char *const argv[],
+                                      char *const envp[]) {
+  int res;
+  asm volatile("pushl %7\n\t"
+               "pushl %%ebp\n\t"
+               "movl 4(%%esp), %%ebp\n\t"
+               "int $0x80\n\t"
+               "popl %%ebp\n\t"
+               "addl $4, %%esp"
+               : "=a"(res)
+               : "a"(SYS_POSIX_SPAWN), "b"(pid), "c"(path), "d"(file_actions),
+                 "S"(attrp), "D"(argv), "m"(envp)
+               : "memory");
+  return res;
+}
+
 /* Execute program */
 static inline int syscall_execve(const char *path, char **argv, char **envp) {
   int res;
@@ -547,6 +627,78 @@ static inline int syscall_sync(void) {
   return res;
 }
 
+/* File ka data disk pe */
+static inline int syscall_fsync(int fd) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_FSYNC), "b"(fd));
+  return res;
+}
+
+static inline int syscall_fdatasync(int fd) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_FDATASYNC), "b"(fd));
+  return res;
+}
+
+/* Scatter/gather segment for readv/writev/preadv/pwritev */
+struct iovec {
+  void *iov_base;
+  uint32_t iov_len;
+};
+
+/* Vectored read/write at an offset; the file position is left unchanged */
+static inline int syscall_preadv(int fd, const struct iovec *iov, int iovcnt,
+                                 int offset) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_PREADV), "b"(fd), "c"(iov), "d"(iovcnt),
+                 "S"(offset)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_pwritev(int fd, const struct iovec *iov, int iovcnt,
+                                  int offset) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_PWRITEV), "b"(fd), "c"(iov), "d"(iovcnt),
+                 "S"(offset)
+               : "memory");
+  return res;
+}
+
+/* Copy count bytes from in_fd to out_fd inside the kernel. A null offset
+   uses and advances in_fd's file position. */
+static inline int syscall_sendfile(int out_fd, int in_fd, int *offset,
+                                   uint32_t count) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SENDFILE), "b"(out_fd), "c"(in_fd), "d"(offset),
+                 "S"(count)
+               : "memory");
+  return res;
+}
+
+/* Move data between a pipe and another fd; flags (6th argument) go in ebp */
+static inline int syscall_splice(int fd_in, int *off_in, int fd_out,
+                                 int *off_out, uint32_t len, uint32_t flags) {
+  int res;
+  asm volatile("push %[fl]\n\t"
+               "push %%ebp\n\t"
+               "mov 4(%%esp), %%ebp\n\t"
+               "int $0x80\n\t"
+               "pop %%ebp\n\t"
+               "add $4, %%esp"
+               : "=a"(res)
+               : "a"(SYS_SPLICE), "b"(fd_in), "c"(off_in), "d"(fd_out),
+                 "S"(off_out), "D"(len), [fl] "g"(flags)
+               : "memory");
+  return res;
+}
+
 /* Set alarm */
 static inline int syscall_alarm(uint32_t seconds) {
   int res;
@@ -590,6 +742,200 @@ static inline int syscall_connect(int sockfd, const char *path) {
   return res;
 }
 
+static inline int syscall_connect_in(int sockfd, const struct sockaddr_in *addr) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_CONNECT), "b"(sockfd), "c"(addr),
+                 "d"(sizeof(struct sockaddr_in))
+               : "memory");
+  return res;
+}
+
+static inline int syscall_bind_in(int sockfd, const struct sockaddr_in *addr) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_BIND), "b"(sockfd), "c"(addr),
+                 "d"(sizeof(struct sockaddr_in))
+               : "memory");
+  return res;
+}
+
+static inline int syscall_listen(int sockfd, int backlog) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_LISTEN), "b"(sockfd), "c"(backlog));
+  return res;
+}
+
+static inline int syscall_accept(int sockfd, struct sockaddr_in *addr,
+                                 uint32_t *addrlen) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_ACCEPT), "b"(sockfd), "c"(addr), "d"(addrlen)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_send(int sockfd, const void *buf, uint32_t len,
+                               int flags) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SEND), "b"(sockfd), "c"(buf), "d"(len), "S"(flags)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_recv(int sockfd, void *buf, uint32_t len, int flags) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_RECV), "b"(sockfd), "c"(buf), "d"(len), "S"(flags)
+               : "memory");
+  return res;
+}
+
+/* sendto/recvfrom take a 6th argument, passed in ebp */
+static inline int syscall_sendto(int sockfd, const void *buf, uint32_t len,
+                                 int flags, const struct sockaddr_in *dest,
+                                 uint32_t addrlen) {
+  int res;
+  asm volatile("push %[al]\n\t"
+               "push %%ebp\n\t"
+               "mov 4(%%esp), %%ebp\n\t"
+               "int $0x80\n\t"
+               "pop %%ebp\n\t"
+               "add $4, %%esp"
+               : "=a"(res)
+               : "a"(SYS_SENDTO), "b"(sockfd), "c"(buf), "d"(len), "S"(flags),
+                 "D"(dest), [al] "g"(addrlen)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_recvfrom(int sockfd, void *buf, uint32_t len,
+                                   int flags, struct sockaddr_in *src,
+                                   uint32_t *addrlen) {
+  int res;
+  asm volatile("push %[al]\n\t"
+               "push %%ebp\n\t"
+               "mov 4(%%esp), %%ebp\n\t"
+               "int $0x80\n\t"
+               "pop %%ebp\n\t"
+               "add $4, %%esp"
+               : "=a"(res)
+               : "a"(SYS_RECVFROM), "b"(sockfd), "c"(buf), "d"(len),
+                 "S"(flags), "D"(src), [al] "g"(addrlen)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_setsockopt(int sockfd, int level, int optname,
+                                     const void *optval, uint32_t optlen) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SETSOCKOPT), "b"(sockfd), "c"(level), "d"(optname),
+                 "S"(optval), "D"(optlen)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_getsockopt(int sockfd, int level, int optname,
+                                     void *optval, uint32_t *optlen) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_GETSOCKOPT), "b"(sockfd), "c"(level), "d"(optname),
+                 "S"(optval), "D"(optlen)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_shutdown(int sockfd, int how) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_SHUTDOWN), "b"(sockfd), "c"(how));
+  return res;
+}
+
+/* Network interface counters (kernel: net.h struct netdev_stats) */
+#define NET_IF_LO 0
+#define NET_IF_ETH0 1
+
+struct netdev_stats {
+  uint32_t rx_packets;
+  uint32_t tx_packets;
+  uint32_t rx_bytes;
+  uint32_t tx_bytes;
+  uint32_t rx_dropped;
+  uint32_t tx_dropped;
+};
+
+static inline int syscall_net_stats(int ifindex, struct netdev_stats *out) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_NET_STATS), "b"(ifindex), "c"(out)
+               : "memory");
+  return res;
+}
+
+// epoll - readiness notification (kernel: src/kernel/epoll.cpp)
+#define EPOLLIN 0x0001
+#define EPOLLPRI 0x0002
+#define EPOLLOUT 0x0004
+#define EPOLLERR 0x0008
+#define EPOLLHUP 0x0010
+#define EPOLLONESHOT (1u << 30)
+#define EPOLLET (1u << 31)
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+#define EPOLL_CLOEXEC 0x80000
+
+struct epoll_event {
+  uint32_t events;
+  union {
+    void *ptr;
+    int fd;
+    uint32_t u32;
+    uint64_t u64;
+  } data;
+} __attribute__((packed));
+
+static inline int syscall_epoll_create1(int flags) {
+  int res;
+  asm volatile("int $0x80" : "=a"(res) : "a"(SYS_EPOLL_CREATE), "b"(flags));
+  return res;
+}
+
+static inline int syscall_epoll_ctl(int epfd, int op, int fd,
+                                    struct epoll_event *event) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_EPOLL_CTL), "b"(epfd), "c"(op), "d"(fd), "S"(event)
+               : "memory");
+  return res;
+}
+
+static inline int syscall_epoll_wait(int epfd, struct epoll_event *events,
+                                     int maxevents, int timeout_ms) {
+  int res;
+  asm volatile("int $0x80"
+               : "=a"(res)
+               : "a"(SYS_EPOLL_WAIT), "b"(epfd), "c"(events), "d"(maxevents),
+                 "S"(timeout_ms)
+               : "memory");
+  return res;
+}
+
 static inline int syscall_sigaction(int sig, const struct sigaction *act,
                                     struct sigaction *oldact) {
   int res;
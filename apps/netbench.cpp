@@ -0,0 +1,345 @@
+// netbench.cpp - Loopback network benchmark
+// 127.0.0.1 pe teen test chalata hai (fork karke client/server):
+//   1. TCP stream          - throughput (MB/s)
+//   2. TCP request/response - round trips/s aur latency
+//   3. UDP stream          - datagrams/s, MB/s aur loss
+// Har test ke baad "lo" interface ke counters se packets/s bhi dikhata hai.
+// Poora offline chalta hai - network stack ke regressions pakadne ke liye.
+
+#include "include/syscall.h"
+#include "include/userlib.h"
+
+#define NB_CLOCK_MONOTONIC 1
+#define NB_DURATION_MS 2000 // Har test kitni der chale
+
+#define NB_TCP_STREAM_PORT 5001
+#define NB_TCP_RR_PORT 5002
+#define NB_UDP_PORT 5003
+
+#define NB_STREAM_CHUNK 8192
+#define NB_RR_SIZE 64
+#define NB_UDP_SIZE 1024
+#define NB_UDP_END_MAGIC 0x454E4421 // "END!" - sender ka aakhri datagram
+
+static uint8_t nb_buf[NB_STREAM_CHUNK];
+
+/* ================= HELPERS ================= */
+
+static uint32_t nb_now_ms() {
+  struct timespec ts;
+  syscall_clock_gettime(NB_CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000 + (uint32_t)(ts.tv_nsec / 1000000);
+}
+
+static void nb_addr(struct sockaddr_in *a, uint16_t port) {
+  memset(a, 0, sizeof(*a));
+  a->sin_family = AF_INET;
+  a->sin_port = net_htons(port);
+  a->sin_addr = INADDR_LOOPBACK;
+}
+
+static int nb_listen(uint16_t port) {
+  int fd = syscall_socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return fd;
+  struct sockaddr_in a;
+  nb_addr(&a, port);
+  if (syscall_bind_in(fd, &a) < 0 || syscall_listen(fd, 4) < 0) {
+    syscall_close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static int nb_connect(uint16_t port, int nodelay) {
+  int fd = syscall_socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return fd;
+  if (nodelay) {
+    int one = 1;
+    syscall_setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  struct sockaddr_in a;
+  nb_addr(&a, port);
+  if (syscall_connect_in(fd, &a) < 0) {
+    syscall_close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Pura len bhejo / padho (TCP short read/write de sakta hai)
+static int nb_send_all(int fd, const uint8_t *p, uint32_t len) {
+  uint32_t done = 0;
+  while (done < len) {
+    int n = syscall_send(fd, p + done, len - done, 0);
+    if (n <= 0)
+      return -1;
+    done += n;
+  }
+  return 0;
+}
+
+static int nb_recv_all(int fd, uint8_t *p, uint32_t len) {
+  uint32_t done = 0;
+  while (done < len) {
+    int n = syscall_recv(fd, p + done, len - done, 0);
+    if (n <= 0)
+      return -1;
+    done += n;
+  }
+  return 0;
+}
+
+// "12.34" - 64-bit division app mein link nahi hota, isliye KB mein hisaab
+static void nb_print_rate(uint32_t bytes, uint32_t ms) {
+  if (ms == 0)
+    ms = 1;
+  uint32_t kb_per_s = (bytes / 1024) * 1000 / ms;
+  print_uint(kb_per_s / 1024);
+  putchar('.');
+  uint32_t frac = (kb_per_s % 1024) * 100 / 1024;
+  if (frac < 10)
+    putchar('0');
+  print_uint(frac);
+  syscall_print(" MB/s");
+}
+
+static void nb_print_pps(const char *label, uint32_t count, uint32_t ms) {
+  if (ms == 0)
+    ms = 1;
+  syscall_print(label);
+  print_uint(count * 1000 / ms); // 2s test mein count * 1000 overflow nahi hota
+  syscall_print("/s");
+}
+
+static struct netdev_stats nb_lo_before;
+
+static void nb_stats_begin() { syscall_net_stats(NET_IF_LO, &nb_lo_before); }
+
+static void nb_stats_end(uint32_t ms) {
+  struct netdev_stats now;
+  if (syscall_net_stats(NET_IF_LO, &now) < 0)
+    return;
+  nb_print_pps("    lo: ", now.tx_packets - nb_lo_before.tx_packets, ms);
+  syscall_print(" packets, ");
+  nb_print_rate(now.tx_bytes - nb_lo_before.tx_bytes, ms);
+  if (now.tx_dropped != nb_lo_before.tx_dropped) {
+    syscall_print(", dropped ");
+    print_uint(now.tx_dropped - nb_lo_before.tx_dropped);
+  }
+  putchar('\n');
+}
+
+/* ================= TCP STREAM ================= */
+
+static void nb_tcp_stream() {
+  syscall_print("[1] TCP stream (127.0.0.1:5001)\n");
+  int lfd = nb_listen(NB_TCP_STREAM_PORT);
+  if (lfd < 0) {
+    puts("    listen failed");
+    return;
+  }
+
+  int pid = syscall_fork();
+  if (pid == 0) {
+    // Client: NB_DURATION_MS tak bhejte raho
+    syscall_close(lfd);
+    int fd = nb_connect(NB_TCP_STREAM_PORT, 0);
+    if (fd < 0)
+      syscall_exit(1);
+    memset(nb_buf, 0x5A, sizeof(nb_buf));
+    uint32_t end = nb_now_ms() + NB_DURATION_MS;
+    while (nb_now_ms() < end) {
+      if (nb_send_all(fd, nb_buf, sizeof(nb_buf)) < 0)
+        break;
+    }
+    syscall_close(fd);
+    syscall_exit(0);
+  }
+
+  int cfd = syscall_accept(lfd, 0, 0);
+  syscall_close(lfd);
+  if (cfd < 0) {
+    puts("    accept failed");
+    syscall_wait(0);
+    return;
+  }
+
+  nb_stats_begin();
+  uint32_t start = nb_now_ms();
+  uint32_t bytes = 0;
+  for (;;) {
+    int n = syscall_recv(cfd, nb_buf, sizeof(nb_buf), 0);
+    if (n <= 0)
+      break;
+    bytes += n;
+  }
+  uint32_t ms = nb_now_ms() - start;
+  syscall_close(cfd);
+  syscall_wait(0);
+
+  syscall_print("    ");
+  print_uint(bytes);
+  syscall_print(" bytes in ");
+  print_uint(ms);
+  syscall_print(" ms, ");
+  nb_print_rate(bytes, ms);
+  putchar('\n');
+  nb_stats_end(ms);
+}
+
+/* ================= TCP REQUEST/RESPONSE ================= */
+
+static void nb_tcp_rr() {
+  syscall_print("[2] TCP request/response, 64 bytes (127.0.0.1:5002)\n");
+  int lfd = nb_listen(NB_TCP_RR_PORT);
+  if (lfd < 0) {
+    puts("    listen failed");
+    return;
+  }
+
+  int pid = syscall_fork();
+  if (pid == 0) {
+    // Server: jo aaye wahi wapas bhejo
+    int cfd = syscall_accept(lfd, 0, 0);
+    syscall_close(lfd);
+    if (cfd < 0)
+      syscall_exit(1);
+    int one = 1;
+    syscall_setsockopt(cfd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    uint8_t msg[NB_RR_SIZE];
+    while (nb_recv_all(cfd, msg, sizeof(msg)) == 0) {
+      if (nb_send_all(cfd, msg, sizeof(msg)) < 0)
+        break;
+    }
+    syscall_close(cfd);
+    syscall_exit(0);
+  }
+  syscall_close(lfd);
+
+  int fd = nb_connect(NB_TCP_RR_PORT, 1);
+  if (fd < 0) {
+    puts("    connect failed");
+    syscall_wait(0);
+    return;
+  }
+
+  uint8_t msg[NB_RR_SIZE];
+  memset(msg, 0xA5, sizeof(msg));
+  nb_stats_begin();
+  uint32_t start = nb_now_ms();
+  uint32_t end = start + NB_DURATION_MS;
+  uint32_t trips = 0;
+  while (nb_now_ms() < end) {
+    if (nb_send_all(fd, msg, sizeof(msg)) < 0 ||
+        nb_recv_all(fd, msg, sizeof(msg)) < 0)
+      break;
+    trips++;
+  }
+  uint32_t ms = nb_now_ms() - start;
+  syscall_close(fd);
+  syscall_wait(0);
+
+  syscall_print("    ");
+  print_uint(trips);
+  syscall_print(" round trips, ");
+  nb_print_pps("", trips, ms);
+  syscall_print(", latency ");
+  print_uint(trips ? ms * 1000 / trips : 0);
+  syscall_print(" us\n");
+  nb_stats_end(ms);
+}
+
+/* ================= UDP STREAM ================= */
+
+static void nb_udp_stream() {
+  syscall_print("[3] UDP stream, 1024 byte datagrams (127.0.0.1:5003)\n");
+  int sfd = syscall_socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in a;
+  nb_addr(&a, NB_UDP_PORT);
+  if (sfd < 0 || syscall_bind_in(sfd, &a) < 0) {
+    puts("    bind failed");
+    return;
+  }
+
+  int pid = syscall_fork();
+  if (pid == 0) {
+    syscall_close(sfd);
+    int fd = syscall_socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+      syscall_exit(1);
+    uint8_t dgram[NB_UDP_SIZE];
+    memset(dgram, 0x3C, sizeof(dgram));
+    uint32_t sent = 0;
+    uint32_t end = nb_now_ms() + NB_DURATION_MS;
+    while (nb_now_ms() < end) {
+      if (syscall_sendto(fd, dgram, sizeof(dgram), 0, &a, sizeof(a)) < 0)
+        break;
+      sent++;
+    }
+    // Aakhri marker mein kitne bheje woh bhi; drop ho sakta hai isliye 3 baar
+    uint32_t fin[2] = {NB_UDP_END_MAGIC, sent};
+    for (int i = 0; i < 3; i++) {
+      syscall_sendto(fd, fin, sizeof(fin), 0, &a, sizeof(a));
+      syscall_sleep(1);
+    }
+    syscall_close(fd);
+    syscall_exit(0);
+  }
+
+  // Receiver: epoll timeout se, taaki marker kho jaaye toh bhi atke nahi
+  int ep = syscall_epoll_create1(0);
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.fd = sfd;
+  syscall_epoll_ctl(ep, EPOLL_CTL_ADD, sfd, &ev);
+
+  uint8_t dgram[NB_UDP_SIZE];
+  uint32_t received = 0, bytes = 0, sent = 0;
+  uint32_t start = 0, last = 0;
+  nb_stats_begin();
+  for (;;) {
+    if (syscall_epoll_wait(ep, &ev, 1, 1000) <= 0)
+      break;
+    int n = syscall_recvfrom(sfd, dgram, sizeof(dgram), 0, 0, 0);
+    if (n < 0)
+      break;
+    if (n == 8 && ((uint32_t *)dgram)[0] == NB_UDP_END_MAGIC) {
+      sent = ((uint32_t *)dgram)[1];
+      break;
+    }
+    if (received == 0)
+      start = nb_now_ms();
+    last = nb_now_ms();
+    received++;
+    bytes += n;
+  }
+  uint32_t ms = last - start;
+  syscall_close(ep);
+  syscall_close(sfd);
+  syscall_wait(0);
+
+  syscall_print("    ");
+  print_uint(received);
+  syscall_print(" datagrams received");
+  if (sent) {
+    syscall_print(" of ");
+    print_uint(sent);
+  }
+  syscall_print(", ");
+  nb_print_pps("", received, ms);
+  syscall_print(", ");
+  nb_print_rate(bytes, ms);
+  putchar('\n');
+  nb_stats_end(ms);
+}
+
+extern "C" void _start() {
+  puts("netbench: loopback network benchmark");
+  nb_tcp_stream();
+  nb_tcp_rr();
+  nb_udp_stream();
+  puts("netbench: done");
+  syscall_exit(0);
+}
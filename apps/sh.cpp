@@ -58,56 +58,38 @@ int main() {
       continue;
     }
 
-    // External commands
-    int pid = fork();
-    if (pid == 0) {
-      // Child process
-      char path[256];
-      char *argv[2];
+    // External commands: posix_spawn - shell ka address space copy nahi
+    // hota, har candidate path seedha try karo
+    const char *prefixes[] = {"/apps/", "/bin/", "/"};
+    int nprefix = (cmd[0] == '/' || cmd[0] == '.') ? 1 : 3;
+    char path[256];
+    char *argv[2];
+    pid_t pid = 0;
+    int err = ENOENT;
 
-      // Try absolute/relative path
+    argv[0] = path;
+    argv[1] = NULL;
+    for (int i = 0; i < nprefix && err; i++) {
       if (cmd[0] == '/' || cmd[0] == '.') {
         strcpy(path, cmd);
       } else {
-        // Try /apps/ first
-        strcpy(path, "/apps/");
+        strcpy(path, prefixes[i]);
         strcat(path, cmd);
         if (strstr(path, ".elf") == 0)
           strcat(path, ".elf");
       }
+      err = posix_spawn(&pid, path, NULL, NULL, argv, NULL);
+    }
 
-      argv[0] = path;
-      argv[1] = NULL;
-      execve(path, argv, NULL);
-
-      // Try /bin/
-      if (cmd[0] != '/' && cmd[0] != '.') {
-        strcpy(path, "/bin/");
-        strcat(path, cmd);
-        if (strstr(path, ".elf") == 0)
-          strcat(path, ".elf");
-        execve(path, argv, NULL);
-      }
-
-      // Try root /
-      if (cmd[0] != '/' && cmd[0] != '.') {
-        strcpy(path, "/");
-        strcat(path, cmd);
-        if (strstr(path, ".elf") == 0)
-          strcat(path, ".elf");
-        execve(path, argv, NULL);
-      }
-
+    if (err == 0) {
+      int status;
+      waitpid((int)pid, &status, 0);
+    } else if (err == ENOENT) {
       shell_print("sh: command not found: ");
       shell_print(cmd);
       shell_print("\n");
-      exit(1);
-    } else if (pid > 0) {
-      // Parent process
-      int status;
-      wait(&status);
     } else {
-      shell_print("sh: fork failed\n");
+      shell_print("sh: spawn failed\n");
     }
   }
 
@@ -40,6 +40,7 @@ build_app "notepad"
 build_app "test"
 build_app "ping"
 build_app "tcptest"
+build_app "netbench"
 # build_app "explorer"
 
 echo "  Building apps/posix_test.cpp..."
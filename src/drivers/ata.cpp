@@ -35,27 +35,66 @@ void ata_read_sector(uint32_t lba, uint8_t *buffer) {
   asm volatile("sti");
 }
 
-void ata_write_sector(uint32_t lba, uint8_t *buffer) {
+// Ek READ command mein `count` lagataar sectors; poore run (max 128) cli
+void ata_read_sectors(uint32_t lba, uint8_t count, uint8_t *buffer) {
+  asm volatile("cli");
   ata_wait_bsy();
 
   outb(ATA_DRIVE_HEAD, 0xE0 | ((lba >> 24) & 0x0F));
   outb(ATA_ERROR, 0x00);
-  outb(ATA_SECTOR_CNT, 1);
+  outb(ATA_SECTOR_CNT, count);
   outb(ATA_LBA_LO, (uint8_t)lba);
   outb(ATA_LBA_MID, (uint8_t)(lba >> 8));
   outb(ATA_LBA_HI, (uint8_t)(lba >> 16));
-  outb(ATA_COMMAND, ATA_CMD_WRITE_PIO);
+  outb(ATA_COMMAND, ATA_CMD_READ_PIO);
 
+  uint16_t *buf16 = (uint16_t *)buffer;
+  for (uint32_t s = 0; s < count; s++) {
+    ata_wait_bsy();
+    ata_wait_drq();
+    for (int i = 0; i < 256; i++) {
+      buf16[s * 256 + i] = inw(ATA_DATA);
+    }
+  }
+  asm volatile("sti");
+}
+
+// Ek hi WRITE command mein `count` (1-255) lagataar sectors. Writeback ke
+// lambe runs ke liye - har sector ka alag command/setup nahi.
+void ata_write_sectors_nosync(uint32_t lba, uint8_t count, uint8_t *buffer) {
   ata_wait_bsy();
-  ata_wait_drq();
 
-  // Write 256 words
+  outb(ATA_DRIVE_HEAD, 0xE0 | ((lba >> 24) & 0x0F));
+  outb(ATA_ERROR, 0x00);
+  outb(ATA_SECTOR_CNT, count);
+  outb(ATA_LBA_LO, (uint8_t)lba);
+  outb(ATA_LBA_MID, (uint8_t)(lba >> 8));
+  outb(ATA_LBA_HI, (uint8_t)(lba >> 16));
+  outb(ATA_COMMAND, ATA_CMD_WRITE_PIO);
+
+  // Har sector ke baad drive agla DRQ deta hai
   uint16_t *buf16 = (uint16_t *)buffer;
-  for (int i = 0; i < 256; i++) {
-    outw(ATA_DATA, buf16[i]);
+  for (uint32_t s = 0; s < count; s++) {
+    ata_wait_bsy();
+    ata_wait_drq();
+    for (int i = 0; i < 256; i++) {
+      outw(ATA_DATA, buf16[s * 256 + i]);
+    }
   }
+}
 
-  // Flush Cache
-  outb(ATA_COMMAND, 0xE7);
+void ata_write_sector_nosync(uint32_t lba, uint8_t *buffer) {
+  ata_write_sectors_nosync(lba, 1, buffer);
+}
+
+// Drive ka write cache platters tak pahuncha do (ordering barrier)
+void ata_flush_cache() {
+  ata_wait_bsy();
+  outb(ATA_COMMAND, ATA_CMD_CACHE_FLUSH);
   ata_wait_bsy();
 }
+
+void ata_write_sector(uint32_t lba, uint8_t *buffer) {
+  ata_write_sector_nosync(lba, buffer);
+  ata_flush_cache();
+}
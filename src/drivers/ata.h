@@ -22,9 +22,16 @@
 // Commands
 #define ATA_CMD_READ_PIO 0x20
 #define ATA_CMD_WRITE_PIO 0x30
+#define ATA_CMD_CACHE_FLUSH 0xE7
 
 // Functions
 void ata_read_sector(uint32_t lba, uint8_t *buffer);
-void ata_write_sector(uint32_t lba, uint8_t *buffer);
+void ata_read_sectors(uint32_t lba, uint8_t count, uint8_t *buffer);
+void ata_write_sector(uint32_t lba, uint8_t *buffer); // Write + cache flush
+
+// Batch writes: bina flush ke likho, phir ek ata_flush_cache() barrier
+void ata_write_sector_nosync(uint32_t lba, uint8_t *buffer);
+void ata_write_sectors_nosync(uint32_t lba, uint8_t count, uint8_t *buffer);
+void ata_flush_cache();
 
 #endif
@@ -6,6 +6,11 @@ void bga_write_register(uint16_t index, uint16_t value) {
   outw(VBE_DISPI_IOPORT_DATA, value);
 }
 
+uint16_t bga_read_register(uint16_t index) {
+  outw(VBE_DISPI_IOPORT_INDEX, index);
+  return inw(VBE_DISPI_IOPORT_DATA);
+}
+
 void bga_set_video_mode(uint16_t width, uint16_t height, uint16_t bpp) {
   bga_write_register(VBE_DISPI_INDEX_ENABLE, VBE_DISPI_DISABLED);
   bga_write_register(VBE_DISPI_INDEX_XRES, width);
@@ -25,6 +25,8 @@
 extern "C" {
 #endif
 void bga_set_video_mode(uint16_t width, uint16_t height, uint16_t bpp);
+void bga_write_register(uint16_t index, uint16_t value);
+uint16_t bga_read_register(uint16_t index);
 #ifdef __cplusplus
 }
 #endif
@@ -1,61 +1,302 @@
+/*
+ * bmp.cpp - BMP decoder + decoded image cache
+ * Pehle draw_bmp har call pe har pixel ka offset nikaal ke put_pixel karta
+ * tha. Ab file ek baar screen format (0xFFRRGGBB) mein decode hoti hai,
+ * chahiye toh usi waqt target size pe scale bhi - phir sirf row blits.
+ */
+
 #include "bmp.h"
+#include "../include/errno.h"
+#include "../include/string.h"
+#include "../include/vfs.h"
+#include "../kernel/heap.h"
 #include "../kernel/memory.h"
 #include "graphics.h"
+#include "raster.h"
 #include "serial.h"
 
+#define BMP_MAGIC 0x4D42 // 'BM'
+#define BMP_HEADER_LEN (sizeof(bmp_file_header_t) + sizeof(bmp_info_header_t))
+#define BMP_BI_RGB 0
+#define BMP_BI_BITFIELDS 3
+
+typedef struct bmp_layout {
+  int width, height; // height hamesha positive
+  int top_down;      // Header mein negative height
+  int bytes_pp;      // 3 ya 4
+  uint32_t row_size; // 4 byte padding ke saath
+  uint32_t offset;   // Pixel data kahan se shuru
+} bmp_layout_t;
+
+// Decode + scale ka state: har source row kis destination rows mein jaati hai
+typedef struct bmp_sink {
+  bmp_image_t *img;
+  int src_h;
+  int *xmap; // Destination column -> source row mein byte offset
+} bmp_sink_t;
 
-void draw_bmp(uint8_t *data, int x, int y) {
-  bmp_file_header_t *file_header = (bmp_file_header_t *)data;
-  bmp_info_header_t *info_header =
-      (bmp_info_header_t *)(data + sizeof(bmp_file_header_t));
+/* ================= HEADER ================= */
+static int bmp_parse(const uint8_t *hdr, bmp_layout_t *l) {
+  const bmp_file_header_t *fh = (const bmp_file_header_t *)hdr;
+  const bmp_info_header_t *ih =
+      (const bmp_info_header_t *)(hdr + sizeof(bmp_file_header_t));
 
-  if (file_header->type != 0x4D42) { // 'BM'
+  if (fh->type != BMP_MAGIC) {
     serial_log("BMP: Invalid Signature");
-    return;
+    return -EINVAL;
+  }
+  int bpp = ih->bits_per_pixel;
+  if ((bpp != 24 && bpp != 32) ||
+      !(ih->compression == BMP_BI_RGB ||
+        (bpp == 32 && ih->compression == BMP_BI_BITFIELDS))) {
+    serial_log("BMP: Unsupported format. Only 24/32 bpp uncompressed.");
+    return -EINVAL;
   }
 
-  int width = info_header->width_px;
-  int height = info_header->height_px;
-  int bpp = info_header->bits_per_pixel;
+  l->width = ih->width_px;
+  l->top_down = ih->height_px < 0;
+  l->height = l->top_down ? -ih->height_px : ih->height_px;
+  if (l->width <= 0 || l->height <= 0 || l->width > BMP_MAX_DIM ||
+      l->height > BMP_MAX_DIM) {
+    serial_log("BMP: Bad dimensions");
+    return -EINVAL;
+  }
+  l->bytes_pp = bpp / 8;
+  l->row_size = ((l->width * bpp + 31) / 32) * 4;
+  l->offset = fh->offset;
+  return 0;
+}
 
-  serial_log("BMP: Rendering Image...");
-  // manual print for debugging
-  // serial_log_num(width);
-  // serial_log_num(height);
+/* ================= OUTPUT ================= */
+static int bmp_sink_init(bmp_sink_t *s, const bmp_layout_t *l, int w, int h,
+                         bmp_image_t *out) {
+  if (w <= 0 || h <= 0) {
+    w = l->width;
+    h = l->height;
+  }
+  if (w > BMP_MAX_DIM || h > BMP_MAX_DIM)
+    return -EINVAL;
 
-  if (bpp != 24 && bpp != 32) {
-    serial_log("BMP: Unsupported BPP. Only 24/32 supported.");
-    return;
+  out->width = w;
+  out->height = h;
+  out->pixels = (uint32_t *)kmalloc((uint32_t)w * h * sizeof(uint32_t));
+  s->xmap = (int *)kmalloc(w * sizeof(int));
+  if (!out->pixels || !s->xmap) {
+    if (out->pixels)
+      kfree(out->pixels);
+    if (s->xmap)
+      kfree(s->xmap);
+    out->pixels = nullptr;
+    return -ENOMEM;
   }
+  for (int x = 0; x < w; x++)
+    s->xmap[x] = (x * l->width / w) * l->bytes_pp;
+  s->img = out;
+  s->src_h = l->height;
+  return 0;
+}
 
-  uint8_t *pixel_data = data + file_header->offset;
+// Source row sy (top-down) un saari destination rows mein jaati hai jinka
+// dy * src_h / dst_h == sy. Pehli row convert hoti hai, baaki uski copy.
+static void bmp_sink_row(bmp_sink_t *s, int sy, const uint8_t *row) {
+  bmp_image_t *img = s->img;
+  int dh = img->height, dw = img->width;
+  int dy0 = (sy * dh + s->src_h - 1) / s->src_h;
+  int dy1 = ((sy + 1) * dh + s->src_h - 1) / s->src_h;
+  if (dy0 >= dy1)
+    return; // Downscale: yeh row kisi ke kaam ki nahi
 
-  // BMP is usually stored bottom-up (height > 0)
-  // Row padding: Each row is padded to a multiple of 4 bytes
-  int row_size = ((width * bpp + 31) / 32) * 4;
+  uint32_t *dst = img->pixels + dy0 * dw;
+  for (int x = 0; x < dw; x++) {
+    const uint8_t *p = row + s->xmap[x];
+    dst[x] = 0xFF000000 | (p[2] << 16) | (p[1] << 8) | p[0];
+  }
+  for (int dy = dy0 + 1; dy < dy1; dy++)
+    span_copy(img->pixels + dy * dw, dst, dw);
+}
 
-  for (int row = 0; row < height; row++) {
-    for (int col = 0; col < width; col++) {
-      // Calculate source index
-      // If height > 0, rows are stored bottom-to-top
-      // So pixel(0,0) is at the bottom-left of the image
-      // We want to draw it at x, y+(height-1-row) OR just flip the loop
+static inline int bmp_visual_row(const bmp_layout_t *l, int r) {
+  // Bottom-up file mein pehli stored row sabse neeche wali hai
+  return l->top_down ? r : l->height - 1 - r;
+}
+
+/* ================= DECODERS ================= */
+extern "C" int bmp_decode(const uint8_t *data, uint32_t len,
+                          bmp_image_t *out) {
+  bmp_layout_t l;
+  bmp_sink_t s;
+  if (!data || len < BMP_HEADER_LEN)
+    return -EINVAL;
+  int ret = bmp_parse(data, &l);
+  if (ret < 0)
+    return ret;
+  if (l.offset > len || (len - l.offset) / l.row_size < (uint32_t)l.height) {
+    serial_log("BMP: Truncated pixel data");
+    return -EINVAL;
+  }
+  ret = bmp_sink_init(&s, &l, 0, 0, out);
+  if (ret < 0)
+    return ret;
 
-      // Let's iterate visual y
-      // Visual row 0 (top) corresponds to data row (height-1)
+  for (int r = 0; r < l.height; r++)
+    bmp_sink_row(&s, bmp_visual_row(&l, r), data + l.offset + r * l.row_size);
+  kfree(s.xmap);
+  return 0;
+}
+
+extern "C" int bmp_load(const char *path, int w, int h, bmp_image_t *out) {
+  vfs_node_t *node = vfs_resolve_path(path);
+  if (!node)
+    return -ENOENT;
 
-      int data_row = height - 1 - row;
-      int offset = (data_row * row_size) + (col * (bpp / 8));
+  uint8_t hdr[BMP_HEADER_LEN];
+  bmp_layout_t l;
+  bmp_sink_t s;
+  uint8_t *row = nullptr;
+  int ret = -EIO;
 
-      uint8_t b = pixel_data[offset + 0];
-      uint8_t g = pixel_data[offset + 1];
-      uint8_t r = pixel_data[offset + 2];
+  if (vfs_read(node, 0, hdr, sizeof(hdr)) != (int)sizeof(hdr))
+    goto out;
+  ret = bmp_parse(hdr, &l);
+  if (ret < 0)
+    goto out;
 
-      // put_pixel expects ARGB (0xAA RR GG BB)
-      uint32_t color = (0xFF << 24) | (r << 16) | (g << 8) | b;
+  row = (uint8_t *)kmalloc(l.row_size);
+  if (!row) {
+    ret = -ENOMEM;
+    goto out;
+  }
+  ret = bmp_sink_init(&s, &l, w, h, out);
+  if (ret < 0)
+    goto out;
 
-      put_pixel(x + col, y + row, color);
+  // File order mein padho (disk pe seedha aage badhte raho)
+  for (int r = 0; r < l.height; r++) {
+    uint64_t off = l.offset + (uint64_t)r * l.row_size;
+    if (vfs_read(node, off, row, l.row_size) != (int)l.row_size) {
+      serial_log("BMP: Short read");
+      bmp_free(out);
+      ret = -EIO;
+      break;
     }
+    bmp_sink_row(&s, bmp_visual_row(&l, r), row);
+  }
+  kfree(s.xmap);
+
+out:
+  if (row)
+    kfree(row);
+  vfs_close(node);
+  return ret;
+}
+
+extern "C" int bmp_scale(const bmp_image_t *src, int w, int h,
+                         bmp_image_t *out) {
+  if (!src || !src->pixels || w <= 0 || h <= 0 || w > BMP_MAX_DIM ||
+      h > BMP_MAX_DIM)
+    return -EINVAL;
+
+  out->width = w;
+  out->height = h;
+  out->pixels = (uint32_t *)kmalloc((uint32_t)w * h * sizeof(uint32_t));
+  int *xmap = (int *)kmalloc(w * sizeof(int));
+  if (!out->pixels || !xmap) {
+    if (out->pixels)
+      kfree(out->pixels);
+    if (xmap)
+      kfree(xmap);
+    out->pixels = nullptr;
+    return -ENOMEM;
   }
-  serial_log("BMP: Render Complete.");
+  for (int x = 0; x < w; x++)
+    xmap[x] = x * src->width / w;
+
+  int prev_sy = -1;
+  for (int y = 0; y < h; y++) {
+    uint32_t *dst = out->pixels + y * w;
+    int sy = y * src->height / h;
+    if (sy == prev_sy) {
+      span_copy(dst, dst - w, w); // Upscale: pichli row hi dobara
+      continue;
+    }
+    const uint32_t *s = src->pixels + sy * src->width;
+    for (int x = 0; x < w; x++)
+      dst[x] = s[xmap[x]];
+    prev_sy = sy;
+  }
+  kfree(xmap);
+  return 0;
+}
+
+extern "C" void bmp_free(bmp_image_t *img) {
+  if (img && img->pixels) {
+    kfree(img->pixels);
+    img->pixels = nullptr;
+  }
+}
+
+/* ================= CACHE ================= */
+#define BMP_CACHE_SLOTS 4
+#define BMP_CACHE_PATH_MAX 64
+
+typedef struct bmp_cache_entry {
+  char path[BMP_CACHE_PATH_MAX];
+  int req_w, req_h; // Jo size maanga gaya tha (0 = original)
+  int failed;       // Load fail hua - har frame disk mat padho
+  uint32_t last_use;
+  bmp_image_t img;
+} bmp_cache_entry_t;
+
+static bmp_cache_entry_t bmp_cache[BMP_CACHE_SLOTS];
+static uint32_t bmp_cache_clock = 0;
+
+extern "C" const bmp_image_t *bmp_cache_get(const char *path, int w, int h) {
+  if (!path || strlen(path) >= BMP_CACHE_PATH_MAX)
+    return nullptr;
+
+  bmp_cache_entry_t *victim = &bmp_cache[0];
+  for (int i = 0; i < BMP_CACHE_SLOTS; i++) {
+    bmp_cache_entry_t *e = &bmp_cache[i];
+    if (e->path[0] && e->req_w == w && e->req_h == h &&
+        strcmp(e->path, path) == 0) {
+      e->last_use = ++bmp_cache_clock;
+      return e->failed ? nullptr : &e->img;
+    }
+    // Khaali slot sabse pehle, warna sabse purana (LRU)
+    if (!victim->path[0])
+      continue;
+    if (!e->path[0] || e->last_use < victim->last_use)
+      victim = e;
+  }
+
+  bmp_free(&victim->img);
+  strcpy(victim->path, path);
+  victim->req_w = w;
+  victim->req_h = h;
+  victim->last_use = ++bmp_cache_clock;
+  victim->failed = bmp_load(path, w, h, &victim->img) < 0;
+  if (victim->failed) {
+    serial_log("BMP: Cache load failed:");
+    serial_log(path);
+    return nullptr;
+  }
+  return &victim->img;
+}
+
+// Resolution badli ya file badli - sab decoded images chhod do
+extern "C" void bmp_cache_flush() {
+  for (int i = 0; i < BMP_CACHE_SLOTS; i++) {
+    bmp_free(&bmp_cache[i].img);
+    bmp_cache[i].path[0] = 0;
+  }
+}
+
+/* ================= LEGACY ================= */
+extern "C" void draw_bmp(uint8_t *data, int x, int y) {
+  bmp_image_t img;
+  // Purana API length nahi deta - pehle ki tarah headers pe bharosa
+  if (!data || bmp_decode(data, 0xFFFFFFFF, &img) < 0)
+    return;
+  draw_bitmap(x, y, img.width, img.height, img.pixels);
+  bmp_free(&img);
 }
@@ -29,6 +29,39 @@ typedef struct {
 
 #pragma pack(pop)
 
+#define BMP_MAX_DIM 4096
+
+// Decoded image: screen format (0xFFRRGGBB), top-down, pitch == width
+typedef struct bmp_image {
+  int width, height;
+  uint32_t *pixels;
+} bmp_image_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Poori file memory mein ho toh. 0 ya negative errno.
+int bmp_decode(const uint8_t *data, uint32_t len, bmp_image_t *out);
+
+// VFS se row-by-row stream karke decode + scale (w/h = 0 -> original size).
+// Ek padded row ka buffer hi lagta hai, poori file kabhi memory mein nahi.
+int bmp_load(const char *path, int w, int h, bmp_image_t *out);
+
+// Nearest-neighbour resize (x map ek baar banta hai, same rows copy hoti hain)
+int bmp_scale(const bmp_image_t *src, int w, int h, bmp_image_t *out);
+
+void bmp_free(bmp_image_t *img);
+
+// Decoded + pre-scaled image cache (path + size key). Cache ka apna hai,
+// caller free na kare. Load fail ho toh nullptr (aur dobara try nahi hota).
+const bmp_image_t *bmp_cache_get(const char *path, int w, int h);
+void bmp_cache_flush();
+
 void draw_bmp(uint8_t *data, int x, int y);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
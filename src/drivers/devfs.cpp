@@ -1,5 +1,5 @@
 // DevFS - Device Filesystem Implementation
-// Provides /dev/null, /dev/zero, /dev/tty
+// Provides /dev/null, /dev/zero, /dev/tty, /dev/input
 
 #include "../include/string.h"
 #include "../include/vfs.h"
@@ -8,6 +8,7 @@
 #include "serial.h"
 
 #include "../kernel/tty.h"
+#include "input.h"
 #include "serial.h"
 
 extern "C" {
@@ -92,6 +93,11 @@ static uint32_t dev_tty_write(vfs_node_t *node, uint32_t offset, uint32_t size,
   return tty_write(tty_get_console(), (const char *)buffer, size);
 }
 
+static int dev_tty_poll(vfs_node_t *node, poll_table_t *pt) {
+  (void)node;
+  return tty_poll(tty_get_console(), pt);
+}
+
 // ============================================================================
 // DevFS Directory Operations
 // ============================================================================
@@ -124,6 +130,11 @@ static struct dirent *devfs_readdir(vfs_node_t *node, uint32_t index) {
     devfs_dirent.d_ino = 5;
     return &devfs_dirent;
   }
+  if (index == 5) {
+    strcpy(devfs_dirent.d_name, "input");
+    devfs_dirent.d_ino = 6;
+    return &devfs_dirent;
+  }
   return 0;
 }
 
@@ -160,6 +171,8 @@ static vfs_node_t *devfs_finddir(vfs_node_t *node, const char *name) {
     return pts_dir_node;
   if (strcmp(name, "ptmx") == 0)
     return ptmx_node;
+  if (strcmp(name, "input") == 0)
+    return input_dev_node();
   return 0;
 }
 
@@ -203,6 +216,7 @@ vfs_node_t *devfs_init() {
   tty_node->flags = VFS_DEVICE;
   tty_node->read = dev_tty_read;
   tty_node->write = dev_tty_write;
+  tty_node->poll = dev_tty_poll;
   tty_node->ref_count = 0xFFFFFFFF;
 
   // Create /dev/pts
@@ -1,15 +1,20 @@
 #include "fat16.h"
 #include "../include/dirent.h"
+#include "../include/errno.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
+#include "../kernel/block_device.h"
 #include "../kernel/heap.h"
 #include "../kernel/memory.h"
+#include "../kernel/process.h"
+#include "../kernel/wait_queue.h"
 #include "ata.h"
 #include "serial.h"
 
 // Forward declaration for DevFS
 extern "C" vfs_node_t *devfs_init();
 static vfs_node_t *devfs_node = 0;
+extern uint32_t tick;
 
 extern "C" {
 
@@ -278,6 +283,773 @@ static int fat16_add_entry(uint16_t dir_cluster, const char *name, uint8_t attr,
   return 0;
 }
 
+// ============================================================================
+// Write-back Cache - Delayed Allocation
+// ============================================================================
+// write() sirf 4KB cache pages mein jaata hai, sahi offset pe. Clusters
+// writeback pe milte hain - poori file ke liye ek lagataar run - aur dirty
+// sectors lambe multi-sector ATA commands mein jaate hain. Background
+// flusher purana dirty data likhta hai; sync/fsync turant.
+// Files ki pehchaan dirent ki jagah se hai (vfs_node::inode) kyunki
+// finddir har baar naya node deta hai.
+// Har file ki cluster chain extents (lagataar clusters ke runs) mein cache
+// hoti hai - offset -> sector binary search hai, har hop pe FAT sector nahi.
+// Likhe ja chuke aur read-ahead wale pages clean rehte hain (disk jaise) -
+// reads unhe seedha dete hain, naye pages ke liye sabse purane hatte hain.
+
+#define FAT16_WB_FILES 32
+#define FAT16_WB_PAGES 256 // 1MB dirty data tak
+#define FAT16_WB_HIGH (FAT16_WB_PAGES * 3 / 4) // Isse upar writer khud likhe
+#define FAT16_WB_EXPIRE_TICKS 150              // 3 sec (50 Hz)
+#define FAT16_WB_RUN_MAX 128 // Ek ATA write command mein sectors
+#define FAT16_RA_QUEUE 16    // Read-ahead requests (bhara ho toh drop)
+
+// File ke clusters [file_cluster, file_cluster + count) disk pe start se
+// lagataar
+typedef struct {
+  uint32_t file_cluster;
+  uint16_t start;
+  uint16_t count;
+} fat16_extent_t;
+
+typedef struct {
+  bool used;
+  uint32_t key;           // Dirent: sector << 4 | slot
+  uint16_t first_cluster; // 0 = abhi koi cluster nahi
+  uint32_t size;          // Cache samet size
+  uint32_t disk_size;     // Dirent mein likha size
+  uint32_t pages;         // Is file ke dirty pages
+  uint32_t dirty_since;   // 0 = clean
+  uint32_t last_use;
+
+  // Cluster chain extents (file_cluster ke order mein). Pehli zaroorat pe
+  // bante hain, allocation pe aage badhte hain.
+  bool ext_valid;
+  fat16_extent_t *ext;
+  uint32_t ext_count, ext_cap;
+  uint32_t ext_clusters; // Chain ki kul lambai
+} fat16_wb_file_t;
+
+typedef struct {
+  bool used;
+  bool dirty;     // false = disk jaisa (likha ja chuka / read-ahead)
+  uint8_t file;   // fat16_wb_files index
+  uint32_t index; // File ke andar page number
+  uint32_t last_use;
+  uint8_t *data;
+} fat16_wb_page_t;
+
+typedef struct {
+  uint32_t key, offset, len;
+} fat16_ra_req_t;
+
+static fat16_wb_file_t fat16_wb_files[FAT16_WB_FILES];
+static fat16_wb_page_t fat16_wb_pages[FAT16_WB_PAGES];
+static uint32_t fat16_wb_dirty = 0; // Kul dirty pages
+static uint32_t fat16_wb_clock = 0;
+
+static fat16_ra_req_t fat16_ra_queue[FAT16_RA_QUEUE];
+static volatile uint32_t fat16_ra_head = 0, fat16_ra_tail = 0;
+static wait_queue_t fat16_ra_wait = WAIT_QUEUE_INIT;
+
+// Flusher thread aur syscalls ke beech. Same process dobara le sakta hai
+// (public API andar se doosre public functions bulata hai).
+static volatile uint32_t fat16_lock_depth = 0;
+static process_t *volatile fat16_lock_owner = 0;
+
+static void fat16_lock() {
+  while (1) {
+    uint32_t eflags = irq_save();
+    bool got = !fat16_lock_depth || fat16_lock_owner == current_process;
+    if (got) {
+      fat16_lock_owner = current_process;
+      fat16_lock_depth = fat16_lock_depth + 1;
+    }
+    irq_restore(eflags);
+    if (got)
+      return;
+    schedule();
+  }
+}
+
+static void fat16_unlock() { fat16_lock_depth = fat16_lock_depth - 1; }
+
+static uint32_t fat16_dirent_key(uint32_t sector, uint32_t offset) {
+  return (sector << 4) | (offset / sizeof(fat16_entry_t));
+}
+
+// Data area ke aakhri cluster + 1
+static uint32_t fat16_cluster_limit() {
+  uint32_t total_sectors =
+      bpb.total_sectors_16 != 0 ? bpb.total_sectors_16 : bpb.total_sectors_32;
+  uint32_t limit =
+      (total_sectors - data_start_sector) / bpb.sectors_per_cluster + 2;
+  if (limit > (uint32_t)bpb.sectors_per_fat * 256)
+    limit = (uint32_t)bpb.sectors_per_fat * 256;
+  if (limit > 0xFFF0)
+    limit = 0xFFF0;
+  return limit;
+}
+
+// FAT entry padho, ek sector buffer ke saath (scan mein har entry pe disk nahi)
+static uint16_t fat16_fat_peek(uint32_t cluster, uint8_t *buf,
+                               uint32_t *buf_sector) {
+  uint32_t sector = fat16_get_fat_sector() + cluster * 2 / 512;
+  if (*buf_sector != sector) {
+    ata_read_sector(sector, buf);
+    *buf_sector = sector;
+  }
+  return *(uint16_t *)(buf + cluster * 2 % 512);
+}
+
+static void fat16_fat_store(uint32_t sector, uint8_t *buf) {
+  ata_write_sector_nosync(sector, buf);
+  if (bpb.fats_count > 1)
+    ata_write_sector_nosync(sector + bpb.sectors_per_fat, buf);
+}
+
+// `count` khaali clusters, ho sake toh hint ke baad ek lagataar run, aur
+// unki chain (aakhri = EOF). Har FAT sector ek hi baar likha jaata hai.
+static int fat16_alloc_run(uint32_t hint, uint32_t count, uint16_t *out) {
+  uint32_t limit = fat16_cluster_limit();
+  if (limit <= 2)
+    return -ENOSPC;
+  uint32_t span = limit - 2;
+  if (hint < 2 || hint >= limit)
+    hint = 2;
+
+  uint8_t buf[512];
+  uint32_t buf_sector = 0;
+  uint32_t run_start = 0, run_len = 0;
+  for (uint32_t k = 0; k < span && run_len < count; k++) {
+    uint32_t c = 2 + (hint - 2 + k) % span;
+    if (c == 2)
+      run_len = 0; // Wrap - run lagataar nahi raha
+    if (fat16_fat_peek(c, buf, &buf_sector) == 0) {
+      if (!run_len)
+        run_start = c;
+      run_len++;
+    } else {
+      run_len = 0;
+    }
+  }
+
+  if (run_len >= count) {
+    for (uint32_t i = 0; i < count; i++)
+      out[i] = (uint16_t)(run_start + i);
+  } else {
+    // Itna bada run nahi - jo khaali mile (fragmented)
+    uint32_t found = 0;
+    for (uint32_t k = 0; k < span && found < count; k++) {
+      uint32_t c = 2 + (hint - 2 + k) % span;
+      if (fat16_fat_peek(c, buf, &buf_sector) == 0)
+        out[found++] = (uint16_t)c;
+    }
+    if (found < count)
+      return -ENOSPC;
+  }
+
+  buf_sector = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t sector = fat16_get_fat_sector() + out[i] * 2 / 512;
+    if (sector != buf_sector) {
+      if (buf_sector)
+        fat16_fat_store(buf_sector, buf);
+      ata_read_sector(sector, buf);
+      buf_sector = sector;
+    }
+    *(uint16_t *)(buf + out[i] * 2 % 512) =
+        i + 1 < count ? out[i + 1] : 0xFFFF;
+  }
+  if (buf_sector)
+    fat16_fat_store(buf_sector, buf);
+  return 0;
+}
+
+// Disk se [offset, offset + size) - cluster chain pe chal ke, sirf woh sectors
+static uint32_t fat16_read_chain(uint16_t cluster, uint32_t offset,
+                                 uint32_t size, uint8_t *buffer) {
+  uint32_t cluster_bytes = bpb.sectors_per_cluster * 512;
+  for (uint32_t skip = offset / cluster_bytes; skip > 0; skip--) {
+    if (cluster < 2 || cluster >= 0xFFF0)
+      return 0;
+    cluster = fat16_get_fat_entry(cluster);
+  }
+
+  uint8_t bounce[512];
+  uint32_t pos = offset, done = 0;
+  while (done < size && cluster >= 2 && cluster < 0xFFF0) {
+    uint32_t first = fat16_cluster_to_sector(cluster);
+    uint32_t sector = first + (pos % cluster_bytes) / 512;
+    for (; sector < first + bpb.sectors_per_cluster && done < size; sector++) {
+      uint32_t in_sector = pos % 512;
+      uint32_t n = 512 - in_sector;
+      if (n > size - done)
+        n = size - done;
+      if (n == 512) {
+        ata_read_sector(sector, buffer + done); // Poora sector seedha
+      } else {
+        ata_read_sector(sector, bounce);
+        memcpy(buffer + done, bounce + in_sector, n);
+      }
+      pos += n;
+      done += n;
+    }
+    if (done < size)
+      cluster = fat16_get_fat_entry(cluster);
+  }
+  return done;
+}
+
+// ---- Extents ----
+
+static void fat16_ext_free(fat16_wb_file_t *f) {
+  if (f->ext)
+    kfree(f->ext);
+  f->ext = 0;
+  f->ext_count = f->ext_cap = f->ext_clusters = 0;
+  f->ext_valid = false;
+}
+
+// Chain ke aage ek cluster; pichle extent se lagataar ho toh usi mein
+static int fat16_ext_push(fat16_wb_file_t *f, uint32_t cluster) {
+  if (f->ext_count) {
+    fat16_extent_t *last = &f->ext[f->ext_count - 1];
+    if (last->start + last->count == cluster && last->count < 0xFFFF) {
+      last->count++;
+      f->ext_clusters++;
+      return 0;
+    }
+  }
+  if (f->ext_count == f->ext_cap) {
+    uint32_t cap = f->ext_cap ? f->ext_cap * 2 : 8;
+    fat16_extent_t *ext =
+        (fat16_extent_t *)kmalloc(cap * sizeof(fat16_extent_t));
+    if (!ext)
+      return -ENOMEM;
+    if (f->ext) {
+      memcpy(ext, f->ext, f->ext_count * sizeof(fat16_extent_t));
+      kfree(f->ext);
+    }
+    f->ext = ext;
+    f->ext_cap = cap;
+  }
+  fat16_extent_t *e = &f->ext[f->ext_count++];
+  e->file_cluster = f->ext_clusters;
+  e->start = (uint16_t)cluster;
+  e->count = 1;
+  f->ext_clusters++;
+  return 0;
+}
+
+// Poori chain ek baar - FAT sectors buffer ke saath, toota/loop wala chain
+// cluster_limit hops pe ruk jaata hai
+static int fat16_ext_ensure(fat16_wb_file_t *f) {
+  if (f->ext_valid)
+    return 0;
+  f->ext_count = f->ext_clusters = 0;
+  uint8_t buf[512];
+  uint32_t buf_sector = 0, limit = fat16_cluster_limit();
+  uint32_t c = f->first_cluster;
+  for (uint32_t hops = 0; c >= 2 && c < limit && hops < limit; hops++) {
+    if (fat16_ext_push(f, c) < 0)
+      return -ENOMEM;
+    c = fat16_fat_peek(c, buf, &buf_sector);
+  }
+  f->ext_valid = true;
+  return 0;
+}
+
+// File ka cluster number -> extent (binary search), 0 = chain se bahar
+static fat16_extent_t *fat16_ext_find(fat16_wb_file_t *f, uint32_t fc) {
+  uint32_t lo = 0, hi = f->ext_count;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    fat16_extent_t *e = &f->ext[mid];
+    if (fc < e->file_cluster)
+      hi = mid;
+    else if (fc >= e->file_cluster + e->count)
+      lo = mid + 1;
+    else
+      return e;
+  }
+  return 0;
+}
+
+// File ka sector number -> LBA (0 = chain se bahar)
+static uint32_t fat16_ext_lba(fat16_wb_file_t *f, uint32_t sector) {
+  uint32_t fc = sector / bpb.sectors_per_cluster;
+  fat16_extent_t *e = fat16_ext_find(f, fc);
+  if (!e)
+    return 0;
+  return fat16_cluster_to_sector(e->start + (fc - e->file_cluster)) +
+         sector % bpb.sectors_per_cluster;
+}
+
+// Disk se [offset, offset + size) extents ke zariye - har extent ka hissa
+// multi-sector reads mein
+static uint32_t fat16_read_extents(fat16_wb_file_t *f, uint32_t offset,
+                                   uint32_t size, uint8_t *buffer) {
+  if (fat16_ext_ensure(f) < 0)
+    return fat16_read_chain(f->first_cluster, offset, size, buffer);
+
+  uint32_t cluster_bytes = bpb.sectors_per_cluster * 512;
+  uint8_t bounce[512];
+  uint32_t done = 0;
+  while (done < size) {
+    uint32_t pos = offset + done;
+    fat16_extent_t *e = fat16_ext_find(f, pos / cluster_bytes);
+    if (!e)
+      break;
+    uint32_t lba = fat16_ext_lba(f, pos / 512);
+    uint32_t avail = (e->file_cluster + e->count) * cluster_bytes - pos;
+    if (avail > size - done)
+      avail = size - done;
+
+    if (pos % 512 || avail < 512) {
+      uint32_t n = 512 - pos % 512;
+      if (n > avail)
+        n = avail;
+      ata_read_sector(lba, bounce);
+      memcpy(buffer + done, bounce + pos % 512, n);
+      done += n;
+      continue;
+    }
+    uint32_t count = avail / 512;
+    if (count > FAT16_WB_RUN_MAX)
+      count = FAT16_WB_RUN_MAX;
+    ata_read_sectors(lba, (uint8_t)count, buffer + done);
+    done += count * 512;
+  }
+  return done;
+}
+
+// File ke saare pages (dirty bhi) hatao
+static void fat16_wb_free_pages(fat16_wb_file_t *f) {
+  uint32_t fi = f - fat16_wb_files;
+  for (uint32_t i = 0; i < FAT16_WB_PAGES; i++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[i];
+    if (!p->used || p->file != fi)
+      continue;
+    kfree(p->data);
+    p->used = false;
+    if (p->dirty) {
+      f->pages--;
+      fat16_wb_dirty--;
+    }
+  }
+  f->dirty_since = 0;
+}
+
+// Ek page hatao (raw sector write ne disk badal di - cached copy purani)
+static void fat16_wb_invalidate(fat16_wb_file_t *f, uint32_t index) {
+  uint32_t fi = f - fat16_wb_files;
+  for (uint32_t i = 0; i < FAT16_WB_PAGES; i++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[i];
+    if (!p->used || p->file != fi || p->index != index)
+      continue;
+    kfree(p->data);
+    p->used = false;
+    if (p->dirty) {
+      f->pages--;
+      fat16_wb_dirty--;
+    }
+    return;
+  }
+}
+
+static fat16_wb_page_t *fat16_wb_find(uint32_t fi, uint32_t index) {
+  for (uint32_t i = 0; i < FAT16_WB_PAGES; i++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[i];
+    if (p->used && p->file == fi && p->index == index) {
+      p->last_use = ++fat16_wb_clock;
+      return p;
+    }
+  }
+  return 0;
+}
+
+// File ke dirty pages disk pe: pehle clusters (delayed allocation), phir
+// data file order mein lambe runs, barrier, tab dirent (size + cluster).
+static int fat16_wb_flush_file(fat16_wb_file_t *f) {
+  if (!f->used || (!f->pages && f->size == f->disk_size))
+    return 0;
+  uint32_t fi = f - fat16_wb_files;
+  uint32_t cluster_bytes = bpb.sectors_per_cluster * 512;
+  uint32_t need = (f->size + cluster_bytes - 1) / cluster_bytes;
+
+  if (need) {
+    if (fat16_ext_ensure(f) < 0)
+      return -ENOMEM;
+    if (f->ext_clusters < need) {
+      uint32_t more = need - f->ext_clusters;
+      uint16_t *fresh = (uint16_t *)kmalloc(more * sizeof(uint16_t));
+      if (!fresh)
+        return -ENOMEM;
+      fat16_extent_t *last = f->ext_count ? &f->ext[f->ext_count - 1] : 0;
+      uint32_t hint = last ? last->start + last->count : 2u;
+      int ret = fat16_alloc_run(hint, more, fresh);
+      if (ret < 0) {
+        kfree(fresh);
+        return ret;
+      }
+      if (last)
+        fat16_set_fat_entry(last->start + last->count - 1, fresh[0]);
+      else
+        f->first_cluster = fresh[0];
+      for (uint32_t i = 0; i < more; i++)
+        if (fat16_ext_push(f, fresh[i]) < 0)
+          f->ext_valid = false; // Agli baar disk se dobara
+      kfree(fresh);
+      if (!f->ext_valid && fat16_ext_ensure(f) < 0)
+        return -ENOMEM;
+    }
+  }
+
+  // Dirty pages file order mein
+  uint16_t order[FAT16_WB_PAGES];
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < FAT16_WB_PAGES; i++) {
+    if (!fat16_wb_pages[i].used || !fat16_wb_pages[i].dirty ||
+        fat16_wb_pages[i].file != fi)
+      continue;
+    uint32_t j = n++;
+    while (j > 0 &&
+           fat16_wb_pages[order[j - 1]].index > fat16_wb_pages[i].index) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = (uint16_t)i;
+  }
+
+  uint8_t *run = n ? (uint8_t *)kmalloc(FAT16_WB_RUN_MAX * 512) : 0;
+  if (n && !run)
+    return -ENOMEM;
+  uint32_t sectors = (f->size + 511) / 512;
+  uint32_t run_lba = 0, run_n = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[order[k]];
+    for (uint32_t s = p->index * 8; s < p->index * 8 + 8 && s < sectors;
+         s++) {
+      uint32_t lba = fat16_ext_lba(f, s);
+      if (run_n && (lba != run_lba + run_n || run_n == FAT16_WB_RUN_MAX)) {
+        ata_write_sectors_nosync(run_lba, (uint8_t)run_n, run);
+        run_n = 0;
+      }
+      if (!run_n)
+        run_lba = lba;
+      memcpy(run + run_n * 512, p->data + (s % 8) * 512, 512);
+      run_n++;
+    }
+  }
+  if (run_n)
+    ata_write_sectors_nosync(run_lba, (uint8_t)run_n, run);
+  if (run)
+    kfree(run);
+
+  // Data + FAT pehle platter pe, tab dirent unhe point kare
+  ata_flush_cache();
+  uint8_t buf[512];
+  ata_read_sector(f->key >> 4, buf);
+  fat16_entry_t *e = (fat16_entry_t *)buf + (f->key & 15);
+  e->file_size = f->size;
+  e->first_cluster_low = f->first_cluster;
+  ata_write_sector(f->key >> 4, buf);
+
+  // Pages cache mein rehte hain, ab clean - par sirf jo likhe gaye. Gap
+  // bharte waqt (f->size abhi purana) flush_all aa gaya toh size ke aage ke
+  // zero pages dirty hi rehne chahiye, warna evict hoke hole mein kachra.
+  uint32_t written = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[order[k]];
+    if (p->index * 4096 < f->size) {
+      p->dirty = false;
+      written++;
+    }
+  }
+  fat16_wb_dirty -= written;
+  f->pages -= written;
+  if (!f->pages)
+    f->dirty_since = 0;
+  f->disk_size = f->size;
+  return 0;
+}
+
+static int fat16_wb_flush_all() {
+  int err = 0;
+  for (uint32_t i = 0; i < FAT16_WB_FILES; i++) {
+    int ret = fat16_wb_flush_file(&fat16_wb_files[i]);
+    if (ret < 0 && !err)
+      err = ret;
+  }
+  return err;
+}
+
+// Dirent key ki cache entry. create = na ho toh dirent padh ke banao (koi
+// clean entry hata ke; sab dirty hon toh sabse purani likh ke).
+static fat16_wb_file_t *fat16_wb_lookup(uint32_t key, bool create) {
+  if (!key)
+    return 0;
+  fat16_wb_file_t *victim = 0, *oldest = 0;
+  for (uint32_t i = 0; i < FAT16_WB_FILES; i++) {
+    fat16_wb_file_t *f = &fat16_wb_files[i];
+    if (f->used && f->key == key) {
+      f->last_use = ++fat16_wb_clock;
+      return f;
+    }
+    if (!f->used) {
+      if (!victim || victim->used)
+        victim = f;
+    } else {
+      if (!oldest || f->last_use < oldest->last_use)
+        oldest = f;
+      if (!f->pages && f->size == f->disk_size &&
+          (!victim || (victim->used && f->last_use < victim->last_use)))
+        victim = f;
+    }
+  }
+  if (!create)
+    return 0;
+  if (!victim) {
+    if (fat16_wb_flush_file(oldest) < 0)
+      return 0;
+    victim = oldest;
+  }
+  if (victim->used) {
+    fat16_wb_free_pages(victim); // Purani file ke clean pages
+    fat16_ext_free(victim);
+  }
+
+  uint8_t buf[512];
+  ata_read_sector(key >> 4, buf);
+  fat16_entry_t *e = (fat16_entry_t *)buf + (key & 15);
+  memset(victim, 0, sizeof(*victim));
+  victim->used = true;
+  victim->key = key;
+  victim->first_cluster = e->first_cluster_low;
+  victim->size = victim->disk_size = e->file_size;
+  victim->last_use = ++fat16_wb_clock;
+  return victim;
+}
+
+// Entry hata do, dirty data samet (file delete ho rahi hai)
+static void fat16_wb_drop(uint32_t key) {
+  fat16_wb_file_t *f = fat16_wb_lookup(key, false);
+  if (!f)
+    return;
+  fat16_wb_free_pages(f);
+  fat16_ext_free(f);
+  f->used = false;
+}
+
+// Naye page ka slot: khaali, warna sabse purana clean page, warna
+// (may_flush) sab dirty data likh ke. Read-ahead dirty data nahi hatata.
+static fat16_wb_page_t *fat16_wb_slot(bool may_flush) {
+  fat16_wb_page_t *lru = 0;
+  for (uint32_t i = 0; i < FAT16_WB_PAGES; i++) {
+    fat16_wb_page_t *p = &fat16_wb_pages[i];
+    if (!p->used)
+      return p;
+    if (!p->dirty && (!lru || p->last_use < lru->last_use))
+      lru = p;
+  }
+  if (!lru) {
+    if (!may_flush || fat16_wb_flush_all() < 0)
+      return 0;
+    return fat16_wb_slot(false);
+  }
+  kfree(lru->data);
+  lru->used = false;
+  return lru;
+}
+
+// Page `index` ka dirty cache page. Naya page disk ke data se bharta hai,
+// jab tak poora overwrite na hone wala ho (whole).
+static uint8_t *fat16_wb_page(fat16_wb_file_t *f, uint32_t index, bool whole) {
+  uint32_t fi = f - fat16_wb_files;
+  fat16_wb_page_t *p = fat16_wb_find(fi, index);
+  if (p) {
+    if (!p->dirty) {
+      p->dirty = true;
+      f->pages++;
+      fat16_wb_dirty++;
+    }
+    return p->data;
+  }
+
+  p = fat16_wb_slot(true);
+  if (!p)
+    return 0;
+  uint8_t *data = (uint8_t *)kmalloc(4096);
+  if (!data)
+    return 0;
+  memset(data, 0, 4096);
+  uint32_t valid = f->disk_size < f->size ? f->disk_size : f->size;
+  if (!whole && index * 4096 < valid) {
+    uint32_t n = valid - index * 4096;
+    fat16_read_extents(f, index * 4096, n < 4096 ? n : 4096, data);
+  }
+  p->used = true;
+  p->dirty = true;
+  p->file = (uint8_t)fi;
+  p->index = index;
+  p->last_use = ++fat16_wb_clock;
+  p->data = data;
+  f->pages++;
+  fat16_wb_dirty++;
+  return data;
+}
+
+// Disk ke [offset, offset + len) ke jo pages cache mein nahi, unhe clean
+// pages mein lao - lagataar missing pages ek hi chain read mein
+static void fat16_ra_fill(fat16_wb_file_t *f, uint32_t offset, uint32_t len) {
+  uint32_t fi = f - fat16_wb_files;
+  uint32_t valid = f->disk_size < f->size ? f->disk_size : f->size;
+  if (offset >= valid)
+    return;
+  if (len > valid - offset)
+    len = valid - offset;
+  uint32_t idx = offset / 4096, last = (offset + len + 4095) / 4096;
+
+  while (idx < last) {
+    if (fat16_wb_find(fi, idx)) {
+      idx++;
+      continue;
+    }
+    uint32_t end = idx;
+    while (end < last && end - idx < VFS_RA_MAX / 4096 &&
+           !fat16_wb_find(fi, end))
+      end++;
+    uint32_t bytes = (end - idx) * 4096;
+    if (bytes > valid - idx * 4096)
+      bytes = valid - idx * 4096;
+    uint8_t *stage = (uint8_t *)kmalloc((end - idx) * 4096);
+    if (!stage)
+      return;
+    memset(stage, 0, (end - idx) * 4096);
+    fat16_read_extents(f, idx * 4096, bytes, stage);
+
+    for (uint32_t k = idx; k < end; k++) {
+      fat16_wb_page_t *p = fat16_wb_slot(false);
+      uint8_t *data = p ? (uint8_t *)kmalloc(4096) : 0;
+      if (!data) {
+        kfree(stage);
+        return; // Cache dirty data se bhara - read-ahead chhodo
+      }
+      memcpy(data, stage + (k - idx) * 4096, 4096);
+      p->used = true;
+      p->dirty = false;
+      p->file = (uint8_t)fi;
+      p->index = k;
+      p->last_use = ++fat16_wb_clock;
+      p->data = data;
+    }
+    kfree(stage);
+    idx = end;
+  }
+}
+
+static uint32_t fat16_wb_write(fat16_wb_file_t *f, uint32_t offset,
+                               const uint8_t *buffer, uint32_t size) {
+  if (size > 0xFFFFFFFF - offset)
+    size = 0xFFFFFFFF - offset;
+  // File ke aage likha toh beech ka gap zero pages se (disk pe kachra na jaye)
+  for (uint32_t idx = f->size / 4096; idx < offset / 4096; idx++)
+    if (!fat16_wb_page(f, idx, false))
+      return 0;
+
+  uint32_t done = 0;
+  while (done < size) {
+    uint32_t pos = offset + done;
+    uint32_t in_page = pos % 4096;
+    uint32_t n = 4096 - in_page;
+    if (n > size - done)
+      n = size - done;
+    uint8_t *page = fat16_wb_page(f, pos / 4096, n == 4096);
+    if (!page)
+      break;
+    memcpy(page + in_page, buffer + done, n);
+    done += n;
+  }
+  if (done && offset + done > f->size)
+    f->size = offset + done;
+  if (f->pages && !f->dirty_since)
+    f->dirty_since = tick | 1;
+  return done;
+}
+
+// Root ki file dhundo, uska cached data pehle disk pe (raw sector users ke
+// liye: phase A journal, fat16_read_file)
+static bool fat16_find_synced(const char *filename, fat16_entry_t *out,
+                              uint32_t *key) {
+  find_ctx ctx;
+  ctx.name = filename;
+  ctx.found = false;
+  fat16_iterate_dir(0, find_callback, &ctx);
+  if (!ctx.found)
+    return false;
+  uint32_t k = fat16_dirent_key(ctx.sector, ctx.offset);
+  fat16_wb_file_t *f = fat16_wb_lookup(k, false);
+  if (f) {
+    fat16_wb_flush_file(f);
+    ctx.result.file_size = f->size;
+    ctx.result.first_cluster_low = f->first_cluster;
+  }
+  if (out)
+    *out = ctx.result;
+  if (key)
+    *key = k;
+  return true;
+}
+
+int fat16_sync() {
+  fat16_lock();
+  int ret = fat16_wb_flush_all();
+  fat16_unlock();
+  return ret;
+}
+
+// Background writeback: FAT16_WB_EXPIRE_TICKS purana dirty data, ya pool
+// bharne lage toh sab
+void fat16_flush_thread() {
+  while (1) {
+    current_process->sleep_until = tick + FAT16_WB_EXPIRE_TICKS / 4;
+    current_process->state = PROCESS_SLEEPING;
+    schedule();
+
+    fat16_lock();
+    for (uint32_t i = 0; i < FAT16_WB_FILES; i++) {
+      fat16_wb_file_t *f = &fat16_wb_files[i];
+      if (f->used && f->dirty_since &&
+          (fat16_wb_dirty >= FAT16_WB_HIGH ||
+           tick - f->dirty_since >= FAT16_WB_EXPIRE_TICKS))
+        fat16_wb_flush_file(f);
+    }
+    fat16_unlock();
+  }
+}
+
+// Read-ahead requests ek ek karke; reader tab tak pichla data process karta
+// hai. Queue khaali ho toh so jao (cli ke saath check - wakeup chhoote nahi).
+void fat16_readahead_thread() {
+  while (1) {
+    asm volatile("cli");
+    if (fat16_ra_head == fat16_ra_tail) {
+      sleep_on(&fat16_ra_wait);
+      continue;
+    }
+    fat16_ra_req_t req = fat16_ra_queue[fat16_ra_tail % FAT16_RA_QUEUE];
+    fat16_ra_tail = fat16_ra_tail + 1;
+    asm volatile("sti");
+
+    fat16_lock();
+    fat16_wb_file_t *f = fat16_wb_lookup(req.key, true);
+    if (f)
+      fat16_ra_fill(f, req.offset, req.len);
+    fat16_unlock();
+  }
+}
+
 void fat16_get_stats_bytes(uint32_t *total_bytes, uint32_t *free_bytes) {
   uint32_t total_sectors =
       bpb.total_sectors_16 != 0 ? bpb.total_sectors_16 : bpb.total_sectors_32;
@@ -309,9 +1081,11 @@ void fat16_init() {
 
 fat16_entry_t fat16_find_file(const char *filename) {
   fat16_entry_t out;
-  if (fat16_find_entry(0, filename, &out))
-    return out;
-  memset(&out, 0, sizeof(out));
+  fat16_lock();
+  bool found = fat16_find_synced(filename, &out, 0);
+  fat16_unlock();
+  if (!found)
+    memset(&out, 0, sizeof(out));
   return out;
 }
 
@@ -332,52 +1106,153 @@ void fat16_read_file(fat16_entry_t *entry, uint8_t *buffer) {
   }
 }
 
+// Poori file `data` se badal do, turant disk pe (phase A ki images)
 int fat16_write_file(const char *filename, uint8_t *data, uint32_t size) {
-  // Legacy wrapper: Seedha root mein likho
-  fat16_entry_t entry;
-  if (!fat16_find_entry(0, filename, &entry))
+  uint32_t key;
+  fat16_lock();
+  fat16_wb_file_t *f =
+      fat16_find_synced(filename, 0, &key) ? fat16_wb_lookup(key, true) : 0;
+  if (!f) {
+    fat16_unlock();
+    return -1;
+  }
+  fat16_wb_free_pages(f);
+  f->size = 0;
+  uint32_t written = fat16_wb_write(f, 0, data, size);
+  f->size = written;
+  int ret = fat16_wb_flush_file(f);
+  fat16_unlock();
+  return ret < 0 ? ret : (int)written;
+}
+
+// Root file ke data sectors ki LBA list. In-place sector writes (phase A
+// journal) har baar cluster chain nahi chalte. Return = kitne sectors mile.
+// Raw writes cache ke bagal se jaate hain, isliye file ke cached pages (flush
+// ke baad sab clean) yahin hata do - warna VFS read purana data dega.
+int fat16_map_file(const char *filename, uint32_t *lbas, uint32_t max) {
+  uint32_t key;
+  fat16_lock();
+  fat16_wb_file_t *f =
+      fat16_find_synced(filename, 0, &key) ? fat16_wb_lookup(key, true) : 0;
+  if (!f || fat16_ext_ensure(f) < 0) {
+    fat16_unlock();
     return -1;
+  }
+  fat16_wb_free_pages(f);
+
+  // Extents se - chain pe dobara nahi chalna
+  uint32_t need = (f->size + 511) / 512;
+  if (need > max)
+    need = max;
+  uint32_t n = 0;
+  for (; n < need; n++) {
+    uint32_t lba = fat16_ext_lba(f, n);
+    if (!lba)
+      break;
+    lbas[n] = lba;
+  }
+  fat16_unlock();
+  return (int)n;
+}
+
+// File-backed block device: root file ke sectors seedha, bina FAT chain ke.
+// Size file banate waqt hi fix hai (journal jaisi cheezon ke liye).
+typedef struct {
+  uint32_t key; // Dirent key - cached page invalidate karne ke liye
+  uint32_t *lbas;
+} fat16_bdev_t;
+
+static int fat16_bdev_read(block_device_t *dev, uint32_t block,
+                           uint8_t *buffer) {
+  if (block >= dev->total_blocks)
+    return -1;
+  ata_read_sector(((fat16_bdev_t *)dev->private_data)->lbas[block], buffer);
+  return 0;
+}
+
+static int fat16_bdev_write(block_device_t *dev, uint32_t block,
+                            uint8_t *buffer) {
+  if (block >= dev->total_blocks)
+    return -1;
+  fat16_bdev_t *b = (fat16_bdev_t *)dev->private_data;
+  ata_write_sector_nosync(b->lbas[block], buffer);
+  // Beech mein VFS read ne page phir se cache kiya ho toh woh ab purana hai
+  fat16_lock();
+  fat16_wb_file_t *f = fat16_wb_lookup(b->key, false);
+  if (f)
+    fat16_wb_invalidate(f, block / 8);
+  fat16_unlock();
+  return 0;
+}
 
-  // Create a temporary VFS node to reuse write_vfs logic
-  vfs_node_t temp_node;
-  memset(&temp_node, 0, sizeof(vfs_node_t));
-  strcpy(temp_node.name, filename);
-  temp_node.impl = (void *)(uintptr_t)entry.first_cluster_low;
-  temp_node.size = entry.file_size;
-
-  // Reuse the logic in write_vfs
-  uint32_t written = fat16_write_vfs(&temp_node, 0, size, data);
-
-  // Update directory entry size if changed
-  if (written > 0) {
-    // Key parameters phir se dhundo directory entry update karne ke liye
-    // ... Legacy root write ke liye ye aasaan hai:
-    find_ctx ctx;
-    ctx.name = filename;
-    ctx.found = false;
-    fat16_iterate_dir(0, find_callback, &ctx);
-    if (ctx.found) {
-      uint8_t buffer[512];
-      ata_read_sector(ctx.sector, buffer);
-      fat16_entry_t *e = (fat16_entry_t *)(buffer + ctx.offset);
-      e->file_size = size; // Update size
-      e->first_cluster_low =
-          (uint16_t)(uintptr_t)
-              temp_node.impl; // Update start cluster (if allocated)
-      ata_write_sector(ctx.sector, buffer);
+static int fat16_bdev_flush(block_device_t *dev) {
+  (void)dev;
+  ata_flush_cache();
+  return 0;
+}
+
+block_device_t *fat16_file_bdev(const char *filename, const char *devname) {
+  fat16_entry_t entry;
+  uint32_t key;
+  fat16_lock();
+  bool found = fat16_find_synced(filename, &entry, &key);
+  fat16_unlock();
+  if (!found)
+    return 0;
+  uint32_t count = (entry.file_size + 511) / 512;
+  uint32_t *lbas = count ? (uint32_t *)kmalloc(count * sizeof(uint32_t)) : 0;
+  if (!lbas)
+    return 0;
+  fat16_bdev_t *b = (fat16_bdev_t *)kmalloc(sizeof(fat16_bdev_t));
+  if (!b || fat16_map_file(filename, lbas, count) != (int)count) {
+    if (b)
+      kfree(b);
+    kfree(lbas);
+    return 0;
+  }
+  b->key = key;
+  b->lbas = lbas;
+
+  // File dobara bani (naye clusters) toh wahi device naye map ke saath
+  block_device_t *dev = get_block_device(devname);
+  if (dev) {
+    fat16_bdev_t *old = (fat16_bdev_t *)dev->private_data;
+    kfree(old->lbas);
+    kfree(old);
+  } else {
+    dev = (block_device_t *)kmalloc(sizeof(block_device_t));
+    if (!dev) {
+      kfree(lbas);
+      kfree(b);
+      return 0;
     }
+    memset(dev, 0, sizeof(block_device_t));
+    strncpy(dev->name, devname, 31);
+    dev->read_block = fat16_bdev_read;
+    dev->write_block = fat16_bdev_write;
+    dev->flush = fat16_bdev_flush;
+    register_block_device(dev);
   }
-  return written;
+  dev->block_size = 512;
+  dev->total_blocks = count;
+  dev->private_data = b;
+  return dev;
 }
 
 int fat16_create_file(const char *filename) {
-  return fat16_add_entry(0, filename, ATTR_ARCHIVE, 0);
+  fat16_lock();
+  int ret = fat16_add_entry(0, filename, ATTR_ARCHIVE, 0);
+  fat16_unlock();
+  return ret;
 }
 
 int fat16_mkdir(const char *name) {
+  fat16_lock();
   uint16_t cluster = fat16_alloc_cluster();
-  if (cluster == 0)
+  if (cluster == 0) {
+    fat16_unlock();
     return -1;
+  }
 
   // Clear cluster
   uint8_t buffer[512];
@@ -387,7 +1262,9 @@ int fat16_mkdir(const char *name) {
     ata_write_sector(sector + i, buffer);
 
   // Add entry to ROOT
-  return fat16_add_entry(0, name, ATTR_DIRECTORY, cluster);
+  int ret = fat16_add_entry(0, name, ATTR_DIRECTORY, cluster);
+  fat16_unlock();
+  return ret;
 }
 
 int fat16_delete_file(const char *name) {
@@ -396,9 +1273,13 @@ int fat16_delete_file(const char *name) {
   ctx.found = false;
 
   // Only supports root delete for legacy API
+  fat16_lock();
   fat16_iterate_dir(0, find_callback, &ctx);
 
   if (ctx.found) {
+    // Cache ka dirty data bhi gaya - uske clusters abhi bane hi nahi
+    fat16_wb_drop(fat16_dirent_key(ctx.sector, ctx.offset));
+
     // Free Chain
     uint16_t cluster = ctx.result.first_cluster_low;
     while (cluster >= 2 && cluster < 0xFFF0) {
@@ -412,8 +1293,10 @@ int fat16_delete_file(const char *name) {
     ata_read_sector(ctx.sector, buffer);
     buffer[ctx.offset] = 0xE5;
     ata_write_sector(ctx.sector, buffer);
+    fat16_unlock();
     return 0;
   }
+  fat16_unlock();
   return -1;
 }
 
@@ -429,84 +1312,98 @@ static int fat16_rename_vfs(vfs_node_t *node, const char *old_name,
                             const char *new_name);
 static int fat16_create_vfs(vfs_node_t *node, const char *name, int permission);
 
+// Cache mein, node ke offset pe. Disk pe writeback/fsync karta hai.
 static uint32_t fat16_write_vfs(vfs_node_t *node, uint32_t offset,
                                 uint32_t size, uint8_t *buffer) {
-  // Update file size logic simplified
-  fat16_entry_t entry;
-  if (!fat16_find_entry(0, node->name, &entry)) {
-    // node->impl should suffice for writing content
+  if (node->flags == VFS_DIRECTORY)
+    return 0;
+  fat16_lock();
+  fat16_wb_file_t *f = fat16_wb_lookup((uint32_t)node->inode, true);
+  if (!f) {
+    fat16_unlock();
+    return 0;
   }
+  uint32_t written = fat16_wb_write(f, offset, buffer, size);
+  node->size = f->size;
+  // Bahut dirty data - writer khud likhe (flusher ka intezaar nahi)
+  if (fat16_wb_dirty >= FAT16_WB_HIGH)
+    fat16_wb_flush_file(f);
+  fat16_unlock();
+  return written;
+}
 
-  uint16_t cluster = (uint16_t)(uintptr_t)node->impl;
-  if (cluster == 0) {
-    // Need to allocate first cluster!
-    cluster = fat16_alloc_cluster();
-    if (cluster == 0)
-      return 0;
-    node->impl = (void *)(uintptr_t)cluster;
-
-    // TODO: Directory entry update logic is missing parent context in VFS phase
-    // 1
+static void fat16_readahead_vfs(vfs_node_t *node, uint32_t offset,
+                                uint32_t len) {
+  if (!node->inode || node->flags == VFS_DIRECTORY)
+    return;
+  uint32_t eflags = irq_save();
+  if (fat16_ra_head - fat16_ra_tail < FAT16_RA_QUEUE) {
+    fat16_ra_req_t *r = &fat16_ra_queue[fat16_ra_head % FAT16_RA_QUEUE];
+    r->key = (uint32_t)node->inode;
+    r->offset = offset;
+    r->len = len;
+    fat16_ra_head = fat16_ra_head + 1;
   }
+  irq_restore(eflags);
+  wake_up(&fat16_ra_wait);
+}
 
-  uint32_t bytes_written = 0;
-  // Naive loop
-  while (cluster >= 2 && bytes_written < size) {
-    uint32_t sector = fat16_cluster_to_sector(cluster);
-    for (int i = 0; i < bpb.sectors_per_cluster && bytes_written < size; i++) {
-      uint8_t sec_buf[512];
-      uint32_t chunk =
-          (size - bytes_written) > 512 ? 512 : (size - bytes_written);
-
-      if (chunk < 512)
-        ata_read_sector(sector + i, sec_buf);
-
-      memcpy(sec_buf, buffer + bytes_written, chunk);
-      ata_write_sector(sector + i, sec_buf);
-      bytes_written += chunk;
-      if (bytes_written % (64 * 1024) == 0) {
-        serial_log("FAT16: Write Progress...");
-      }
-    }
-
-    if (bytes_written < size) {
-      uint16_t next = fat16_get_fat_entry(cluster);
-      if (next >= 0xFFF0 || next == 0) {
-        uint16_t new_c = fat16_alloc_cluster();
-        if (!new_c)
-          break;
-        fat16_set_fat_entry(cluster, new_c);
-        cluster = new_c;
-      } else {
-        cluster = next;
-      }
-    }
-  }
-  return bytes_written;
+static int fat16_fsync_vfs(vfs_node_t *node) {
+  fat16_lock();
+  fat16_wb_file_t *f = fat16_wb_lookup((uint32_t)node->inode, false);
+  int ret = f ? fat16_wb_flush_file(f) : 0;
+  fat16_unlock();
+  return ret;
 }
 
+// Sirf [offset, offset + size) wale sectors padho. Pehle har read poori file
+// temp buffer mein leta tha - page fault ko 4 KB chahiye tab bhi.
+// Jo pages cache mein hain (dirty ya read-ahead) woh disk se nahi aate.
 static uint32_t fat16_read_vfs(vfs_node_t *node, uint32_t offset, uint32_t size,
                                uint8_t *buffer) {
-  fat16_entry_t entry;
-  entry.first_cluster_low = (uint16_t)(uintptr_t)node->impl;
-  entry.file_size = node->size;
-
-  // Full read temp buffer strategy
-  uint8_t *tmp = (uint8_t *)kmalloc((entry.file_size + 511) & ~511);
-  if (!tmp)
-    return 0;
-
-  fat16_read_file(&entry, tmp);
-
-  if (offset > entry.file_size) {
-    kfree(tmp);
+  fat16_lock();
+  fat16_wb_file_t *f = fat16_wb_lookup((uint32_t)node->inode, true);
+  uint16_t cluster = (uint16_t)(uintptr_t)node->impl;
+  uint32_t file_size = node->size, disk_size = node->size;
+  if (f) {
+    cluster = f->first_cluster;
+    file_size = f->size;
+    disk_size = f->disk_size < f->size ? f->disk_size : f->size;
+    node->size = file_size;
+    node->impl = (void *)(uintptr_t)cluster;
+  }
+  if (offset >= file_size) {
+    fat16_unlock();
     return 0;
   }
-  if (offset + size > entry.file_size)
-    size = entry.file_size - offset;
-
-  memcpy(buffer, tmp + offset, size);
-  kfree(tmp);
+  if (size > file_size - offset)
+    size = file_size - offset;
+
+  // Cache ke pages seedha; baaki lagataar runs disk se (disk_size tak)
+  uint32_t fi = f ? (uint32_t)(f - fat16_wb_files) : 0;
+  uint32_t pos = offset, end = offset + size;
+  while (pos < end) {
+    uint32_t page_end = (pos / 4096 + 1) * 4096;
+    uint32_t n = (page_end < end ? page_end : end) - pos;
+    fat16_wb_page_t *p = f ? fat16_wb_find(fi, pos / 4096) : 0;
+    if (p) {
+      memcpy(buffer + (pos - offset), p->data + pos % 4096, n);
+      pos += n;
+      continue;
+    }
+    uint32_t run = pos + n;
+    while (run < end && !(f && fat16_wb_find(fi, run / 4096)))
+      run = (run / 4096 + 1) * 4096 < end ? (run / 4096 + 1) * 4096 : end;
+    uint32_t got = 0;
+    if (pos < disk_size) {
+      uint32_t want = (run < disk_size ? run : disk_size) - pos;
+      got = f ? fat16_read_extents(f, pos, want, buffer + (pos - offset))
+              : fat16_read_chain(cluster, pos, want, buffer + (pos - offset));
+    }
+    memset(buffer + (pos - offset) + got, 0, run - pos - got);
+    pos = run;
+  }
+  fat16_unlock();
   return size;
 }
 
@@ -517,11 +1414,25 @@ static vfs_node_t *fat16_finddir_vfs(vfs_node_t *node, const char *name) {
     return devfs_node;
   }
 
-  fat16_entry_t entry;
-  if (fat16_find_entry((uint16_t)(uintptr_t)node->impl, name, &entry)) {
+  find_ctx ctx;
+  ctx.name = name;
+  ctx.found = false;
+  fat16_lock();
+  fat16_iterate_dir((uint16_t)(uintptr_t)node->impl, find_callback, &ctx);
+  if (ctx.found) {
+    fat16_entry_t entry = ctx.result;
+    uint32_t key = fat16_dirent_key(ctx.sector, ctx.offset);
+    fat16_wb_file_t *f = fat16_wb_lookup(key, false);
+    if (f) {
+      entry.file_size = f->size;
+      entry.first_cluster_low = f->first_cluster;
+    }
+    fat16_unlock();
+
     vfs_node_t *res = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
     memset(res, 0, sizeof(vfs_node_t));
     strcpy(res->name, name);
+    res->inode = key;
     res->size = entry.file_size;
     res->impl = (void *)(uintptr_t)entry.first_cluster_low;
     res->read = fat16_read_vfs;
@@ -532,6 +1443,8 @@ static vfs_node_t *fat16_finddir_vfs(vfs_node_t *node, const char *name) {
     res->unlink = fat16_unlink_vfs;
     res->rename = fat16_rename_vfs;
     res->create = fat16_create_vfs;
+    res->fsync = fat16_fsync_vfs;
+    res->readahead = fat16_readahead_vfs;
 
     if (entry.attributes & ATTR_DIRECTORY) {
       res->flags = VFS_DIRECTORY;
@@ -540,6 +1453,7 @@ static vfs_node_t *fat16_finddir_vfs(vfs_node_t *node, const char *name) {
     }
     return res;
   }
+  fat16_unlock();
   return 0;
 }
 
@@ -578,10 +1492,13 @@ static struct dirent *fat16_readdir_vfs(vfs_node_t *node, uint32_t index) {
   ctx.current_index = 0;
   ctx.found_entry = 0;
 
+  fat16_lock();
   fat16_iterate_dir((uint16_t)(uintptr_t)node->impl, readdir_callback, &ctx);
+  if (ctx.found_entry)
+    entry_copy = *ctx.found_entry;
+  fat16_unlock();
 
   if (ctx.found_entry) {
-    entry_copy = *ctx.found_entry;
     memset(&d, 0, sizeof(struct dirent));
     fat16_to_name(d.d_name, entry_copy.filename, entry_copy.ext);
     d.d_ino = entry_copy.first_cluster_low;
@@ -597,9 +1514,12 @@ static struct dirent *fat16_readdir_vfs(vfs_node_t *node, uint32_t index) {
 }
 
 static int fat16_mkdir_vfs(vfs_node_t *node, const char *name, uint32_t mask) {
+  fat16_lock();
   uint16_t cluster = fat16_alloc_cluster();
-  if (cluster == 0)
+  if (cluster == 0) {
+    fat16_unlock();
     return -1;
+  }
 
   uint8_t buffer[512];
   memset(buffer, 0, 512);
@@ -607,8 +1527,10 @@ static int fat16_mkdir_vfs(vfs_node_t *node, const char *name, uint32_t mask) {
   for (int i = 0; i < bpb.sectors_per_cluster; i++)
     ata_write_sector(sector + i, buffer);
 
-  return fat16_add_entry((uint16_t)(uintptr_t)node->impl, name, ATTR_DIRECTORY,
-                         cluster);
+  int ret = fat16_add_entry((uint16_t)(uintptr_t)node->impl, name,
+                            ATTR_DIRECTORY, cluster);
+  fat16_unlock();
+  return ret;
 }
 
 static int fat16_unlink_vfs(vfs_node_t *node, const char *name) {
@@ -622,10 +1544,13 @@ static int fat16_rename_vfs(vfs_node_t *node, const char *old_name,
   find_ctx ctx;
   ctx.name = old_name;
   ctx.found = false;
+  fat16_lock();
   fat16_iterate_dir((uint16_t)(uintptr_t)node->impl, find_callback, &ctx);
 
-  if (!ctx.found)
+  if (!ctx.found) {
+    fat16_unlock();
     return -1;
+  }
 
   // New name parse
   char filename[9];
@@ -666,14 +1591,18 @@ static int fat16_rename_vfs(vfs_node_t *node, const char *old_name,
   memcpy(entry->filename, filename, 8);
   memcpy(entry->ext, ext, 3);
   ata_write_sector(ctx.sector, buffer);
+  fat16_unlock();
 
   return 0;
 }
 
 static int fat16_create_vfs(vfs_node_t *node, const char *name,
                             int permission) {
-  return fat16_add_entry((uint16_t)(uintptr_t)node->impl, name, ATTR_ARCHIVE,
-                         0);
+  fat16_lock();
+  int ret = fat16_add_entry((uint16_t)(uintptr_t)node->impl, name,
+                            ATTR_ARCHIVE, 0);
+  fat16_unlock();
+  return ret;
 }
 
 vfs_node_t *fat16_vfs_init() {
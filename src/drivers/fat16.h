@@ -67,9 +67,17 @@ void fat16_read_file(fat16_entry_t *entry, uint8_t *buffer);
 int fat16_create_file(const char *filename);
 int fat16_write_file(const char *filename, uint8_t *data, uint32_t size);
 int fat16_delete_file(const char *filename);
+int fat16_map_file(const char *filename, uint32_t *lbas, uint32_t max);
+struct block_device *fat16_file_bdev(const char *filename,
+                                     const char *devname);
 int fat16_mkdir(const char *name);
 void fat16_get_stats_bytes(uint32_t *total, uint32_t *free);
 
+// Write-back cache: sab dirty files disk pe / background flusher thread
+int fat16_sync();
+void fat16_flush_thread();
+void fat16_readahead_thread(); // Sequential readers ke aage ke pages
+
 vfs_node_t *fat16_vfs_init();
 vfs_node_t *devfs_init();
 
@@ -5,6 +5,8 @@
 
 #include "graphics.h"
 #include "../include/string.h"
+#include "bga.h"
+#include "raster.h"
 #include "serial.h"
 
 // Screen dimensions
@@ -18,6 +20,8 @@ uint32_t *back_buffer = nullptr;   // Off-screen render target
 // Forward declare heap function
 extern "C" void *malloc(uint32_t size);
 
+static void graphics_enable_page_flip();
+
 extern "C" void init_graphics(uint32_t lfb_address) {
   screen_buffer = (uint32_t *)(uintptr_t)lfb_address;
 
@@ -29,33 +33,141 @@ extern "C" void init_graphics(uint32_t lfb_address) {
     return;
   }
 
+  raster_init();
+
   // Clear to black
-  for (int i = 0; i < SCREEN_W * SCREEN_H; i++) {
-    back_buffer[i] = 0xFF000000;
-  }
+  span_fill(back_buffer, 0xFF000000, SCREEN_W * SCREEN_H);
 
   serial_log_hex("GRAPHICS: Backbuffer Addr: ",
                  (uint32_t)(uintptr_t)back_buffer);
+
+  graphics_enable_page_flip();
 }
 
-extern "C" void swap_buffers() {
+/* ================= PRESENT / PAGE FLIPPING =================
+   VRAM mein 2 pages (BGA virtual height = 2 * 768). Scanout ek page
+   dikhata hai, hum doosre (hidden) mein likh ke Y offset flip karte hain.
+   Hidden page pichle frame ke damage jitna purana hota hai, isliye woh
+   rects bhi dobara copy karne padte hain (buffer age = 1). */
+#define FB_MAX_PAGES 2
+#define FB_PREV_MAX 32
+
+static int fb_pages = 1; // 1 = flipping nahi, front buffer pe seedha copy
+static int fb_front = 0; // Abhi scanout wala page
+static fb_rect_t fb_prev[FB_PREV_MAX];
+static int fb_prev_count = 0;
+static bool fb_prev_full = true;
+
+static inline uint32_t *fb_page(int page) {
+  return screen_buffer + page * SCREEN_W * SCREEN_H;
+}
+
+// Screen se clip karo; false = kuch visible nahi
+static inline bool clip_to_screen(int &x, int &y, int &w, int &h) {
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > SCREEN_W)
+    w = SCREEN_W - x;
+  if (y + h > SCREEN_H)
+    h = SCREEN_H - y;
+  return w > 0 && h > 0;
+}
+
+// back_buffer se dst page mein ek rect (row-wise memcpy)
+static void fb_copy_rect(uint32_t *dst, int x, int y, int w, int h) {
+  if (!clip_to_screen(x, y, w, h))
+    return;
+
+  uint32_t off = y * SCREEN_W + x;
+  raster_blit(dst + off, SCREEN_W, back_buffer + off, SCREEN_W, w, h);
+}
+
+static void graphics_enable_page_flip() {
+  uint16_t need = SCREEN_H * FB_MAX_PAGES;
+
+  // Bochs yeh register maanta hai; QEMU khud VRAM size se nikalta hai.
+  // Dono case mein read-back se pata chalega ki jagah hai ya nahi.
+  bga_write_register(VBE_DISPI_INDEX_VIRT_HEIGHT, need);
+  if (bga_read_register(VBE_DISPI_INDEX_VIRT_HEIGHT) < need) {
+    serial_log("GRAPHICS: VRAM too small for page flipping, using copy");
+    return;
+  }
+  bga_write_register(VBE_DISPI_INDEX_Y_OFFSET, SCREEN_H);
+  if (bga_read_register(VBE_DISPI_INDEX_Y_OFFSET) != SCREEN_H) {
+    serial_log("GRAPHICS: BGA Y offset not supported, using copy");
+    return;
+  }
+  bga_write_register(VBE_DISPI_INDEX_Y_OFFSET, 0);
+
+  fb_pages = FB_MAX_PAGES;
+  fb_front = 0;
+  fb_prev_full = true; // Page 1 mein abhi kachra hai
+  serial_log_hex("GRAPHICS: Page flipping enabled, pages: ", fb_pages);
+}
+
+extern "C" int graphics_page_count() { return fb_pages; }
+
+extern "C" void graphics_present(const fb_rect_t *rects, int count) {
   if (!screen_buffer || !back_buffer)
     return;
 
-  // Fast memcpy from back to front
-  uint32_t *src = back_buffer;
-  uint32_t *dst = screen_buffer;
-  for (int i = 0; i < SCREEN_W * SCREEN_H; i++) {
-    dst[i] = src[i];
+  if (fb_pages == 1) {
+    for (int i = 0; i < count; i++)
+      fb_copy_rect(screen_buffer, rects[i].x, rects[i].y, rects[i].w,
+                   rects[i].h);
+    return;
+  }
+
+  int back = fb_front ^ 1;
+  uint32_t *dst = fb_page(back);
+
+  // Hidden page ko pehle pichle frame tak laao, phir is frame ka damage
+  if (fb_prev_full) {
+    fb_copy_rect(dst, 0, 0, SCREEN_W, SCREEN_H);
+  } else {
+    for (int i = 0; i < fb_prev_count; i++)
+      fb_copy_rect(dst, fb_prev[i].x, fb_prev[i].y, fb_prev[i].w,
+                   fb_prev[i].h);
+    for (int i = 0; i < count; i++)
+      fb_copy_rect(dst, rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+  }
+
+  // Flip: sirf ek register write, scanout agle refresh se naya page padhta hai
+  bga_write_register(VBE_DISPI_INDEX_Y_OFFSET, back * SCREEN_H);
+  fb_front = back;
+
+  // Ab doosra page in rects jitna peeche hai
+  if (count > FB_PREV_MAX) {
+    fb_prev_full = true;
+  } else {
+    fb_prev_full = false;
+    fb_prev_count = count;
+    for (int i = 0; i < count; i++)
+      fb_prev[i] = rects[i];
   }
 }
 
+extern "C" void swap_buffers() {
+  fb_rect_t full = {0, 0, SCREEN_W, SCREEN_H};
+  graphics_present(&full, 1);
+}
+
+// Sirf ek rectangle dikhao (damage-tracked compositor ke liye)
+extern "C" void swap_buffers_rect(int x, int y, int w, int h) {
+  fb_rect_t r = {x, y, w, h};
+  graphics_present(&r, 1);
+}
+
 extern "C" void gfx_clear_screen(uint32_t color) {
   if (!back_buffer)
     return;
-  for (int i = 0; i < SCREEN_W * SCREEN_H; i++) {
-    back_buffer[i] = color;
-  }
+  span_fill(back_buffer, color, SCREEN_W * SCREEN_H);
 }
 
 extern "C" void put_pixel(int x, int y, uint32_t color) {
@@ -67,14 +179,33 @@ extern "C" void put_pixel(int x, int y, uint32_t color) {
 }
 
 extern "C" void draw_rect(int x, int y, int w, int h, uint32_t color) {
-  for (int py = 0; py < h; py++) {
-    for (int px = 0; px < w; px++) {
-      put_pixel(x + px, y + py, color);
-    }
-  }
+  if (!back_buffer || !clip_to_screen(x, y, w, h))
+    return;
+  raster_fill_rect(back_buffer, SCREEN_W, x, y, w, h, color);
+}
+
+// Tightly packed w x h ARGB image - clip ek baar, phir row-wise copy
+extern "C" void draw_bitmap(int x, int y, int w, int h, const uint32_t *data) {
+  int pitch = w, cx = x, cy = y;
+  if (!back_buffer || !data || !clip_to_screen(cx, cy, w, h))
+    return;
+  data += (cy - y) * pitch + (cx - x);
+  raster_blit(back_buffer + cy * SCREEN_W + cx, SCREEN_W, data, pitch, w, h);
 }
 
 extern "C" void draw_line(int x1, int y1, int x2, int y2, uint32_t color) {
+  // Seedhi lines ek span hain
+  if (y1 == y2) {
+    int x = x1 < x2 ? x1 : x2;
+    draw_rect(x, y1, (x1 < x2 ? x2 - x1 : x1 - x2) + 1, 1, color);
+    return;
+  }
+  if (x1 == x2) {
+    int y = y1 < y2 ? y1 : y2;
+    draw_rect(x1, y, 1, (y1 < y2 ? y2 - y1 : y1 - y2) + 1, color);
+    return;
+  }
+
   int dx = (x2 > x1) ? (x2 - x1) : (x1 - x2);
   int dy = (y2 > y1) ? (y2 - y1) : (y1 - y2);
   int sx = (x1 < x2) ? 1 : -1;
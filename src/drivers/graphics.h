@@ -45,8 +45,17 @@ void draw_string_scaled(int x, int y, const char *str, uint32_t color,
 void draw_rect_gradient(int x, int y, int w, int h, uint32_t c1, uint32_t c2);
 
 // Double Buffering
+typedef struct fb_rect {
+  int x, y, w, h;
+} fb_rect_t;
+
 void init_graphics(uint32_t lfb_address); // Allocates backbuffer
 void swap_buffers();
+void swap_buffers_rect(int x, int y, int w, int h); // Partial present
+// Frame ke saare damaged rects ek saath dikhao. BGA page flipping on ho toh
+// hidden page mein copy karke Y offset badalta hai (tear-free).
+void graphics_present(const fb_rect_t *rects, int count);
+int graphics_page_count(); // 1 = flipping nahi, seedha LFB copy
 
 // Primitives
 void draw_circle(int x, int y, int radius, uint32_t color);
@@ -0,0 +1,210 @@
+/*
+ * input.cpp - Lock-free keyboard/mouse event queues
+ * Pehle keyboard ka ek hi g_last_key slot tha (tez typing pe keys ud jaati
+ * thin) aur mouse sirf x/y/btn globals - frame ke beech ka click kho jaata
+ * tha. Ab har event timestamp ke saath ring mein jaata hai.
+ *
+ * Producer: keyboard aur mouse IRQ handlers. Dono interrupt gates se chalte
+ * hain (IF = 0) aur CPU ek hai, isliye kabhi ek saath nahi chalte - ring ke
+ * liye effectively ek hi producer hai. Consumer thread context mein hai aur
+ * IRQ use beech mein rok sakta hai, par consumer sirf tail likhta hai.
+ */
+
+#include "input.h"
+#include "../include/poll.h"
+#include "../include/string.h"
+#include "../kernel/heap.h"
+#include "../kernel/memory.h"
+#include "../kernel/process.h"
+#include "../kernel/wait_queue.h"
+#include "serial.h"
+
+#define INPUT_QUEUE_SIZE 256 // 2 ki power honi chahiye
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_SIZE - 1)
+#define INPUT_MS_PER_TICK 20 // 50 Hz timer
+
+extern "C" uint32_t tick;
+
+typedef struct input_queue {
+  input_event_t ev[INPUT_QUEUE_SIZE];
+  volatile uint32_t head; // Sirf producer badalta hai
+  volatile uint32_t tail; // Sirf consumer badalta hai
+  volatile int ready;     // Non-empty - schedule_timeout ka cond
+  uint32_t dropped;       // Queue bhari thi - consumer so gaya?
+  wait_queue_t wait;      // Sirf callback entries (IRQ se kfree nahi hota)
+} input_queue_t;
+
+static input_queue_t gui_queue;
+static input_queue_t dev_queue;
+
+static struct process *gui_waiter = nullptr;
+
+static int mouse_last_x = -1, mouse_last_y = -1, mouse_last_btn = 0;
+
+/* ================= RING ================= */
+static void queue_push(input_queue_t *q, const input_event_t *ev) {
+  uint32_t head = q->head;
+  uint32_t used = head - q->tail;
+
+  // Motion coalescing: pichla event bhi motion hai aur consumer use abhi
+  // nahi padh raha (woh sirf tail wala slot padhta hai) - wahin update karo
+  if (ev->type == INPUT_EV_MOTION && used >= 2) {
+    input_event_t *last = &q->ev[(head - 1) & INPUT_QUEUE_MASK];
+    if (last->type == INPUT_EV_MOTION) {
+      *last = *ev;
+      return;
+    }
+  }
+
+  if (used == INPUT_QUEUE_SIZE) {
+    if (q->dropped++ == 0)
+      serial_log("INPUT: queue full, dropping events");
+    return;
+  }
+
+  q->ev[head & INPUT_QUEUE_MASK] = *ev;
+  asm volatile("" ::: "memory"); // Pehle slot, phir head
+  q->head = head + 1;
+  q->ready = 1;
+  wake_up(&q->wait);
+}
+
+static int queue_pop(input_queue_t *q, input_event_t *ev) {
+  uint32_t tail = q->tail;
+  if (tail == q->head) {
+    // Khaali: flag girao, phir dobara dekho (beech mein IRQ aaya ho toh)
+    q->ready = 0;
+    if (q->head != tail)
+      q->ready = 1;
+    return 0;
+  }
+  asm volatile("" ::: "memory"); // head dekhne ke baad hi slot padho
+  *ev = q->ev[tail & INPUT_QUEUE_MASK];
+  asm volatile("" ::: "memory");
+  q->tail = tail + 1;
+  return 1;
+}
+
+static void input_post(const input_event_t *ev) {
+  queue_push(&gui_queue, ev);
+  if (gui_waiter)
+    wake_up_process(gui_waiter);
+  queue_push(&dev_queue, ev);
+}
+
+/* ================= PRODUCERS ================= */
+extern "C" void input_report_key(int key, int pressed) {
+  input_event_t ev;
+  ev.time_ms = tick * INPUT_MS_PER_TICK;
+  ev.type = INPUT_EV_KEY;
+  ev.code = (uint16_t)key;
+  ev.value = pressed;
+  ev.x = mouse_last_x;
+  ev.y = mouse_last_y;
+  ev.buttons = mouse_last_btn;
+  input_post(&ev);
+}
+
+extern "C" void input_report_mouse(int x, int y, int buttons) {
+  input_event_t ev;
+  ev.time_ms = tick * INPUT_MS_PER_TICK;
+  ev.x = x;
+  ev.y = y;
+  ev.buttons = buttons;
+
+  // Ek packet mein move + button dono: pehle move, taaki click sahi jagah ho
+  if (x != mouse_last_x || y != mouse_last_y) {
+    ev.type = INPUT_EV_MOTION;
+    ev.code = 0;
+    ev.value = 0;
+    ev.buttons = mouse_last_btn;
+    input_post(&ev);
+  }
+  if (buttons != mouse_last_btn) {
+    ev.type = INPUT_EV_BUTTON;
+    ev.code = (uint16_t)(buttons ^ mouse_last_btn);
+    ev.value = buttons;
+    ev.buttons = buttons;
+    input_post(&ev);
+  }
+
+  mouse_last_x = x;
+  mouse_last_y = y;
+  mouse_last_btn = buttons;
+}
+
+/* ================= COMPOSITOR ================= */
+extern "C" int input_read_event(input_event_t *ev) {
+  return queue_pop(&gui_queue, ev);
+}
+
+extern "C" void input_set_waiter(struct process *proc) { gui_waiter = proc; }
+
+extern "C" volatile int *input_ready_flag() { return &gui_queue.ready; }
+
+/* ================= /dev/input ================= */
+static void input_wake_reader(wait_queue_entry_t *entry) {
+  wake_up_process((struct process *)entry->priv);
+}
+
+// Sirf poore records. Kuch na ho toh pehle event tak block.
+static uint32_t input_dev_read(vfs_node_t *node, uint32_t offset,
+                               uint32_t size, uint8_t *buffer) {
+  (void)node;
+  (void)offset;
+  uint32_t max = size / sizeof(input_event_t);
+  if (max == 0)
+    return 0;
+
+  // epoll_wait jaisa: callback entry + schedule_timeout. sleep_on wali
+  // entry IRQ ke wake_up mein kfree hoti - producer IRQ hai, woh nahi chalega.
+  if (dev_queue.head == dev_queue.tail) {
+    wait_queue_entry_t self;
+    self.proc = 0;
+    self.func = input_wake_reader;
+    self.priv = current_process;
+    add_wait_queue(&dev_queue.wait, &self);
+    for (;;) {
+      dev_queue.ready = 0; // Purana flag (open ne tail khiskaya ho) mat maano
+      if (dev_queue.head != dev_queue.tail)
+        break;
+      schedule_timeout(0, &dev_queue.ready);
+    }
+    remove_wait_queue(&dev_queue.wait, &self);
+  }
+
+  uint32_t n = 0;
+  input_event_t *out = (input_event_t *)buffer;
+  while (n < max && queue_pop(&dev_queue, &out[n]))
+    n++;
+  return n * sizeof(input_event_t);
+}
+
+static int input_dev_poll(vfs_node_t *node, poll_table_t *pt) {
+  (void)node;
+  poll_wait(&dev_queue.wait, pt);
+  return dev_queue.head != dev_queue.tail ? POLLIN | POLLRDNORM : 0;
+}
+
+// Naya reader purane (boot se jama) events nahi chahta. tail consumer ka
+// hai, isliye yahan se chhedna safe hai.
+static void input_dev_open(vfs_node_t *node) {
+  (void)node;
+  dev_queue.tail = dev_queue.head;
+}
+
+static vfs_node_t *input_node = 0;
+
+extern "C" vfs_node_t *input_dev_node() {
+  if (input_node)
+    return input_node;
+  input_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  memset(input_node, 0, sizeof(vfs_node_t));
+  strcpy(input_node->name, "input");
+  input_node->flags = VFS_DEVICE;
+  input_node->read = input_dev_read;
+  input_node->poll = input_dev_poll;
+  input_node->open = input_dev_open;
+  input_node->ref_count = 0xFFFFFFFF;
+  return input_node;
+}
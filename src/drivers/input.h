@@ -0,0 +1,34 @@
+// input.h - Keyboard/mouse event queues
+// IRQ handlers events daalte hain, compositor aur /dev/input nikaalte hain.
+// Har consumer ki apni single-producer/single-consumer ring hai: producer
+// sirf head likhta hai, consumer sirf tail - koi lock nahi.
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "../include/input_event.h"
+#include "../include/vfs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Producers (IRQ context)
+void input_report_key(int key, int pressed);
+void input_report_mouse(int x, int y, int buttons);
+
+// Compositor ka queue: non-blocking, 1 = event mila
+int input_read_event(input_event_t *ev);
+
+// Compositor so raha ho toh event aate hi jaga do. Flag schedule_timeout ka
+// cond hai: queue mein kuch ho toh non-zero.
+void input_set_waiter(struct process *proc);
+volatile int *input_ready_flag();
+
+// /dev/input node (devfs isse register karta hai)
+vfs_node_t *input_dev_node();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // INPUT_H
@@ -4,6 +4,7 @@
 #include "../include/types.h"
 #include "../kernel/process.h"
 #include "../kernel/tty.h"
+#include "input.h"
 #include "serial.h"
 
 // US Keyboard Layout (Normal)
@@ -31,8 +32,6 @@ static int ctrl_pressed = 0;
 static int alt_pressed = 0;
 static int caps_lock = 0;
 
-extern "C" void keyboard_set_last_key(int k);
-
 static void keyboard_callback(registers_t *regs) {
   uint8_t scancode = inb(0x60);
   serial_log_hex("KEYBOARD: Scancode ", scancode);
@@ -69,55 +68,60 @@ static void keyboard_callback(registers_t *regs) {
     return;
   }
 
-  // Dabaye gaye normal buttons
-  if (!(scancode & 0x80)) {
-    // Combinations check karo
-    if (ctrl_pressed && scancode == 0x2E) { // Ctrl+C
-      serial_log("KEYBOARD: Ctrl+C detected. Sending SIGINT.");
-      sys_kill(current_process->id, SIGINT);
-      return;
-    }
+  // Dabaye gaye normal buttons (release pe bhi wahi char, value 0)
+  int pressed = !(scancode & 0x80);
+  scancode &= 0x7F;
+
+  // Combinations check karo
+  if (pressed && ctrl_pressed && scancode == 0x2E) { // Ctrl+C
+    serial_log("KEYBOARD: Ctrl+C detected. Sending SIGINT.");
+    sys_kill(current_process->id, SIGINT);
+    return;
+  }
 
-    // Character mapping decide karo
-    char c = 0;
-    int is_letter = (scancode >= 0x10 && scancode <= 0x19) || // q to p
-                    (scancode >= 0x1E && scancode <= 0x26) || // a to l
-                    (scancode >= 0x2C && scancode <= 0x32);   // z se m tak
+  // Character mapping decide karo
+  char c = 0;
+  int is_letter = (scancode >= 0x10 && scancode <= 0x19) || // q to p
+                  (scancode >= 0x1E && scancode <= 0x26) || // a to l
+                  (scancode >= 0x2C && scancode <= 0x32);   // z se m tak
 
-    if (is_letter) {
-      // Letters: Shift XOR Caps Lock ka logic
-      if (shift_pressed ^ caps_lock) {
-        c = kbd_us_shifted[scancode];
-      } else {
-        c = kbd_us[scancode];
-      }
+  if (is_letter) {
+    // Letters: Shift XOR Caps Lock ka logic
+    if (shift_pressed ^ caps_lock) {
+      c = kbd_us_shifted[scancode];
     } else {
-      // Non-letters: Sirf Shift ko dekho
-      if (shift_pressed) {
-        c = kbd_us_shifted[scancode];
-      } else {
-        c = kbd_us[scancode];
-      }
+      c = kbd_us[scancode];
     }
-
-    // Special Keys (Arrows aur F buttons ke liye scancode mapping)
-    if (c == 0) {
-      if (scancode == 0x48)
-        c = 17; // Up
-      if (scancode == 0x50)
-        c = 18; // Down
-      if (scancode == 0x4B)
-        c = 19; // Left
-      if (scancode == 0x4D)
-        c = 20; // Right
-      if (scancode == 0x3E)
-        c = 14; // F4
+  } else {
+    // Non-letters: Sirf Shift ko dekho
+    if (shift_pressed) {
+      c = kbd_us_shifted[scancode];
+    } else {
+      c = kbd_us[scancode];
     }
+  }
 
-    // Kernel Mode - seedha shell pe jao
-    if (c != 0) {
-      keyboard_set_last_key(c);
-    }
+  // Special Keys (Arrows aur F buttons ke liye scancode mapping)
+  if (c == 0) {
+    if (scancode == 0x48)
+      c = 17; // Up
+    if (scancode == 0x50)
+      c = 18; // Down
+    if (scancode == 0x4B)
+      c = 19; // Left
+    if (scancode == 0x4D)
+      c = 20; // Right
+    if (scancode == 0x3E)
+      c = 14; // F4
+    if (scancode == 0x57)
+      c = 16; // F11
+    if (scancode == 0x58)
+      c = 15; // F12
+  }
+
+  // Event queue mein - compositor aur /dev/input dono ko milega
+  if (c != 0) {
+    input_report_key(c, pressed);
   }
 }
 
@@ -2,6 +2,7 @@
 #include "../include/irq.h"
 #include "../include/types.h"
 #include "../kernel/apic.h"
+#include "input.h"
 #include "serial.h"
 
 uint8_t mouse_cycle = 0;
@@ -89,6 +90,9 @@ void mouse_callback(registers_t *regs) {
       mouse_y = 767;
 
     mouse_btn = state & 0x07; // Fill left, right, middle buttons
+
+    // Har packet event queue mein - frame ke beech ke clicks bhi
+    input_report_mouse(mouse_x, mouse_y, mouse_btn);
   }
 }
 
@@ -0,0 +1,142 @@
+/*
+ * raster.cpp - Span kernels (fill / blend / blit)
+ * Window shadows aur translucent titlebars sabse mehenge the: har pixel pe
+ * bounds check aur teen "/ 255". Ab blend ek baar clip hoke row pe chalta
+ * hai, SSE2 mein 4 pixels ek saath.
+ */
+
+#include "raster.h"
+#include "serial.h"
+
+#define CPUID_EDX_SSE2 (1u << 26)
+#define CPUID_EDX_FXSR (1u << 24)
+#define CR0_EM (1u << 2)
+#define CR4_OSFXSR (1u << 9)
+#define CR4_OSXMMEXCPT (1u << 10)
+
+static int has_sse2 = 0;
+
+extern "C" void raster_init() {
+  uint32_t eax = 1, ebx, ecx, edx;
+  asm volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+
+  if ((edx & (CPUID_EDX_SSE2 | CPUID_EDX_FXSR)) !=
+      (CPUID_EDX_SSE2 | CPUID_EDX_FXSR)) {
+    serial_log("RASTER: No SSE2, using scalar spans");
+    return;
+  }
+
+  uint32_t cr0, cr4;
+  asm volatile("mov %%cr0, %0" : "=r"(cr0));
+  cr0 &= ~CR0_EM;
+  asm volatile("mov %0, %%cr0" ::"r"(cr0));
+  asm volatile("mov %%cr4, %0" : "=r"(cr4));
+  cr4 |= CR4_OSFXSR | CR4_OSXMMEXCPT;
+  asm volatile("mov %0, %%cr4" ::"r"(cr4));
+
+  has_sse2 = 1;
+  serial_log("RASTER: SSE2 span kernels enabled");
+}
+
+extern "C" int raster_has_sse2() { return has_sse2; }
+
+/* ================= SCALAR (SWAR) ================= */
+// R aur B ek 32-bit word mein (bits 16-23 aur 0-7): ek multiply mein dono.
+// Har half mein max 255*255 + 128 = 65153, toh carry doosre half mein nahi
+// jaata.
+static inline uint32_t blend_px(uint32_t d, uint32_t ca_rb, uint32_t ca_g,
+                                uint32_t inv) {
+  uint32_t rb = (d & 0x00FF00FF) * inv + ca_rb;
+  uint32_t g = ((d >> 8) & 0xFF) * inv + ca_g;
+  rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+  g = ((g + (g >> 8)) >> 8) & 0xFF;
+  return 0xFF000000 | rb | (g << 8);
+}
+
+static void span_blend_scalar(uint32_t *dst, uint32_t color, uint8_t alpha,
+                              int n) {
+  uint32_t inv = 255 - alpha;
+  uint32_t ca_rb = (color & 0x00FF00FF) * alpha + 0x00800080;
+  uint32_t ca_g = ((color >> 8) & 0xFF) * alpha + 0x80;
+  for (int i = 0; i < n; i++)
+    dst[i] = blend_px(dst[i], ca_rb, ca_g, inv);
+}
+
+/* ================= SSE2 ================= */
+// emmintrin.h freestanding mein nahi milta, isliye seedhe GCC builtins
+typedef char v16qi __attribute__((vector_size(16)));
+typedef short v8hi __attribute__((vector_size(16)));
+typedef unsigned short v8hu __attribute__((vector_size(16)));
+typedef int v4si __attribute__((vector_size(16)));
+typedef v4si v4si_u __attribute__((aligned(1), may_alias));
+
+__attribute__((target("sse2"))) static void
+span_blend_sse2(uint32_t *dst, uint32_t color, uint8_t alpha, int n) {
+  uint16_t inv = 255 - alpha;
+  uint16_t cb = (color & 0xFF) * alpha + 128;
+  uint16_t cg = ((color >> 8) & 0xFF) * alpha + 128;
+  uint16_t cr = ((color >> 16) & 0xFF) * alpha + 128;
+
+  // 8 lanes = 2 pixels (B,G,R,A). A lane ka result baad mein 0xFF se OR
+  const v8hu ca = {cb, cg, cr, 0, cb, cg, cr, 0};
+  const v8hu vinv = {inv, inv, inv, inv, inv, inv, inv, inv};
+  const v16qi zero = {0};
+  const v4si opaque = {(int)0xFF000000, (int)0xFF000000, (int)0xFF000000,
+                       (int)0xFF000000};
+
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    v16qi px = (v16qi) * (const v4si_u *)(dst + i);
+    v8hu lo = (v8hu)__builtin_ia32_punpcklbw128(px, zero);
+    v8hu hi = (v8hu)__builtin_ia32_punpckhbw128(px, zero);
+
+    lo = lo * vinv + ca;
+    hi = hi * vinv + ca;
+    lo = (lo + (lo >> 8)) >> 8;
+    hi = (hi + (hi >> 8)) >> 8;
+
+    v4si out = (v4si)__builtin_ia32_packuswb128((v8hi)lo, (v8hi)hi);
+    *(v4si_u *)(dst + i) = out | opaque;
+  }
+
+  if (i < n)
+    span_blend_scalar(dst + i, color, alpha, n - i);
+}
+
+extern "C" void span_blend(uint32_t *dst, uint32_t color, uint8_t alpha,
+                           int n) {
+  if (n <= 0)
+    return;
+  if (has_sse2)
+    span_blend_sse2(dst, color, alpha, n);
+  else
+    span_blend_scalar(dst, color, alpha, n);
+}
+
+/* ================= RECT HELPERS ================= */
+extern "C" void raster_fill_rect(uint32_t *base, int pitch, int x, int y,
+                                 int w, int h, uint32_t color) {
+  uint32_t *row = base + y * pitch + x;
+  for (int i = 0; i < h; i++, row += pitch)
+    span_fill(row, color, w);
+}
+
+extern "C" void raster_blend_rect(uint32_t *base, int pitch, int x, int y,
+                                  int w, int h, uint32_t color,
+                                  uint8_t alpha) {
+  if (alpha == 0)
+    return;
+  if (alpha == 255) {
+    raster_fill_rect(base, pitch, x, y, w, h, color | 0xFF000000);
+    return;
+  }
+  uint32_t *row = base + y * pitch + x;
+  for (int i = 0; i < h; i++, row += pitch)
+    span_blend(row, color, alpha, w);
+}
+
+extern "C" void raster_blit(uint32_t *dst, int dst_pitch, const uint32_t *src,
+                            int src_pitch, int w, int h) {
+  for (int i = 0; i < h; i++, dst += dst_pitch, src += src_pitch)
+    span_copy(dst, src, w);
+}
@@ -0,0 +1,53 @@
+// raster.h - Span-based 2D rasterizer kernels
+// Har primitive ek baar clip hota hai (caller karta hai), phir yeh row-span
+// kernels chalte hain: fill = rep stosl, copy = rep movsl, blend = SSE2
+// (agar CPU mein hai) warna SWAR scalar. Koi per-pixel bounds check nahi.
+//
+// Note: kernel context switch pe XMM state save nahi hota (x87 ka bhi nahi),
+// isliye SSE2 path sirf compositor thread se hi chalna chahiye.
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "../include/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPUID se SSE2 dekho, ho toh CR4.OSFXSR on karke fast blend select karo
+void raster_init();
+int raster_has_sse2();
+
+// dst[0..n) par color ka alpha blend (a = 0..255), result opaque (A = 0xFF).
+// x/255 ki jagah (x + 128) * 257 >> 16 - divide nahi lagta.
+void span_blend(uint32_t *dst, uint32_t color, uint8_t alpha, int n);
+
+// Pre-clipped rect helpers. pitch pixels mein hai.
+void raster_fill_rect(uint32_t *base, int pitch, int x, int y, int w, int h,
+                      uint32_t color);
+void raster_blend_rect(uint32_t *base, int pitch, int x, int y, int w, int h,
+                       uint32_t color, uint8_t alpha);
+void raster_blit(uint32_t *dst, int dst_pitch, const uint32_t *src,
+                 int src_pitch, int w, int h);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void span_fill(uint32_t *dst, uint32_t color, int n) {
+  if (n < 16) {
+    // Chhote spans (glyph runs) pe rep ka startup mehenga padta hai
+    while (n-- > 0)
+      *dst++ = color;
+    return;
+  }
+  asm volatile("rep stosl" : "+D"(dst), "+c"(n) : "a"(color) : "memory");
+}
+
+static inline void span_copy(uint32_t *dst, const uint32_t *src, int n) {
+  if (n <= 0)
+    return;
+  asm volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(n) : : "memory");
+}
+
+#endif // RASTER_H
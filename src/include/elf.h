@@ -38,6 +38,10 @@ typedef struct {
 #define PT_SHLIB 5
 #define PT_PHDR 6
 
+#define PF_X 0x1
+#define PF_W 0x2
+#define PF_R 0x4
+
 typedef struct {
   Elf32_Word p_type;
   Elf32_Off p_offset;
@@ -49,4 +53,23 @@ typedef struct {
   Elf32_Word p_align;
 } Elf32_Phdr;
 
+#define SHT_NOBITS 8
+
+#define SHF_WRITE 0x1
+#define SHF_ALLOC 0x2
+#define SHF_EXECINSTR 0x4
+
+typedef struct {
+  Elf32_Word sh_name;
+  Elf32_Word sh_type;
+  Elf32_Word sh_flags;
+  Elf32_Addr sh_addr;
+  Elf32_Off sh_offset;
+  Elf32_Word sh_size;
+  Elf32_Word sh_link;
+  Elf32_Word sh_info;
+  Elf32_Word sh_addralign;
+  Elf32_Word sh_entsize;
+} Elf32_Shdr;
+
 #endif
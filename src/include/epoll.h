@@ -0,0 +1,61 @@
+#ifndef EPOLL_H
+#define EPOLL_H
+
+#include "types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// epoll Event Flags (POLL* ke saath same bits)
+// ============================================================================
+#define EPOLLIN 0x0001
+#define EPOLLPRI 0x0002
+#define EPOLLOUT 0x0004
+#define EPOLLERR 0x0008
+#define EPOLLHUP 0x0010
+#define EPOLLRDNORM 0x0040
+#define EPOLLWRNORM 0x0100
+#define EPOLLONESHOT (1u << 30)
+#define EPOLLET (1u << 31) // Edge-triggered
+
+// epoll_ctl operations
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+#define EPOLL_CLOEXEC 0x80000 // O_CLOEXEC
+
+// ============================================================================
+// epoll_event Structure (i386 Linux layout: packed, 12 bytes)
+// ============================================================================
+typedef union epoll_data {
+  void *ptr;
+  int fd;
+  uint32_t u32;
+  uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+  uint32_t events;
+  epoll_data_t data;
+} __attribute__((packed));
+
+// ============================================================================
+// epoll Functions
+// ============================================================================
+int epoll_create1(int flags);
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event);
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout);
+
+// Kernel: node band hone se pehle saare epoll sets se hatao
+struct vfs_node;
+void epoll_node_release(struct vfs_node *node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EPOLL_H
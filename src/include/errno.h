@@ -49,4 +49,24 @@
 #define ENOMSG 42          /* No message of desired type */
 #define EIDRM 43           /* Identifier removed */
 
+/* Networking */
+#define ENOTSOCK 88         /* Socket operation on non-socket */
+#define EDESTADDRREQ 89     /* Destination address required */
+#define EMSGSIZE 90         /* Message too long */
+#define EPROTOTYPE 91       /* Protocol wrong type for socket */
+#define ENOPROTOOPT 92      /* Protocol not available */
+#define EPROTONOSUPPORT 93  /* Protocol not supported */
+#define EOPNOTSUPP ENOTSUP  /* Operation not supported on socket */
+#define EAFNOSUPPORT 97     /* Address family not supported */
+#define EADDRINUSE 98       /* Address already in use */
+#define EADDRNOTAVAIL 99    /* Cannot assign requested address */
+#define ENETUNREACH 101     /* Network is unreachable */
+#define ECONNRESET 104      /* Connection reset by peer */
+#define EISCONN 106         /* Transport endpoint is already connected */
+#define ENOTCONN 107        /* Transport endpoint is not connected */
+#define ETIMEDOUT 110       /* Connection timed out */
+#define ECONNREFUSED 111    /* Connection refused */
+#define EALREADY 114        /* Operation already in progress */
+#define EINPROGRESS 115     /* Operation now in progress */
+
 #endif
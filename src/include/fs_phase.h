@@ -53,8 +53,9 @@ int vfs_create_file_phase_a(const char *path);
 int vfs_write_phase_a(phase_inode *f, const char *data, uint32_t len);
 
 // Persistence Interface
-void phase_vfs_sync();
-void phase_vfs_load();
+void phase_vfs_sync(); // Dirty sectors WAL ke through TRUTH.DAT mein
+void phase_vfs_load(); // Base image + committed log ka replay
+void phase_flush_thread(); // Background flusher (kernel thread)
 uint32_t phase_vfs_get_total_size();
 
 // Phase B Functions
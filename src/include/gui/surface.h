@@ -1,5 +1,22 @@
 /*
  * gui/surface.h - GUI Shared Surface Buffer Structures
+ *
+ * Double-buffered client surface protocol (one SHM segment per window):
+ *
+ *   [gui_surface_ctrl_t][gui_surface_buffer_t 0][gui_surface_buffer_t 1]
+ *
+ * - The compositor only ever reads buffers[front]; the client only ever
+ *   draws into the other one (the back buffer).
+ * - Commit: client bumps `committed`, then sends MSG_GFX_INVALIDATE_RECT
+ *   with the damage rect.
+ * - The compositor flips `front` to the committed buffer, repaints only
+ *   the damage rect, and sets `fence = committed`. From then on the old
+ *   front buffer is no longer read and belongs to the client again.
+ * - The compositor keeps its own copy of `front`, `fence` and the buffer
+ *   addresses; it only publishes them here and never reads them back.
+ * - Before drawing the next frame the client waits for `fence ==
+ *   committed` and copies the last damage rect from the new front into its
+ *   new back buffer, so both buffers hold the same image.
  */
 
 #ifndef GUI_SURFACE_H
@@ -8,6 +25,7 @@
 #include <stdint.h>
 
 #define SURFACE_MAGIC 0x53555246 // 'SURF'
+#define GUI_SURFACE_BUFFERS 2
 
 // Surface Buffer Header (must match layout for shared memory)
 typedef struct {
@@ -18,11 +36,24 @@ typedef struct {
   uint32_t pixels[]; // Flexible array member
 } gui_surface_buffer_t;
 
-// Surface Control Block
+// Surface Control Block (at offset 0 of the SHM segment)
 typedef struct {
   uint32_t magic;              // Must be SURFACE_MAGIC
-  volatile uint32_t committed; // Commit counter for sync
-  gui_surface_buffer_t *back;  // Pointer to backing buffer
+  volatile uint32_t committed; // Commit counter (client increments)
+  volatile uint32_t fence;     // Last commit the compositor has consumed
+  volatile uint32_t front;     // Buffer the compositor reads (compositor-owned)
+  uint32_t buffer_offset[GUI_SURFACE_BUFFERS]; // From start of segment
 } gui_surface_ctrl_t;
 
+static inline gui_surface_buffer_t *gui_surface_buffer(gui_surface_ctrl_t *c,
+                                                       uint32_t i) {
+  return (gui_surface_buffer_t *)((uint8_t *)c + c->buffer_offset[i]);
+}
+
+// Segment size for a w x h ARGB32 window (control block + both buffers)
+static inline uint32_t gui_surface_size(uint32_t w, uint32_t h) {
+  return sizeof(gui_surface_ctrl_t) +
+         GUI_SURFACE_BUFFERS * (sizeof(gui_surface_buffer_t) + w * h * 4);
+}
+
 #endif // GUI_SURFACE_H
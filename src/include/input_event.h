@@ -0,0 +1,27 @@
+#ifndef INPUT_EVENT_H
+#define INPUT_EVENT_H
+
+#include "types.h"
+
+// ============================================================================
+// Input events - /dev/input se read() pe yahi records milte hain (poore
+// records, aadha kabhi nahi). Compositor bhi isi format mein padhta hai.
+// ============================================================================
+#define INPUT_EV_KEY 1    // code = ASCII / special key, value = 1 press, 0 release
+#define INPUT_EV_MOTION 2 // x, y = naya pointer position (coalesce hota hai)
+#define INPUT_EV_BUTTON 3 // code = jo buttons badle, value = naya button mask
+
+#define INPUT_BTN_LEFT 0x01
+#define INPUT_BTN_RIGHT 0x02
+#define INPUT_BTN_MIDDLE 0x04
+
+typedef struct input_event {
+  uint32_t time_ms; // Boot se (timer ticks ke hisaab se)
+  uint16_t type;    // INPUT_EV_*
+  uint16_t code;
+  int32_t value;
+  int32_t x, y;     // Event ke waqt pointer position
+  uint32_t buttons; // Event ke baad button mask
+} input_event_t;
+
+#endif // INPUT_EVENT_H
@@ -0,0 +1,49 @@
+#ifndef SPAWN_H
+#define SPAWN_H
+
+#include "signal.h"
+#include "types.h"
+
+// ============================================================================
+// posix_spawn ABI - user ke structs kernel seedha copy karta hai
+// (apps/include/libc.h mein same layout)
+// ============================================================================
+
+// posix_spawnattr_t::flags
+#define POSIX_SPAWN_RESETIDS 0x01
+#define POSIX_SPAWN_SETPGROUP 0x02
+#define POSIX_SPAWN_SETSIGDEF 0x04
+#define POSIX_SPAWN_SETSIGMASK 0x08
+#define POSIX_SPAWN_SETSCHEDPARAM 0x10
+
+// File actions - child mein isi order mein lagte hain
+#define SPAWN_FA_OPEN 1
+#define SPAWN_FA_CLOSE 2
+#define SPAWN_FA_DUP2 3
+
+#define SPAWN_MAX_ACTIONS 16
+#define SPAWN_PATH_MAX 128
+
+typedef struct posix_spawn_file_action {
+  int type;
+  int fd;        // OPEN/CLOSE: target fd, DUP2: source fd
+  int newfd;     // DUP2
+  int oflag;     // OPEN
+  uint32_t mode; // OPEN
+  char path[SPAWN_PATH_MAX];
+} posix_spawn_file_action_t;
+
+typedef struct posix_spawn_file_actions {
+  int count;
+  posix_spawn_file_action_t actions[SPAWN_MAX_ACTIONS];
+} posix_spawn_file_actions_t;
+
+typedef struct posix_spawnattr {
+  uint32_t flags;
+  uint32_t pgroup;     // 0 = child ka apna pid
+  sigset_t sigmask;    // SETSIGMASK
+  sigset_t sigdefault; // SETSIGDEF: in signals ka handler SIG_DFL
+  int priority;        // SETSCHEDPARAM: 0-139
+} posix_spawnattr_t;
+
+#endif
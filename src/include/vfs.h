@@ -22,6 +22,7 @@ enum vfs_node_type {
 #define O_CREAT 0x40
 #define O_TRUNC 0x200
 #define O_NONBLOCK 0x800
+#define O_CLOEXEC 0x80000
 
 #define SEEK_SET 0
 #define SEEK_CUR 1
@@ -31,6 +32,7 @@ enum vfs_node_type {
 struct vfs_node;
 struct filesystem;
 struct dirent;
+struct poll_table;
 
 // Filesystem Interface (The Contract)
 struct filesystem {
@@ -55,6 +57,7 @@ struct filesystem {
   int (*rmdir)(struct vfs_node *parent, const char *name);
   int (*rename)(struct vfs_node *parent, const char *old_name,
                 const char *new_name);
+  int (*truncate)(struct vfs_node *file, uint64_t length); // Optional
 };
 
 // The VFS Node (The Brain)
@@ -90,8 +93,28 @@ typedef struct vfs_node {
   int (*rmdir)(struct vfs_node *, const char *);
   int (*rename)(struct vfs_node *, const char *, const char *);
   int (*ioctl)(struct vfs_node *, int, void *);
+  // Readiness mask (POLLIN/POLLOUT/POLLHUP). pt non-null ho toh driver apni
+  // wait queues poll_wait() se register karta hai (poll/select/epoll ke liye)
+  int (*poll)(struct vfs_node *, struct poll_table *pt);
+  // Cache ka dirty data (aur size) disk pe - fsync/fdatasync. Null = driver
+  // kuch cache nahi karta
+  int (*fsync)(struct vfs_node *);
+  // [offset, offset + len) ko background mein cache karo (read-ahead).
+  // Turant lautta hai; null = driver read-ahead nahi karta
+  void (*readahead)(struct vfs_node *, uint32_t offset, uint32_t len);
 } vfs_node_t;
 
+// Per-open-file read-ahead (file_description_t / exec image mein).
+// Sequential read pe window dugni hoti hai, random access pe band.
+#define VFS_RA_MIN (16 * 1024)
+#define VFS_RA_MAX (128 * 1024)
+
+typedef struct file_ra_state {
+  uint64_t next;   // Sequential read yahan se aayega
+  uint64_t issued; // Is offset tak read-ahead maanga ja chuka
+  uint32_t window; // Bytes, 0 = random access
+} file_ra_state_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -107,6 +130,9 @@ vfs_node_t *vfs_resolve_path_relative(vfs_node_t *base, const char *path);
 
 // Operation Wrappers
 int vfs_read(vfs_node_t *node, uint64_t offset, void *buf, uint64_t size);
+// vfs_read + read-ahead state update (read() jaise sequential readers)
+int vfs_read_ra(vfs_node_t *node, file_ra_state_t *ra, uint64_t offset,
+                void *buf, uint64_t size);
 int vfs_write(vfs_node_t *node, uint64_t offset, const void *buf,
               uint64_t size);
 int vfs_create(const char *path, int type);
@@ -120,10 +120,6 @@ struct SyscallPacket {
 
 extern "C" int kernel_syscall(SyscallPacket *p);
 
-extern "C" void compositor_invalidate() {
-  // Force a full redraw of the GUI loop if needed
-}
-
 extern "C" void *sys_get_framebuffer() { return (void *)back_buffer; }
 extern "C" int sys_fb_width() { return 1024; }
 extern "C" int sys_fb_height() { return 768; }
@@ -131,6 +127,9 @@ extern "C" int sys_fb_pitch() {
   return 1024 * 4;
 } // bytes per line, hisaab fix hai
 extern "C" void sys_fb_swap() { swap_buffers(); }
+extern "C" void sys_fb_present(const fb_rect_t *rects, int count) {
+  graphics_present(rects, count);
+}
 extern "C" void sys_get_mouse(int *x, int *y, int *btn) {
   uint8_t b;
   get_mouse_state(x, y, &b);
@@ -155,25 +154,6 @@ extern "C" int sys_spawn(const char *path, char **argv) {
   return 0;
 }
 
-// Keyboard: aakhri scancode wapas karo ya -1 agar kuch nahi hai
-static volatile int g_last_key = -1;
-extern "C" void keyboard_set_last_key(int k) { g_last_key = k; }
-extern "C" int sys_get_key() {
-  int k = g_last_key;
-  g_last_key = -1;
-  return k;
-}
-
-extern "C" int sys_read_key(int *key, int *state) {
-  int k = sys_get_key();
-  if (k == -1)
-    return 0;
-  *key = k & 0x7F;
-  *state =
-      (k & 0x80) ? 0 : 1; // Basic scancode mapping: bit 7 ka matlab release
-  return 1;
-}
-
 extern "C" int sys_is_dir(const char *path) {
   vfs_node_t *n = vfs_resolve_path(path);
   return (n && n->type == VFS_DIRECTORY) ? 1 : 0;
@@ -476,6 +456,13 @@ extern "C" int main() {
     serial_log("KERNEL: Starting Net System...");
     create_kernel_thread(net_thread);
 
+    // Phase A filesystem ka background flusher (dirty sectors -> TRUTH.DAT)
+    create_kernel_thread(phase_flush_thread);
+
+    // FAT16 write-back cache ka flusher (delayed allocation + batch writes)
+    create_kernel_thread(fat16_flush_thread);
+    create_kernel_thread(fat16_readahead_thread);
+
     // User space start karo - Non-GUI INIT chala rahe hain
     create_user_process("INIT.ELF", nullptr);
     init_timer(50);
@@ -36,4 +36,10 @@ int block_write(block_device_t *dev, uint32_t block, uint8_t *buffer) {
   return dev->write_block(dev, block, buffer);
 }
 
+int block_flush(block_device_t *dev) {
+  if (!dev)
+    return -1;
+  return dev->flush ? dev->flush(dev) : 0;
+}
+
 } // extern "C"
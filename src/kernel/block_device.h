@@ -12,6 +12,8 @@ typedef int (*block_read_t)(struct block_device *dev, uint32_t block,
                             uint8_t *buffer);
 typedef int (*block_write_t)(struct block_device *dev, uint32_t block,
                              uint8_t *buffer);
+// Write cache ko media tak pahunchao (journal ordering ke liye)
+typedef int (*block_flush_t)(struct block_device *dev);
 
 typedef struct block_device {
   char name[32];
@@ -21,6 +23,7 @@ typedef struct block_device {
 
   block_read_t read_block;
   block_write_t write_block;
+  block_flush_t flush; // Optional - nahi hai toh writes sync maane jaate hain
 } block_device_t;
 
 #ifdef __cplusplus
@@ -36,6 +39,7 @@ block_device_t *get_block_device(const char *name);
 // High-level read/write
 int block_read(block_device_t *dev, uint32_t block, uint8_t *buffer);
 int block_write(block_device_t *dev, uint32_t block, uint8_t *buffer);
+int block_flush(block_device_t *dev);
 
 #ifdef __cplusplus
 }
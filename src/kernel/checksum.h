@@ -0,0 +1,52 @@
+// checksum.h - Internet checksum (RFC 1071) helpers for the network path
+// Saare sums "native" order mein hote hain: packet ke 16-bit words ko jaise
+// memory mein hain waise hi jodo, result seedha header field mein likh do.
+// Isliye htons/ntohs ki zaroorat nahi padti (ones-complement sum byte order
+// se independent hai).
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "../include/types.h"
+
+// RX side: NIC ne kya verify kiya (e1000 RXCSUM ya loopback se aata hai)
+#define CSUM_RX_NONE 0x00   // Kuch verify nahi hua - software check karega
+#define CSUM_RX_IP_OK 0x01  // IPv4 header checksum sahi hai
+#define CSUM_RX_L4_OK 0x02  // TCP/UDP checksum sahi hai
+#define CSUM_RX_BAD 0x80    // Hardware ne galat checksum dekha - drop karo
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 32-bit partial sum (fold nahi kiya hua). Buffer ka start packet mein even
+// offset pe hona chahiye; odd length sirf aakhri chunk ki ho sakti hai.
+uint32_t csum_partial(const void *buf, uint32_t len, uint32_t sum);
+
+// Partial sum ko 16 bit mein fold karke complement - header mein yahi jaata hai
+uint16_t csum_fold(uint32_t sum);
+
+// IPv4 header checksum (ihl 32-bit words mein). Verify karte waqt 0 = sahi.
+uint16_t ip_fast_csum(const void *iph, uint32_t ihl);
+
+// TCP/UDP pseudo-header jod ke. Addresses network order mein (jaise ip_hdr
+// mein stored hain), len host order mein.
+uint32_t csum_tcpudp_nofold(uint32_t saddr, uint32_t daddr, uint16_t len,
+                            uint8_t proto, uint32_t sum);
+uint16_t csum_tcpudp_magic(uint32_t saddr, uint32_t daddr, uint16_t len,
+                           uint8_t proto, uint32_t sum);
+
+// Checksum offload ke liye seed: L4 checksum field mein yeh daalo, phir NIC
+// (ya software fallback) L4 header + data ka sum jod ke complement karega.
+uint16_t csum_pseudo_seed(uint32_t saddr, uint32_t daddr, uint16_t len,
+                          uint8_t proto);
+
+// Incremental update (RFC 1624 eqn. 3): HC' = ~(~HC + ~m + m').
+// Header ka ek 16/32-bit field badla ho toh poora packet dobara mat jodo.
+uint16_t csum_update16(uint16_t check, uint16_t from, uint16_t to);
+uint16_t csum_update32(uint16_t check, uint32_t from, uint32_t to);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CHECKSUM_H
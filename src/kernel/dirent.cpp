@@ -79,10 +79,11 @@ DIR *opendir(const char *name) {
 // fdopendir - File descriptor se directory stream kholo
 // ============================================================================
 DIR *fdopendir(int fd) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return 0;
 
-  vfs_node_t *node = current_process->fd_table[fd]->node;
+  file_description_t *desc = fd_get(fd);
+  vfs_node_t *node = desc->node;
   if ((node->flags & 0x7) != VFS_DIRECTORY)
     return 0;
 
@@ -243,23 +244,22 @@ int sys_getdents(int fd, void *dirp, unsigned int count) {
   if (!dirp)
     return -EFAULT;
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  file_description_t *desc = fd_get(fd);
+  if (!desc)
     return -EBADF;
 
-  vfs_node_t *node = current_process->fd_table[fd]->node;
+  vfs_node_t *node = desc->node;
   if ((node->flags & 0x7) != VFS_DIRECTORY)
     return -ENOTDIR;
 
   if (!node->readdir)
     return -ENOSYS;
 
-  // We need to track the position per-fd
-  // Using a simplified approach with a static position tracker
-  static uint32_t getdents_pos[MAX_PROCESS_FILES] = {0};
-
+  // Directory position description ke offset mein rehta hai (entry index),
+  // taaki dup kiye hue fds bhi same position share karein
   uint8_t *buf = (uint8_t *)dirp;
   unsigned int bytes_written = 0;
-  uint32_t pos = getdents_pos[fd];
+  uint32_t pos = desc->offset;
 
   while (bytes_written < count) {
     struct dirent *entry = node->readdir(node, pos);
@@ -285,7 +285,7 @@ int sys_getdents(int fd, void *dirp, unsigned int count) {
     pos++;
   }
 
-  getdents_pos[fd] = pos;
+  desc->offset = pos;
   return bytes_written;
 }
 
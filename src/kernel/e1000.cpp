@@ -4,6 +4,10 @@
 // Retro-OS Networking Phase 1
 
 #include "../drivers/pci.h"
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "checksum.h"
+#include "e1000.h"
 #include "paging.h"
 #include "vm.h"
 #include <stddef.h>
@@ -58,6 +62,31 @@ extern "C" uint32_t virt_to_phys(void *addr) {
 #define E1000_RDH 0x2810
 #define E1000_RDT 0x2818
 
+#define E1000_RXCSUM 0x5000
+#define E1000_RXCSUM_IPOFL (1 << 8) // IPv4 header checksum offload
+#define E1000_RXCSUM_TUOFL (1 << 9) // TCP/UDP checksum offload
+
+// RX descriptor status / errors bits (checksum related)
+#define E1000_RXD_STAT_DD 0x01
+#define E1000_RXD_STAT_IXSM 0x04  // Ignore checksum indication
+#define E1000_RXD_STAT_TCPCS 0x20 // TCP/UDP checksum calculated
+#define E1000_RXD_STAT_IPCS 0x40  // IP checksum calculated
+#define E1000_RXD_ERR_TCPE 0x20
+#define E1000_RXD_ERR_IPE 0x40
+
+// TX descriptor command bits. Legacy descriptor mein cmd ek byte hai; context
+// aur extended data descriptor mein yahi bits 32-bit word ke top byte mein.
+#define E1000_TXD_CMD_EOP 0x01
+#define E1000_TXD_CMD_IFCS 0x02
+#define E1000_TXD_CMD_RS 0x08
+#define E1000_TXD_CMD_DEXT 0x20
+#define E1000_TXD_DTYP_D 0x00100000 // Extended data descriptor
+#define E1000_TXD_DTYP_C 0x00000000 // Context descriptor
+#define E1000_TXD_POPTS_IXSM 0x01   // Insert IP checksum
+#define E1000_TXD_POPTS_TXSM 0x02   // Insert TCP/UDP checksum
+#define E1000_TXD_TUCMD_TCP 0x01    // Context: L4 is TCP (warna UDP)
+#define E1000_TXD_TUCMD_IP 0x02     // Context: L3 is IPv4
+
 // =======================================================
 // DESCRIPTORS
 // =======================================================
@@ -84,6 +113,32 @@ struct tx_desc {
   uint16_t special;
 } __attribute__((packed));
 
+// Checksum offload context. Ring mein data descriptor ki jagah hi baithta hai;
+// NIC isse yaad rakhta hai jab tak naya context na aaye.
+struct tx_ctx_desc {
+  uint8_t ipcss;  // IP header start
+  uint8_t ipcso;  // IP checksum field offset
+  uint16_t ipcse; // IP header end (inclusive)
+  uint8_t tucss;  // TCP/UDP header start
+  uint8_t tucso;  // TCP/UDP checksum field offset
+  uint16_t tucse; // 0 = packet ke end tak
+  uint32_t cmd_and_length;
+  uint8_t status;
+  uint8_t hdr_len;
+  uint16_t mss;
+} __attribute__((packed));
+
+// Extended data descriptor (DEXT). POPTS batata hai kaunse checksum bharne hain.
+struct tx_data_desc {
+  uint64_t addr;
+  uint32_t cmd_and_length;
+  uint8_t status;
+  uint8_t reserved;
+  uint8_t popts;
+  uint8_t special_lo;
+  uint16_t special;
+} __attribute__((packed));
+
 // =======================================================
 // DRIVER STATE
 // =======================================================
@@ -97,9 +152,18 @@ static tx_desc tx_ring[TX_DESC_COUNT] __attribute__((aligned(16)));
 static uint8_t rx_buffers[RX_DESC_COUNT][2048] __attribute__((aligned(16)));
 static uint8_t tx_buffers[TX_DESC_COUNT][2048] __attribute__((aligned(16)));
 
+static uint32_t tx_buf_phys[TX_DESC_COUNT];
+
 static uint32_t rx_tail = 0;
 static uint32_t tx_tail = 0;
 
+// Last context jo NIC ko diya tha. Same offsets (har TCP/UDP packet ke) pe
+// naya context descriptor nahi bhejte.
+static struct {
+  uint8_t valid;
+  uint8_t ipcss, ipcso, tucss, tucso, tucmd;
+} tx_ctx;
+
 // =======================================================
 // MMIO ACCESS
 // =======================================================
@@ -166,11 +230,17 @@ extern "C" void e1000_init(uint8_t bus, uint8_t slot, uint8_t func) {
                   (0 << 16) | // BSIZE = 2048 (00)
                   (1 << 26)); // SECRC - Strip Ethernet CRC
 
+  // RX checksum offload: NIC IP/TCP/UDP checksum check karke status mein
+  // batata hai, software ko dobara nahi jodna padta
+  e1000_write(E1000_RXCSUM, E1000_RXCSUM_IPOFL | E1000_RXCSUM_TUOFL);
+
   // Setup TX ring
   for (int i = 0; i < TX_DESC_COUNT; i++) {
-    tx_ring[i].addr = virt_to_phys(tx_buffers[i]);
+    tx_buf_phys[i] = virt_to_phys(tx_buffers[i]);
+    tx_ring[i].addr = tx_buf_phys[i];
     tx_ring[i].status = 0x1;
   }
+  tx_ctx.valid = 0;
 
   e1000_write(E1000_TDBAL, virt_to_phys((void *)tx_ring));
   e1000_write(E1000_TDLEN, TX_DESC_COUNT * sizeof(tx_desc));
@@ -199,41 +269,98 @@ extern "C" void e1000_init(uint8_t bus, uint8_t slot, uint8_t func) {
 // SEND PACKET
 // =======================================================
 
-extern "C" void e1000_send(void *data, uint16_t length) {
-  extern void serial_log(const char *);
-  extern void serial_log_hex(const char *, uint32_t);
+// Context descriptor sirf tab jab offsets badle hon
+static void e1000_load_tx_ctx(uint8_t ipcss, uint8_t ipcso, uint8_t tucss,
+                              uint8_t tucso, uint8_t tucmd) {
+  if (tx_ctx.valid && tx_ctx.ipcss == ipcss && tx_ctx.ipcso == ipcso &&
+      tx_ctx.tucss == tucss && tx_ctx.tucso == tucso && tx_ctx.tucmd == tucmd)
+    return;
+
+  tx_ctx_desc *ctx = (tx_ctx_desc *)&tx_ring[tx_tail];
+  ctx->ipcss = ipcss;
+  ctx->ipcso = ipcso;
+  ctx->ipcse = tucss - 1;
+  ctx->tucss = tucss;
+  ctx->tucso = tucso;
+  ctx->tucse = 0;
+  ctx->cmd_and_length =
+      E1000_TXD_DTYP_C | ((uint32_t)(tucmd | E1000_TXD_CMD_DEXT) << 24);
+  ctx->status = 0;
+  ctx->hdr_len = 0;
+  ctx->mss = 0;
+
+  tx_tail = (tx_tail + 1) % TX_DESC_COUNT;
+
+  tx_ctx.valid = 1;
+  tx_ctx.ipcss = ipcss;
+  tx_ctx.ipcso = ipcso;
+  tx_ctx.tucss = tucss;
+  tx_ctx.tucso = tucso;
+  tx_ctx.tucmd = tucmd;
+}
+
+static void e1000_tx_kick(volatile uint8_t *status) {
+  e1000_write(E1000_TDT, tx_tail);
 
+  // Wait for transmit to complete
+  for (volatile int i = 0; i < 100000; i++)
+    if (*status & 0x1)
+      break;
+}
+
+extern "C" void e1000_send(void *data, uint16_t length) {
   tx_desc *desc = &tx_ring[tx_tail];
   uint8_t *buf = tx_buffers[tx_tail];
 
-  for (int i = 0; i < length; i++)
-    buf[i] = ((uint8_t *)data)[i];
+  memcpy(buf, data, length);
 
+  // Slot pehle context descriptor raha ho sakta hai - saare fields dobara bharo
+  desc->addr = tx_buf_phys[tx_tail];
   desc->length = length;
-  desc->cmd = (1 << 0) | (1 << 3); // EOP | RS
+  desc->cso = 0;
+  desc->cmd = E1000_TXD_CMD_EOP | E1000_TXD_CMD_RS;
   desc->status = 0;
+  desc->css = 0;
+  desc->special = 0;
 
   serial_log_hex("e1000: TX packet len: ", length);
 
   tx_tail = (tx_tail + 1) % TX_DESC_COUNT;
-  e1000_write(E1000_TDT, tx_tail);
+  e1000_tx_kick(&desc->status);
+}
 
-  // Wait for transmit to complete
-  for (volatile int i = 0; i < 100000; i++) {
-    if (desc->status & 0x1) {
-      serial_log("e1000: TX complete.");
-      break;
-    }
-  }
+extern "C" void e1000_send_csum(void *data, uint16_t length, uint8_t l3_off,
+                                uint8_t l4_off, uint8_t l4_csum_off,
+                                int is_tcp) {
+  e1000_load_tx_ctx(l3_off, l3_off + 10, l4_off, l4_off + l4_csum_off,
+                    E1000_TXD_TUCMD_IP | (is_tcp ? E1000_TXD_TUCMD_TCP : 0));
+
+  tx_data_desc *desc = (tx_data_desc *)&tx_ring[tx_tail];
+  uint8_t *buf = tx_buffers[tx_tail];
+
+  memcpy(buf, data, length);
+
+  desc->addr = tx_buf_phys[tx_tail];
+  desc->cmd_and_length =
+      length | E1000_TXD_DTYP_D |
+      ((uint32_t)(E1000_TXD_CMD_EOP | E1000_TXD_CMD_IFCS | E1000_TXD_CMD_RS |
+                  E1000_TXD_CMD_DEXT)
+       << 24);
+  desc->status = 0;
+  desc->reserved = 0;
+  desc->popts = E1000_TXD_POPTS_IXSM | E1000_TXD_POPTS_TXSM;
+  desc->special_lo = 0;
+  desc->special = 0;
+
+  tx_tail = (tx_tail + 1) % TX_DESC_COUNT;
+  e1000_tx_kick(&desc->status);
 }
 
 // =======================================================
 // RECEIVE PACKET (Polling)
 // =======================================================
 
-extern "C" int e1000_receive(uint8_t *out) {
-  extern void serial_log(const char *);
-  extern void serial_log_hex(const char *, uint32_t);
+extern "C" int e1000_receive_csum(uint8_t *out, uint32_t *rx_csum) {
 
   // Debug: Log first 10 calls to verify we're being called
   static int first_calls = 0;
@@ -265,8 +392,23 @@ extern "C" int e1000_receive(uint8_t *out) {
   uint16_t len = desc->length;
   serial_log_hex("e1000: RX packet! len=", len);
 
-  for (int i = 0; i < len; i++)
-    out[i] = rx_buffers[rx_tail][i];
+  memcpy(out, rx_buffers[rx_tail], len);
+
+  if (rx_csum) {
+    // IXSM set ho toh NIC ne kuch check nahi kiya (QEMU aksar yahi karta hai)
+    uint32_t flags = CSUM_RX_NONE;
+    if (!(status & E1000_RXD_STAT_IXSM)) {
+      if (desc->errors & (E1000_RXD_ERR_IPE | E1000_RXD_ERR_TCPE))
+        flags = CSUM_RX_BAD;
+      else {
+        if (status & E1000_RXD_STAT_IPCS)
+          flags |= CSUM_RX_IP_OK;
+        if (status & E1000_RXD_STAT_TCPCS)
+          flags |= CSUM_RX_L4_OK;
+      }
+    }
+    *rx_csum = flags;
+  }
 
   desc->status = 0;
   uint32_t last_tail = rx_tail;
@@ -275,3 +417,7 @@ extern "C" int e1000_receive(uint8_t *out) {
 
   return len;
 }
+
+extern "C" int e1000_receive(uint8_t *out) {
+  return e1000_receive_csum(out, nullptr);
+}
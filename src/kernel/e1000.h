@@ -5,6 +5,14 @@
 
 extern "C" void e1000_init(uint8_t bus, uint8_t slot, uint8_t func);
 extern "C" void e1000_send(void *data, uint16_t length);
+// Ethernet frame bhejo aur IPv4 header + TCP/UDP checksum NIC se bharwao.
+// Offsets frame ki shuruaat se; L4 checksum field mein pseudo-header seed
+// (csum_pseudo_seed) pehle se hona chahiye, IP checksum field 0.
+extern "C" void e1000_send_csum(void *data, uint16_t length, uint8_t l3_off,
+                                uint8_t l4_off, uint8_t l4_csum_off,
+                                int is_tcp);
 extern "C" int e1000_receive(uint8_t *out);
+// rx_csum mein CSUM_RX_* flags (checksum.h) - NIC ne kya verify kiya
+extern "C" int e1000_receive_csum(uint8_t *out, uint32_t *rx_csum);
 
 #endif
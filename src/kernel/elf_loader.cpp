@@ -1,15 +1,467 @@
+#include "elf_loader.h"
 #include "../drivers/serial.h"
 #include "../include/elf.h"
+#include "../include/errno.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
 #include "../kernel/heap.h" // Added for kfree
 #include "../kernel/memory.h"
 #include "../kernel/pmm.h"
 #include "../kernel/vm.h"
+#include "paging.h"
+#include "process.h"
 
-// ... imports ...
+/* =========================================================
+   DEMAND-PAGED ELF LOADER
+   Pehle load_elf poori file kmalloc buffer mein padhta tha aur har segment
+   ka har page pehle se allocate + memcpy karta tha - har spawn pe. Ab sirf
+   headers padhte hain; pages pehli baar chhoone pe aate hain.
+   ========================================================= */
+
+#define ELF_MAX_PHDRS 16
+#define ELF_USER_START 0x00400000
+#define ELF_USER_END 0x70000000 // SHM window se pehle
+
+/* ================= IMAGES =================
+   Ek binary: file ki identity, parsed segments aur entry. Page cache ke
+   frames isi se bandhe hain, aur fault pe file padhne ke liye node khula
+   rehta hai. Valid image pe agla exec seedha yahin se (no resolve, no I/O).
+   FAT16 har lookup pe naya node kmalloc karta hai aur inode 0 deta hai,
+   isliye identity = (fs ya driver, inode ya pehla cluster). */
+#define ELF_IMAGE_MAX 16
+
+typedef struct elf_image {
+  char path[128];
+  uintptr_t dev;    // node->fs, warna driver ka read fn
+  uint64_t file_id; // inode, warna impl (FAT16: pehla cluster)
+  uint64_t size;
+  vfs_node_t *node;
+  bool valid;     // false = file badal gayi, sirf purane users ke liye
+  uint32_t refs;  // Kitne mm isse use kar rahe hain
+  uint32_t pages; // Page cache mein kitne frames
+  uint32_t pin_first, pin_end; // Text ke file pages [first, end)
+  uint32_t last_use;
+  file_ra_state_t ra; // Sequential page faults pe read-ahead
+  uint32_t entry, top;
+  int vma_count;
+  elf_vma_t vmas[ELF_MM_MAX_VMAS];
+} elf_image_t;
+
+static elf_image_t elf_images[ELF_IMAGE_MAX];
+static uint32_t elf_image_clock = 0;
+
+/* ================= PAGE CACHE =================
+   (image, file page) -> frame. `maps` = kitne PTEs is frame pe hain; 0 ho
+   toh frame sirf cache mein hai aur evict ho sakta hai. Do hash chains:
+   key se lookup (fault) aur phys se (PTE hatane pe).
+   Valid image ke text pages pinned hain - unmapped hon tab bhi normal
+   eviction unhe nahi chhoota (sirf PMM bilkul khaali ho tab). */
+#define ELF_PCACHE_MAX 1024 // 4 MB
+#define ELF_PCACHE_BUCKETS 256
+#define ELF_PCACHE_NONE -1
+#define ELF_PIN_MAX 512 // Aadha cache - baaki hamesha evictable
+
+typedef struct elf_page {
+  elf_image_t *image; // nullptr = khaali slot
+  uint32_t index;     // File offset / 4096
+  uint32_t phys;
+  uint32_t maps;
+  uint32_t last_use;
+  bool pinned;
+  int16_t next_key, next_phys;
+} elf_page_t;
+
+static elf_page_t elf_pages[ELF_PCACHE_MAX];
+static int16_t elf_key_head[ELF_PCACHE_BUCKETS];
+static int16_t elf_phys_head[ELF_PCACHE_BUCKETS];
+static uint32_t elf_pcache_clock = 0;
+static uint32_t elf_pinned_total = 0;
+static bool elf_pcache_ready = false;
+
+static inline uint32_t key_hash(const elf_image_t *img, uint32_t index) {
+  return (((uint32_t)(uintptr_t)img >> 4) ^ (index * 2654435761u)) &
+         (ELF_PCACHE_BUCKETS - 1);
+}
+
+static inline uint32_t phys_hash(uint32_t phys) {
+  return (phys >> 12) & (ELF_PCACHE_BUCKETS - 1);
+}
+
+static void elf_pcache_init() {
+  for (int i = 0; i < ELF_PCACHE_BUCKETS; i++)
+    elf_key_head[i] = elf_phys_head[i] = ELF_PCACHE_NONE;
+  memset(elf_pages, 0, sizeof(elf_pages));
+  elf_pcache_ready = true;
+}
+
+static elf_page_t *elf_pcache_find(const elf_image_t *img, uint32_t index) {
+  for (int i = elf_key_head[key_hash(img, index)]; i != ELF_PCACHE_NONE;
+       i = elf_pages[i].next_key)
+    if (elf_pages[i].image == img && elf_pages[i].index == index)
+      return &elf_pages[i];
+  return nullptr;
+}
+
+static elf_page_t *elf_pcache_find_phys(uint32_t phys) {
+  for (int i = elf_phys_head[phys_hash(phys)]; i != ELF_PCACHE_NONE;
+       i = elf_pages[i].next_phys)
+    if (elf_pages[i].image && elf_pages[i].phys == phys)
+      return &elf_pages[i];
+  return nullptr;
+}
+
+static void elf_pcache_unlink(int idx) {
+  elf_page_t *p = &elf_pages[idx];
+  int16_t *link = &elf_key_head[key_hash(p->image, p->index)];
+  while (*link != idx)
+    link = &elf_pages[*link].next_key;
+  *link = p->next_key;
+  link = &elf_phys_head[phys_hash(p->phys)];
+  while (*link != idx)
+    link = &elf_pages[*link].next_phys;
+  *link = p->next_phys;
+}
+
+static void elf_page_unpin(elf_page_t *p) {
+  if (p->pinned) {
+    p->pinned = false;
+    elf_pinned_total--;
+  }
+}
+
+static void elf_pcache_drop(int idx) {
+  elf_page_t *p = &elf_pages[idx];
+  elf_page_unpin(p);
+  elf_pcache_unlink(idx);
+  pmm_free_block((void *)(uintptr_t)p->phys);
+  p->image->pages--;
+  p->image = nullptr;
+}
+
+// Koi bhi unmapped (maps == 0) frame - sabse purana. `pinned` = text pages
+// bhi chalenge. -1 = kuch nahi mila.
+static int elf_pcache_victim(bool pinned) {
+  int victim = ELF_PCACHE_NONE;
+  for (int i = 0; i < ELF_PCACHE_MAX; i++) {
+    elf_page_t *p = &elf_pages[i];
+    if (!p->image || p->maps || (p->pinned && !pinned))
+      continue;
+    if (victim == ELF_PCACHE_NONE || p->last_use < elf_pages[victim].last_use)
+      victim = i;
+  }
+  return victim;
+}
+
+// Frame do; PMM khaali ho toh cache ka ek unmapped page chhod ke dobara
+static uint32_t elf_alloc_frame() {
+  void *phys = pmm_alloc_block();
+  if (!phys && elf_pcache_ready) {
+    int v = elf_pcache_victim(false);
+    if (v == ELF_PCACHE_NONE)
+      v = elf_pcache_victim(true); // Memory hi nahi - pin bhi toot sakta hai
+    if (v != ELF_PCACHE_NONE) {
+      elf_pcache_drop(v);
+      phys = pmm_alloc_block();
+    }
+  }
+  return (uint32_t)(uintptr_t)phys;
+}
+
+// File page cache mein lao (ya jo pehle se hai). `map` = caller ise PTE mein
+// daalega, maps++ yahin. 0 = cache bhara / OOM / read fail.
+static uint32_t elf_pcache_get(elf_image_t *img, uint32_t index, int map) {
+  elf_page_t *p = elf_pcache_find(img, index);
+  if (!p) {
+    int slot = ELF_PCACHE_NONE;
+    for (int i = 0; i < ELF_PCACHE_MAX && slot == ELF_PCACHE_NONE; i++)
+      if (!elf_pages[i].image)
+        slot = i;
+    if (slot == ELF_PCACHE_NONE) {
+      slot = elf_pcache_victim(false);
+      if (slot == ELF_PCACHE_NONE)
+        return 0;
+      elf_pcache_drop(slot);
+    }
+
+    uint32_t phys = elf_alloc_frame();
+    if (!phys)
+      return 0;
+    uint8_t *dst = (uint8_t *)PHYS_TO_VIRT(phys);
+    int n = vfs_read_ra(img->node, &img->ra, (uint64_t)index * 4096, dst, 4096);
+    if (n < 0) {
+      pmm_free_block((void *)(uintptr_t)phys);
+      return 0;
+    }
+    if (n < 4096)
+      memset(dst + n, 0, 4096 - n);
+
+    p = &elf_pages[slot];
+    p->image = img;
+    p->index = index;
+    p->phys = phys;
+    p->maps = 0;
+    p->pinned = img->valid && index >= img->pin_first &&
+                index < img->pin_end && elf_pinned_total < ELF_PIN_MAX;
+    if (p->pinned)
+      elf_pinned_total++;
+    p->next_key = elf_key_head[key_hash(img, index)];
+    elf_key_head[key_hash(img, index)] = slot;
+    p->next_phys = elf_phys_head[phys_hash(phys)];
+    elf_phys_head[phys_hash(phys)] = slot;
+    img->pages++;
+  }
+  p->last_use = ++elf_pcache_clock;
+  if (map)
+    p->maps++;
+  return p->phys;
+}
+
+void elf_page_share(uint32_t phys) {
+  elf_page_t *p = elf_pcache_find_phys(phys & 0xFFFFF000);
+  if (p)
+    p->maps++;
+}
+
+void elf_page_put(uint32_t phys) {
+  elf_page_t *p = elf_pcache_find_phys(phys & 0xFFFFF000);
+  if (!p) {
+    serial_log_hex("ELF: put on unknown shared frame ", phys);
+    return;
+  }
+  if (p->maps)
+    p->maps--; // Frame cache mein rehta hai - agla spawn yahin se
+}
+
+/* ================= IMAGE TABLE ================= */
+static inline uintptr_t elf_node_dev(vfs_node_t *node) {
+  return node->fs ? (uintptr_t)node->fs : (uintptr_t)node->read;
+}
+
+static inline uint64_t elf_node_id(vfs_node_t *node) {
+  return node->inode ? node->inode : (uint64_t)(uintptr_t)node->impl;
+}
+
+static void elf_image_free(elf_image_t *img) {
+  for (int i = 0; i < ELF_PCACHE_MAX && img->pages; i++)
+    if (elf_pages[i].image == img)
+      elf_pcache_drop(i);
+  vfs_close(img->node);
+  img->node = nullptr;
+  img->valid = false;
+  img->path[0] = 0;
+}
+
+// File badli: naye exec ke liye image gayab. Jo chal rahe hain unke paas
+// purani rehti hai, aakhri mm release pe free.
+static void elf_image_stale(elf_image_t *img) {
+  serial_log("ELF: Cached image invalidated:");
+  serial_log(img->path);
+  img->valid = false;
+  for (int i = 0; i < ELF_PCACHE_MAX; i++)
+    if (elf_pages[i].image == img)
+      elf_page_unpin(&elf_pages[i]);
+  if (img->refs == 0)
+    elf_image_free(img);
+}
+
+// Exec fast path: sirf absolute path (cwd-relative naam ka matlab badalta hai)
+static elf_image_t *elf_image_lookup(const char *path) {
+  if (path[0] != '/')
+    return nullptr;
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (img->valid && strcmp(img->path, path) == 0)
+      return img;
+  }
+  return nullptr;
+}
+
+// Khaali slot, warna sabse purani image jo ab chal nahi rahi (refs == 0)
+static elf_image_t *elf_image_slot() {
+  elf_image_t *victim = nullptr;
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (!img->node)
+      return img;
+    if (img->refs == 0 && (!victim || img->last_use < victim->last_use))
+      victim = img;
+  }
+  if (victim)
+    elf_image_free(victim);
+  return victim;
+}
+
+// Node ki ownership image le leti hai (match mila toh node band). Doosre
+// path se wahi file (same identity + size) - purani image hi chalegi.
+static elf_image_t *elf_image_get(const char *path, vfs_node_t *node,
+                                  const elf_mm_t *mm, bool *fresh) {
+  *fresh = false;
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (img->valid && img->dev == elf_node_dev(node) &&
+        img->file_id == elf_node_id(node) && img->size == node->size) {
+      vfs_close(node);
+      return img;
+    }
+  }
+
+  elf_image_t *img = elf_image_slot();
+  if (!img)
+    return nullptr;
+  strncpy(img->path, path, sizeof(img->path) - 1);
+  img->path[sizeof(img->path) - 1] = 0;
+  img->dev = elf_node_dev(node);
+  img->file_id = elf_node_id(node);
+  img->size = node->size;
+  img->node = node;
+  img->valid = true;
+  img->refs = 0;
+  img->pages = 0;
+  memset(&img->ra, 0, sizeof(img->ra));
+  img->vma_count = mm->vma_count;
+  memcpy(img->vmas, mm->vmas, sizeof(img->vmas));
+  *fresh = true;
+  return img;
+}
+
+int elf_image_invalidate_node(vfs_node_t *node) {
+  if (!node)
+    return 0;
+  // Pehle poori table: busy mila toh kuch bhi stale mat karo
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (img->node && img->refs &&
+        (img->node == node || (img->dev == elf_node_dev(node) &&
+                               img->file_id == elf_node_id(node))))
+      return -ETXTBSY;
+  }
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (img->valid &&
+        (img->node == node || (img->dev == elf_node_dev(node) &&
+                               img->file_id == elf_node_id(node))))
+      elf_image_stale(img);
+  }
+  return 0;
+}
+
+static bool elf_name_eq(const char *a, const char *b) {
+  for (; *a && *b; a++, b++) {
+    char x = (*a >= 'a' && *a <= 'z') ? *a - 32 : *a;
+    char y = (*b >= 'a' && *b <= 'z') ? *b - 32 : *b;
+    if (x != y)
+      return false;
+  }
+  return *a == *b;
+}
+
+// Rename/unlink kabhi sirf naam dete hain (parent + name). FAT16 naam case
+// nahi dekhta, toh basename case-insensitive - galti se zyada invalidate
+// karna theek hai, kam nahi.
+void elf_image_invalidate_name(const char *path) {
+  if (!path)
+    return;
+  const char *base = strrchr(path, '/');
+  base = base ? base + 1 : path;
+  for (int i = 0; i < ELF_IMAGE_MAX; i++) {
+    elf_image_t *img = &elf_images[i];
+    if (!img->valid)
+      continue;
+    const char *ib = strrchr(img->path, '/');
+    ib = ib ? ib + 1 : img->path;
+    if (strcmp(img->path, path) == 0 || elf_name_eq(ib, base))
+      elf_image_stale(img);
+  }
+}
+
+/* ================= MM ================= */
+void elf_mm_init(elf_mm_t *mm) {
+  mm->image = nullptr;
+  mm->vma_count = 0;
+}
+
+void elf_mm_dup(elf_mm_t *dst, const elf_mm_t *src) {
+  *dst = *src;
+  if (dst->image)
+    dst->image->refs++;
+}
+
+void elf_mm_release(elf_mm_t *mm) {
+  elf_image_t *img = mm->image;
+  if (img && img->refs) {
+    img->refs--;
+    if (img->refs == 0 && !img->valid)
+      elf_image_free(img); // Stale image ka aakhri user
+  }
+  elf_mm_init(mm);
+}
+
+static void elf_mm_attach(elf_mm_t *mm, elf_image_t *img) {
+  mm->image = img;
+  mm->vma_count = img->vma_count;
+  memcpy(mm->vmas, img->vmas, sizeof(mm->vmas));
+  img->refs++;
+  img->last_use = ++elf_image_clock;
+}
+
+/* ================= LOADER ================= */
+// Text (read-only) ke file pages. Read-only PT_LOAD ho toh wahi; hamare apps
+// ek hi RWX segment mein link hote hain, tab section headers se .text/.rodata.
+static void elf_text_range(vfs_node_t *node, const Elf32_Ehdr *ehdr,
+                           const Elf32_Phdr *phdr, uint32_t *first,
+                           uint32_t *end) {
+  uint32_t lo = 0xFFFFFFFF, hi = 0;
+  for (int i = 0; i < ehdr->e_phnum; i++) {
+    if (phdr[i].p_type != PT_LOAD || (phdr[i].p_flags & PF_W) ||
+        !phdr[i].p_filesz)
+      continue;
+    if (phdr[i].p_offset < lo)
+      lo = phdr[i].p_offset;
+    if (phdr[i].p_offset + phdr[i].p_filesz > hi)
+      hi = phdr[i].p_offset + phdr[i].p_filesz;
+  }
+
+  if (lo >= hi && ehdr->e_shentsize == sizeof(Elf32_Shdr)) {
+    Elf32_Shdr sh[8];
+    for (uint32_t i = 0; i < ehdr->e_shnum; i += 8) {
+      uint32_t n = ehdr->e_shnum - i < 8 ? ehdr->e_shnum - i : 8;
+      uint32_t bytes = n * sizeof(Elf32_Shdr);
+      if (vfs_read(node, ehdr->e_shoff + i * sizeof(Elf32_Shdr), sh, bytes) !=
+          (int)bytes)
+        break;
+      for (uint32_t j = 0; j < n; j++) {
+        if ((sh[j].sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+            sh[j].sh_type == SHT_NOBITS || !sh[j].sh_size)
+          continue;
+        if (sh[j].sh_offset < lo)
+          lo = sh[j].sh_offset;
+        if (sh[j].sh_offset + sh[j].sh_size > hi)
+          hi = sh[j].sh_offset + sh[j].sh_size;
+      }
+    }
+  }
+
+  *first = *end = 0;
+  if (lo < hi && hi <= node->size) {
+    *first = lo >> 12;
+    *end = (hi + 0xFFF) >> 12;
+  }
+}
+
+uint32_t load_elf(const char *filename, uint32_t *top_address, elf_mm_t *mm) {
+  if (!elf_pcache_ready)
+    elf_pcache_init();
+  elf_mm_init(mm);
+
+  // Hot binary: parsed layout pehle se hai - na resolve, na disk
+  elf_image_t *img = elf_image_lookup(filename);
+  if (img) {
+    elf_mm_attach(mm, img);
+    if (top_address)
+      *top_address = img->top;
+    return img->entry;
+  }
 
-uint32_t load_elf(const char *filename, uint32_t *top_address) {
   serial_log("ELF: Loading file via VFS...");
   serial_log(filename);
 
@@ -19,85 +471,182 @@ uint32_t load_elf(const char *filename, uint32_t *top_address) {
     return 0;
   }
 
-  uint8_t *buffer = (uint8_t *)kmalloc(node->size + 512);
-  vfs_read(node, 0, buffer, node->size);
-
-  Elf32_Ehdr *ehdr = (Elf32_Ehdr *)buffer;
-
-  // Check karo ki Magic sahi hai ya nahi
-  if (memcmp(ehdr->e_ident, "\x7f\x45\x4c\x46", 4) != 0) {
+  // Sirf ELF header + program headers - baaki file fault pe
+  Elf32_Ehdr ehdr;
+  Elf32_Phdr phdr[ELF_MAX_PHDRS];
+  if (vfs_read(node, 0, &ehdr, sizeof(ehdr)) != (int)sizeof(ehdr) ||
+      memcmp(ehdr.e_ident, "\x7f\x45\x4c\x46", 4) != 0) {
     serial_log("ELF ERROR: Invalid Magic.");
-    kfree(buffer); // Achhi aadat
+    vfs_close(node);
+    return 0;
+  }
+  uint32_t ph_bytes = ehdr.e_phnum * sizeof(Elf32_Phdr);
+  if (ehdr.e_phnum > ELF_MAX_PHDRS ||
+      ehdr.e_phentsize != sizeof(Elf32_Phdr) ||
+      vfs_read(node, ehdr.e_phoff, phdr, ph_bytes) != (int)ph_bytes) {
+    serial_log("ELF ERROR: Bad program headers.");
+    vfs_close(node);
     return 0;
   }
 
-  serial_log("ELF: Valid Magic found.");
-  serial_log_hex("ELF: Entry Point: ", ehdr->e_entry);
-  uint32_t entry_point = ehdr->e_entry;
-
+  serial_log_hex("ELF: Entry Point: ", ehdr.e_entry);
   uint32_t max_addr = 0;
 
-  // Program Headers ko padho
-  Elf32_Phdr *phdr = (Elf32_Phdr *)(buffer + ehdr->e_phoff);
-  for (int i = 0; i < ehdr->e_phnum; i++) {
-    if (phdr[i].p_type == PT_LOAD) {
-      serial_log_hex("ELF: Loading segment at ", phdr[i].p_vaddr);
-      serial_log_hex("ELF: Segment size: ", phdr[i].p_memsz);
-
-      // Pages ka map hona zaroori hai!
-      // Ye user processes ke liye bahut important hai jahan shuru mein sab
-      // khali hota hai.
-      uint32_t start_addr = phdr[i].p_vaddr;
-      uint32_t end_addr = start_addr + phdr[i].p_memsz;
-
-      if (end_addr > max_addr) {
-        max_addr = end_addr;
-      }
+  for (int i = 0; i < ehdr.e_phnum; i++) {
+    if (phdr[i].p_type != PT_LOAD || phdr[i].p_memsz == 0)
+      continue;
+    uint32_t vaddr = phdr[i].p_vaddr;
+    uint32_t end = vaddr + phdr[i].p_memsz;
+    if (mm->vma_count == ELF_MM_MAX_VMAS || phdr[i].p_filesz > phdr[i].p_memsz ||
+        vaddr < ELF_USER_START || end > ELF_USER_END || end < vaddr ||
+        phdr[i].p_offset + phdr[i].p_filesz > node->size) {
+      serial_log("ELF ERROR: Bad segment.");
+      vfs_close(node);
+      return 0;
+    }
 
-      uint32_t start_page = start_addr & 0xFFFFF000;
-      uint32_t end_page = (end_addr + 0xFFF) & 0xFFFFF000;
-
-      // Map pages (Silent)
-      for (uint32_t page = start_page; page < end_page; page += 4096) {
-        if (vm_get_phys(page) == 0) {
-          void *phys = pmm_alloc_block();
-          if (!phys) {
-            serial_log("ELF ERROR: PMM allocation failed!");
-            kfree(buffer);
-            return 0;
-          }
-          vm_map_page((uint32_t)phys, page, 7);
-        }
-      }
+    elf_vma_t *v = &mm->vmas[mm->vma_count++];
+    v->start = vaddr & 0xFFFFF000;
+    v->end = (end + 0xFFF) & 0xFFFFF000;
+    v->vaddr = vaddr;
+    v->file_offset = phdr[i].p_offset;
+    v->file_end = vaddr + phdr[i].p_filesz;
+    v->writable = phdr[i].p_flags & PF_W;
+    serial_log_hex("ELF: Segment (lazy) at ", vaddr);
+    serial_log_hex("ELF: Segment size: ", phdr[i].p_memsz);
 
-      // Copy content
-      memcpy((void *)phdr[i].p_vaddr, buffer + phdr[i].p_offset,
-             phdr[i].p_filesz);
-
-      // Verify Entry Point Content
-      if (entry_point >= phdr[i].p_vaddr &&
-          entry_point < phdr[i].p_vaddr + phdr[i].p_memsz) {
-        uint8_t *code = (uint8_t *)entry_point;
-        serial_log("ELF: Code at Entry Point:");
-        serial_log_hex(" [0]: ", code[0]);
-        serial_log_hex(" [1]: ", code[1]);
-        serial_log_hex(" [2]: ", code[2]);
-        serial_log_hex(" [3]: ", code[3]);
-      }
+    if (end > max_addr)
+      max_addr = end;
+  }
 
-      // Zero BSS
-      if (phdr[i].p_memsz > phdr[i].p_filesz) {
-        memset((void *)(phdr[i].p_vaddr + phdr[i].p_filesz), 0,
-               phdr[i].p_memsz - phdr[i].p_filesz);
-      }
-    }
+  uint32_t pin_first, pin_end;
+  bool fresh;
+  elf_text_range(node, &ehdr, phdr, &pin_first, &pin_end);
+  img = elf_image_get(filename, node, mm, &fresh);
+  if (!img) {
+    serial_log("ELF ERROR: Image table full.");
+    vfs_close(node);
+    elf_mm_init(mm);
+    return 0;
   }
+  if (fresh) {
+    // Nayi image - baaki metadata bhi cache mein
+    img->pin_first = pin_first;
+    img->pin_end = pin_end;
+    img->entry = ehdr.e_entry;
+    img->top = (max_addr + 0xFFF) & 0xFFFFF000;
+  }
+  elf_mm_attach(mm, img);
 
   if (top_address) {
-    *top_address = (max_addr + 0xFFF) & 0xFFFFF000;
+    *top_address = img->top;
   }
 
-  kfree(buffer);
-  serial_log_hex("ELF: Returning entry point ", entry_point);
-  return entry_point;
+  serial_log_hex("ELF: Returning entry point ", img->entry);
+  return img->entry;
+}
+
+/* ================= FAULTS ================= */
+static elf_vma_t *elf_find_vma(elf_mm_t *mm, uint32_t page) {
+  for (int i = 0; i < mm->vma_count; i++)
+    if (page >= mm->vmas[i].start && page < mm->vmas[i].end)
+      return &mm->vmas[i];
+  return nullptr;
+}
+
+// Poora page isi segment ki file bytes se bhara hai aur file offset page
+// aligned hai - tabhi cache ka frame seedha map ho sakta hai
+static bool elf_page_shareable(elf_mm_t *mm, elf_vma_t *v, uint32_t page) {
+  if (page < v->vaddr || page + 4096 > v->file_end)
+    return false;
+  if ((v->vaddr - v->file_offset) & 0xFFF)
+    return false;
+  for (int i = 0; i < mm->vma_count; i++)
+    if (&mm->vmas[i] != v && page < mm->vmas[i].end &&
+        mm->vmas[i].start < page + 4096)
+      return false; // Do segments ek page mein
+  return true;
+}
+
+// Private page: zero, phir jo bhi segments is page mein file bytes rakhte
+// hain woh (segment ka sira, .data + .bss wala page, unaligned offset)
+static int elf_fill_private(elf_mm_t *mm, uint32_t page, uint8_t *dst) {
+  memset(dst, 0, 4096);
+  for (int i = 0; i < mm->vma_count; i++) {
+    elf_vma_t *v = &mm->vmas[i];
+    uint32_t from = page > v->vaddr ? page : v->vaddr;
+    uint32_t to = page + 4096 < v->file_end ? page + 4096 : v->file_end;
+    if (from >= to)
+      continue;
+    uint32_t len = to - from;
+    uint64_t off = v->file_offset + (from - v->vaddr);
+    if (vfs_read(mm->image->node, off, dst + (from - page), len) != (int)len)
+      return -1;
+  }
+  return 0;
+}
+
+static int elf_map_private(elf_mm_t *mm, elf_vma_t *v, uint32_t page,
+                           uint32_t src_phys) {
+  uint32_t phys = elf_alloc_frame();
+  if (!phys)
+    return 0;
+  uint8_t *dst = (uint8_t *)PHYS_TO_VIRT(phys);
+  if (src_phys) {
+    memcpy(dst, (void *)PHYS_TO_VIRT(src_phys), 4096);
+  } else if (elf_fill_private(mm, page, dst) < 0) {
+    serial_log_hex("ELF: Read failed for page ", page);
+    pmm_free_block((void *)(uintptr_t)phys);
+    return 0;
+  }
+  vm_map_page(phys, page, PTE_PRESENT | PTE_USER | (v->writable ? PTE_RW : 0));
+  return 1;
+}
+
+int elf_handle_fault(uint32_t addr, uint32_t err_code) {
+  if (!current_process || !current_process->exec_mm.image)
+    return 0;
+  elf_mm_t *mm = &current_process->exec_mm;
+  uint32_t page = addr & 0xFFFFF000;
+  elf_vma_t *v = elf_find_vma(mm, page);
+  if (!v)
+    return 0;
+
+  uint32_t *pte = vm_get_pte(page);
+  if (pte && (*pte & PTE_PRESENT)) {
+    // Copy-on-write: shared frame ki apni copy, cache wala frame wahin
+    if (!(err_code & PF_ERR_WRITE) || !(*pte & PTE_COW))
+      return 0;
+    uint32_t old = *pte & 0xFFFFF000;
+    if (!elf_map_private(mm, v, page, old))
+      return 0;
+    elf_page_put(old);
+    return 1;
+  }
+
+  if (page >= ((v->file_end + 0xFFF) & 0xFFFFF000)) {
+    // Pure BSS: demand-zero
+    uint32_t phys = elf_alloc_frame();
+    if (!phys)
+      return 0;
+    memset((void *)PHYS_TO_VIRT(phys), 0, 4096);
+    vm_map_page(phys, page, PTE_PRESENT | PTE_USER | (v->writable ? PTE_RW : 0));
+    return 1;
+  }
+
+  if (elf_page_shareable(mm, v, page)) {
+    uint32_t index = (v->file_offset + (page - v->vaddr)) >> 12;
+    bool write = (err_code & PF_ERR_WRITE) && v->writable;
+    uint32_t phys = elf_pcache_get(mm->image, index, !write);
+    if (phys && write)
+      return elf_map_private(mm, v, page, phys); // Seedha apni copy
+    if (phys) {
+      vm_map_page(phys, page,
+                  PTE_PRESENT | PTE_USER | PTE_SHARED |
+                      (v->writable ? PTE_COW : 0));
+      return 1;
+    }
+    // Cache bhara hai - neeche private copy
+  }
+  return elf_map_private(mm, v, page, 0);
 }
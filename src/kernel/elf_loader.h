@@ -5,6 +5,55 @@
 
 #include "../include/types.h"
 
-uint32_t load_elf(const char *filename, uint32_t *top_address);
+// ============================================================================
+// Demand-paged ELF: load_elf sirf headers padhta hai aur segments ko VMAs
+// mein likhta hai. Pages pehle access pe page fault se aate hain:
+//  - file-backed page: exec page cache ka frame, sab processes mein shared
+//    (read-only, refcounted). Writable segment ho toh copy-on-write.
+//  - BSS: demand-zero private page.
+// Parsed images (VMAs + entry) cache mein rehte hain: same binary ka agla
+// exec na path resolve karta hai, na headers padhta hai. Text ke pages
+// cache mein pinned rehte hain jab tak file badle nahi.
+// ============================================================================
+#define ELF_MM_MAX_VMAS 4
+
+struct elf_image;
+struct vfs_node;
+
+typedef struct elf_vma {
+  uint32_t start, end;   // Page aligned [start, end)
+  uint32_t vaddr;        // Segment ka p_vaddr
+  uint32_t file_offset;  // p_offset
+  uint32_t file_end;     // vaddr + p_filesz - isse aage sab zero
+  uint32_t writable;     // PF_W
+} elf_vma_t;
+
+typedef struct elf_mm {
+  struct elf_image *image; // nullptr = kernel thread / koi ELF nahi
+  int vma_count;
+  elf_vma_t vmas[ELF_MM_MAX_VMAS];
+} elf_mm_t;
+
+// Current page directory mein mm ke segments tayyar karo. 0 = fail.
+uint32_t load_elf(const char *filename, uint32_t *top_address, elf_mm_t *mm);
+
+void elf_mm_init(elf_mm_t *mm);
+void elf_mm_dup(elf_mm_t *dst, const elf_mm_t *src); // fork
+void elf_mm_release(elf_mm_t *mm); // exec/reap - PTEs pehle hat chuke hon
+
+// Page fault (current_process ke mm mein). 1 = handle ho gaya.
+int elf_handle_fault(uint32_t addr, uint32_t err_code);
+
+// PTE_SHARED frames ka hisaab (vm.cpp: clone/unmap/destroy)
+void elf_page_share(uint32_t phys);
+void elf_page_put(uint32_t phys);
+
+// File ka content badalne wala hai (write/truncate/unlink/rename target).
+// Koi process is binary ko chala raha hai toh -ETXTBSY - uske pages abhi bhi
+// fault pe isi file se aate hain. Warna cached image stale, return 0.
+int elf_image_invalidate_node(struct vfs_node *node);
+// Sirf naam badla (rename source) - content wahi, toh chal rahe processes
+// pe asar nahi; naya exec dobara parse karega
+void elf_image_invalidate_name(const char *path); // Poora path ya sirf naam
 
 #endif
@@ -0,0 +1,433 @@
+// ============================================================================
+// epoll.cpp - Scalable readiness notification
+// Har watched fd ka ek epitem hota hai jo driver ki wait queues pe callback
+// entry lagata hai (poll_wait ke through). Driver wake_up kare toh item ready
+// list mein aa jaata hai; epoll_wait sirf ready list dekhta hai, isliye kaam
+// O(ready events) hai aur idle mein CPU zero.
+// ============================================================================
+
+#include "../drivers/serial.h"
+#include "../include/epoll.h"
+#include "../include/errno.h"
+#include "../include/poll.h"
+#include "../include/string.h"
+#include "../include/vfs.h"
+#include "heap.h"
+#include "memory.h"
+#include "process.h"
+#include "wait_queue.h"
+
+#define EP_HASH_SIZE 32      // Per-instance (fd, node) lookup
+#define EP_NODE_HASH_SIZE 64 // Global node -> items (close pe cleanup)
+#define EP_MAX_WAITQ 2       // Socket: rx_wait + tx_wait
+#define EP_PRIVATE_BITS (EPOLLET | EPOLLONESHOT)
+
+struct eventpoll;
+
+typedef struct ep_waiter {
+  wait_queue_entry_t entry;
+  wait_queue_t *wq;
+} ep_waiter_t;
+
+typedef struct epitem {
+  struct eventpoll *ep;
+  int fd;
+  vfs_node_t *node;
+  uint32_t events; // Requested mask (EPOLLET/EPOLLONESHOT bhi)
+  uint64_t data;
+  ep_waiter_t waiters[EP_MAX_WAITQ];
+  int nwait;
+  int on_ready;
+  struct epitem *ready_next;
+  struct epitem *hash_next; // ep->hash chain
+  struct epitem *node_next; // ep_node_hash chain
+} epitem_t;
+
+typedef struct eventpoll {
+  epitem_t *hash[EP_HASH_SIZE];
+  epitem_t *ready_head;
+  epitem_t *ready_tail;
+  volatile int nready;
+  wait_queue_t wq; // epoll_wait sleepers + nested epoll watchers
+} eventpoll_t;
+
+// poll op ko yeh milta hai; qproc isse item nikaal leta hai
+typedef struct ep_pqueue {
+  poll_table_t pt;
+  epitem_t *item;
+} ep_pqueue_t;
+
+static epitem_t *ep_node_hash[EP_NODE_HASH_SIZE];
+
+extern "C" {
+
+static inline uint32_t ep_hash_fd(int fd) {
+  return (uint32_t)fd % EP_HASH_SIZE;
+}
+
+static inline uint32_t ep_hash_node(vfs_node_t *node) {
+  return ((uint32_t)(uintptr_t)node >> 4) % EP_NODE_HASH_SIZE;
+}
+
+// ============================================================================
+// Ready list
+// ============================================================================
+// Interrupts band hone chahiye (callbacks wake_up ke andar se aate hain)
+static void ep_ready_append(eventpoll_t *ep, epitem_t *item) {
+  item->on_ready = 1;
+  item->ready_next = 0;
+  if (ep->ready_tail)
+    ep->ready_tail->ready_next = item;
+  else
+    ep->ready_head = item;
+  ep->ready_tail = item;
+  ep->nready = ep->nready + 1;
+}
+
+static epitem_t *ep_ready_pop(eventpoll_t *ep) {
+  uint32_t flags = irq_save();
+  epitem_t *item = ep->ready_head;
+  if (item) {
+    ep->ready_head = item->ready_next;
+    if (!ep->ready_head)
+      ep->ready_tail = 0;
+    item->on_ready = 0;
+    item->ready_next = 0;
+    ep->nready = ep->nready - 1;
+  }
+  irq_restore(flags);
+  return item;
+}
+
+static void ep_ready_remove(eventpoll_t *ep, epitem_t *item) {
+  uint32_t flags = irq_save();
+  if (item->on_ready) {
+    epitem_t *prev = 0;
+    for (epitem_t *it = ep->ready_head; it; prev = it, it = it->ready_next) {
+      if (it != item)
+        continue;
+      if (prev)
+        prev->ready_next = it->ready_next;
+      else
+        ep->ready_head = it->ready_next;
+      if (ep->ready_tail == it)
+        ep->ready_tail = prev;
+      ep->nready = ep->nready - 1;
+      break;
+    }
+    item->on_ready = 0;
+  }
+  irq_restore(flags);
+}
+
+// Item ko ready list mein daalo (agar pehle se nahi hai) aur waiters jagao
+static void ep_mark_ready(epitem_t *item) {
+  eventpoll_t *ep = item->ep;
+  uint32_t flags = irq_save();
+  int queued = 0;
+  if (!item->on_ready && (item->events & ~EP_PRIVATE_BITS)) {
+    ep_ready_append(ep, item);
+    queued = 1;
+  }
+  irq_restore(flags);
+  // Sirf naya queue hone pe jagao - nested epoll cycles yahin ruk jaate hain
+  if (queued)
+    wake_up_all(&ep->wq);
+}
+
+// ============================================================================
+// Wait queue callbacks
+// ============================================================================
+static void ep_poll_callback(wait_queue_entry_t *entry) {
+  ep_mark_ready((epitem_t *)entry->priv);
+}
+
+static void ep_ptable_queue_proc(poll_table_t *pt, wait_queue_t *wq) {
+  epitem_t *item = ((ep_pqueue_t *)pt)->item;
+  if (item->nwait >= EP_MAX_WAITQ) {
+    serial_log("EPOLL: Too many wait queues for one fd, ignoring extra");
+    return;
+  }
+  ep_waiter_t *w = &item->waiters[item->nwait++];
+  w->wq = wq;
+  w->entry.proc = 0;
+  w->entry.next = 0;
+  w->entry.func = ep_poll_callback;
+  w->entry.priv = item;
+  add_wait_queue(wq, &w->entry);
+}
+
+static void ep_wake_waiter(wait_queue_entry_t *entry) {
+  wake_up_process((process_t *)entry->priv);
+}
+
+static int ep_item_poll(epitem_t *item, poll_table_t *pt) {
+  return item->node->poll(item->node, pt) &
+         (item->events | EPOLLERR | EPOLLHUP);
+}
+
+// ============================================================================
+// Item bookkeeping
+// ============================================================================
+static epitem_t *ep_find(eventpoll_t *ep, int fd, vfs_node_t *node) {
+  for (epitem_t *it = ep->hash[ep_hash_fd(fd)]; it; it = it->hash_next) {
+    if (it->fd == fd && it->node == node)
+      return it;
+  }
+  return 0;
+}
+
+static void ep_unregister(eventpoll_t *ep, epitem_t *item) {
+  for (int i = 0; i < item->nwait; i++)
+    remove_wait_queue(item->waiters[i].wq, &item->waiters[i].entry);
+  item->nwait = 0;
+  ep_ready_remove(ep, item);
+
+  epitem_t **pp = &ep->hash[ep_hash_fd(item->fd)];
+  while (*pp && *pp != item)
+    pp = &(*pp)->hash_next;
+  if (*pp)
+    *pp = item->hash_next;
+
+  pp = &ep_node_hash[ep_hash_node(item->node)];
+  while (*pp && *pp != item)
+    pp = &(*pp)->node_next;
+  if (*pp)
+    *pp = item->node_next;
+
+  kfree(item);
+}
+
+void epoll_node_release(vfs_node_t *node) {
+  if (!node)
+    return;
+  epitem_t *it = ep_node_hash[ep_hash_node(node)];
+  while (it) {
+    epitem_t *next = it->node_next;
+    if (it->node == node)
+      ep_unregister(it->ep, it);
+    it = next;
+  }
+}
+
+// ============================================================================
+// The epoll fd itself
+// ============================================================================
+static int ep_node_poll(vfs_node_t *node, poll_table_t *pt) {
+  eventpoll_t *ep = (eventpoll_t *)node->impl;
+  poll_wait(&ep->wq, pt);
+  return ep->nready ? (POLLIN | POLLRDNORM) : 0;
+}
+
+static void ep_node_close(vfs_node_t *node) {
+  eventpoll_t *ep = (eventpoll_t *)node->impl;
+  if (!ep)
+    return;
+  for (int i = 0; i < EP_HASH_SIZE; i++) {
+    while (ep->hash[i])
+      ep_unregister(ep, ep->hash[i]);
+  }
+  node->impl = 0;
+  kfree(ep);
+}
+
+static vfs_node_t *ep_fd_node(int fd) {
+  file_description_t *desc = fd_get(fd);
+  return desc ? desc->node : 0;
+}
+
+static eventpoll_t *ep_from_fd(int epfd, int *err) {
+  vfs_node_t *node = ep_fd_node(epfd);
+  if (!node) {
+    *err = -EBADF;
+    return 0;
+  }
+  if (node->poll != ep_node_poll || !node->impl) {
+    *err = -EINVAL;
+    return 0;
+  }
+  return (eventpoll_t *)node->impl;
+}
+
+// ============================================================================
+// epoll_create1
+// ============================================================================
+int epoll_create1(int flags) {
+  if (flags & ~EPOLL_CLOEXEC)
+    return -EINVAL;
+
+  eventpoll_t *ep = (eventpoll_t *)kmalloc(sizeof(eventpoll_t));
+  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  file_description_t *desc = node ? fd_desc_alloc(node, O_RDONLY) : 0;
+  if (!ep || !node || !desc) {
+    if (ep)
+      kfree(ep);
+    if (node)
+      kfree(node);
+    if (desc)
+      kfree(desc);
+    return -ENOMEM;
+  }
+
+  memset(ep, 0, sizeof(eventpoll_t));
+  wait_queue_init(&ep->wq);
+
+  memset(node, 0, sizeof(vfs_node_t));
+  strcpy(node->name, "epoll");
+  node->flags = VFS_DEVICE;
+  node->impl = ep;
+  node->poll = ep_node_poll;
+  node->close = ep_node_close;
+  node->ref_count = 1;
+
+  int fd = fd_alloc(desc, 0, (flags & EPOLL_CLOEXEC) != 0);
+  if (fd < 0) {
+    kfree(desc);
+    kfree(node);
+    kfree(ep);
+  }
+  return fd;
+}
+
+// ============================================================================
+// epoll_ctl
+// ============================================================================
+int epoll_ctl(int epfd, int op, int fd, struct epoll_event *event) {
+  int err = 0;
+  eventpoll_t *ep = ep_from_fd(epfd, &err);
+  if (!ep)
+    return err;
+
+  vfs_node_t *node = ep_fd_node(fd);
+  if (!node)
+    return -EBADF;
+  if (node->impl == ep)
+    return -EINVAL; // Khud ko watch nahi kar sakte
+  if (!node->poll)
+    return -EPERM; // Regular files hamesha ready hain, epoll unhe nahi leta
+  if (op != EPOLL_CTL_DEL && !event)
+    return -EFAULT;
+
+  epitem_t *item = ep_find(ep, fd, node);
+
+  switch (op) {
+  case EPOLL_CTL_ADD: {
+    if (item)
+      return -EEXIST;
+    item = (epitem_t *)kmalloc(sizeof(epitem_t));
+    if (!item)
+      return -ENOMEM;
+    memset(item, 0, sizeof(epitem_t));
+    item->ep = ep;
+    item->fd = fd;
+    item->node = node;
+    item->events = event->events | EPOLLERR | EPOLLHUP;
+    item->data = event->data.u64;
+
+    uint32_t h = ep_hash_fd(fd);
+    item->hash_next = ep->hash[h];
+    ep->hash[h] = item;
+    uint32_t nh = ep_hash_node(node);
+    item->node_next = ep_node_hash[nh];
+    ep_node_hash[nh] = item;
+
+    // Pehla poll driver ki wait queues pe hamari entries laga deta hai
+    ep_pqueue_t pq;
+    pq.pt.qproc = ep_ptable_queue_proc;
+    pq.item = item;
+    if (ep_item_poll(item, &pq.pt))
+      ep_mark_ready(item);
+    return 0;
+  }
+  case EPOLL_CTL_MOD:
+    if (!item)
+      return -ENOENT;
+    item->events = event->events | EPOLLERR | EPOLLHUP;
+    item->data = event->data.u64;
+    // ONESHOT re-arm ya naya mask - jo abhi ready hai woh turant dikhe
+    if (ep_item_poll(item, 0))
+      ep_mark_ready(item);
+    return 0;
+  case EPOLL_CTL_DEL:
+    if (!item)
+      return -ENOENT;
+    ep_unregister(ep, item);
+    return 0;
+  default:
+    return -EINVAL;
+  }
+}
+
+// ============================================================================
+// epoll_wait
+// ============================================================================
+// Ready list se events nikalo. Har item ko dobara poll karte hain kyunki
+// callback sirf "kuch badla" batata hai; level-triggered items wapas list ke
+// end mein jaate hain taaki agli baar phir check ho.
+static int ep_send_events(eventpoll_t *ep, struct epoll_event *events,
+                          int maxevents) {
+  int count = 0;
+  int budget = ep->nready; // LT requeue wale isi call mein dobara na aayein
+
+  while (count < maxevents && budget-- > 0) {
+    epitem_t *item = ep_ready_pop(ep);
+    if (!item)
+      break;
+
+    int revents = ep_item_poll(item, 0);
+    if (!revents)
+      continue; // Ab ready nahi raha; agla wake_up phir daalega
+
+    events[count].events = (uint32_t)revents;
+    events[count].data.u64 = item->data;
+    count++;
+
+    if (item->events & EPOLLONESHOT) {
+      item->events &= EP_PRIVATE_BITS; // MOD se re-arm hone tak disabled
+    } else if (!(item->events & EPOLLET)) {
+      uint32_t flags = irq_save();
+      if (!item->on_ready)
+        ep_ready_append(ep, item);
+      irq_restore(flags);
+    }
+  }
+  return count;
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout) {
+  if (maxevents <= 0)
+    return -EINVAL;
+  if (!events)
+    return -EFAULT;
+
+  int err = 0;
+  eventpoll_t *ep = ep_from_fd(epfd, &err);
+  if (!ep)
+    return err;
+
+  int count = ep_send_events(ep, events, maxevents);
+  if (count > 0 || timeout == 0)
+    return count;
+
+  uint32_t deadline = timeout_to_deadline(timeout);
+
+  wait_queue_entry_t self;
+  self.proc = current_process;
+  self.next = 0;
+  self.func = ep_wake_waiter;
+  self.priv = current_process;
+  add_wait_queue(&ep->wq, &self);
+
+  for (;;) {
+    int alive = schedule_timeout(deadline, &ep->nready);
+    count = ep_send_events(ep, events, maxevents);
+    if (count > 0 || !alive)
+      break;
+  }
+
+  remove_wait_queue(&ep->wq, &self);
+  return count;
+}
+
+} // extern "C"
@@ -0,0 +1,363 @@
+// fd_table.cpp - Growable per-process file descriptor table
+#include "fd_table.h"
+#include "../drivers/serial.h"
+#include "../include/epoll.h"
+#include "../include/errno.h"
+#include "../include/string.h"
+#include "heap.h"
+#include "memory.h"
+#include "process.h"
+
+extern "C" {
+
+static inline uint32_t fd_words(uint32_t nfds) { return (nfds + 31) / 32; }
+
+static inline int first_zero_bit(uint32_t word) {
+  return __builtin_ctz(~word); // Caller ensure karta hai word != ~0
+}
+
+// ============================================================================
+// Bitmap helpers
+// ============================================================================
+static void fd_mark_open(files_struct_t *f, uint32_t fd, int cloexec) {
+  uint32_t w = fd / 32;
+  uint32_t bit = 1u << (fd % 32);
+  f->open_fds[w] |= bit;
+  if (f->open_fds[w] == 0xFFFFFFFF)
+    f->full_words[w / 32] |= 1u << (w % 32);
+  if (cloexec)
+    f->close_on_exec[w] |= bit;
+  else
+    f->close_on_exec[w] &= ~bit;
+}
+
+static void fd_mark_free(files_struct_t *f, uint32_t fd) {
+  uint32_t w = fd / 32;
+  uint32_t bit = 1u << (fd % 32);
+  f->open_fds[w] &= ~bit;
+  f->close_on_exec[w] &= ~bit;
+  f->full_words[w / 32] &= ~(1u << (w % 32));
+  if (fd < f->next_fd)
+    f->next_fd = fd;
+}
+
+// start se lowest free fd; table mein jagah na ho toh -1
+static int fd_find_free(files_struct_t *f, uint32_t start) {
+  uint32_t nwords = f->max_fds / 32;
+  uint32_t w = start / 32;
+  if (w >= nwords)
+    return -1;
+
+  // Pehla (adhoora) word - start se neeche wale bits ko bhara maano
+  uint32_t bits = f->open_fds[w] | ((1u << (start % 32)) - 1);
+  if (bits != 0xFFFFFFFF)
+    return (int)(w * 32 + first_zero_bit(bits));
+  w++;
+
+  // Baaki: full_words se poore bhare words ek saath skip
+  while (w < nwords) {
+    uint32_t full = f->full_words[w / 32] | ((1u << (w % 32)) - 1);
+    if (full == 0xFFFFFFFF) {
+      w = (w / 32 + 1) * 32;
+      continue;
+    }
+    w = (w / 32) * 32 + first_zero_bit(full);
+    if (w >= nwords)
+      break;
+    return (int)(w * 32 + first_zero_bit(f->open_fds[w]));
+  }
+  return -1;
+}
+
+static int files_resize(files_struct_t *f, uint32_t new_max) {
+  new_max = (new_max + 31) & ~31u;
+  if (new_max <= f->max_fds)
+    return 0;
+
+  uint32_t words = fd_words(new_max);
+  uint32_t full_words = fd_words(words);
+  file_description_t **fd =
+      (file_description_t **)kmalloc(new_max * sizeof(file_description_t *));
+  uint32_t *open_fds = (uint32_t *)kmalloc(words * 4);
+  uint32_t *cloexec = (uint32_t *)kmalloc(words * 4);
+  uint32_t *full = (uint32_t *)kmalloc(full_words * 4);
+  if (!fd || !open_fds || !cloexec || !full) {
+    if (fd)
+      kfree(fd);
+    if (open_fds)
+      kfree(open_fds);
+    if (cloexec)
+      kfree(cloexec);
+    if (full)
+      kfree(full);
+    return -ENOMEM;
+  }
+
+  memset(fd, 0, new_max * sizeof(file_description_t *));
+  memset(open_fds, 0, words * 4);
+  memset(cloexec, 0, words * 4);
+  memset(full, 0, full_words * 4);
+
+  if (f->max_fds) {
+    uint32_t old_words = fd_words(f->max_fds);
+    memcpy(fd, f->fd, f->max_fds * sizeof(file_description_t *));
+    memcpy(open_fds, f->open_fds, old_words * 4);
+    memcpy(cloexec, f->close_on_exec, old_words * 4);
+    memcpy(full, f->full_words, fd_words(old_words) * 4);
+    kfree(f->fd);
+    kfree(f->open_fds);
+    kfree(f->close_on_exec);
+    kfree(f->full_words);
+  }
+
+  f->fd = fd;
+  f->open_fds = open_fds;
+  f->close_on_exec = cloexec;
+  f->full_words = full;
+  f->max_fds = new_max;
+  return 0;
+}
+
+// fd tak table badhao - har baar double, taaki grow amortized O(1) rahe
+static int files_expand(files_struct_t *f, uint32_t fd) {
+  if (fd < f->max_fds)
+    return 0;
+  uint32_t new_max = f->max_fds ? f->max_fds : FD_TABLE_INIT_SIZE;
+  while (new_max <= fd)
+    new_max *= 2;
+  if (new_max > NR_OPEN_MAX)
+    new_max = NR_OPEN_MAX;
+  return files_resize(f, new_max);
+}
+
+// ============================================================================
+// Open file descriptions
+// ============================================================================
+file_description_t *fd_desc_alloc(vfs_node_t *node, uint32_t flags) {
+  file_description_t *desc =
+      (file_description_t *)kmalloc(sizeof(file_description_t));
+  if (!desc)
+    return 0;
+  desc->node = node;
+  desc->offset = 0;
+  desc->flags = flags;
+  desc->ref_count = 1;
+  memset(&desc->ra, 0, sizeof(desc->ra));
+  return desc;
+}
+
+void fd_desc_put(file_description_t *desc) {
+  if (!desc)
+    return;
+  desc->ref_count--;
+  if (desc->ref_count == 0) {
+    epoll_node_release(desc->node);
+    if (desc->node && desc->node->close)
+      desc->node->close(desc->node);
+    kfree(desc);
+  }
+}
+
+// ============================================================================
+// Table lifecycle
+// ============================================================================
+files_struct_t *files_alloc() {
+  files_struct_t *f = (files_struct_t *)kmalloc(sizeof(files_struct_t));
+  if (!f)
+    return 0;
+  memset(f, 0, sizeof(files_struct_t));
+  f->count = 1;
+  if (files_resize(f, FD_TABLE_INIT_SIZE) < 0) {
+    kfree(f);
+    return 0;
+  }
+  return f;
+}
+
+files_struct_t *files_dup(files_struct_t *src) {
+  files_struct_t *f = files_alloc();
+  if (!f || !src)
+    return f;
+  if (files_resize(f, src->max_fds) < 0) {
+    files_put(f);
+    return 0;
+  }
+
+  uint32_t words = fd_words(src->max_fds);
+  memcpy(f->open_fds, src->open_fds, words * 4);
+  memcpy(f->close_on_exec, src->close_on_exec, words * 4);
+  memcpy(f->full_words, src->full_words, fd_words(words) * 4);
+  for (uint32_t i = 0; i < src->max_fds; i++) {
+    f->fd[i] = src->fd[i];
+    if (f->fd[i])
+      f->fd[i]->ref_count++;
+  }
+  f->next_fd = src->next_fd;
+  return f;
+}
+
+void files_share(files_struct_t *files) {
+  if (files)
+    files->count++;
+}
+
+static void files_close_fd(files_struct_t *f, uint32_t fd) {
+  file_description_t *desc = f->fd[fd];
+  f->fd[fd] = 0;
+  fd_mark_free(f, fd);
+  fd_desc_put(desc);
+}
+
+void files_put(files_struct_t *files) {
+  if (!files || --files->count > 0)
+    return;
+
+  for (uint32_t w = 0; w < fd_words(files->max_fds); w++) {
+    while (files->open_fds[w])
+      files_close_fd(files, w * 32 + __builtin_ctz(files->open_fds[w]));
+  }
+  kfree(files->fd);
+  kfree(files->open_fds);
+  kfree(files->close_on_exec);
+  kfree(files->full_words);
+  kfree(files);
+}
+
+void files_close_on_exec(files_struct_t *files) {
+  if (!files)
+    return;
+  for (uint32_t w = 0; w < fd_words(files->max_fds); w++) {
+    while (files->close_on_exec[w])
+      files_close_fd(files, w * 32 + __builtin_ctz(files->close_on_exec[w]));
+  }
+}
+
+// ============================================================================
+// current_process ke fds
+// ============================================================================
+// Kernel threads (window server, net) ka table pehli zaroorat pe banta hai
+static files_struct_t *current_files() {
+  if (!current_process)
+    return 0;
+  if (!current_process->files)
+    current_process->files = files_alloc();
+  return current_process->files;
+}
+
+uint32_t fd_limit() {
+  if (!current_process || !current_process->nofile_cur)
+    return NR_OPEN_DEFAULT;
+  return current_process->nofile_cur;
+}
+
+file_description_t *fd_get(int fd) {
+  if (!current_process)
+    return 0;
+  return files_get(current_process->files, fd);
+}
+
+int fd_alloc(file_description_t *desc, int min_fd, int cloexec) {
+  files_struct_t *f = current_files();
+  if (!f || !desc)
+    return -ENOMEM;
+  if (min_fd < 0)
+    return -EINVAL;
+
+  uint32_t limit = fd_limit();
+  uint32_t start = (uint32_t)min_fd > f->next_fd ? (uint32_t)min_fd : f->next_fd;
+  if (start >= limit)
+    return -EMFILE;
+
+  int found = fd_find_free(f, start);
+  uint32_t fd = found >= 0 ? (uint32_t)found
+                           : (start > f->max_fds ? start : f->max_fds);
+  if (fd >= limit)
+    return -EMFILE;
+  if (files_expand(f, fd) < 0)
+    return -ENOMEM;
+
+  f->fd[fd] = desc;
+  fd_mark_open(f, fd, cloexec);
+  if (start == f->next_fd)
+    f->next_fd = fd + 1;
+  return (int)fd;
+}
+
+int files_install_at(files_struct_t *f, int fd, file_description_t *desc,
+                     int cloexec) {
+  if (!f || !desc)
+    return -ENOMEM;
+  if (fd < 0 || fd >= NR_OPEN_MAX)
+    return -EBADF;
+  if (files_expand(f, (uint32_t)fd) < 0)
+    return -ENOMEM;
+
+  file_description_t *old = f->fd[fd];
+  f->fd[fd] = desc;
+  fd_mark_open(f, (uint32_t)fd, cloexec);
+  if (f->next_fd == (uint32_t)fd)
+    f->next_fd = fd + 1;
+  fd_desc_put(old);
+  return fd;
+}
+
+file_description_t *files_get(files_struct_t *f, int fd) {
+  if (!f || fd < 0 || (uint32_t)fd >= f->max_fds)
+    return 0;
+  return f->fd[fd];
+}
+
+int files_close_at(files_struct_t *f, int fd) {
+  if (!files_get(f, fd))
+    return -EBADF;
+  files_close_fd(f, (uint32_t)fd);
+  return 0;
+}
+
+int files_set_cloexec(files_struct_t *f, int fd, int on) {
+  if (!files_get(f, fd))
+    return -EBADF;
+  if (on)
+    f->close_on_exec[fd / 32] |= 1u << (fd % 32);
+  else
+    f->close_on_exec[fd / 32] &= ~(1u << (fd % 32));
+  return 0;
+}
+
+int fd_install_at(int fd, file_description_t *desc, int cloexec) {
+  if (fd < 0 || (uint32_t)fd >= fd_limit())
+    return -EBADF;
+  return files_install_at(current_files(), fd, desc, cloexec);
+}
+
+file_description_t *fd_detach(int fd) {
+  file_description_t *desc = fd_get(fd);
+  if (!desc)
+    return 0;
+  current_process->files->fd[fd] = 0;
+  fd_mark_free(current_process->files, (uint32_t)fd);
+  return desc;
+}
+
+int fd_close(int fd) {
+  file_description_t *desc = fd_detach(fd);
+  if (!desc)
+    return -EBADF;
+  fd_desc_put(desc);
+  return 0;
+}
+
+int fd_get_cloexec(int fd) {
+  if (!fd_get(fd))
+    return -EBADF;
+  uint32_t *bits = current_process->files->close_on_exec;
+  return (bits[fd / 32] >> (fd % 32)) & 1;
+}
+
+int fd_set_cloexec(int fd, int on) {
+  if (!current_process)
+    return -EBADF;
+  return files_set_cloexec(current_process->files, fd, on);
+}
+
+} // extern "C"
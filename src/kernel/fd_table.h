@@ -0,0 +1,72 @@
+// fd_table.h - Per-process file descriptor table
+// Table heap pe hota hai aur zaroorat ke hisaab se badhta hai (RLIMIT_NOFILE
+// tak). Free fd dhoondhne ke liye do-level bitmap: open_fds mein har fd ka ek
+// bit, full_words mein har bhare hue 32-fd word ka ek bit.
+#ifndef FD_TABLE_H
+#define FD_TABLE_H
+
+#include "../include/types.h"
+#include "../include/vfs.h"
+
+#define FD_TABLE_INIT_SIZE 32 // Pehli allocation (bitmap ka ek word)
+#define NR_OPEN_DEFAULT 1024  // RLIMIT_NOFILE soft default
+#define NR_OPEN_MAX 65536     // RLIMIT_NOFILE hard cap
+
+typedef struct file_description {
+  vfs_node_t *node;   // The actual VFS node
+  uint64_t offset;    // Current seek position (cursor)
+  uint32_t flags;     // Open flags (O_RDONLY, etc)
+  uint32_t ref_count; // Reference count for fork/dup
+  file_ra_state_t ra; // Sequential read-ahead (read/readv)
+} file_description_t;
+
+typedef struct files_struct {
+  uint32_t count;           // Kitne tasks is table ko share karte hain
+  uint32_t max_fds;         // fd[] ki capacity (32 ka multiple)
+  uint32_t next_fd;         // Isse neeche koi free fd nahi hai
+  file_description_t **fd;  // fd -> open file description
+  uint32_t *open_fds;       // 1 bit per fd
+  uint32_t *close_on_exec;  // FD_CLOEXEC, 1 bit per fd
+  uint32_t *full_words;     // 1 bit per open_fds word jo poora bhara hai
+} files_struct_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Table lifecycle
+files_struct_t *files_alloc();
+files_struct_t *files_dup(files_struct_t *src); // fork: copy, desc ref++
+void files_share(files_struct_t *files);        // Threads: count++
+void files_put(files_struct_t *files);          // Last ref closes all fds
+void files_close_on_exec(files_struct_t *files);
+int files_install_at(files_struct_t *files, int fd, file_description_t *desc,
+                     int cloexec);
+// Kisi aur ke table pe (posix_spawn file actions - child abhi chala nahi)
+file_description_t *files_get(files_struct_t *files, int fd);
+int files_close_at(files_struct_t *files, int fd);
+int files_set_cloexec(files_struct_t *files, int fd, int on);
+
+// Open file descriptions
+file_description_t *fd_desc_alloc(vfs_node_t *node, uint32_t flags);
+void fd_desc_put(file_description_t *desc); // ref_count--, last one closes
+
+// current_process ke table pe kaam karte hain
+file_description_t *fd_get(int fd);
+// Lowest free fd >= min_fd; -EMFILE jab RLIMIT_NOFILE tak bhar gaya
+int fd_alloc(file_description_t *desc, int min_fd, int cloexec);
+// dup2 style: fd pe jo khula ho use band karke desc lagao
+int fd_install_at(int fd, file_description_t *desc, int cloexec);
+// Table se hatao (desc ka ref nahi chhoda jaata)
+file_description_t *fd_detach(int fd);
+int fd_close(int fd);
+int fd_get_cloexec(int fd);
+int fd_set_cloexec(int fd, int on);
+// RLIMIT_NOFILE badle toh allocation limit ke liye
+uint32_t fd_limit();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FD_TABLE_H
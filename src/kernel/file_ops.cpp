@@ -27,10 +27,10 @@ ssize_t sys_pread(int fd, void *buf, size_t count, off_t offset) {
   if (!buf)
     return -EFAULT;
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   return (ssize_t)vfs_read(desc->node, (uint64_t)offset, buf, (uint64_t)count);
 }
 
@@ -42,10 +42,10 @@ ssize_t sys_pwrite(int fd, const void *buf, size_t count, off_t offset) {
   if (!buf)
     return -EFAULT;
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   return (ssize_t)vfs_write(desc->node, (uint64_t)offset, buf, (uint64_t)count);
 }
 
@@ -54,10 +54,10 @@ ssize_t sys_pwrite(int fd, const void *buf, size_t count, off_t offset) {
 // ============================================================================
 
 off_t sys_lseek(int fd, off_t offset, int whence) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   uint32_t new_pos;
 
   switch (whence) {
@@ -94,11 +94,17 @@ int sys_truncate(const char *path, off_t length) {
   if (!node)
     return -ENOENT;
 
-  // Update file length (simplified - actual implementation would need
-  // filesystem support)
-  if ((node->flags & 0x7) != VFS_FILE)
+  if (node->type == VFS_DIRECTORY)
     return -EISDIR;
+  if (length < 0)
+    return -EINVAL;
 
+  int busy = elf_image_invalidate_node(node); // Chalti binary
+  if (busy < 0)
+    return busy;
+  // FS truncate de toh woh pages chhodega / sparse extend karega
+  if (node->fs && node->fs->truncate)
+    return node->fs->truncate(node, (uint64_t)length);
   node->size = (uint32_t)length;
   return 0;
 }
@@ -108,18 +114,148 @@ int sys_truncate(const char *path, off_t length) {
 // ============================================================================
 
 int sys_ftruncate(int fd, off_t length) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   vfs_node_t *node = desc->node;
-  if ((node->flags & 0x7) != VFS_FILE)
+  if (node->type != VFS_FILE || length < 0)
     return -EINVAL;
 
+  int busy = elf_image_invalidate_node(node); // Chalti binary
+  if (busy < 0)
+    return busy;
+  if (node->fs && node->fs->truncate)
+    return node->fs->truncate(node, (uint64_t)length);
   node->size = (uint32_t)length;
   return 0;
 }
 
+// ============================================================================
+// sys_fsync - File ka cached data aur metadata disk pe
+// ============================================================================
+
+int sys_fsync(int fd) {
+  file_description_t *desc = fd_get(fd);
+  if (!desc)
+    return -EBADF;
+  vfs_node_t *node = desc->node;
+  // Socket nodes sirf flags mein VFS_SOCKET rakhte hain, type nahi
+  if (node->type == VFS_PIPE || node->flags == VFS_SOCKET)
+    return -EINVAL;
+  return node->fsync ? node->fsync(node) : 0;
+}
+
+// ============================================================================
+// sys_fdatasync - Sirf data (aur padhne ke liye zaroori size)
+// ============================================================================
+
+int sys_fdatasync(int fd) {
+  // FAT16 mein size hi woh metadata hai jiske bina data nahi milta, aur
+  // timestamps hum likhte nahi - toh fsync jaisa hi
+  return sys_fsync(fd);
+}
+
+// ============================================================================
+// sys_sendfile / sys_splice - fd se fd, data user space se hokar nahi jaata
+// ============================================================================
+// Source ke page cache se ek kernel chunk mein, wahan se seedha destination
+// (file, pipe ring ya socket queue) - user ke do copies bach jaate hain.
+
+#define FD_XFER_CHUNK (64 * 1024)
+
+static bool fd_is_stream(vfs_node_t *node) {
+  return node->type == VFS_PIPE || node->flags == VFS_SOCKET;
+}
+
+// pos null = description ka offset use karo aur aage badhao
+static ssize_t fd_transfer(file_description_t *in, off_t *in_pos,
+                           file_description_t *out, off_t *out_pos,
+                           size_t count) {
+  if (!count)
+    return 0;
+  uint32_t chunk = count < FD_XFER_CHUNK ? count : FD_XFER_CHUNK;
+  uint8_t *kbuf = (uint8_t *)kmalloc(chunk);
+  if (!kbuf)
+    return -ENOMEM;
+
+  uint64_t rpos = in_pos ? (uint64_t)*in_pos : in->offset;
+  uint64_t wpos = out_pos ? (uint64_t)*out_pos : out->offset;
+  // Pipe/socket se padha data stream se nikal chuka - wapas seek nahi hota,
+  // isliye poora chunk destination tak pahunchao. File source pe short write
+  // ke baad rpos bas utna hi aage badhta hai.
+  bool stream = fd_is_stream(in->node);
+  size_t done = 0;
+  int ret = 0;
+  while (done < count) {
+    uint32_t want = count - done < chunk ? count - done : chunk;
+    int n = vfs_read_ra(in->node, &in->ra, rpos, kbuf, want);
+    if (n <= 0) {
+      ret = n;
+      break;
+    }
+    uint32_t put = 0;
+    int w = 0;
+    while (put < (uint32_t)n) {
+      w = vfs_write(out->node, wpos, kbuf + put, n - put);
+      if (w <= 0)
+        break;
+      put += w;
+      wpos += w;
+      if (!stream)
+        break;
+    }
+    rpos += put;
+    done += put;
+    if (put < (uint32_t)n) {
+      ret = w < 0 ? w : 0;
+      break; // Destination bhara/band - ab tak jitna gaya woh lautao
+    }
+    if ((uint32_t)n < want)
+      break; // EOF ya stream khaali
+  }
+  kfree(kbuf);
+
+  if (in_pos)
+    *in_pos = (off_t)rpos;
+  else
+    in->offset = rpos;
+  if (out_pos)
+    *out_pos = (off_t)wpos;
+  else
+    out->offset = wpos;
+  return done ? (ssize_t)done : ret;
+}
+
+ssize_t sys_sendfile(int out_fd, int in_fd, off_t *offset, size_t count) {
+  file_description_t *in = fd_get(in_fd);
+  file_description_t *out = fd_get(out_fd);
+  if (!in || !out)
+    return -EBADF;
+  // Source seekable file hona chahiye (Linux jaisa)
+  if (fd_is_stream(in->node) || (offset && *offset < 0))
+    return -EINVAL;
+  return fd_transfer(in, offset, out, NULL, count);
+}
+
+ssize_t sys_splice(int fd_in, off_t *off_in, int fd_out, off_t *off_out,
+                   size_t len, uint32_t flags) {
+  (void)flags; // SPLICE_F_MOVE/MORE sirf hints hain, NONBLOCK pipe pe nahi
+  file_description_t *in = fd_get(fd_in);
+  file_description_t *out = fd_get(fd_out);
+  if (!in || !out)
+    return -EBADF;
+  bool in_pipe = in->node->type == VFS_PIPE;
+  bool out_pipe = out->node->type == VFS_PIPE;
+  if (!in_pipe && !out_pipe)
+    return -EINVAL;
+  if ((in_pipe && off_in) || (out_pipe && off_out))
+    return -ESPIPE;
+  if ((off_in && *off_in < 0) || (off_out && *off_out < 0))
+    return -EINVAL;
+  return fd_transfer(in, off_in, out, off_out, len);
+}
+
 // ============================================================================
 // sys_link - Create a hard link
 // ============================================================================
@@ -264,9 +400,8 @@ int sys_mkdirat(int dirfd, const char *pathname, uint32_t mode) {
   vfs_node_t *base;
   if (dirfd == AT_FDCWD) {
     base = vfs_root;
-  } else if (dirfd >= 0 && dirfd < MAX_PROCESS_FILES &&
-             current_process->fd_table[dirfd]) {
-    base = current_process->fd_table[dirfd]->node;
+  } else if (fd_get(dirfd)) {
+    base = fd_get(dirfd)->node;
   } else {
     return -EBADF;
   }
@@ -294,9 +429,8 @@ int sys_unlinkat(int dirfd, const char *pathname, int flags) {
   vfs_node_t *base;
   if (dirfd == AT_FDCWD) {
     base = vfs_root;
-  } else if (dirfd >= 0 && dirfd < MAX_PROCESS_FILES &&
-             current_process->fd_table[dirfd]) {
-    base = current_process->fd_table[dirfd]->node;
+  } else if (fd_get(dirfd)) {
+    base = fd_get(dirfd)->node;
   } else {
     return -EBADF;
   }
@@ -321,16 +455,14 @@ int sys_renameat(int olddirfd, const char *oldpath, int newdirfd,
   vfs_node_t *old_base =
       (olddirfd == AT_FDCWD)
           ? vfs_root
-          : ((olddirfd >= 0 && olddirfd < MAX_PROCESS_FILES &&
-              current_process->fd_table[olddirfd])
-                 ? current_process->fd_table[olddirfd]->node
+          : ((fd_get(olddirfd))
+                 ? fd_get(olddirfd)->node
                  : 0);
   vfs_node_t *new_base =
       (newdirfd == AT_FDCWD)
           ? vfs_root
-          : ((newdirfd >= 0 && newdirfd < MAX_PROCESS_FILES &&
-              current_process->fd_table[newdirfd])
-                 ? current_process->fd_table[newdirfd]->node
+          : ((fd_get(newdirfd))
+                 ? fd_get(newdirfd)->node
                  : 0);
 
   if (!old_base || !new_base)
@@ -348,6 +480,8 @@ int sys_renameat(int olddirfd, const char *oldpath, int newdirfd,
 
   // Rename in VFS (simplified: just update name)
   // Real implementation would need filesystem-level support
+  elf_image_invalidate_name(oldpath);
+  elf_image_invalidate_name(newpath);
   strncpy(src->name, newpath, 127);
   src->name[127] = 0;
 
@@ -367,10 +501,10 @@ int sys_rename(const char *oldpath, const char *newpath) {
 // ============================================================================
 
 int sys_fchmod(int fd, uint32_t mode) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  current_process->fd_table[fd]->node->mask = mode;
+  fd_get(fd)->node->mask = mode;
   return 0;
 }
 
@@ -397,57 +531,61 @@ int sys_chown(const char *pathname, uint32_t owner, uint32_t group) {
 // ============================================================================
 
 int sys_fchown(int fd, uint32_t owner, uint32_t group) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  current_process->fd_table[fd]->node->uid = owner;
-  current_process->fd_table[fd]->node->gid = group;
+  fd_get(fd)->node->uid = owner;
+  fd_get(fd)->node->gid = group;
   return 0;
 }
 
+// Common ioctl requests
+#define TIOCGWINSZ 0x5413 // Get window size
+#define TIOCSWINSZ 0x5414 // Set window size
+#define FIONREAD 0x541B   // Bytes available to read
+#define FIONBIO 0x5421    // Set/clear non-blocking I/O
+
 // ============================================================================
 // sys_fcntl - File control operations
 // ============================================================================
 
-// Per-fd flags storage (simplified)
-static uint32_t fd_flags[256];
-
 int sys_fcntl(int fd, int cmd, int arg) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  file_description_t *desc = fd_get(fd);
+  if (!desc)
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
-
   switch (cmd) {
   case F_DUPFD:
   case F_DUPFD_CLOEXEC: {
     // Pehla available fd dhundo jo >= arg ho
-    for (int i = arg; i < MAX_PROCESS_FILES; i++) {
-      if (!current_process->fd_table[i]) {
-        current_process->fd_table[i] = current_process->fd_table[fd];
-        current_process->fd_table[i]->ref_count++;
-        if (cmd == F_DUPFD_CLOEXEC)
-          fd_flags[i] = FD_CLOEXEC;
-        return i;
-      }
-    }
-    return -EMFILE;
+    if (arg < 0 || (uint32_t)arg >= fd_limit())
+      return -EINVAL;
+    int newfd = fd_alloc(desc, arg, cmd == F_DUPFD_CLOEXEC);
+    if (newfd >= 0)
+      desc->ref_count++;
+    return newfd;
   }
 
+  // FD_CLOEXEC fd ka flag hai, description ka nahi - fd table mein rehta hai
   case F_GETFD:
-    return fd_flags[fd];
+    return fd_get_cloexec(fd) ? FD_CLOEXEC : 0;
 
   case F_SETFD:
-    fd_flags[fd] = arg & FD_CLOEXEC;
-    return 0;
+    return fd_set_cloexec(fd, arg & FD_CLOEXEC);
 
   case F_GETFL:
     return desc->flags;
 
-  case F_SETFL:
+  case F_SETFL: {
     // arg is typically int for flags
     desc->flags = (desc->flags & ~0x800) | (arg & 0x800); // 0x800 = O_NONBLOCK
+    // Socket/PTY apna nonblock flag node mein rakhte hain, unhe bhi batao
+    if (desc->node && desc->node->ioctl) {
+      int on = (arg & O_NONBLOCK) ? 1 : 0;
+      desc->node->ioctl(desc->node, FIONBIO, &on);
+    }
     return 0;
+  }
 
   case F_GETOWN:
   case F_SETOWN:
@@ -463,17 +601,11 @@ int sys_fcntl(int fd, int cmd, int arg) {
 // sys_ioctl - I/O control
 // ============================================================================
 
-// Common ioctl requests
-#define TIOCGWINSZ 0x5413 // Get window size
-#define TIOCSWINSZ 0x5414 // Set window size
-#define FIONREAD 0x541B   // Bytes available to read
-#define FIONBIO 0x5421    // Set/clear non-blocking I/O
-
 int sys_ioctl(int fd, unsigned long request, void *argp) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   vfs_node_t *node = desc->node;
 
   switch (request) {
@@ -490,6 +622,9 @@ int sys_ioctl(int fd, unsigned long request, void *argp) {
   }
 
   case FIONREAD: {
+    // Sockets/PTYs khud jaante hain kitna data pada hai
+    if (node->ioctl && node->ioctl(node, request, argp) == 0)
+      return 0;
     // Return bytes available
     if (argp) {
       *(int *)argp = node->size - desc->offset;
@@ -498,7 +633,14 @@ int sys_ioctl(int fd, unsigned long request, void *argp) {
   }
 
   case FIONBIO: {
-    // Set non-blocking - not fully implemented
+    if (argp) {
+      if (*(int *)argp)
+        desc->flags |= O_NONBLOCK;
+      else
+        desc->flags &= ~O_NONBLOCK;
+    }
+    if (node->ioctl)
+      node->ioctl(node, request, argp);
     return 0;
   }
 
@@ -514,10 +656,10 @@ int sys_ioctl(int fd, unsigned long request, void *argp) {
 // ============================================================================
 
 int sys_fchdir(int fd) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  vfs_node_t *node = current_process->fd_table[fd]->node;
+  vfs_node_t *node = fd_get(fd)->node;
   if ((node->flags & 0x7) != VFS_DIRECTORY)
     return -ENOTDIR;
 
@@ -562,9 +704,8 @@ int sys_faccessat(int dirfd, const char *pathname, int mode, int flags) {
   vfs_node_t *base;
   if (dirfd == AT_FDCWD) {
     base = vfs_root;
-  } else if (dirfd >= 0 && dirfd < MAX_PROCESS_FILES &&
-             current_process->fd_table[dirfd]) {
-    base = current_process->fd_table[dirfd]->node;
+  } else if (fd_get(dirfd)) {
+    base = fd_get(dirfd)->node;
   } else {
     return -EBADF;
   }
@@ -27,6 +27,15 @@ off_t sys_lseek(int fd, off_t offset, int whence);
 int sys_truncate(const char *path, off_t length);
 int sys_ftruncate(int fd, off_t length);
 
+// Durability
+int sys_fsync(int fd);
+int sys_fdatasync(int fd);
+
+// In-kernel transfer (data user space se hokar nahi jaata)
+ssize_t sys_sendfile(int out_fd, int in_fd, off_t *offset, size_t count);
+ssize_t sys_splice(int fd_in, off_t *off_in, int fd_out, off_t *off_out,
+                   size_t len, uint32_t flags);
+
 // Links
 int sys_link(const char *oldpath, const char *newpath);
 int sys_symlink(const char *target, const char *linkpath);
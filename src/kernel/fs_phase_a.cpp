@@ -9,16 +9,23 @@
  * 3. Desktop/Home path mapping
  * 4. Directory & File creation correctness
  * 5. RAM Blocks and Inode Logic
+ * 6. Incremental persistence: dirty sectors + on-disk journal (TRUTH.LOG)
  */
 
+#include "../drivers/fat16.h"
+#include "../include/errno.h"
 #include "../include/fs_phase.h"
 #include "../include/string.h"
 #include "heap.h"
+#include "journal.h"
 #include "memory.h"
+#include "process.h"
+#include "wait_queue.h"
 #include <stddef.h>
 #include <stdint.h>
 
 extern "C" void serial_log(const char *msg);
+extern uint32_t tick;
 
 #define FILE_READ 0x1
 #define FILE_WRITE 0x2
@@ -32,9 +39,12 @@ uint32_t phase_inode_count = 0;
 uint32_t phase_block_count = 0;
 
 // 🔹 SECTION 4: KERNEL — BLOCK + INODE ALLOCATION
+static void phase_mark_dirty(const void *p, uint32_t len);
+
 uint32_t phase_alloc_block() {
   if (phase_block_count >= 64)
     return 0; // Out of blocks
+  phase_mark_dirty(&phase_block_count, 4);
   return phase_block_count++;
 }
 
@@ -54,9 +64,125 @@ phase_inode *phase_alloc_inode(uint32_t type) {
     n->blocks[i] = 0;
 
   phase_inode_count++;
+  phase_mark_dirty(n, sizeof(*n));
+  phase_mark_dirty(&phase_inode_count, 4);
   return n;
 }
 
+// 🔹 SECTION 4B: DIRTY TRACKING
+// TRUTH.DAT ka layout purana hi hai (inode table, blocks, do counters) -
+// bas ab har mutation apne badle hue bytes ko image ke 512-byte sectors mein
+// dirty mark karti hai. Flush sirf wahi sectors likhta hai, WAL ke through.
+#define PHASE_IMG_BYTES                                                        \
+  (sizeof(phase_inode_table) + sizeof(phase_data_blocks) + 8)
+#define PHASE_IMG_SECTORS ((PHASE_IMG_BYTES + 511) / 512)
+
+#define PHASE_LOG_SLOTS JOURNAL_TXN_MAX // Ek transaction mein max sectors
+#define PHASE_OP_MAX_SECTORS 24 // Sabse bada op (mkdir: block + entries)
+#define PHASE_LOG_HIGH (PHASE_LOG_SLOTS - PHASE_OP_MAX_SECTORS)
+#define PHASE_FLUSH_TICKS 100 // 50Hz - 2 second purana dirty data flush
+
+typedef struct phase_region {
+  uint8_t *base;
+  uint32_t size;
+} phase_region_t;
+
+// Image mein order: inode table, data blocks, inode_count, block_count
+static const phase_region_t phase_regions[] = {
+    {(uint8_t *)phase_inode_table, sizeof(phase_inode_table)},
+    {(uint8_t *)phase_data_blocks, sizeof(phase_data_blocks)},
+    {(uint8_t *)&phase_inode_count, 4},
+    {(uint8_t *)&phase_block_count, 4},
+};
+#define PHASE_REGIONS (int)(sizeof(phase_regions) / sizeof(phase_regions[0]))
+
+static uint32_t phase_dirty_map[(PHASE_IMG_SECTORS + 31) / 32];
+static volatile uint32_t phase_dirty_count = 0;
+static volatile uint32_t phase_dirty_since = 0; // 0 = kuch dirty nahi
+
+// Ek op (mkdir/write/rename...) ke beech flush snapshot nahi leta, taaki
+// har log transaction mein sirf poore ops hon
+static volatile uint32_t phase_op_depth = 0;
+static volatile bool phase_flushing = false;
+// Commit fail hua: naye ops -EIO jab tak koi commit kamyaab na ho, warna
+// wapas dirty hue sectors + naye ops ek transaction se bade ho jaate
+static volatile bool phase_io_error = false;
+
+static void phase_mark_dirty(const void *p, uint32_t len) {
+  const uint8_t *addr = (const uint8_t *)p;
+  uint32_t off = 0;
+  int r;
+  for (r = 0; r < PHASE_REGIONS; r++) {
+    const phase_region_t *reg = &phase_regions[r];
+    if (addr >= reg->base && addr < reg->base + reg->size) {
+      off += (uint32_t)(addr - reg->base);
+      break;
+    }
+    off += reg->size;
+  }
+  if (r == PHASE_REGIONS || len == 0)
+    return;
+
+  uint32_t flags = irq_save();
+  for (uint32_t sec = off / 512; sec <= (off + len - 1) / 512; sec++) {
+    uint32_t bit = 1u << (sec & 31);
+    if (phase_dirty_map[sec / 32] & bit)
+      continue;
+    phase_dirty_map[sec / 32] |= bit;
+    phase_dirty_count = phase_dirty_count + 1;
+  }
+  if (!phase_dirty_since)
+    phase_dirty_since = tick | 1;
+  irq_restore(flags);
+}
+
+// Naya block saaf karo - sirf jo sectors sach mein non-zero the woh dirty
+static void phase_block_zero(uint32_t blk) {
+  uint32_t *w = (uint32_t *)phase_data_blocks[blk];
+  for (uint32_t sec = 0; sec < BLOCK_SIZE / 512; sec++, w += 128) {
+    for (int i = 0; i < 128; i++) {
+      if (w[i]) {
+        memset(w, 0, 512);
+        phase_mark_dirty(w, 512);
+        break;
+      }
+    }
+  }
+}
+
+static int phase_flush();
+
+// false = op shuru mat karo (pichla commit fail). Commit chal raha ho toh
+// naya op uske khatam hone tak rukta hai - fail hone pe dirty set sirf wahi
+// snapshot rahe.
+static bool phase_op_begin() {
+  while (1) {
+    uint32_t flags = irq_save();
+    if (phase_io_error) {
+      irq_restore(flags);
+      return false;
+    }
+    if (!phase_flushing || phase_op_depth) {
+      phase_op_depth = phase_op_depth + 1;
+      irq_restore(flags);
+      return true;
+    }
+    irq_restore(flags);
+    schedule();
+  }
+}
+
+// Log bharne wala ho toh abhi flush (ops kabhi do transactions mein nahi
+// bantte). Background flush chal raha ho toh uske khatam hone ka wait.
+static void phase_op_end() {
+  uint32_t flags = irq_save();
+  phase_op_depth = phase_op_depth - 1;
+  irq_restore(flags);
+  while (phase_dirty_count >= PHASE_LOG_HIGH && !phase_op_depth &&
+         phase_flush() == 0)
+    schedule();
+}
+
 // 🔹 SECTION 5: PERMISSION ENFORCEMENT
 bool phase_vfs_check_perm(phase_inode *node, uint16_t uid, uint8_t req) {
   if (!node)
@@ -138,7 +264,7 @@ phase_inode *phase_vfs_resolve(const char *path) {
 }
 
 // 🔹 SECTION 7: DIRECTORY CREATION
-bool vfs_mkdir_phase_a(const char *path) {
+static bool phase_mkdir_op(const char *path) {
   char parent[MAX_PATH], name[MAX_NAME];
   split_path(path, parent, name);
 
@@ -158,18 +284,27 @@ bool vfs_mkdir_phase_a(const char *path) {
 
   uint32_t blk = phase_alloc_block();
   n->blocks[0] = blk;
-  memset(phase_data_blocks[blk], 0, BLOCK_SIZE);
+  phase_mark_dirty(&n->blocks[0], 4);
+  phase_block_zero(blk);
 
   strcpy(ents[dir->size].name, name);
   ents[dir->size].inode_id = n->id;
+  phase_mark_dirty(&ents[dir->size], sizeof(phase_dir_entry));
   dir->size++;
-
-  phase_vfs_sync();
+  phase_mark_dirty(&dir->size, 4);
   return true;
 }
 
+bool vfs_mkdir_phase_a(const char *path) {
+  if (!phase_op_begin())
+    return false;
+  bool ok = phase_mkdir_op(path);
+  phase_op_end();
+  return ok;
+}
+
 // 🔹 SECTION 8: FILE CREATION + WRITE
-int vfs_create_file_phase_a(const char *path) {
+static int phase_create_file_op(const char *path) {
   char parent[MAX_PATH], name[MAX_NAME];
   split_path(path, parent, name);
 
@@ -188,30 +323,42 @@ int vfs_create_file_phase_a(const char *path) {
     return -1;
 
   f->blocks[0] = phase_alloc_block();
+  phase_mark_dirty(&f->blocks[0], 4);
 
   ents = (phase_dir_entry *)phase_data_blocks[dir->blocks[0]];
   strcpy(ents[dir->size].name, name);
   ents[dir->size].inode_id = f->id;
+  phase_mark_dirty(&ents[dir->size], sizeof(phase_dir_entry));
   dir->size++;
-
-  phase_vfs_sync();
+  phase_mark_dirty(&dir->size, 4);
   return f->id;
 }
 
+int vfs_create_file_phase_a(const char *path) {
+  if (!phase_op_begin())
+    return -1;
+  int id = phase_create_file_op(path);
+  phase_op_end();
+  return id;
+}
+
 int vfs_write_phase_a(phase_inode *f, const char *data, uint32_t len) {
   if (!f || f->type != INODE_FILE)
     return -1;
   if (len > BLOCK_SIZE)
     len = BLOCK_SIZE;
 
+  if (!phase_op_begin())
+    return -1;
   memcpy(phase_data_blocks[f->blocks[0]], data, len);
+  phase_mark_dirty(phase_data_blocks[f->blocks[0]], len);
   f->size = len;
-
-  phase_vfs_sync();
+  phase_mark_dirty(&f->size, 4);
+  phase_op_end();
   return len;
 }
 
-bool phase_vfs_rename(const char *oldpath, const char *newpath) {
+static bool phase_rename_op(const char *oldpath, const char *newpath) {
   char old_parent_path[MAX_PATH], old_name[MAX_NAME];
   char new_parent_path[MAX_PATH], new_name[MAX_NAME];
 
@@ -250,20 +397,31 @@ bool phase_vfs_rename(const char *oldpath, const char *newpath) {
 
   strcpy(new_ents[new_dir->size].name, new_name);
   new_ents[new_dir->size].inode_id = target_inode_id;
+  phase_mark_dirty(&new_ents[new_dir->size], sizeof(phase_dir_entry));
   new_dir->size++;
+  phase_mark_dirty(&new_dir->size, 4);
 
   // Remove from old_dir
   for (uint32_t i = (uint32_t)old_idx; i < old_dir->size - 1; i++) {
     old_ents[i] = old_ents[i + 1];
   }
+  phase_mark_dirty(&old_ents[old_idx],
+                   (old_dir->size - old_idx) * sizeof(phase_dir_entry));
   old_dir->size--;
-
-  phase_vfs_sync();
+  phase_mark_dirty(&old_dir->size, 4);
   return true;
 }
 
-extern "C" int phase_create_in_dir(phase_inode *pdir, const char *name,
-                                   int type) {
+bool phase_vfs_rename(const char *oldpath, const char *newpath) {
+  if (!phase_op_begin())
+    return false;
+  bool ok = phase_rename_op(oldpath, newpath);
+  phase_op_end();
+  return ok;
+}
+
+static int phase_create_in_dir_op(phase_inode *pdir, const char *name,
+                                  int type) {
   if (!pdir || pdir->type != INODE_DIR)
     return -1;
   // 1. Check if name already exists
@@ -280,8 +438,9 @@ extern "C" int phase_create_in_dir(phase_inode *pdir, const char *name,
     return -1;
 
   n->blocks[0] = phase_alloc_block();
+  phase_mark_dirty(&n->blocks[0], 4);
   if (itype == INODE_DIR) {
-    memset(phase_data_blocks[n->blocks[0]], 0, BLOCK_SIZE);
+    phase_block_zero(n->blocks[0]);
   }
 
   // 3. Add to parent
@@ -293,37 +452,100 @@ extern "C" int phase_create_in_dir(phase_inode *pdir, const char *name,
     ents[idx].name[i + 1] = 0;
   }
   ents[idx].inode_id = n->id;
-
-  phase_vfs_sync();
+  phase_mark_dirty(&ents[idx], sizeof(phase_dir_entry));
+  phase_mark_dirty(&pdir->size, 4);
   return n->id;
 }
 
+extern "C" int phase_create_in_dir(phase_inode *pdir, const char *name,
+                                   int type) {
+  if (!phase_op_begin())
+    return -1;
+  int id = phase_create_in_dir_op(pdir, name, type);
+  phase_op_end();
+  return id;
+}
+
 // 🔹 SECTION 10: PERSISTENCE (DISK SYNC)
-#include "../drivers/fat16.h"
+// TRUTH.DAT = poori image (purana format). TRUTH.LOG = uska circular
+// journal (journal.h): har flush dirty sectors ka ek txn hai, ek cache flush
+// mein. TRUTH.DAT mein sectors checkpoint pe jaate hain - log bhare tab ya
+// flusher idle ho tab. Mount pe pehle journal replay, phir image padho.
+#define PHASE_LOG_BLOCKS 1024 // Superblock + circular area (512KB)
+#define PHASE_CHECKPOINT_TICKS (PHASE_FLUSH_TICKS * 5)
 
 // Optimization: Disable sync during bootstrap
 static bool g_phase_a_sync_enabled = true;
 
-uint32_t phase_vfs_get_total_size() {
-  return sizeof(phase_inode_table) + sizeof(phase_data_blocks) + 8;
+static journal_t phase_journal;
+static bool phase_journal_ok = false; // false = purana full rewrite
+static volatile uint32_t phase_commit_tick = 0; // Aakhri commit kab hua
+
+uint32_t phase_vfs_get_total_size() { return PHASE_IMG_BYTES; }
+
+// Image offset [off, off + len) <-> buf. to_img = load/replay.
+static void phase_img_xfer(uint32_t off, uint8_t *buf, uint32_t len,
+                           bool to_img) {
+  uint32_t base = 0;
+  for (int r = 0; r < PHASE_REGIONS && len; r++) {
+    uint32_t size = phase_regions[r].size;
+    if (off < base + size) {
+      uint32_t n = base + size - off;
+      if (n > len)
+        n = len;
+      uint8_t *p = phase_regions[r].base + (off - base);
+      if (to_img)
+        memcpy(p, buf, n);
+      else
+        memcpy(buf, p, n);
+      buf += n;
+      off += n;
+      len -= n;
+    }
+    base += size;
+  }
+  if (len && !to_img)
+    memset(buf, 0, len); // Aakhri sector ki padding
 }
 
-extern "C" void phase_vfs_sync() {
-  if (!g_phase_a_sync_enabled)
-    return;
-  uint32_t total = phase_vfs_get_total_size();
+// TRUTH.DAT home device, TRUTH.LOG log device - committed txns yahin replay
+static void phase_journal_open() {
+  struct block_device *home = fat16_file_bdev("TRUTH.DAT", "truth0");
+  struct block_device *log = fat16_file_bdev("TRUTH.LOG", "truthlog0");
+  phase_journal_ok =
+      home && log && journal_open(&phase_journal, log, home) >= 0;
+  if (!phase_journal_ok)
+    serial_log("FS_PHASE_A: Journal unavailable, full rewrites only");
+}
+
+// Khaali (zero) log - journal_open ise format karega
+static bool phase_log_create() {
+  uint32_t len = PHASE_LOG_BLOCKS * 512;
+  uint8_t *zero = (uint8_t *)kmalloc(len);
+  if (!zero)
+    return false;
+  memset(zero, 0, len);
+  fat16_entry_t e = fat16_find_file("TRUTH.LOG");
+  if (e.filename[0] == 0)
+    fat16_create_file("TRUTH.LOG");
+  bool ok = fat16_write_file("TRUTH.LOG", zero, len) > 0;
+  kfree(zero);
+  return ok;
+}
+
+// Poori image ek saath (pehli boot / journal nahi mila). Sab clean.
+static void phase_write_full() {
+  uint32_t total = PHASE_IMG_SECTORS * 512;
   uint8_t *buf = (uint8_t *)kmalloc(total);
   if (!buf)
     return;
 
-  uint32_t offset = 0;
-  memcpy(buf + offset, phase_inode_table, sizeof(phase_inode_table));
-  offset += sizeof(phase_inode_table);
-  memcpy(buf + offset, phase_data_blocks, sizeof(phase_data_blocks));
-  offset += sizeof(phase_data_blocks);
-  memcpy(buf + offset, &phase_inode_count, 4);
-  offset += 4;
-  memcpy(buf + offset, &phase_block_count, 4);
+  uint32_t flags = irq_save();
+  phase_img_xfer(0, buf, total, false);
+  memset(phase_dirty_map, 0, sizeof(phase_dirty_map));
+  phase_dirty_count = 0;
+  phase_dirty_since = 0;
+  irq_restore(flags);
 
   // Create if not exists
   fat16_entry_t e = fat16_find_file("TRUTH.DAT");
@@ -331,35 +553,161 @@ extern "C" void phase_vfs_sync() {
     fat16_create_file("TRUTH.DAT");
   }
 
-  fat16_write_file("TRUTH.DAT", buf, total);
+  fat16_write_file("TRUTH.DAT", buf, PHASE_IMG_BYTES);
   kfree(buf);
   serial_log("FS_PHASE_A: Synced to TRUTH.DAT");
 }
 
+// Ek transaction. 1 = ho gaya (ya karne ko kuch nahi), 0 = abhi nahi ho
+// sakta (koi op beech mein hai ya doosra flush chal raha hai), -errno.
+static int phase_flush() {
+  if (!g_phase_a_sync_enabled)
+    return 1;
+  if (!phase_journal_ok) {
+    if (phase_flushing || phase_op_depth)
+      return 0;
+    phase_flushing = true;
+    if (phase_dirty_count)
+      phase_write_full();
+    phase_flushing = false;
+    return 1;
+  }
+
+  uint32_t *targets = (uint32_t *)kmalloc(PHASE_LOG_SLOTS * sizeof(uint32_t));
+  uint8_t *data = (uint8_t *)kmalloc(PHASE_LOG_SLOTS * 512);
+  if (!targets || !data) {
+    if (targets)
+      kfree(targets);
+    if (data)
+      kfree(data);
+    return -ENOMEM;
+  }
+
+  // Snapshot: interrupts band, koi op beech mein nahi - image consistent
+  uint32_t flags = irq_save();
+  if (phase_flushing || phase_op_depth) {
+    irq_restore(flags);
+    kfree(targets);
+    kfree(data);
+    return 0;
+  }
+  uint32_t n = 0;
+  for (uint32_t sec = 0; sec < PHASE_IMG_SECTORS && n < PHASE_LOG_SLOTS;
+       sec++) {
+    uint32_t bit = 1u << (sec & 31);
+    if (!(phase_dirty_map[sec / 32] & bit))
+      continue;
+    phase_dirty_map[sec / 32] &= ~bit;
+    targets[n] = sec;
+    phase_img_xfer(sec * 512, data + n * 512, 512, false);
+    n++;
+  }
+  phase_dirty_count = phase_dirty_count - n;
+  if (!phase_dirty_count)
+    phase_dirty_since = 0;
+  if (n)
+    phase_flushing = true;
+  irq_restore(flags);
+
+  int ret = 1;
+  if (n) {
+    if (journal_commit(&phase_journal, targets, data, n) < 0) {
+      // Sectors phir se dirty - flusher baad mein dobara koshish karega
+      serial_log("FS_PHASE_A: Journal commit failed");
+      flags = irq_save();
+      for (uint32_t i = 0; i < n; i++) {
+        uint32_t bit = 1u << (targets[i] & 31);
+        if (!(phase_dirty_map[targets[i] / 32] & bit)) {
+          phase_dirty_map[targets[i] / 32] |= bit;
+          phase_dirty_count = phase_dirty_count + 1;
+        }
+      }
+      if (!phase_dirty_since)
+        phase_dirty_since = tick | 1;
+      irq_restore(flags);
+      phase_io_error = true;
+      ret = -EIO;
+    } else {
+      phase_io_error = false;
+    }
+    phase_commit_tick = tick;
+    phase_flushing = false;
+  }
+  kfree(targets);
+  kfree(data);
+  return ret;
+}
+
+// Log ke txns TRUTH.DAT mein aur log khaali. Durability commit se hi hai,
+// yeh sirf replay chhota rakhta hai.
+static void phase_checkpoint() {
+  uint32_t flags = irq_save();
+  if (phase_flushing || !phase_journal_ok) {
+    irq_restore(flags);
+    return;
+  }
+  phase_flushing = true;
+  irq_restore(flags);
+  if (journal_checkpoint(&phase_journal) < 0)
+    serial_log("FS_PHASE_A: Checkpoint failed");
+  phase_flushing = false;
+}
+
+// Sab dirty data disk pe (sync syscall). Ops ke andar se mat bulao.
+extern "C" void phase_vfs_sync() {
+  while (g_phase_a_sync_enabled && phase_dirty_count) {
+    int ret = phase_flush();
+    if (ret < 0)
+      return;
+    if (ret == 0)
+      schedule();
+  }
+}
+
+// Background flusher: jo data PHASE_FLUSH_TICKS se dirty hai use batch karo,
+// aur kuch der shanti rahe toh checkpoint
+extern "C" void phase_flush_thread() {
+  while (1) {
+    current_process->sleep_until = tick + PHASE_FLUSH_TICKS / 4;
+    current_process->state = PROCESS_SLEEPING;
+    schedule();
+
+    uint32_t since = phase_dirty_since;
+    if (since && tick - since >= PHASE_FLUSH_TICKS)
+      phase_vfs_sync();
+    if (phase_journal_ok && phase_journal.txns && !phase_dirty_count &&
+        tick - phase_commit_tick >= PHASE_CHECKPOINT_TICKS)
+      phase_checkpoint();
+  }
+}
+
 extern "C" void phase_vfs_load() {
   fat16_entry_t e = fat16_find_file("TRUTH.DAT");
   if (e.filename[0] == 0) {
     serial_log("FS_PHASE_A: No TRUTH.DAT found, starting fresh.");
     return;
   }
+  if (e.file_size < PHASE_IMG_BYTES) {
+    serial_log("FS_PHASE_A: TRUTH.DAT too small, starting fresh.");
+    return;
+  }
 
-  uint32_t total = phase_vfs_get_total_size();
-  uint8_t *buf = (uint8_t *)kmalloc(total);
+  // Pehle journal: committed txns TRUTH.DAT pe, tab image padho.
+  // Purani images mein TRUTH.LOG nahi (ya purane size ka) hota.
+  fat16_entry_t log = fat16_find_file("TRUTH.LOG");
+  if (log.filename[0] == 0 || log.file_size != PHASE_LOG_BLOCKS * 512)
+    phase_log_create();
+  phase_journal_open();
+
+  // fat16_read_file poore sectors likhta hai
+  uint8_t *buf = (uint8_t *)kmalloc(PHASE_IMG_SECTORS * 512);
   if (!buf)
     return;
 
   fat16_read_file(&e, buf);
-
-  uint32_t offset = 0;
-  memcpy(phase_inode_table, buf + offset, sizeof(phase_inode_table));
-  offset += sizeof(phase_inode_table);
-  memcpy(phase_data_blocks, buf + offset, sizeof(phase_data_blocks));
-  offset += sizeof(phase_data_blocks);
-  memcpy(&phase_inode_count, buf + offset, 4);
-  offset += 4;
-  memcpy(&phase_block_count, buf + offset, 4);
-
+  phase_img_xfer(0, buf, PHASE_IMG_BYTES, true);
   kfree(buf);
+
   serial_log("FS_PHASE_A: Loaded persistent state from TRUTH.DAT");
 }
 
@@ -394,6 +742,10 @@ extern "C" void fs_phase_a_bootstrap() {
   phase_vfs_load();
 
   if (phase_inode_count > 0) {
+    memset(phase_dirty_map, 0, sizeof(phase_dirty_map));
+    phase_dirty_count = 0;
+    phase_dirty_since = 0;
+    g_phase_a_sync_enabled = true;
     serial_log("FS Phase A: Persistent Boot Successful.");
     return;
   }
@@ -402,7 +754,7 @@ extern "C" void fs_phase_a_bootstrap() {
   phase_inode *root = phase_alloc_inode(INODE_DIR);
   if (root) {
     root->blocks[0] = phase_alloc_block();
-    memset(phase_data_blocks[root->blocks[0]], 0, BLOCK_SIZE);
+    phase_block_zero(root->blocks[0]);
   }
 
   // 2. Create Standard Hierarchy
@@ -427,8 +779,10 @@ extern "C" void fs_phase_a_bootstrap() {
 
   serial_log("FS Phase A: Bootstrapped.");
 
-  // Initial sync
+  // Initial sync: poori image + khaali log, phir sirf incremental
   g_phase_a_sync_enabled = true;
-  phase_vfs_sync();
+  phase_write_full();
+  if (phase_log_create())
+    phase_journal_open();
 }
 } // extern "C"
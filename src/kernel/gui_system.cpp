@@ -5,24 +5,36 @@
    Warning: Isme panga mat lena varna boot nahi hoga.
    ========================================================= */
 
+#include "../drivers/bmp.h"
+#include "../drivers/input.h"
+#include "../drivers/raster.h"
 #include "../drivers/serial.h"
 #include "../include/font.h"
+#include "../include/gui/abi.h"
+#include "../include/gui/surface.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
+#include "heap.h"
+#include "memory.h"
 #include "pmm.h"
 #include "process.h"
+#include "shm.h"
+#include "tsc.h"
+#include "wait_queue.h"
 #include <stdint.h>
 
+struct Rect; // Neeche defined - layout graphics.h ke fb_rect_t jaisa
+
 /* 🧱 SYSTEM INTERFACES (Kernel ke saath baat-cheet ka jariya) */
 extern "C" {
 void *sys_get_framebuffer();
 int sys_fb_width();
 int sys_fb_height();
 void sys_fb_swap();
+void sys_fb_present(const Rect *rects, int count);
 void sys_get_mouse(int *, int *, int *);
 uint32_t sys_time_ms();
 int sys_spawn(const char *path, char **argv);
-int sys_read_key(int *key, int *state);
 int sys_open(const char *, int);
 int sys_readdir(int, uint32_t, void *);
 int sys_close(int);
@@ -109,21 +121,202 @@ extern "C" void explorer_context_action(int index, int act);
 struct Rect {
   int x, y, w, h;
 };
-
-/* 🚀 GPU ACCELERATION LAYER (Taaki smooth chale) */
-enum GpuCmdType { GPU_RECT, GPU_BLEND_RECT, GPU_TEXT, GPU_ICON };
+static_assert(sizeof(Rect) == 4 * sizeof(int), "Rect is passed as fb_rect_t");
+
+/* 🚀 GPU ACCELERATION LAYER (Taaki smooth chale)
+   Compositor frame ka saara drawing pehle is display list mein record hota
+   hai - recording ke waqt FB primitives pixel nahi likhte, command jodte
+   hain. Phir har damage rect (tile) ke liye list ek pass mein chalti hai:
+   tile ke bahar wale aur upar wali window ki opaque body ke neeche chhupe
+   commands skip ho jaate hain. Har tile alag execute hota hai, isliye
+   tiles ko baad mein worker threads mein baanta ja sakta hai. */
+enum GpuCmdType { GPU_RECT, GPU_BLEND_RECT, GPU_TEXT, GPU_ICON, GPU_BLIT };
 struct GpuCmd {
   GpuCmdType type;
-  Rect r;
+  Rect r; // Bounds (culling isi se)
   uint32_t color;
   uint8_t alpha;
   int icon_id;
+  int arg;             // GPU_ICON: size, GPU_TEXT: font size, GPU_BLIT: pitch
+  int layer;           // 0 = desktop, 1.. = window z-order
+  const uint32_t *src; // GPU_BLIT: pixels (r.x, r.y wala pixel)
   char text[64];
 };
 
 #define GPU_CMD_MAX 2048
+#define GPU_OCCLUDER_MAX 16
+#define GPU_LAYER_OVERLAY 1000 // Menu, dialog, taskbar, cursor
+#define GPU_COALESCE_LOOKBACK 4
+
 static GpuCmd gpu_cmds[GPU_CMD_MAX];
 static int gpu_count = 0;
+static bool gpu_recording = false;
+static bool gpu_overflow = false; // List bhar gayi - frame immediate mode mein
+static int gpu_layer = 0;
+
+// Opaque areas (window body). Inke neeche wali layers ke commands cull.
+struct GpuOccluder {
+  Rect r;
+  int layer;
+};
+static GpuOccluder gpu_occluders[GPU_OCCLUDER_MAX];
+static int gpu_occluder_count = 0;
+
+static inline bool rect_overlaps(const Rect &a, const Rect &b) {
+  return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h &&
+         b.y < a.y + a.h;
+}
+
+static inline bool rect_contains(const Rect &outer, const Rect &in) {
+  return in.x >= outer.x && in.y >= outer.y &&
+         in.x + in.w <= outer.x + outer.w && in.y + in.h <= outer.y + outer.h;
+}
+
+// a - b: zyada se zyada 4 tukde (upar aur neeche poori chaudai, beech mein
+// baayen/daayen). Overlap na ho toh a khud.
+static int rect_subtract(const Rect &a, const Rect &b, Rect *out) {
+  if (!rect_overlaps(a, b)) {
+    out[0] = a;
+    return 1;
+  }
+  int n = 0;
+  int ax1 = a.x + a.w, ay1 = a.y + a.h;
+  int bx1 = b.x + b.w, by1 = b.y + b.h;
+  int y0 = b.y > a.y ? b.y : a.y;
+  int y1 = by1 < ay1 ? by1 : ay1;
+  if (b.y > a.y)
+    out[n++] = {a.x, a.y, a.w, b.y - a.y};
+  if (by1 < ay1)
+    out[n++] = {a.x, by1, a.w, ay1 - by1};
+  if (b.x > a.x)
+    out[n++] = {a.x, y0, b.x - a.x, y1 - y0};
+  if (bx1 < ax1)
+    out[n++] = {bx1, y0, ax1 - bx1, y1 - y0};
+  return n;
+}
+
+void gpu_begin() {
+  gpu_count = 0;
+  gpu_occluder_count = 0;
+  gpu_overflow = false;
+  gpu_layer = 0;
+  gpu_recording = true;
+}
+
+void gpu_end() { gpu_recording = false; }
+
+static GpuCmd *gpu_push(GpuCmdType type, int x, int y, int w, int h) {
+  if (w <= 0 || h <= 0)
+    return nullptr;
+  if (gpu_count == GPU_CMD_MAX) {
+    gpu_overflow = true;
+    return nullptr;
+  }
+  GpuCmd *c = &gpu_cmds[gpu_count++];
+  c->type = type;
+  c->r = {x, y, w, h};
+  c->layer = gpu_layer;
+  return c;
+}
+
+// Same color ke sate hue rects ek command (sysmon ke put() loops, borders).
+// Pichhle kuch commands mein dhoondo, par sirf tab jab beech ka koi command
+// merged area ko na chhue - warna painter's order toot jaayega.
+static bool gpu_coalesce(const Rect &r, uint32_t color) {
+  int stop = gpu_count - GPU_COALESCE_LOOKBACK;
+  for (int k = gpu_count - 1; k >= 0 && k >= stop; k--) {
+    GpuCmd *p = &gpu_cmds[k];
+    if (p->type == GPU_RECT && p->color == color && p->layer == gpu_layer) {
+      Rect m;
+      bool adjacent = true;
+      if (p->r.y == r.y && p->r.h == r.h && p->r.x + p->r.w == r.x)
+        m = {p->r.x, p->r.y, p->r.w + r.w, r.h};
+      else if (p->r.x == r.x && p->r.w == r.w && p->r.y + p->r.h == r.y)
+        m = {p->r.x, p->r.y, r.w, p->r.h + r.h};
+      else
+        adjacent = false;
+
+      if (adjacent) {
+        for (int j = k + 1; j < gpu_count; j++)
+          if (rect_overlaps(gpu_cmds[j].r, m))
+            return false;
+        p->r = m;
+        return true;
+      }
+    }
+    if (rect_overlaps(p->r, r))
+      return false; // Iske peeche merge karna order badal dega
+  }
+  return false;
+}
+
+void gpu_rect(int x, int y, int w, int h, uint32_t color) {
+  if (w <= 0 || h <= 0 || gpu_coalesce({x, y, w, h}, color))
+    return;
+  GpuCmd *c = gpu_push(GPU_RECT, x, y, w, h);
+  if (c)
+    c->color = color;
+}
+
+void gpu_blend_rect(int x, int y, int w, int h, uint32_t color, uint8_t a) {
+  GpuCmd *c = gpu_push(GPU_BLEND_RECT, x, y, w, h);
+  if (c) {
+    c->color = color;
+    c->alpha = a;
+  }
+}
+
+void gpu_blit(int x, int y, int w, int h, const uint32_t *src, int pitch) {
+  GpuCmd *c = gpu_push(GPU_BLIT, x, y, w, h);
+  if (c) {
+    c->src = src;
+    c->arg = pitch;
+  }
+}
+
+// Lambi string 63-char tukdon mein
+void gpu_text(int size, int x, int y, const char *s, uint32_t color) {
+  int scale = (size > 8) ? 2 : 1;
+  while (*s) {
+    int n = 0;
+    while (s[n] && n < 63)
+      n++;
+    GpuCmd *c = gpu_push(GPU_TEXT, x, y, n * 8 * scale, 8 * scale);
+    if (!c)
+      return;
+    for (int i = 0; i < n; i++)
+      c->text[i] = s[i];
+    c->text[n] = 0;
+    c->color = color;
+    c->arg = size;
+    s += n;
+    x += n * 8 * scale;
+  }
+}
+
+// bounds.x/y = icon ka origin; w/h conservative (chhote icons bahar jaate hain)
+void gpu_icon(int id, Rect bounds, int size, uint32_t accent) {
+  GpuCmd *c = gpu_push(GPU_ICON, bounds.x, bounds.y, bounds.w, bounds.h);
+  if (c) {
+    c->icon_id = id;
+    c->arg = size;
+    c->color = accent;
+  }
+}
+
+void gpu_occluder(Rect r) {
+  if (gpu_recording && gpu_occluder_count < GPU_OCCLUDER_MAX)
+    gpu_occluders[gpu_occluder_count++] = {r, gpu_layer};
+}
+
+// Kya yeh hissa kisi upar wali layer ki opaque body ke neeche poora chhupa hai
+static bool gpu_occluded(const Rect &v, int layer) {
+  for (int i = 0; i < gpu_occluder_count; i++)
+    if (gpu_occluders[i].layer > layer &&
+        rect_contains(gpu_occluders[i].r, v))
+      return true;
+  return false;
+}
 
 /* 📋 CLIPBOARD & DRAG-DROP (Idhar se udhar karne ke liye) */
 struct Clipboard {
@@ -312,48 +505,146 @@ static inline bool inside(Rect r, int x, int y) {
 namespace FB {
 static uint32_t *buf;
 static int W, H;
+// Clip window [x0,x1) x [y0,y1). Compositor har damage rect ke liye isse set
+// karta hai, taaki baaki screen ko chhua bhi na jaaye.
+static int clip_x0, clip_y0, clip_x1, clip_y1;
+
+// Draw target: screen back buffer, ya kisi window ka cached surface.
+// Coords hamesha screen ke hote hain; target screen pe (tgt_x, tgt_y) pe
+// baitha hai aur pitch = tgt_w.
+static uint32_t *tgt;
+static int tgt_x, tgt_y, tgt_w, tgt_h;
+
+static inline uint32_t *at(int x, int y) {
+  return tgt + (y - tgt_y) * tgt_w + (x - tgt_x);
+}
+
+void reset_clip() {
+  clip_x0 = tgt_x;
+  clip_y0 = tgt_y;
+  clip_x1 = tgt_x + tgt_w;
+  clip_y1 = tgt_y + tgt_h;
+}
+
+void set_clip(Rect r) {
+  clip_x0 = r.x < tgt_x ? tgt_x : r.x;
+  clip_y0 = r.y < tgt_y ? tgt_y : r.y;
+  clip_x1 = r.x + r.w > tgt_x + tgt_w ? tgt_x + tgt_w : r.x + r.w;
+  clip_y1 = r.y + r.h > tgt_y + tgt_h ? tgt_y + tgt_h : r.y + r.h;
+}
+
+Rect get_clip() {
+  return {clip_x0, clip_y0, clip_x1 - clip_x0, clip_y1 - clip_y0};
+}
+
+// Ab se saara drawing px mein (screen rect r ka backing store). Clip = r.
+void bind(uint32_t *px, Rect r) {
+  tgt = px;
+  tgt_x = r.x;
+  tgt_y = r.y;
+  tgt_w = r.w;
+  tgt_h = r.h;
+  reset_clip();
+}
+
+void unbind() { bind(buf, {0, 0, W, H}); }
 
 void init() {
   buf = (uint32_t *)sys_get_framebuffer();
   W = sys_fb_width();
   H = sys_fb_height();
+  unbind();
+}
+
+// Rect ko clip se kaat do. false = kuch bhi visible nahi
+inline bool clip_rect(int &x, int &y, int &w, int &h) {
+  int x1 = x + w, y1 = y + h;
+  if (x < clip_x0)
+    x = clip_x0;
+  if (y < clip_y0)
+    y = clip_y0;
+  if (x1 > clip_x1)
+    x1 = clip_x1;
+  if (y1 > clip_y1)
+    y1 = clip_y1;
+  w = x1 - x;
+  h = y1 - y;
+  return w > 0 && h > 0;
+}
+
+// Kya yeh area current clip mein aata hai? (poora widget skip karne ke liye)
+inline bool visible(int x, int y, int w, int h) {
+  return x < clip_x1 && y < clip_y1 && x + w > clip_x0 && y + h > clip_y0;
 }
 
 inline void put(int x, int y, uint32_t c) {
-  if (x < 0 || y < 0 || x >= W || y >= H)
+  if (x < clip_x0 || y < clip_y0 || x >= clip_x1 || y >= clip_y1)
+    return;
+  if (gpu_recording) {
+    gpu_rect(x, y, 1, 1, c);
     return;
-  buf[y * W + x] = c;
+  }
+  *at(x, y) = c;
 }
 
-void rect(int x, int y, int w, int h, uint32_t c) {
-  for (int i = 0; i < h; i++)
-    for (int j = 0; j < w; j++)
-      put(x + j, y + i, c);
+// Ek row ka horizontal span (text runs isi se banti hain)
+inline void hspan(int x, int y, int n, uint32_t c) {
+  if (y < clip_y0 || y >= clip_y1)
+    return;
+  if (gpu_recording) {
+    gpu_rect(x, y, n, 1, c);
+    return;
+  }
+  if (x < clip_x0) {
+    n -= clip_x0 - x;
+    x = clip_x0;
+  }
+  if (x + n > clip_x1)
+    n = clip_x1 - x;
+  span_fill(at(x, y), c, n);
 }
 
-void clear(uint32_t c) {
-  for (int i = 0; i < W * H; i++)
-    buf[i] = c;
+// Ek baar clip, phir row-span kernels (raster.h)
+void rect(int x, int y, int w, int h, uint32_t c) {
+  if (!clip_rect(x, y, w, h))
+    return;
+  if (gpu_recording) {
+    gpu_rect(x, y, w, h, c);
+    return;
+  }
+  raster_fill_rect(tgt, tgt_w, x - tgt_x, y - tgt_y, w, h, c);
 }
 
+void clear(uint32_t c) { rect(0, 0, W, H, c); }
+
 void blend_rect(int x, int y, int w, int h, uint32_t c, uint8_t a) {
-  uint8_t r1 = (c >> 16) & 255, g1 = (c >> 8) & 255, b1 = c & 255;
-  for (int i = 0; i < h; i++) {
-    for (int j = 0; j < w; j++) {
-      int px = x + j, py = y + i;
-      if (px < 0 || py < 0 || px >= W || py >= H)
-        continue;
-      uint32_t bg = buf[py * W + px];
-      uint8_t r2 = (bg >> 16) & 255, g2 = (bg >> 8) & 255, b2 = bg & 255;
-      uint8_t r = (r1 * a + r2 * (255 - a)) / 255;
-      uint8_t g = (g1 * a + g2 * (255 - a)) / 255;
-      uint8_t b = (b1 * a + b2 * (255 - a)) / 255;
-      buf[py * W + px] = (0xFF << 24) | (r << 16) | (g << 8) | b;
-    }
+  if (!clip_rect(x, y, w, h))
+    return;
+  if (gpu_recording) {
+    gpu_blend_rect(x, y, w, h, c, a);
+    return;
   }
+  raster_blend_rect(tgt, tgt_w, x - tgt_x, y - tgt_y, w, h, c, a);
+}
+
+// Pitch wale source se clipped blit (source ka (0,0) screen pe (x, y) hai)
+void blit(int x, int y, int w, int h, const uint32_t *src, int src_pitch) {
+  if (gpu_recording) {
+    if (visible(x, y, w, h))
+      gpu_blit(x, y, w, h, src, src_pitch);
+    return;
+  }
+  int cx = x, cy = y;
+  if (!clip_rect(cx, cy, w, h))
+    return;
+  src += (cy - y) * src_pitch + (cx - x);
+  raster_blit(at(cx, cy), tgt_w, src, src_pitch, w, h);
 }
 
-inline void swap() { sys_fb_swap(); }
+// Sirf diye hue hisse screen pe bhejo (page flip ho toh ek hi flip)
+inline void present(const Rect *rects, int count) {
+  sys_fb_present(rects, count);
+}
 } // namespace FB
 
 namespace Input {
@@ -364,12 +655,60 @@ static bool g_has_clicked = false;
 static bool g_is_double_click = false;
 #define DBLCLICK_MS 800
 
+// Keyboard events jo is frame ke key loop ko milenge
+#define INPUT_KEYS_MAX 32
+static int keys[INPUT_KEYS_MAX];
+static int key_count = 0, key_pos = 0;
+
+// Queue se nikala par agle frame ke liye rakha hua event
+static input_event_t deferred;
+static bool has_deferred = false;
+
+void init() {
+  sys_get_mouse(&mx, &my, &mb);
+  pmb = mb;
+}
+
+/* Event queue khaali karo: motion coalesce (bas aakhri position), keys
+   jama. Button change pe ruk jao - ek frame mein ek hi transition, taaki
+   press+release ek hi frame mein aaye toh bhi click na khoye. */
 void poll() {
   pmb = mb;
-  sys_get_mouse(&mx, &my, &mb);
+  key_count = 0;
+  key_pos = 0;
+  uint32_t press_time = 0;
+
+  input_event_t ev;
+  for (;;) {
+    if (has_deferred) {
+      ev = deferred;
+      has_deferred = false;
+    } else if (!input_read_event(&ev)) {
+      break;
+    }
+
+    if (ev.type == INPUT_EV_KEY) {
+      if (key_count == INPUT_KEYS_MAX) {
+        deferred = ev;
+        has_deferred = true;
+        break;
+      }
+      if (ev.value)
+        keys[key_count++] = ev.code;
+      continue;
+    }
+
+    mx = ev.x;
+    my = ev.y;
+    if (ev.type == INPUT_EV_BUTTON && (int)ev.buttons != mb) {
+      mb = ev.buttons;
+      press_time = ev.time_ms;
+      break;
+    }
+  }
 
   if ((mb & 1) && !(pmb & 1)) {
-    uint32_t now = sys_time_ms();
+    uint32_t now = press_time;
     int dx = mx - last_click_x;
     int dy = my - last_click_y;
     if (dx < 0)
@@ -406,8 +745,136 @@ inline bool inside_rect(Rect r) {
 }
 
 inline bool is_double_click() { return g_is_double_click; }
+
+// Is frame ki agli key (sirf press)
+inline bool read_key(int *k) {
+  if (key_pos == key_count)
+    return false;
+  *k = keys[key_pos++];
+  return true;
+}
 } // namespace Input
 
+/* =========================================================
+   DAMAGE TRACKER (Sirf badla hua hissa dobara banao)
+   Har frame mein jo bhi screen pe badla (window move, cursor, IPC invalidate,
+   widget update) uska rect yahan jama hota hai. Compositor sirf inhi rects
+   ko clip karke redraw aur swap karta hai; list khaali = frame skip.
+   ========================================================= */
+namespace Damage {
+#define DAMAGE_MAX_RECTS 16
+// Do rects ko ek bana do agar union mein itne se zyada pixels waste na hon
+#define DAMAGE_MERGE_SLACK (64 * 64)
+
+static Rect rects[DAMAGE_MAX_RECTS];
+static int count = 0;
+
+// Doosre thread/syscall (fs_phase_c) se aata hai - frame ke start pe uthate hain
+static volatile bool pending_all = false;
+
+static inline int area(const Rect &r) { return r.w * r.h; }
+
+static inline Rect unite(const Rect &a, const Rect &b) {
+  int x0 = a.x < b.x ? a.x : b.x;
+  int y0 = a.y < b.y ? a.y : b.y;
+  int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+  int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+  return {x0, y0, x1 - x0, y1 - y0};
+}
+
+static inline int overlap(const Rect &a, const Rect &b) {
+  int x0 = a.x > b.x ? a.x : b.x;
+  int y0 = a.y > b.y ? a.y : b.y;
+  int x1 = a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w;
+  int y1 = a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h;
+  if (x1 <= x0 || y1 <= y0)
+    return 0;
+  return (x1 - x0) * (y1 - y0);
+}
+
+// Union karne se kitne extra (bina damage wale) pixels redraw honge
+static inline int merge_cost(const Rect &a, const Rect &b) {
+  return area(unite(a, b)) - (area(a) + area(b) - overlap(a, b));
+}
+
+void clear() { count = 0; }
+bool empty() { return count == 0; }
+
+void add(int x, int y, int w, int h) {
+  // Screen ke bahar ka hissa kaat do
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (x + w > FB::W)
+    w = FB::W - x;
+  if (y + h > FB::H)
+    h = FB::H - y;
+  if (w <= 0 || h <= 0)
+    return;
+
+  Rect r = {x, y, w, h};
+
+  // Sasta merge milta rahe tab tak jodte raho (union naye rects ko bhi
+  // overlap kar sakta hai, isliye loop)
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (int i = 0; i < count; i++) {
+      if (merge_cost(rects[i], r) <= DAMAGE_MERGE_SLACK) {
+        r = unite(rects[i], r);
+        rects[i] = rects[--count];
+        merged = true;
+        break;
+      }
+    }
+  }
+
+  if (count < DAMAGE_MAX_RECTS) {
+    rects[count++] = r;
+    return;
+  }
+
+  // List bhar gayi: jis rect ke saath sabse kam waste ho usme mila do
+  int best = 0, best_cost = merge_cost(rects[0], r);
+  for (int i = 1; i < count; i++) {
+    int c = merge_cost(rects[i], r);
+    if (c < best_cost) {
+      best = i;
+      best_cost = c;
+    }
+  }
+  rects[best] = unite(rects[best], r);
+}
+
+inline void add(Rect r) { add(r.x, r.y, r.w, r.h); }
+
+// Saare damage rects ka bounding box (display list recording ka clip)
+Rect bounds() {
+  Rect b = rects[0];
+  for (int i = 1; i < count; i++)
+    b = unite(b, rects[i]);
+  return b;
+}
+
+// Har add_all pe badhta hai - window surfaces isse dekh ke poora re-render
+// karti hain (click, FS change: kisi bhi window ka content badal sakta hai)
+static uint32_t epoch = 0;
+
+void add_all() {
+  count = 0;
+  add(0, 0, FB::W, FB::H);
+  epoch++;
+}
+} // namespace Damage
+
+// Kernel ke kisi bhi hisse se "poori screen dobara banao" (e.g. FS badla)
+extern "C" void compositor_invalidate() { Damage::pending_all = true; }
+
 /* =========================================================
    1️⃣ FRAMEBUFFER UTILS (Screen pe rang bharna)
    ========================================================= */
@@ -424,21 +891,164 @@ FontHandle font_load(const char *name, int size) {
   return {size, true};
 }
 
-void draw_text(FontHandle f, int x, int y, const char *s, uint32_t c) {
-  int scale = (f.size > 8) ? 2 : 1;
+/* ---------- Glyph cache ----------
+   Har glyph har scale pe ek baar "runs" mein expand hota hai: (row, x, len)
+   lagataar set pixels. Draw = har run ka ek span fill, color kuch bhi ho.
+   Pehle har set pixel (scale^2 baar) FB::put se jaata tha. */
+#define GLYPH_SCALES 2
+#define GLYPH_MAX_RUNS 64 // 16 rows x max 4 runs (scale 2)
 
-  while (*s) {
-    const uint8_t *g = font8x8_basic[(int)*s++];
-    for (int r = 0; r < 8; r++) {
-      for (int b = 0; b < 8; b++) {
-        if (g[r] & (1 << (7 - b))) {
-          for (int sy = 0; sy < scale; sy++)
-            for (int sx = 0; sx < scale; sx++)
-              FB::put(x + b * scale + sx, y + r * scale + sy, c);
+struct GlyphRun {
+  uint8_t row, x, len;
+};
+
+struct CachedGlyph {
+  bool built;
+  uint8_t count;
+  GlyphRun runs[GLYPH_MAX_RUNS]; // row ke order mein
+};
+
+static CachedGlyph glyph_cache[GLYPH_SCALES][128];
+
+static const CachedGlyph &glyph(char ch, int scale) {
+  CachedGlyph &cg = glyph_cache[scale - 1][ch & 0x7F];
+  if (cg.built)
+    return cg;
+
+  const uint8_t *g = font8x8_basic[ch & 0x7F];
+  cg.count = 0;
+  for (int r = 0; r < 8; r++) {
+    for (int sy = 0; sy < scale; sy++) {
+      int b = 0;
+      while (b < 8) {
+        if (!(g[r] & (1 << (7 - b)))) {
+          b++;
+          continue;
         }
+        int start = b;
+        while (b < 8 && (g[r] & (1 << (7 - b))))
+          b++;
+        cg.runs[cg.count++] = {(uint8_t)(r * scale + sy),
+                               (uint8_t)(start * scale),
+                               (uint8_t)((b - start) * scale)};
       }
     }
-    x += 8 * scale;
+  }
+  cg.built = true;
+  return cg;
+}
+
+/* ---------- Text run cache ----------
+   Titlebar, icon labels, menu items har frame same string banate hain.
+   Poori string ke runs (glyph boundaries ke paar merged) cache karo. Key
+   string ka content hai, isliye title badla toh naya entry - purana LRU
+   mein nikal jaata hai. */
+#define TEXT_CACHE_SIZE 32
+#define TEXT_CACHE_MAX_LEN 32
+#define TEXT_CACHE_MAX_RUNS 512
+
+struct TextRun {
+  uint16_t x, len;
+  uint8_t row;
+};
+
+struct CachedText {
+  uint32_t hash;
+  uint32_t last_used; // 0 = khaali slot
+  uint8_t scale;
+  char str[TEXT_CACHE_MAX_LEN + 1];
+  uint16_t count;
+  TextRun runs[TEXT_CACHE_MAX_RUNS];
+};
+
+static CachedText text_cache[TEXT_CACHE_SIZE];
+static uint32_t text_cache_clock = 0;
+
+static uint32_t text_hash(const char *s, int len, int scale) {
+  uint32_t h = 2166136261u ^ scale; // FNV-1a
+  for (int i = 0; i < len; i++)
+    h = (h ^ (uint8_t)s[i]) * 16777619u;
+  return h;
+}
+
+// Runs banao (row-major, taaki agle glyph ka run pichhle se jud sake).
+// false = TEXT_CACHE_MAX_RUNS se zyada, glyph path use karo.
+static bool text_build(CachedText *t, const char *s, int len, int scale) {
+  t->count = 0;
+  for (int row = 0; row < 8 * scale; row++) {
+    for (int i = 0; i < len; i++) {
+      const CachedGlyph &g = glyph(s[i], scale);
+      for (int k = 0; k < g.count; k++) {
+        if (g.runs[k].row != row)
+          continue;
+        int x = i * 8 * scale + g.runs[k].x;
+        TextRun *prev = t->count ? &t->runs[t->count - 1] : nullptr;
+        if (prev && prev->row == row && prev->x + prev->len == x) {
+          prev->len += g.runs[k].len;
+          continue;
+        }
+        if (t->count == TEXT_CACHE_MAX_RUNS)
+          return false;
+        t->runs[t->count++] = {(uint16_t)x, g.runs[k].len, (uint8_t)row};
+      }
+    }
+  }
+  return true;
+}
+
+static CachedText *text_lookup(const char *s, int len, int scale) {
+  uint32_t h = text_hash(s, len, scale);
+  text_cache_clock++;
+
+  CachedText *victim = &text_cache[0];
+  for (int i = 0; i < TEXT_CACHE_SIZE; i++) {
+    CachedText *t = &text_cache[i];
+    if (t->last_used && t->hash == h && t->scale == scale &&
+        strcmp(t->str, s) == 0) {
+      t->last_used = text_cache_clock;
+      return t;
+    }
+    if (t->last_used < victim->last_used)
+      victim = t;
+  }
+
+  if (!text_build(victim, s, len, scale)) {
+    victim->last_used = 0;
+    return nullptr;
+  }
+  victim->hash = h;
+  victim->scale = scale;
+  strcpy(victim->str, s);
+  victim->last_used = text_cache_clock;
+  return victim;
+}
+
+void draw_text(FontHandle f, int x, int y, const char *s, uint32_t c) {
+  int scale = (f.size > 8) ? 2 : 1;
+  int len = strlen(s);
+  if (!FB::visible(x, y, len * 8 * scale, 8 * scale))
+    return;
+  if (gpu_recording) {
+    gpu_text(f.size, x, y, s, c);
+    return;
+  }
+
+  if (len <= TEXT_CACHE_MAX_LEN) {
+    CachedText *t = text_lookup(s, len, scale);
+    if (t) {
+      for (int i = 0; i < t->count; i++)
+        FB::hspan(x + t->runs[i].x, y + t->runs[i].row, t->runs[i].len, c);
+      return;
+    }
+  }
+
+  // Lambi lines (terminal) - glyph runs seedhe
+  for (int i = 0; i < len; i++, x += 8 * scale) {
+    if (!FB::visible(x, y, 8 * scale, 8 * scale))
+      continue; // Clip ke bahar - glyph skip
+    const CachedGlyph &g = glyph(s[i], scale);
+    for (int k = 0; k < g.count; k++)
+      FB::hspan(x + g.runs[k].x, y + g.runs[k].row, g.runs[k].len, c);
   }
 }
 
@@ -468,7 +1078,18 @@ enum IconID {
   ICON_NOTEPAD
 };
 
+// Sabse bada icon (monitor ke graph bars) origin se ~20px tak jaata hai
+static inline Rect icon_extent(int x, int y, int size) {
+  return {x, y, (size > 20 ? size : 20) + 2, size + 4};
+}
+
 void draw_icon(IconID id, int x, int y, int size, uint32_t accent) {
+  if (gpu_recording) {
+    Rect b = icon_extent(x, y, size);
+    if (FB::visible(b.x, b.y, b.w, b.h))
+      gpu_icon(id, b, size, accent);
+    return;
+  }
   switch (id) {
   case ICON_FOLDER:
     // Folder tab
@@ -546,6 +1167,257 @@ void draw_icon(IconID id, int x, int y, int size, uint32_t accent) {
 
 } // namespace IconSystem
 
+/* ⏱️ FRAME PROFILER (Kaunsa stage kitna khaata hai)
+   Compositor loop ke har stage ka TSC time, 1 second ki window mein jodke
+   per-frame average. F12 = overlay on/off (FPS, ms per stage, pixels
+   likhe gaye, damage area). F11 = benchmark: scripted scene N baar bina
+   present ke render, result serial log mein. Har rendering optimization
+   isi se naapo. */
+extern "C" {
+extern uint32_t tick;
+}
+
+namespace Profiler {
+enum Stage {
+  PROF_INPUT,   // Input::poll + WindowServer::poll
+  PROF_NET,     // net_poll
+  PROF_RECORD,  // compose_scene -> display list
+  PROF_DESKTOP, // Layer 0 execute (wallpaper, icons)
+  PROF_WINDOWS, // Window layers execute
+  PROF_OVERLAY, // Taskbar, menu, dialog, cursor
+  PROF_PRESENT, // FB::present (back buffer -> LFB)
+  PROF_STAGES
+};
+static const char *stage_names[PROF_STAGES] = {
+    "input", "net", "record", "desktop", "windows", "overlay", "present"};
+
+#define PROF_WINDOW_TICKS 50 // 1 second (50 Hz timer)
+#define PROF_MS_PER_TICK 20  // 50 Hz timer
+#define PROF_KEY_OVERLAY 15  // F12 (keyboard.cpp)
+#define PROF_KEY_BENCH 16    // F11
+#define GUI_BENCH_FRAMES 120
+#define PROF_LINES (PROF_STAGES + 3)
+
+static bool overlay = false;
+static uint32_t cycles_per_us = 1;
+static uint64_t mark_tsc = 0;
+
+// Chalu window: sirf 32-bit jod (ek second ke cycles 4 GHz tak fit)
+static uint32_t cycles[PROF_STAGES];
+static uint32_t pixels = 0, damage_px = 0, frames = 0;
+static uint32_t idle_frames = 0; // Input/net inme bhi chalte hain
+static uint32_t window_start = 0;
+
+// Pichli window ka result - overlay yahi dikhata hai
+static uint32_t shown_us[PROF_STAGES];
+static uint32_t shown_fps = 0, shown_pixels = 0, shown_damage = 0;
+
+static volatile int bench_pending = 0; // Doosre thread se request
+
+static inline Stage stage_of(int layer) {
+  if (layer == 0)
+    return PROF_DESKTOP;
+  return layer < GPU_LAYER_OVERLAY ? PROF_WINDOWS : PROF_OVERLAY;
+}
+
+// Ek timer tick mein kitne cycles - tsc_calibrate ka estimate loop-based
+// hai, isliye yahan tick edge se tick edge naapte hain (max ~40 ms spin)
+void init() {
+  volatile uint32_t *t = &tick;
+  uint32_t t0 = *t;
+  while (*t == t0)
+    asm volatile("pause");
+  uint64_t c0 = rdtsc();
+  t0 = *t;
+  while (*t == t0)
+    asm volatile("pause");
+  uint32_t per_tick = (uint32_t)(rdtsc() - c0);
+  cycles_per_us = per_tick / (1000 * PROF_MS_PER_TICK);
+  if (cycles_per_us == 0)
+    cycles_per_us = 1;
+  window_start = tick;
+  serial_log_hex("PROF: TSC cycles per us: ", cycles_per_us);
+}
+
+static void reset() {
+  for (int s = 0; s < PROF_STAGES; s++)
+    cycles[s] = 0;
+  pixels = damage_px = frames = idle_frames = 0;
+}
+
+inline void frame_begin() { mark_tsc = rdtsc(); }
+
+// Pichle mark se ab tak ka time is stage ke khaate mein
+inline void lap(Stage s) {
+  uint64_t now = rdtsc();
+  cycles[s] += (uint32_t)(now - mark_tsc);
+  mark_tsc = now;
+}
+
+inline void add_pixels(int n) { pixels += n; }
+inline void frame_idle() { idle_frames++; }
+
+static inline uint32_t avg_us(uint32_t c, uint32_t n) {
+  return n ? c / cycles_per_us / n : 0;
+}
+
+Rect bounds() { return {FB::W - 200, 8, 192, PROF_LINES * 10 + 8}; }
+
+void count_damage(const Rect *rects, int count) {
+  for (int i = 0; i < count; i++)
+    damage_px += rects[i].w * rects[i].h;
+}
+
+// Frame present ho gaya. Second poora hua toh numbers overlay ke liye publish.
+void frame_end(const Rect *rects, int count) {
+  count_damage(rects, count);
+  frames++;
+
+  uint32_t elapsed = tick - window_start;
+  if (elapsed < PROF_WINDOW_TICKS)
+    return;
+  for (int s = 0; s < PROF_STAGES; s++)
+    shown_us[s] = avg_us(cycles[s], s <= PROF_NET ? frames + idle_frames
+                                                  : frames);
+  shown_fps = frames * PROF_WINDOW_TICKS / elapsed;
+  shown_pixels = pixels / frames;
+  shown_damage = damage_px / frames;
+  reset();
+  window_start = tick;
+  if (overlay)
+    Damage::add(bounds());
+}
+
+// "label   12.34 ms"
+static void format_us(char *out, const char *label, uint32_t us) {
+  char num[12];
+  strcpy(out, label);
+  int n = strlen(out);
+  while (n < 9)
+    out[n++] = ' ';
+  out[n] = 0;
+  itoa(us / 1000, num, 10);
+  strcat(out, num);
+  strcat(out, ".");
+  uint32_t frac = (us % 1000) / 10;
+  if (frac < 10)
+    strcat(out, "0");
+  itoa(frac, num, 10);
+  strcat(out, num);
+  strcat(out, " ms");
+}
+
+static void format_count(char *out, const char *label, uint32_t v) {
+  char num[12];
+  strcpy(out, label);
+  itoa(v, num, 10);
+  strcat(out, num);
+}
+
+void draw() {
+  if (!overlay)
+    return;
+  Rect b = bounds();
+  FB::blend_rect(b.x, b.y, b.w, b.h, 0x000000, 180);
+  auto font = FontSystem::font_load("default", 8);
+  char line[48];
+  int y = b.y + 4;
+
+  format_count(line, "FPS      ", shown_fps);
+  FontSystem::draw_text(font, b.x + 8, y, line, 0x80FF80);
+  y += 10;
+  for (int s = 0; s < PROF_STAGES; s++) {
+    format_us(line, stage_names[s], shown_us[s]);
+    FontSystem::draw_text(font, b.x + 8, y, line, 0xFFFFFF);
+    y += 10;
+  }
+  format_count(line, "pixels   ", shown_pixels);
+  FontSystem::draw_text(font, b.x + 8, y, line, 0xFFD180);
+  y += 10;
+  format_count(line, "damage   ", shown_damage);
+  FontSystem::draw_text(font, b.x + 8, y, line, 0xFFD180);
+}
+
+void toggle() {
+  overlay = !overlay;
+  Damage::add(bounds());
+}
+
+static void log_result(const char *phase, int n) {
+  char line[64];
+  serial_log(phase);
+  for (int s = PROF_RECORD; s <= PROF_OVERLAY; s++) {
+    format_us(line, stage_names[s], avg_us(cycles[s], n));
+    serial_log(line);
+  }
+  format_count(line, "pixels/frame ", pixels / n);
+  serial_log(line);
+  format_count(line, "damage/frame ", damage_px / n);
+  serial_log(line);
+}
+} // namespace Profiler
+
+// Kernel ke kisi bhi hisse se benchmark maango (compositor thread chalayega)
+extern "C" void compositor_request_benchmark() {
+  Profiler::bench_pending = 1;
+}
+
+// Display list ko ek tile (damage rect) ke liye chalao. Tiles ek doosre se
+// independent hain - har tile apna clip leke poori list pe ek pass.
+void gpu_execute(Rect tile) {
+  Profiler::Stage stage = Profiler::PROF_DESKTOP;
+  FB::set_clip(tile);
+  for (int i = 0; i < gpu_count; i++) {
+    const GpuCmd &c = gpu_cmds[i];
+    if (!rect_overlaps(c.r, tile))
+      continue;
+
+    // Sirf tile ke andar wala hissa occlusion ke liye dekho
+    Rect v = c.r;
+    int vx1 = v.x + v.w, vy1 = v.y + v.h;
+    if (v.x < tile.x)
+      v.x = tile.x;
+    if (v.y < tile.y)
+      v.y = tile.y;
+    if (vx1 > tile.x + tile.w)
+      vx1 = tile.x + tile.w;
+    if (vy1 > tile.y + tile.h)
+      vy1 = tile.y + tile.h;
+    v.w = vx1 - v.x;
+    v.h = vy1 - v.y;
+    if (gpu_occluded(v, c.layer))
+      continue;
+
+    // Layer badli toh ab tak ka time pichle stage ka
+    Profiler::Stage st = Profiler::stage_of(c.layer);
+    if (st != stage) {
+      Profiler::lap(stage);
+      stage = st;
+    }
+    Profiler::add_pixels(v.w * v.h);
+
+    switch (c.type) {
+    case GPU_RECT:
+      FB::rect(c.r.x, c.r.y, c.r.w, c.r.h, c.color);
+      break;
+    case GPU_BLEND_RECT:
+      FB::blend_rect(c.r.x, c.r.y, c.r.w, c.r.h, c.color, c.alpha);
+      break;
+    case GPU_TEXT:
+      FontSystem::draw_text({c.arg, true}, c.r.x, c.r.y, c.text, c.color);
+      break;
+    case GPU_ICON:
+      IconSystem::draw_icon((IconSystem::IconID)c.icon_id, c.r.x, c.r.y, c.arg,
+                            c.color);
+      break;
+    case GPU_BLIT:
+      FB::blit(c.r.x, c.r.y, c.r.w, c.r.h, c.src, c.arg);
+      break;
+    }
+  }
+  Profiler::lap(stage);
+}
+
 /* =========================================================
    UI TOOLKIT (Phase 4)
    ========================================================= */
@@ -761,13 +1633,24 @@ void handle_context_input() {
   }
 }
 
+// Menu + uski shadow (4px)
+Rect context_menu_bounds() {
+  return {g_ctx_menu.area.x, g_ctx_menu.area.y, g_ctx_menu.area.w + 4,
+          g_ctx_menu.area.h + 4};
+}
+
+Rect rename_dialog_bounds() {
+  return {(FB::W - 300) / 2, (FB::H - 100) / 2, 300, 100};
+}
+
 void draw_rename_dialog() {
   if (!g_rename.active)
     return;
 
-  int w = 300, h = 100;
-  int x = (FB::W - w) / 2;
-  int y = (FB::H - h) / 2;
+  Rect d = rename_dialog_bounds();
+  int w = d.w, h = d.h;
+  int x = d.x;
+  int y = d.y;
 
   // Background
   FB::rect(x, y, w, h, 0xFFFFFF);
@@ -890,6 +1773,7 @@ struct Window;
 typedef void (*DrawFn)(Window *);
 typedef bool (*ClickFn)(Window *, int, int);
 typedef void (*KeyFn)(Window *, int, int);
+typedef void (*TickFn)(Window *); // Har frame: apne aap badalne wala content
 
 #define MAX_DESKTOPS 4
 
@@ -906,25 +1790,101 @@ struct Window {
   DrawFn draw;
   ClickFn click;
   KeyFn key;
-  uint32_t *backbuffer;
+  uint32_t *backbuffer; // IPC: shm ka front buffer (sirf isi se padhte hain)
+  gui_surface_ctrl_t *shm;
   int id;
   int client_fd;
 
   ContextProvider context_provider;
+
+  // Segment client bhi likh sakta hai - buffer pointers, front aur fence
+  // compositor ki apni copy hai, shm se sirf `committed` padha jaata hai
+  uint32_t *shm_pixels[GUI_SURFACE_BUFFERS] = {nullptr, nullptr};
+  uint32_t shm_front = 0;
+  uint32_t shm_fence = 0;
+
+  TickFn tick = nullptr;    // Terminal output, clock jaisa content -> damage
+  uint32_t tick_last = 0;   // Tick hook ka apna state (last phase/second)
+  bool wants_hover = false; // Mouse move pe repaint chahiye (hover highlight)
+
+  // Pichle frame mein screen pe kaisa tha - damage diff ke liye
+  Rect damage_prev = {0, 0, 0, 0};
+  bool damage_shown = false;
+  bool damage_focused = false;
+
+  // Z-order: desktop ki doubly linked list (neeche -> upar). Slots kabhi
+  // move nahi hote, isliye Window* hamesha valid rehta hai.
+  Window *z_below = nullptr;
+  Window *z_above = nullptr;
+
+  // Client area ka cached render. Sirf surface_dirty (window-relative)
+  // dobara banta hai; move/raise/expose pe bas blit.
+  uint32_t *surface = nullptr;
+  uint32_t surface_cap = 0; // Pixels (resize pe chhota hua toh realloc nahi)
+  int surface_w = 0, surface_h = 0;
+  Rect surface_dirty = {0, 0, 0, 0}; // w = 0 -> saaf
+  uint32_t surface_epoch = 0;
 };
 
-void execute_ipc_draw(Window *w) {
-  if (w->backbuffer) {
-    for (int j = 0; j < w->h; j++) {
-      for (int i = 0; i < w->w; i++) {
-        FB::put(w->x + i, w->y + j, w->backbuffer[j * w->w + i]);
-      }
-    }
+// Titlebar (28px upar) aur shadow (6px right/bottom) samet poora area
+static inline Rect window_bounds(const Window *w) {
+  return {w->x, w->y - 28, w->w + 6, w->h + 34};
+}
+
+// Surface ka yeh hissa (window-relative, pehle se clipped) purana ho gaya
+static void surface_invalidate(Window *w, int x, int y, int rw, int rh) {
+  Rect r = {x, y, rw, rh};
+  Rect &d = w->surface_dirty;
+  if (d.w <= 0 || d.h <= 0) {
+    d = r;
+    return;
+  }
+  int x1 = d.x + d.w > x + rw ? d.x + d.w : x + rw;
+  int y1 = d.y + d.h > y + rh ? d.y + d.h : y + rh;
+  d.x = d.x < x ? d.x : x;
+  d.y = d.y < y ? d.y : y;
+  d.w = x1 - d.x;
+  d.h = y1 - d.y;
+}
+
+static inline void window_damage(Window *w) {
+  surface_invalidate(w, 0, 0, w->w, w->h);
+  Damage::add(window_bounds(w));
+}
+
+// Client area ka ek hissa (window-relative coords), client ke bahar kaata hua
+void window_damage_rect(Window *w, int x, int y, int rw, int rh) {
+  if (x < 0) {
+    rw += x;
+    x = 0;
+  }
+  if (y < 0) {
+    rh += y;
+    y = 0;
+  }
+  if (x + rw > w->w)
+    rw = w->w - x;
+  if (y + rh > w->h)
+    rh = w->h - y;
+  if (rw > 0 && rh > 0) {
+    surface_invalidate(w, x, y, rw, rh);
+    Damage::add(w->x + x, w->y + y, rw, rh);
   }
 }
 
-static Window windows[MAX_DESKTOPS][16];
-static int win_count[MAX_DESKTOPS] = {0};
+void execute_ipc_draw(Window *w) {
+  if (!w->backbuffer)
+    return;
+  // Sirf clip ke andar wali rows/columns copy karo
+  FB::blit(w->x, w->y, w->w, w->h, w->backbuffer, w->w);
+}
+
+#define WIN_SLOTS 16
+
+static Window windows[MAX_DESKTOPS][WIN_SLOTS];
+static Window *z_bottom[MAX_DESKTOPS]; // Sabse neeche (pehle draw)
+static Window *z_top[MAX_DESKTOPS];    // Sabse upar (pehle input)
+static Window *focused_win[MAX_DESKTOPS];
 static int current_desktop = 0;
 static Window *dragging = nullptr;
 static Window *resizing = nullptr;
@@ -943,65 +1903,252 @@ ResizeEdge detect_resize(Window *w, int mx, int my) {
   return EDGE_NONE;
 }
 
-void focus_window(int index);
+/* ---------- Z-order (O(1) raise/lower) ----------
+   Pehle focus pe poore Window structs shift hote the aur band windows
+   compaction mein copy hoti thin - dragging/resizing jaise pointers galat
+   window pe chale jaate the. Ab slot fixed hai, sirf links badalte hain. */
+static void z_unlink(Window *w) {
+  int d = current_desktop;
+  if (w->z_below)
+    w->z_below->z_above = w->z_above;
+  else if (z_bottom[d] == w)
+    z_bottom[d] = w->z_above;
+  if (w->z_above)
+    w->z_above->z_below = w->z_below;
+  else if (z_top[d] == w)
+    z_top[d] = w->z_below;
+  w->z_below = w->z_above = nullptr;
+}
+
+static void z_link_top(Window *w) {
+  int d = current_desktop;
+  w->z_below = z_top[d];
+  w->z_above = nullptr;
+  if (z_top[d])
+    z_top[d]->z_above = w;
+  else
+    z_bottom[d] = w;
+  z_top[d] = w;
+}
+
+static void z_link_bottom(Window *w) {
+  int d = current_desktop;
+  w->z_above = z_bottom[d];
+  w->z_below = nullptr;
+  if (z_bottom[d])
+    z_bottom[d]->z_below = w;
+  else
+    z_top[d] = w;
+  z_bottom[d] = w;
+}
+
+void focus_window(Window *w) {
+  Window *&f = focused_win[current_desktop];
+  if (f && f != w)
+    f->focused = false;
+  f = w;
+  if (!w)
+    return;
+  w->focused = true;
+  if (z_top[current_desktop] != w) {
+    z_unlink(w);
+    z_link_top(w);
+  }
+}
+
+// Sabse neeche bhejo, focus ab upar wali window ko
+void lower_window(Window *w) {
+  z_unlink(w);
+  z_link_bottom(w);
+  Window *top = z_top[current_desktop];
+  focus_window(top != w ? top : nullptr);
+}
+
+void close_window(Window *w) {
+  w->fade.target = 0.0f;
+  w->alive = false;
+  w->focused = false;
+  z_unlink(w);
+  if (focused_win[current_desktop] == w)
+    focused_win[current_desktop] = nullptr;
+  if (dragging == w)
+    dragging = nullptr;
+  if (resizing == w)
+    resizing = nullptr;
+  if (w->surface) {
+    kfree(w->surface);
+    w->surface = nullptr;
+    w->surface_cap = 0;
+  }
+}
 
 Window *create_window(int x, int y, int w, int h, const char *t,
                       ThemeEngine::Theme *theme, DrawFn d, ClickFn c) {
   static int next_win_id = 1;
   Window *win = nullptr;
 
-  // Try to reuse a dead slot
-  for (int i = 0; i < win_count[current_desktop]; i++) {
-    if (!windows[current_desktop][i].alive) {
-      win = &windows[current_desktop][i];
+  // Khali slot. Jo abhi band hui aur jiska purana area damage_scan ne nahi
+  // uthaya (damage_shown), use is frame mein dobara mat do.
+  for (int i = 0; i < WIN_SLOTS; i++) {
+    Window *s = &windows[current_desktop][i];
+    if (!s->alive && !s->damage_shown) {
+      win = s;
       break;
     }
   }
 
-  // Use new slot if available
-  if (!win && win_count[current_desktop] < 16) {
-    win = &windows[current_desktop][win_count[current_desktop]++];
-  }
-
   if (win) {
     *win = {x,     y,    w,       h,       {0},
-            theme, true, true,    false,   {1.0f, 1.0f, 0.05f},
-            d,     c,    nullptr, nullptr, next_win_id++};
+            theme, true, false,   false,   {1.0f, 1.0f, 0.05f},
+            d,     c,    nullptr, nullptr, nullptr, next_win_id++};
     for (int i = 0; t && t[i] && i < 63; i++)
       win->title[i] = t[i];
-    focus_window(win_count[current_desktop] - 1);
+    z_link_top(win);
+    focus_window(win);
     return win;
   }
   return nullptr; // Too many windows
 }
 
-void focus_window(int index) {
-  int count = win_count[current_desktop];
-  if (index < 0 || index >= count)
-    return;
+void switch_desktop(int d) {
+  if (d >= 0 && d < MAX_DESKTOPS)
+    current_desktop = d;
+}
 
-  for (int i = 0; i < count; i++)
-    windows[current_desktop][i].focused = false;
+// Point ke neeche sabse upar wali zinda window (titlebar samet)
+Window *window_at(int px, int py) {
+  for (Window *w = z_top[current_desktop]; w; w = w->z_below)
+    if (inside(window_bounds(w), px, py))
+      return w;
+  return nullptr;
+}
 
-  Window tmp = windows[current_desktop][index];
-  for (int i = index; i < count - 1; i++)
-    windows[current_desktop][i] = windows[current_desktop][i + 1];
-  windows[current_desktop][count - 1] = tmp;
-  windows[current_desktop][count - 1].focused = true;
+/* Client area ka woh hissa jo upar wali windows ki opaque body ke neeche
+   nahi hai. Poori dhaki window ka client na render hota hai na blit. Rects
+   zyada ho jaayein toh poora client (painter's order phir bhi sahi hai). */
+#define WIN_VIS_MAX 32
+
+static int window_visible_region(const Window *w, Rect *vis) {
+  Rect c = {w->x, w->y, w->w, w->h};
+  if (!rect_overlaps(c, {0, 0, FB::W, FB::H}))
+    return 0;
+  int n = 1;
+  vis[0] = c;
+
+  for (const Window *o = w->z_above; o && n > 0; o = o->z_above) {
+    if (o->fade.value < 0.1f)
+      continue; // Draw hi nahi hoti
+    Rect body = {o->x, o->y, o->w, o->h};
+    Rect next[WIN_VIS_MAX];
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+      if (m + 4 > WIN_VIS_MAX) {
+        vis[0] = c;
+        return 1;
+      }
+      m += rect_subtract(vis[i], body, next + m);
+    }
+    for (int i = 0; i < m; i++)
+      vis[i] = next[i];
+    n = m;
+  }
+  return n;
 }
 
-void switch_desktop(int d) {
-  if (d >= 0 && d < MAX_DESKTOPS)
-    current_desktop = d;
+/* Window geometry ka diff: pichle frame se compare karke create/close/
+   focus/move/resize ka damage nikalo. Har jagah jahan x/y/w/h badalta hai
+   wahan haath se damage daalne se yeh zyada bharosemand hai. */
+static int damage_prev_desktop = -1;
+
+void damage_scan_windows() {
+  if (current_desktop != damage_prev_desktop) {
+    damage_prev_desktop = current_desktop;
+    Damage::add_all();
+  }
+
+  bool taskbar = false;
+  for (int i = 0; i < WIN_SLOTS; i++) {
+    Window *w = &windows[current_desktop][i];
+    Rect b = window_bounds(w);
+    bool shown = w->alive;
+    const Rect &p = w->damage_prev;
+
+    if (shown != w->damage_shown || w->focused != w->damage_focused) {
+      // Naya / band / focus badla (raise bhi yahi hai)
+      if (w->damage_shown)
+        Damage::add(p);
+      if (shown)
+        Damage::add(b);
+      taskbar = true;
+    } else if (shown &&
+               (b.x != p.x || b.y != p.y || b.w != p.w || b.h != p.h)) {
+      Damage::add(p);
+      Damage::add(b);
+    }
+    if (shown && w->fade.value != w->fade.target)
+      Damage::add(b);
+
+    w->damage_prev = b;
+    w->damage_shown = shown;
+    w->damage_focused = w->focused;
+  }
+
+  if (taskbar)
+    Damage::add(0, FB::H - 32, FB::W, 32);
 }
 
-void draw_window(Window *w) {
-  // Animate fade
-  AnimationEngine::animate(&w->fade);
+/* Surface ko taaza karo: sirf surface_dirty wala hissa, clip ke saath
+   body + draw callback seedha surface mein (display list mein nahi).
+   false = memory nahi mili, caller seedha screen pe draw kare. */
+static bool surface_update(Window *w) {
+  uint32_t need = (uint32_t)w->w * w->h;
+  if (need > w->surface_cap) {
+    if (w->surface)
+      kfree(w->surface);
+    w->surface = (uint32_t *)kmalloc(need * 4);
+    w->surface_cap = w->surface ? need : 0;
+    if (!w->surface)
+      return false;
+  }
+  // Resize (pitch badla) ya add_all: poora banao
+  if (w->surface_w != w->w || w->surface_h != w->h ||
+      w->surface_epoch != Damage::epoch) {
+    w->surface_w = w->w;
+    w->surface_h = w->h;
+    w->surface_epoch = Damage::epoch;
+    w->surface_dirty = {0, 0, w->w, w->h};
+  }
+
+  Rect d = w->surface_dirty;
+  if (d.w <= 0 || d.h <= 0)
+    return true;
+
+  bool rec = gpu_recording;
+  Rect clip = FB::get_clip();
+  gpu_recording = false;
+  FB::bind(w->surface, {w->x, w->y, w->w, w->h});
+  FB::set_clip({w->x + d.x, w->y + d.y, d.w, d.h});
+
+  FB::rect(w->x, w->y, w->w, w->h, w->theme->bg);
+  if (w->draw)
+    w->draw(w);
 
+  FB::unbind();
+  FB::set_clip(clip);
+  gpu_recording = rec;
+  w->surface_dirty = {0, 0, 0, 0};
+  return true;
+}
+
+void draw_window(Window *w) {
   if (w->fade.value < 0.1f)
     return; // Fully faded out
 
+  // Is damage rect ko chhuti hi nahi toh poori window skip
+  Rect b = window_bounds(w);
+  if (!FB::visible(b.x, b.y, b.w, b.h))
+    return;
+
   // Shadow with blend
   FB::blend_rect(w->x + 6, w->y - 22, w->w, w->h + 28, 0x000000, 60);
 
@@ -1017,14 +2164,34 @@ void draw_window(Window *w) {
   IconSystem::draw_icon(IconSystem::ICON_CLOSE, w->x + w->w - 18, w->y - 18, 12,
                         0xFFFFFF);
 
-  // Body
-  FB::rect(w->x, w->y, w->w, w->h, w->theme->bg);
+  // Body - opaque hai, iske neeche ki windows/desktop cull ho sakte hain
+  gpu_occluder({w->x, w->y, w->w, w->h});
+
+  Rect vis[WIN_VIS_MAX];
+  int n = window_visible_region(w, vis);
+  if (n == 0)
+    return; // Client poora upar wali windows ke neeche
+
+  // IPC window ka SHM backbuffer khud hi surface hai
+  const uint32_t *src = w->backbuffer;
+  if (!src) {
+    if (!surface_update(w)) {
+      FB::rect(w->x, w->y, w->w, w->h, w->theme->bg);
+      if (w->draw)
+        w->draw(w);
+      return;
+    }
+    src = w->surface;
+  }
 
-  if (w->draw)
-    w->draw(w);
+  for (int i = 0; i < n; i++) {
+    const Rect &v = vis[i];
+    FB::blit(v.x, v.y, v.w, v.h, src + (v.y - w->y) * w->w + (v.x - w->x),
+             w->w);
+  }
 }
 
-bool handle_window_input(Window *w, int index) {
+bool handle_window_input(Window *w) {
   int mx = Input::x();
   int my = Input::y();
 
@@ -1033,12 +2200,11 @@ bool handle_window_input(Window *w, int index) {
     if (Input::clicked()) {
       if (mx >= w->x + w->w - 20 && mx < w->x + w->w - 4 && my >= w->y - 20 &&
           my < w->y - 4) {
-        w->fade.target = 0.0f;
-        w->alive = false;
+        close_window(w);
         return true;
       }
 
-      focus_window(index);
+      focus_window(w);
       dragging = w;
       drag_dx = mx - w->x;
       drag_dy = my - w->y;
@@ -1081,14 +2247,14 @@ bool handle_window_input(Window *w, int index) {
   if (edge != EDGE_NONE && Input::clicked()) {
     resizing = w;
     res_edge = edge;
-    focus_window(index);
+    focus_window(w);
     return true;
   }
 
   // Client area
   if (mx >= w->x && mx < w->x + w->w && my >= w->y && my < w->y + w->h) {
     if (Input::clicked()) {
-      focus_window(index);
+      focus_window(w);
       if (w->click)
         w->click(w, mx - w->x, my - w->y);
       return true;
@@ -1140,6 +2306,12 @@ static int drag_offset_y = 0;
 static int prev_x = 0;
 static int prev_y = 0;
 
+// Icon + selection highlight + label - damage ke liye
+Rect icon_bounds(int i) {
+  int text_w = strlen(icons[i].name) * 8;
+  return {icons[i].x - 4, icons[i].y - 4, text_w > 56 ? text_w + 4 : 56, 70};
+}
+
 void add_icon(const char *name, IconSystem::IconID icon, int x, int y,
               void (*launch)()) {
   if (icon_count >= MAX_ICONS)
@@ -1259,19 +2431,28 @@ void refresh() {
   } else {
     serial_log("DESKTOP: Failed to open Desktop dir");
   }
+  Damage::add_all(); // Icons add/remove/move ho sakte hain
 }
 
+#define WALLPAPER_PATH "/WALL.BMP"
+
 void draw_desktop() {
-  // Gradient background
-  for (int y = 0; y < FB::H; y++) {
-    uint32_t c = (y < FB::H / 2) ? 0x1E1E2F : 0x12121C;
-    for (int x = 0; x < FB::W; x++)
-      FB::put(x, y, c);
+  // Wallpaper ek baar decode + screen size pe scale hokar cache mein rehta
+  // hai - yahan sirf rows ka blit. Na mile toh purana gradient.
+  const bmp_image_t *wall = bmp_cache_get(WALLPAPER_PATH, FB::W, FB::H);
+  if (wall) {
+    FB::blit(0, 0, wall->width, wall->height, wall->pixels, wall->width);
+  } else {
+    FB::rect(0, 0, FB::W, FB::H / 2, 0x1E1E2F);
+    FB::rect(0, FB::H / 2, FB::W, FB::H - FB::H / 2, 0x12121C);
   }
 
   // Draw desktop icons
   auto font = FontSystem::font_load("default", 8);
   for (int i = 0; i < icon_count; i++) {
+    Rect b = icon_bounds(i);
+    if (!FB::visible(b.x, b.y, b.w, b.h))
+      continue;
     if (icons[i].selected) {
       FB::blend_rect(icons[i].x - 4, icons[i].y - 4, 56, 70, 0x7E57C2, 100);
     }
@@ -1360,6 +2541,8 @@ void handle_desktop_input() {
   }
 
   if (dragging_icon_index != -1) {
+    // Purani jagah saaf karni padegi - naye position ka damage neeche
+    Damage::add(icon_bounds(dragging_icon_index));
     if (Input::held()) {
       icons[dragging_icon_index].x = Input::x() - drag_offset_x;
       icons[dragging_icon_index].y = Input::y() - drag_offset_y;
@@ -1398,8 +2581,11 @@ void handle_desktop_input() {
         icons[dragging_icon_index].x = prev_x;
         icons[dragging_icon_index].y = prev_y;
       }
+      Damage::add(icon_bounds(dragging_icon_index));
       dragging_icon_index = -1;
+      return;
     }
+    Damage::add(icon_bounds(dragging_icon_index));
   }
 }
 
@@ -1438,6 +2624,26 @@ void open_item(const char *path) {
   }
 }
 
+// Drag karte waqt edge pe auto-scroll. Draw se bahar hai kyunki draw ab har
+// damage rect ke liye alag chalta hai.
+void explorer_tick(Window *w) {
+  int content_y = w->y + 40;
+  int content_h = w->h - 40;
+  if (!Input::held() || Input::x() < w->x + 160 || Input::y() < content_y ||
+      Input::y() >= content_y + content_h)
+    return;
+
+  int old = scroll_y;
+  if (Input::y() < content_y + 50)
+    scroll_y -= 5;
+  if (Input::y() > content_y + content_h - 50)
+    scroll_y += 5;
+  if (scroll_y < 0)
+    scroll_y = 0;
+  if (scroll_y != old)
+    window_damage_rect(w, 160, 40, w->w - 160, content_h);
+}
+
 void explorer_draw(Window *w) {
   auto font = FontSystem::font_load("default", 8);
   int sidebar_w = 160;
@@ -1503,16 +2709,6 @@ void explorer_draw(Window *w) {
   int visible_h = content_h;
   int content_x = w->x + sidebar_w;
 
-  if (Input::x() >= main_x && Input::y() >= content_y &&
-      Input::y() < content_y + content_h) {
-    if (Input::held() && Input::y() < content_y + 50)
-      scroll_y -= 5;
-    if (Input::held() && Input::y() > content_y + visible_h - 50)
-      scroll_y += 5;
-  }
-  if (scroll_y < 0)
-    scroll_y = 0;
-
   // 5. Icons / Files
   int icon_cols = (visible_w - 40) / 90;
   if (icon_cols < 1)
@@ -1673,9 +2869,8 @@ void on_right_click(int x, int y) {
   full_path[0] = 0;
 
   // Check if we hit a window (top to bottom)
-  for (int i = win_count[current_desktop] - 1; i >= 0; i--) {
-    Window *w = &windows[current_desktop][i];
-    if (!w->alive || w->fade.value < 0.5f)
+  for (Window *w = z_top[current_desktop]; w; w = w->z_below) {
+    if (w->fade.value < 0.5f)
       continue;
 
     Rect win_rect = {w->x, w->y, w->w, w->h};
@@ -1721,8 +2916,9 @@ void draw_taskbar() {
   auto font = FontSystem::font_load("default", 8);
   FontSystem::draw_text(font, 8, FB::H - 20, "MENU", 0xFFFFFF);
 
+  // Buttons slot order mein - raise/lower pe taskbar nahi khisakta
   int button_count = 0;
-  for (int i = 0; i < win_count[current_desktop]; i++) {
+  for (int i = 0; i < WIN_SLOTS; i++) {
     if (windows[current_desktop][i].alive) {
       uint32_t c = windows[current_desktop][i].focused ? 0x3A7AFE : 0x222222;
       FB::rect(80 + button_count * 110, FB::H - 32, 105, 32, c);
@@ -1752,11 +2948,16 @@ void draw_taskbar() {
 void handle_taskbar_click() {
   if (Input::clicked() && Input::y() > FB::H - 32) {
     int button_count = 0;
-    for (int i = 0; i < win_count[current_desktop]; i++) {
-      if (windows[current_desktop][i].alive) {
+    for (int i = 0; i < WIN_SLOTS; i++) {
+      Window *w = &windows[current_desktop][i];
+      if (w->alive) {
         if (Input::x() >= 80 + button_count * 110 &&
             Input::x() < 185 + button_count * 110) {
-          focus_window(i);
+          // Upar wali focused window ka button dobara = neeche bhej do
+          if (w->focused && z_top[current_desktop] == w)
+            lower_window(w);
+          else
+            focus_window(w);
           return;
         }
         button_count++;
@@ -1802,7 +3003,9 @@ void launch_explorer() {
                             &ThemeEngine::explorer_theme, explorer_draw,
                             explorer_click);
   w->wants_keyboard = true;
+  w->wants_hover = true;
   w->key = explorer_key;
+  w->tick = explorer_tick;
   w->context_provider = {nullptr, explorer_context_items};
 }
 
@@ -1962,6 +3165,7 @@ void term_exec(const char *cmd) {
     term_print("\n  echo <t>  - print text");
     term_print("\n  ping      - test network (ICMP)");
     term_print("\n  tcptest   - test TCP connection");
+    term_print("\n  netbench  - loopback TCP/UDP benchmark");
     term_print("\n  run <elf> - run program");
     term_print("\n  clear     - clear screen");
     term_print("\n  help      - this message");
@@ -2097,6 +3301,11 @@ void term_exec(const char *cmd) {
     sys_spawn("/TCPTEST.ELF", nullptr);
     return;
   }
+  if (strcmp(cmd, "netbench") == 0) {
+    term_print("\nNETBENCH: TCP/UDP over 127.0.0.1 (~6s)...\n");
+    sys_spawn("/NETBENCH.ELF", nullptr);
+    return;
+  }
   // Try to run as program if ends in .elf
   int cmdlen = strlen(cmd);
   if (cmdlen > 4 && strcmp(cmd + cmdlen - 4, ".elf") == 0) {
@@ -2136,10 +3345,22 @@ void term_init() {
   term_input[0] = 0;
 }
 
-void terminal_draw(Window *w) {
-  // Poll for program output first
-  poll_output();
+// Program output aur cursor blink - bina input ke bhi badalte hain
+void terminal_tick(Window *w) {
+  if (output_tail != output_head) {
+    poll_output();
+    window_damage(w);
+  }
 
+  uint32_t phase = (sys_time_ms() / 300) & 1;
+  if (phase != w->tick_last) {
+    w->tick_last = phase;
+    window_damage_rect(w, 8 + term_cursor_x * 8, 30 + term_cursor_y * 12, 8,
+                       10);
+  }
+}
+
+void terminal_draw(Window *w) {
   int px = w->x;
   int py = w->y;
 
@@ -2156,10 +3377,8 @@ void terminal_draw(Window *w) {
   // Draw input line at cursor position
   int input_y = py + 30 + term_cursor_y * 12;
 
-  // Blinking cursor
-  static int blink = 0;
-  blink++;
-  if ((blink / 15) % 2 == 0) {
+  // Blinking cursor (phase terminal_tick ne set kiya)
+  if (w->tick_last == 0) {
     int cursor_px = px + 8 + term_cursor_x * 8;
     FB::rect(cursor_px, input_y, 8, 10, term_theme.accent);
   }
@@ -2210,14 +3429,12 @@ void launch_terminal() {
       TerminalSystem::terminal_draw, TerminalSystem::terminal_click);
   w->wants_keyboard = true;
   w->key = TerminalSystem::terminal_key;
+  w->tick = TerminalSystem::terminal_tick;
 }
 
 /* =========================================================
    SYSTEM MONITOR (Shows memory, processes, system info)
    ========================================================= */
-extern "C" {
-extern uint32_t tick;
-}
 
 namespace SysMonitor {
 
@@ -2385,6 +3602,15 @@ void sysmon_draw(Window *w) {
   FontSystem::draw_text(font, value_x, line_y, "Higher-Half", 0xFFFFFF);
 }
 
+// Memory/uptime har second repaint
+void sysmon_tick(Window *w) {
+  uint32_t sec = sys_time_ms() / 1000;
+  if (sec != w->tick_last) {
+    w->tick_last = sec;
+    window_damage(w);
+  }
+}
+
 bool sysmon_click(Window *w, int x, int y) {
   (void)w;
   (void)x;
@@ -2396,8 +3622,11 @@ bool sysmon_click(Window *w, int x, int y) {
 
 void launch_sysmonitor() {
   serial_log("GUI: Launching System Monitor...");
-  create_window(250, 150, 320, 280, "System Monitor", &SysMonitor::sysmon_theme,
-                SysMonitor::sysmon_draw, SysMonitor::sysmon_click);
+  Window *w = create_window(250, 150, 320, 280, "System Monitor",
+                            &SysMonitor::sysmon_theme, SysMonitor::sysmon_draw,
+                            SysMonitor::sysmon_click);
+  if (w)
+    w->tick = SysMonitor::sysmon_tick;
 }
 
 /* =========================================================
@@ -2714,16 +3943,16 @@ extern "C" {
 
 // Kernel-internal helpers
 int k_read(int fd, void *buf, int size) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -1;
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   return vfs_read(desc->node, desc->offset, (uint8_t *)buf, size);
 }
 
 int k_write(int fd, void *buf, int size) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -1;
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   return vfs_write(desc->node, desc->offset, (uint8_t *)buf, size);
 }
 
@@ -2798,6 +4027,54 @@ bool ipc_window_click_callback(Window *w, int x, int y) {
   return false;
 }
 
+// Naye client ka segment: dono buffers saaf, buffer 0 front. Pixel pointers
+// yahin apne offsets se nikaalo - baad mein shm ke offsets pe bharosa nahi.
+static void surface_setup(gui_surface_ctrl_t *ctrl, int w, int h,
+                          uint32_t *pixels[GUI_SURFACE_BUFFERS]) {
+  uint32_t buf_bytes = sizeof(gui_surface_buffer_t) + (uint32_t)w * h * 4;
+  for (uint32_t i = 0; i < GUI_SURFACE_BUFFERS; i++) {
+    uint32_t off = sizeof(gui_surface_ctrl_t) + i * buf_bytes;
+    ctrl->buffer_offset[i] = off;
+    gui_surface_buffer_t *b = (gui_surface_buffer_t *)((uint8_t *)ctrl + off);
+    pixels[i] = b->pixels;
+    b->width = w;
+    b->height = h;
+    b->stride = w;
+    b->format = GUI_FMT_ARGB32;
+    memset(b->pixels, 0, (uint32_t)w * h * 4);
+  }
+  ctrl->front = 0;
+  ctrl->committed = 0;
+  ctrl->fence = 0;
+  ctrl->magic = SURFACE_MAGIC;
+}
+
+// Fence timeout ke baad client itne commits aage ja sakta hai; isse zyada
+// (ya peeche) = kachra, flip mat karo
+#define SURFACE_MAX_AHEAD 16
+
+/* Client ne commit kiya: front flip. Compositor pixels sirf frame render
+   karte waqt padhta hai, aur yeh poll usse pehle chalta hai - isliye flip ke
+   turant baad purana front free hai, fence wahin de do. Pixel copy nahi.
+   shm se sirf `committed` padhte hain; front/fence wahan sirf client ke liye
+   likhe jaate hain. */
+static void surface_commit(Window *w) {
+  gui_surface_ctrl_t *ctrl = w->shm;
+  if (!ctrl || !w->shm_pixels[0])
+    return;
+  uint32_t seq = ctrl->committed;
+  uint32_t ahead = seq - w->shm_fence;
+  if (ahead == 0)
+    return; // Purane protocol wala invalidate - sirf repaint
+  if (ahead > SURFACE_MAX_AHEAD)
+    return;
+  w->shm_front ^= 1;
+  w->shm_fence = seq;
+  w->backbuffer = w->shm_pixels[w->shm_front];
+  ctrl->front = w->shm_front;
+  ctrl->fence = seq;
+}
+
 // Helper to process a message blocking-ly (called once after accept to read
 // Create Window)
 void handle_client_setup(int fd) {
@@ -2809,10 +4086,17 @@ void handle_client_setup(int fd) {
       int h = msg.data.create.height;
       char *t = msg.data.create.title;
 
-      // Create SHM
-      uint32_t shm_size = w * h * 4;
-      int shmid = sys_shmget(0, shm_size, 0); // alloc
-      void *buf = (void *)sys_shmat(shmid);
+      // Create SHM: control block + do buffers (gui/surface.h)
+      gui_surface_ctrl_t *ctrl = nullptr;
+      uint32_t *pixels[GUI_SURFACE_BUFFERS] = {nullptr, nullptr};
+      int shmid = -1;
+      if (w > 0 && h > 0 && w <= 2048 && h <= 2048) {
+        shmid = sys_shmget(IPC_PRIVATE, gui_surface_size(w, h), 0);
+        if (shmid >= 0)
+          ctrl = (gui_surface_ctrl_t *)sys_shmat(shmid);
+      }
+      if (ctrl)
+        surface_setup(ctrl, w, h, pixels);
 
       // Create Window
       Window *win =
@@ -2824,8 +4108,13 @@ void handle_client_setup(int fd) {
         win->client_fd = fd;
       }
 
-      if (win && buf) {
-        win->backbuffer = (uint32_t *)buf;
+      if (win && ctrl) {
+        win->shm = ctrl;
+        for (uint32_t i = 0; i < GUI_SURFACE_BUFFERS; i++)
+          win->shm_pixels[i] = pixels[i];
+        win->shm_front = 0;
+        win->shm_fence = 0;
+        win->backbuffer = pixels[0];
         // Store window ID and connection ID relation if needed?
         // For now, we assume 1:1 and don't track carefully.
         // But wait, Invalidate has window_id.
@@ -2853,15 +4142,17 @@ void handle_client_msg(int fd) {
       // Update the window!
       // We need to find the window.
       // Since we don't have a map, let's search windows
-      int wid = msg.data.invalidate.window_id;
-      // Iterate all windows
-      for (int d = 0; d < 1; d++) {
-        for (int i = 0; i < win_count[d]; i++) {
-          if (windows[d][i].alive && windows[d][i].id == wid) {
-            // Refresh it!
-            // Since it has backbuffer, next draw_window loop will pick it up.
-            // But checking "dirty" flags might be optimized later.
-            // For now, just ensuring we read the msg clears the pipe.
+      // Commit har desktop pe lo (client fence ka wait kar raha hai), par
+      // damage sirf current desktop ka - doosre desktop pe switch hote hi
+      // poori screen waise bhi redraw hoti hai.
+      msg_gfx_invalidate_t inv = msg.data.invalidate; // packed - copy
+      for (int d = 0; d < MAX_DESKTOPS; d++) {
+        for (int i = 0; i < WIN_SLOTS; i++) {
+          Window *w = &windows[d][i];
+          if (w->alive && w->id == inv.window_id && w->client_fd == fd) {
+            surface_commit(w);
+            if (d == current_desktop)
+              window_damage_rect(w, inv.x, inv.y, inv.width, inv.height);
             break;
           }
         }
@@ -2881,7 +4172,7 @@ void init() {
     return;
   }
 
-  if (sys_bind(server_fd, WS_PORT) < 0) {
+  if (sys_bind(server_fd, WS_PORT, 0) < 0) {
     serial_log("WS: Failed to bind socket");
     return;
   }
@@ -2900,7 +4191,7 @@ void poll() {
 
   // 1. Accept new clients
   if (socket_can_accept(server_fd)) {
-    int client = sys_accept(server_fd);
+    int client = sys_accept(server_fd, 0, 0);
     if (client >= 0) {
       if (client_count < 16) {
         for (int i = 0; i < 16; i++) {
@@ -2934,9 +4225,119 @@ void poll() {
 
 } // namespace WindowServer
 
+// Poora scene neeche se upar. Recording mode mein display list banta hai,
+// warna seedha current clip mein draw hota hai.
+static void compose_scene() {
+  // Recording mein pixel nahi likhe jaate - sab time "record" ka
+  auto lap = [](Profiler::Stage s) {
+    Profiler::lap(gpu_recording ? Profiler::PROF_RECORD : s);
+  };
+
+  gpu_layer = 0;
+  DesktopSystem::draw_desktop();
+  lap(Profiler::PROF_DESKTOP);
+
+  int layer = 1;
+  for (Window *w = z_bottom[current_desktop]; w; w = w->z_above) {
+    gpu_layer = layer++;
+    draw_window(w);
+  }
+  lap(Profiler::PROF_WINDOWS);
+
+  gpu_layer = GPU_LAYER_OVERLAY;
+  if (g_rename.active) {
+    draw_rename_dialog();
+  }
+
+  if (g_ctx_menu.visible)
+    draw_context_menu();
+  else
+    draw_taskbar();
+
+  Profiler::draw();
+  draw_cursor(Input::x(), Input::y());
+  lap(Profiler::PROF_OVERLAY);
+}
+
+// Damage rects ka scene: ek baar display list mein record (damage ke
+// bounding box tak), phir har rect pe execute. Present caller karta hai.
+static void render_damage() {
+  FB::set_clip(Damage::bounds());
+  gpu_begin();
+  compose_scene();
+  gpu_end();
+
+  if (!gpu_overflow) {
+    for (int r = 0; r < Damage::count; r++)
+      gpu_execute(Damage::rects[r]);
+  } else {
+    // List chhoti pad gayi - purana tareeka, har rect pe scene seedha
+    for (int r = 0; r < Damage::count; r++) {
+      FB::set_clip(Damage::rects[r]);
+      compose_scene();
+    }
+  }
+  FB::reset_clip();
+}
+
+// Headless benchmark: na input, na net, na present - sirf scene render.
+// Do scripted phases: har frame poori screen (add_all, window surfaces bhi
+// dobara), aur ek 64x64 damage jo screen pe tircha chalta hai (drag/cursor).
+static void run_benchmark(int n) {
+  serial_log("BENCH: compositor benchmark start");
+
+  Profiler::reset();
+  for (int i = 0; i < n; i++) {
+    Damage::add_all();
+    Profiler::frame_begin();
+    render_damage();
+    Profiler::count_damage(Damage::rects, Damage::count);
+    Damage::clear();
+  }
+  Profiler::log_result("BENCH: full repaint", n);
+
+  Profiler::reset();
+  for (int i = 0; i < n; i++) {
+    Damage::add((i * 16) % (FB::W - 64), (i * 12) % (FB::H - 64), 64, 64);
+    Profiler::frame_begin();
+    render_damage();
+    Profiler::count_damage(Damage::rects, Damage::count);
+    Damage::clear();
+  }
+  Profiler::log_result("BENCH: 64x64 moving damage", n);
+
+  serial_log("BENCH: done");
+  Profiler::reset();
+  Profiler::window_start = tick;
+  Damage::add_all(); // Back buffer mein bench ke frames hain
+}
+
+/* Frame pacing: compositor timer ke hisaab se chalta hai, spin nahi karta.
+   50 Hz timer pe GUI_FRAME_TICKS = 1 matlab ~50 fps cap. */
+#define GUI_FRAME_TICKS 1
+
+static void frame_pace(uint32_t frame_start, bool idle) {
+  uint32_t deadline = frame_start + GUI_FRAME_TICKS;
+  if ((int32_t)(tick - deadline) >= 0) {
+    schedule(); // Frame late hua - phir bhi doosron ko mauka do
+    return;
+  }
+  if (!idle) {
+    schedule_timeout(deadline, nullptr);
+    return;
+  }
+  // Kuch draw nahi hua: input aate hi jaago, agle tick ka intezaar nahi.
+  // Waiter sirf yahin set hai, warna mouse IRQs fps cap tod dete.
+  input_set_waiter(current_process);
+  schedule_timeout(deadline, input_ready_flag());
+  input_set_waiter(nullptr);
+}
+
 extern "C" void gui_main() {
   bga_set_video_mode(1024, 768, 32);
   FB::init();
+  Input::init();
+  Profiler::init();
   load_dir();
   DesktopSystem::refresh();
 
@@ -2958,46 +4359,79 @@ extern "C" void gui_main() {
 
   serial_log("GUI: Entering main loop with net_poll");
 
+  Damage::add_all(); // Pehla frame poora banao
+  int last_mx = Input::x(), last_my = Input::y();
+
   while (true) {
+    uint32_t frame_start = tick;
+    Profiler::frame_begin();
     Input::poll();
     WindowServer::poll();
+    Profiler::lap(Profiler::PROF_INPUT);
     net_poll();
+    Profiler::lap(Profiler::PROF_NET);
 
-    // Fix 4: Keyboard Focus Contract
-    int k, ks;
-    if (sys_read_key(&k, &ks)) {
-      if (g_rename.active) {
-        handle_rename_key(k);
-      } else {
-        for (int i = win_count[current_desktop] - 1; i >= 0; i--) {
-          if (windows[current_desktop][i].alive &&
-              windows[current_desktop][i].focused &&
-              windows[current_desktop][i].key) {
-            windows[current_desktop][i].key(&windows[current_desktop][i], k,
-                                            ks);
-            break;
-          }
-        }
-      }
+    if (Profiler::bench_pending) {
+      Profiler::bench_pending = 0;
+      run_benchmark(GUI_BENCH_FRAMES);
     }
 
-    DesktopSystem::draw_desktop();
+    if (Damage::pending_all) {
+      Damage::pending_all = false;
+      Damage::add_all();
+    }
 
-    int count = win_count[current_desktop];
-    for (int i = 0; i < count; i++) {
-      if (windows[current_desktop][i].alive) {
-        draw_window(&windows[current_desktop][i]);
-      }
+    // Button press/release se kuch bhi badal sakta hai (selection, menu,
+    // explorer dir, naya app) - clicks kam hote hain, poora repaint sasta hai
+    if (Input::mb != Input::pmb)
+      Damage::add_all();
+
+    if (Input::x() != last_mx || Input::y() != last_my) {
+      // Cursor: purana aur naya 12x12 triangle
+      Damage::add(last_mx, last_my, 12, 12);
+      Damage::add(Input::x(), Input::y(), 12, 12);
+
+      // Hover highlight wali windows (explorer) - purani aur nayi dono
+      Window *a = window_at(last_mx, last_my);
+      Window *b = window_at(Input::x(), Input::y());
+      if (a && a->wants_hover)
+        window_damage(a);
+      if (b && b != a && b->wants_hover)
+        window_damage(b);
+
+      if (g_ctx_menu.visible)
+        Damage::add(context_menu_bounds());
+
+      last_mx = Input::x();
+      last_my = Input::y();
     }
 
-    if (g_rename.active) {
-      draw_rename_dialog();
+    // Fix 4: Keyboard Focus Contract
+    // Loop ab frame rate pe chalta hai, isliye saari pending keys ek saath
+    int k;
+    while (Input::read_key(&k)) {
+      if (k == PROF_KEY_OVERLAY) {
+        Profiler::toggle();
+      } else if (k == PROF_KEY_BENCH) {
+        Profiler::bench_pending = 1; // Agle frame ke shuru mein
+      } else if (g_rename.active) {
+        handle_rename_key(k);
+        if (g_rename.active)
+          Damage::add(rename_dialog_bounds());
+        else
+          Damage::add_all(); // Rename hua toh desktop/explorer refresh
+      } else {
+        Window *w = focused_win[current_desktop];
+        if (w && w->key) {
+          w->key(w, k, 1);
+          window_damage(w);
+        }
+      }
     }
 
     // Fix 5: Context Menu Priority
     if (g_ctx_menu.visible) {
       handle_context_input();
-      draw_context_menu();
     } else {
       // Global Right-Click detection
       if (Input::right_clicked()) {
@@ -3005,12 +4439,10 @@ extern "C" void gui_main() {
       }
 
       bool consumed = false;
-      for (int i = win_count[current_desktop] - 1; i >= 0; i--) {
-        if (windows[current_desktop][i].alive) {
-          if (handle_window_input(&windows[current_desktop][i], i)) {
-            consumed = true;
-            break;
-          }
+      for (Window *w = z_top[current_desktop]; w; w = w->z_below) {
+        if (handle_window_input(w)) {
+          consumed = true;
+          break;
         }
       }
 
@@ -3018,23 +4450,32 @@ extern "C" void gui_main() {
         DesktopSystem::handle_desktop_input();
         handle_taskbar_click();
       }
-      draw_taskbar();
     }
 
-    draw_cursor(Input::x(), Input::y());
+    // Widgets jo khud badalte hain + fade animation (frame mein ek baar)
+    for (Window *w = z_bottom[current_desktop]; w; w = w->z_above) {
+      AnimationEngine::animate(&w->fade);
+      if (w->tick)
+        w->tick(w);
+    }
 
-    // Fix 3: Compact window list
-    for (int i = 0; i < win_count[current_desktop];) {
-      if (!windows[current_desktop][i].alive &&
-          windows[current_desktop][i].fade.value < 0.1f) {
-        for (int j = i; j < win_count[current_desktop] - 1; j++)
-          windows[current_desktop][j] = windows[current_desktop][j + 1];
-        win_count[current_desktop]--;
-      } else {
-        i++;
-      }
+    // Band windows ke slots create_window dobara deta hai - compaction nahi
+    damage_scan_windows();
+
+    // Kuch nahi badla: na draw, na present - agle frame tak so jao
+    if (Damage::empty()) {
+      Profiler::frame_idle();
+      frame_pace(frame_start, true);
+      continue;
     }
 
-    FB::swap();
+    render_damage();
+
+    FB::present(Damage::rects, Damage::count);
+    Profiler::lap(Profiler::PROF_PRESENT);
+    Profiler::frame_end(Damage::rects, Damage::count);
+    Damage::clear();
+
+    frame_pace(frame_start, false);
   }
 }
@@ -0,0 +1,629 @@
+// inet.cpp - AF_INET sockets (TCP/UDP) for user processes
+// socket.cpp fd aur vfs node sambhalta hai; yahan sirf protocol ka kaam hai.
+// TCP ke liye tcp.cpp ka TCB use hota hai, UDP datagrams yahin queue hote hain.
+
+#include "../drivers/serial.h"
+#include "../include/errno.h"
+#include "../include/poll.h"
+#include "../include/string.h"
+#include "heap.h"
+#include "memory.h"
+#include "net.h"
+#include "process.h"
+#include "socket.h"
+#include "tcp.h"
+
+/* ================= CONFIG ================= */
+
+#define MAX_INET_SOCKETS 64
+#define INET_EPHEMERAL_FIRST 49152
+#define INET_EPHEMERAL_LAST 65535
+#define INET_UDP_MAX_PAYLOAD 1458 // 1500 - eth(14) - ip(20) - udp(8)
+#define INET_UDP_DEFAULT_RCVBUF 16384
+#define INET_CONNECT_TIMEOUT 500 // ticks (~10s at 50Hz)
+
+extern "C" void udp_send(uint32_t src_ip, uint16_t src_port, uint32_t dst_ip,
+                         uint16_t dst_port, uint8_t *data, uint16_t length);
+extern uint32_t tick;
+
+/* ================= GLOBALS ================= */
+
+// Saare AF_INET sockets: port allocation aur UDP demux isi se hota hai
+static socket_t *inet_table[MAX_INET_SOCKETS];
+static uint16_t inet_next_port = INET_EPHEMERAL_FIRST;
+
+static inline uint16_t inet_htons(uint16_t x) { return (x << 8) | (x >> 8); }
+static inline uint16_t inet_ntohs(uint16_t x) { return inet_htons(x); }
+
+/* ================= HELPERS ================= */
+
+// Table bhari ho toh -ENFILE: bina entry ke socket demux/port check se chhoot
+// jaata
+static int inet_register(socket_t *sock) {
+  for (int i = 0; i < MAX_INET_SOCKETS; i++) {
+    if (!inet_table[i]) {
+      inet_table[i] = sock;
+      return 0;
+    }
+  }
+  return -ENFILE;
+}
+
+static void inet_unregister(socket_t *sock) {
+  for (int i = 0; i < MAX_INET_SOCKETS; i++) {
+    if (inet_table[i] == sock)
+      inet_table[i] = 0;
+  }
+}
+
+static int inet_port_taken(int type, uint16_t port) {
+  for (int i = 0; i < MAX_INET_SOCKETS; i++) {
+    socket_t *s = inet_table[i];
+    if (!s || s->type != type || s->local_port != port)
+      continue;
+    // Accepted children listener ka port share karte hain, bind nahi rokte
+    if (type == SOCK_STREAM && s->state == SOCKET_CONNECTED)
+      continue;
+    return 1;
+  }
+  if (type == SOCK_STREAM && tcp_port_in_use(port))
+    return 1;
+  return 0;
+}
+
+static int inet_autobind(socket_t *sock) {
+  if (sock->local_port)
+    return 0;
+  for (int tries = 0; tries <= INET_EPHEMERAL_LAST - INET_EPHEMERAL_FIRST;
+       tries++) {
+    uint16_t port = inet_next_port;
+    inet_next_port = (inet_next_port == INET_EPHEMERAL_LAST)
+                         ? INET_EPHEMERAL_FIRST
+                         : inet_next_port + 1;
+    if (!inet_port_taken(sock->type, port)) {
+      sock->local_port = port;
+      if (sock->state == SOCKET_FREE)
+        sock->state = SOCKET_BOUND;
+      return 0;
+    }
+  }
+  return -EADDRINUSE;
+}
+
+static int inet_local_addr_ok(uint32_t ip) {
+  return ip == INADDR_ANY || net_local_addr(ip);
+}
+
+// Net thread se aata hai jab TCB mein kuch badla
+static void inet_tcp_notify(void *owner) {
+  socket_t *sock = (socket_t *)owner;
+  wake_up_all(&sock->rx_wait);
+  wake_up_all(&sock->tx_wait);
+}
+
+static void inet_attach_tcb(socket_t *sock, tcp_tcb_t *tcb) {
+  sock->tcb = tcb;
+  tcp_set_owner(tcb, sock, inet_tcp_notify);
+  tcp_set_sndbuf(tcb, sock->sndbuf);
+  tcp_set_nodelay(tcb, sock->nodelay);
+}
+
+typedef struct inet_waiter {
+  struct process *proc;
+  volatile int woken; // schedule_timeout ka cond
+} inet_waiter_t;
+
+static void inet_waiter_wake(wait_queue_entry_t *entry) {
+  inet_waiter_t *w = (inet_waiter_t *)entry->priv;
+  w->woken = 1;
+  wake_up_process(w->proc);
+}
+
+// Condition check aur sleep ke beech interrupts band rakho, warna net thread
+// ka wake_up beech mein aakar kho sakta hai. sleep_on khud sti karta hai.
+static void inet_wait(wait_queue_t *wq, int (*ready)(socket_t *),
+                      socket_t *sock) {
+  asm volatile("cli");
+  if (ready(sock)) {
+    asm volatile("sti");
+    return;
+  }
+  sleep_on(wq);
+}
+
+static int inet_rx_ready(socket_t *sock) {
+  if (sock->type == SOCK_DGRAM)
+    return sock->dgram_head != 0;
+  if (!sock->tcb)
+    return 1;
+  if (sock->state == SOCKET_LISTENING)
+    return tcp_can_accept(sock->tcb);
+  return tcp_has_data(sock->tcb) || tcp_peer_closed(sock->tcb);
+}
+
+static int inet_tx_ready(socket_t *sock) {
+  return !sock->tcb || tcp_tx_space(sock->tcb) > 0 ||
+         tcp_peer_closed(sock->tcb) || !tcp_is_connected(sock->tcb);
+}
+
+// Nonblocking connect ka nateeja yahan socket state mein utaarte hain
+static void inet_sync_state(socket_t *sock) {
+  if (sock->state != SOCKET_CONNECTING || !sock->tcb)
+    return;
+  if (tcp_is_connecting(sock->tcb))
+    return;
+  if (tcp_was_reset(sock->tcb)) {
+    sock->error = ECONNREFUSED;
+    sock->state = SOCKET_CLOSED;
+    return;
+  }
+  sock->state = SOCKET_CONNECTED;
+}
+
+/* ================= SOCKET LIFECYCLE ================= */
+
+int inet_socket_init(socket_t *sock, int type, int protocol) {
+  if (type == SOCK_STREAM) {
+    if (protocol != 0 && protocol != IPPROTO_TCP)
+      return -EPROTONOSUPPORT;
+    sock->protocol = IPPROTO_TCP;
+    sock->rcvbuf = TCP_DEFAULT_RCVBUF;
+    sock->sndbuf = TCP_DEFAULT_SNDBUF;
+  } else if (type == SOCK_DGRAM) {
+    if (protocol != 0 && protocol != IPPROTO_UDP)
+      return -EPROTONOSUPPORT;
+    sock->protocol = IPPROTO_UDP;
+    sock->rcvbuf = INET_UDP_DEFAULT_RCVBUF;
+    sock->sndbuf = INET_UDP_MAX_PAYLOAD;
+  } else {
+    return -EPROTOTYPE;
+  }
+  return inet_register(sock);
+}
+
+void inet_release(socket_t *sock) {
+  if (sock->tcb) {
+    tcp_close(sock->tcb); // Owner detach; TCB apna FIN handshake khud karega
+    sock->tcb = 0;
+  }
+  while (sock->dgram_head) {
+    inet_dgram_t *d = sock->dgram_head;
+    sock->dgram_head = d->next;
+    kfree(d);
+  }
+  sock->dgram_tail = 0;
+  sock->dgram_bytes = 0;
+  inet_unregister(sock);
+  wake_up_all(&sock->rx_wait);
+  wake_up_all(&sock->tx_wait);
+}
+
+/* ================= BIND / CONNECT / LISTEN / ACCEPT ================= */
+
+int inet_bind(socket_t *sock, const struct sockaddr_in *addr) {
+  if (addr->sin_family != AF_INET)
+    return -EAFNOSUPPORT;
+  if (sock->local_port)
+    return -EINVAL; // Pehle se bound hai
+  if (!inet_local_addr_ok(addr->sin_addr))
+    return -EADDRNOTAVAIL;
+
+  uint16_t port = inet_ntohs(addr->sin_port);
+  sock->local_ip = addr->sin_addr;
+  if (port == 0)
+    return inet_autobind(sock);
+  if (inet_port_taken(sock->type, port))
+    return -EADDRINUSE;
+
+  sock->local_port = port;
+  sock->state = SOCKET_BOUND;
+  return 0;
+}
+
+int inet_connect(socket_t *sock, const struct sockaddr_in *addr) {
+  if (addr->sin_family != AF_INET)
+    return -EAFNOSUPPORT;
+
+  if (sock->type == SOCK_DGRAM) {
+    // UDP connect sirf default destination set karta hai
+    int err = inet_autobind(sock);
+    if (err < 0)
+      return err;
+    sock->remote_ip = addr->sin_addr;
+    sock->remote_port = inet_ntohs(addr->sin_port);
+    sock->state = SOCKET_CONNECTED;
+    return 0;
+  }
+
+  inet_sync_state(sock);
+  if (sock->state == SOCKET_CONNECTED)
+    return -EISCONN;
+  if (sock->state == SOCKET_CONNECTING)
+    return -EALREADY;
+  if (sock->state == SOCKET_LISTENING)
+    return -EINVAL;
+
+  int err = inet_autobind(sock);
+  if (err < 0)
+    return err;
+  uint32_t local_ip =
+      sock->local_ip ? sock->local_ip : net_route_src(addr->sin_addr);
+
+  if (sock->tcb) {
+    // Pichla nonblocking connect fail hua tha
+    tcp_close(sock->tcb);
+    sock->tcb = 0;
+    sock->error = 0;
+  }
+
+  tcp_tcb_t *tcb = tcp_connect(local_ip, sock->local_port, addr->sin_addr,
+                               inet_ntohs(addr->sin_port));
+  if (!tcb)
+    return -ENOMEM;
+  inet_attach_tcb(sock, tcb);
+  tcp_set_rcvbuf(tcb, sock->rcvbuf);
+  sock->local_ip = local_ip;
+  sock->remote_ip = addr->sin_addr;
+  sock->remote_port = inet_ntohs(addr->sin_port);
+  sock->state = SOCKET_CONNECTING;
+
+  if (sock->nonblock)
+    return -EINPROGRESS;
+
+  // SYN-ACK/RST pe inet_tcp_notify tx_wait jagata hai; koi SYN retransmit
+  // timer nahi hai, isliye deadline pe timer jagayega
+  inet_waiter_t w;
+  w.proc = current_process;
+  wait_queue_entry_t self;
+  self.proc = 0;
+  self.func = inet_waiter_wake;
+  self.priv = &w;
+  uint32_t deadline = tick + INET_CONNECT_TIMEOUT;
+  if (!deadline)
+    deadline = 1;
+  add_wait_queue(&sock->tx_wait, &self);
+  for (;;) {
+    w.woken = 0; // Flag pehle, condition baad mein - beech ka wake nahi khota
+    if (!tcp_is_connecting(tcb))
+      break;
+    if (!schedule_timeout(deadline, &w.woken))
+      break;
+  }
+  remove_wait_queue(&sock->tx_wait, &self);
+
+  inet_sync_state(sock);
+  if (sock->state == SOCKET_CONNECTED)
+    return 0;
+
+  int result = tcp_is_connecting(tcb) ? -ETIMEDOUT : -ECONNREFUSED;
+  tcp_close(tcb);
+  sock->tcb = 0;
+  sock->state = SOCKET_BOUND;
+  sock->error = 0;
+  return result;
+}
+
+int inet_listen(socket_t *sock, int backlog) {
+  if (sock->type != SOCK_STREAM)
+    return -EOPNOTSUPP;
+  if (sock->state == SOCKET_LISTENING)
+    return 0;
+  if (sock->tcb)
+    return -EINVAL;
+
+  int err = inet_autobind(sock);
+  if (err < 0)
+    return err;
+
+  tcp_tcb_t *tcb = tcp_listen(sock->local_ip, sock->local_port, backlog);
+  if (!tcb)
+    return -ENOMEM;
+  inet_attach_tcb(sock, tcb);
+  tcp_set_rcvbuf(tcb, sock->rcvbuf); // Children isse inherit karte hain
+  sock->state = SOCKET_LISTENING;
+  sock->max_backlog = backlog;
+  return 0;
+}
+
+static int inet_accept_ready(socket_t *sock) {
+  return !sock->tcb || tcp_can_accept(sock->tcb);
+}
+
+socket_t *inet_accept(socket_t *sock, int *err) {
+  if (sock->state != SOCKET_LISTENING || !sock->tcb) {
+    *err = -EINVAL;
+    return 0;
+  }
+
+  tcp_tcb_t *child;
+  while (!(child = tcp_accept(sock->tcb))) {
+    if (sock->nonblock) {
+      *err = -EAGAIN;
+      return 0;
+    }
+    inet_wait(&sock->rx_wait, inet_accept_ready, sock);
+    if (!sock->tcb) {
+      *err = -EINVAL;
+      return 0;
+    }
+  }
+
+  socket_t *conn = socket_alloc(AF_INET);
+  if (!conn) {
+    tcp_close(child);
+    *err = -ENOMEM;
+    return 0;
+  }
+  conn->domain = AF_INET;
+  conn->type = SOCK_STREAM;
+  conn->protocol = IPPROTO_TCP;
+  conn->rcvbuf = sock->rcvbuf;
+  conn->sndbuf = sock->sndbuf;
+  conn->nodelay = sock->nodelay;
+  conn->state = SOCKET_CONNECTED;
+  tcp_get_endpoints(child, &conn->local_ip, &conn->local_port,
+                    &conn->remote_ip, &conn->remote_port);
+  inet_attach_tcb(conn, child);
+  *err = inet_register(conn);
+  if (*err < 0) {
+    socket_discard(conn); // inet_release child TCB bhi band karta hai
+    return 0;
+  }
+  return conn;
+}
+
+/* ================= DATA PATH ================= */
+
+int inet_send(socket_t *sock, const void *buf, uint32_t len, int flags,
+              const struct sockaddr_in *dest) {
+  int nonblock = sock->nonblock || (flags & MSG_DONTWAIT);
+
+  if (sock->type == SOCK_DGRAM) {
+    uint32_t dst_ip = sock->remote_ip;
+    uint16_t dst_port = sock->remote_port;
+    if (dest) {
+      if (dest->sin_family != AF_INET)
+        return -EAFNOSUPPORT;
+      dst_ip = dest->sin_addr;
+      dst_port = inet_ntohs(dest->sin_port);
+    } else if (sock->state != SOCKET_CONNECTED) {
+      return -EDESTADDRREQ;
+    }
+    if (len > INET_UDP_MAX_PAYLOAD)
+      return -EMSGSIZE;
+    int err = inet_autobind(sock);
+    if (err < 0)
+      return err;
+    uint32_t src_ip = sock->local_ip ? sock->local_ip : net_route_src(dst_ip);
+    udp_send(src_ip, sock->local_port, dst_ip, dst_port, (uint8_t *)buf,
+             (uint16_t)len);
+    return (int)len;
+  }
+
+  inet_sync_state(sock);
+  if (sock->state != SOCKET_CONNECTED || !sock->tcb)
+    return sock->error == ECONNREFUSED ? -ECONNREFUSED : -ENOTCONN;
+
+  const uint8_t *src = (const uint8_t *)buf;
+  uint32_t sent = 0;
+  while (sent < len) {
+    uint32_t chunk = len - sent;
+    if (chunk > 0xFFFF)
+      chunk = 0xFFFF;
+    int n = tcp_send_data(sock->tcb, (void *)(src + sent), (uint16_t)chunk);
+    if (n < 0) {
+      if (sent)
+        break;
+      return tcp_was_reset(sock->tcb) ? -ECONNRESET : -EPIPE;
+    }
+    sent += n;
+    if (n == 0) {
+      if (nonblock)
+        return sent ? (int)sent : -EAGAIN;
+      inet_wait(&sock->tx_wait, inet_tx_ready, sock);
+    }
+  }
+  return (int)sent;
+}
+
+int inet_recv(socket_t *sock, void *buf, uint32_t len, int flags,
+              struct sockaddr_in *src) {
+  int nonblock = sock->nonblock || (flags & MSG_DONTWAIT);
+
+  if (sock->type == SOCK_DGRAM) {
+    while (!sock->dgram_head) {
+      if (nonblock)
+        return -EAGAIN;
+      inet_wait(&sock->rx_wait, inet_rx_ready, sock);
+    }
+    asm volatile("cli");
+    inet_dgram_t *d = sock->dgram_head;
+    sock->dgram_head = d->next;
+    if (!sock->dgram_head)
+      sock->dgram_tail = 0;
+    sock->dgram_bytes -= d->len;
+    asm volatile("sti");
+
+    // Datagram semantics: jo buffer mein na aaye wo kat jata hai
+    uint32_t n = d->len < len ? d->len : len;
+    memcpy(buf, d->data, n);
+    if (src) {
+      memset(src, 0, sizeof(*src));
+      src->sin_family = AF_INET;
+      src->sin_port = inet_htons(d->src_port);
+      src->sin_addr = d->src_ip;
+    }
+    kfree(d);
+    return (int)n;
+  }
+
+  inet_sync_state(sock);
+  if (!sock->tcb || sock->state == SOCKET_LISTENING)
+    return -ENOTCONN;
+
+  while (!tcp_has_data(sock->tcb)) {
+    if (tcp_was_reset(sock->tcb))
+      return -ECONNRESET;
+    if (tcp_peer_closed(sock->tcb))
+      return 0; // EOF
+    if (nonblock)
+      return -EAGAIN;
+    inet_wait(&sock->rx_wait, inet_rx_ready, sock);
+  }
+
+  if (len > 0xFFFF)
+    len = 0xFFFF;
+  int n = tcp_read_data(sock->tcb, buf, (uint16_t)len);
+  if (src)
+    inet_getname(sock, 1, src);
+  return n;
+}
+
+uint32_t inet_pending_bytes(socket_t *sock) {
+  if (sock->type == SOCK_DGRAM)
+    return sock->dgram_head ? sock->dgram_head->len : 0;
+  return tcp_rx_available(sock->tcb);
+}
+
+int inet_poll(socket_t *sock) {
+  int mask = 0;
+
+  if (sock->type == SOCK_DGRAM) {
+    if (sock->dgram_head)
+      mask |= POLLIN | POLLRDNORM;
+    mask |= POLLOUT | POLLWRNORM;
+    return mask;
+  }
+
+  inet_sync_state(sock);
+  if (sock->state == SOCKET_LISTENING) {
+    if (tcp_can_accept(sock->tcb))
+      mask |= POLLIN | POLLRDNORM;
+    return mask;
+  }
+  if (sock->state == SOCKET_CONNECTING)
+    return 0;
+  if (sock->error)
+    return POLLOUT | POLLERR | POLLHUP;
+  if (!sock->tcb)
+    return sock->state == SOCKET_CLOSED ? POLLHUP : 0;
+
+  if (tcp_has_data(sock->tcb) || tcp_peer_closed(sock->tcb))
+    mask |= POLLIN | POLLRDNORM;
+  if (tcp_tx_space(sock->tcb) > 0)
+    mask |= POLLOUT | POLLWRNORM;
+  if (tcp_was_reset(sock->tcb))
+    mask |= POLLERR | POLLHUP;
+  else if (tcp_peer_closed(sock->tcb) && !tcp_has_data(sock->tcb) &&
+           !tcp_is_connected(sock->tcb))
+    mask |= POLLHUP;
+  return mask;
+}
+
+/* ================= OPTIONS / SHUTDOWN / NAMES ================= */
+
+int inet_setsockopt(socket_t *sock, int level, int optname, int value) {
+  if (level == IPPROTO_TCP) {
+    if (optname != TCP_NODELAY || sock->type != SOCK_STREAM)
+      return -ENOPROTOOPT;
+    sock->nodelay = value ? 1 : 0;
+    if (sock->tcb)
+      tcp_set_nodelay(sock->tcb, sock->nodelay);
+    return 0;
+  }
+  if (level != SOL_SOCKET)
+    return -ENOPROTOOPT;
+
+  switch (optname) {
+  case SO_RCVBUF:
+    if (value <= 0)
+      return -EINVAL;
+    if (sock->type == SOCK_STREAM) {
+      if (value > TCP_MAX_RCVBUF)
+        value = TCP_MAX_RCVBUF;
+      if (sock->tcb && tcp_set_rcvbuf(sock->tcb, value) < 0)
+        return -ENOMEM;
+    }
+    sock->rcvbuf = value;
+    return 0;
+  case SO_SNDBUF:
+    if (value <= 0)
+      return -EINVAL;
+    sock->sndbuf = value;
+    if (sock->tcb)
+      tcp_set_sndbuf(sock->tcb, value);
+    return 0;
+  case SO_REUSEADDR:
+  case SO_KEEPALIVE:
+  case SO_BROADCAST:
+  case SO_LINGER:
+  case SO_RCVTIMEO:
+  case SO_SNDTIMEO:
+    return 0;
+  default:
+    return -ENOPROTOOPT;
+  }
+}
+
+int inet_shutdown(socket_t *sock, int how) {
+  if (sock->type != SOCK_STREAM)
+    return sock->state == SOCKET_CONNECTED ? 0 : -ENOTCONN;
+  inet_sync_state(sock);
+  if (sock->state != SOCKET_CONNECTED || !sock->tcb)
+    return -ENOTCONN;
+  if (how == 1 || how == 2) // SHUT_WR / SHUT_RDWR
+    tcp_shutdown(sock->tcb);
+  return 0;
+}
+
+void inet_getname(socket_t *sock, int peer, struct sockaddr_in *out) {
+  memset(out, 0, sizeof(*out));
+  out->sin_family = AF_INET;
+  if (peer) {
+    out->sin_addr = sock->remote_ip;
+    out->sin_port = inet_htons(sock->remote_port);
+  } else {
+    out->sin_addr = sock->local_ip;
+    out->sin_port = inet_htons(sock->local_port);
+  }
+}
+
+/* ================= UDP RX DEMUX ================= */
+
+// udp_receive se pehle yahan aata hai. 1 = kisi socket ne le liya.
+int inet_udp_input(uint32_t src_ip, uint32_t dst_ip, uint16_t src_port,
+                   uint16_t dst_port, uint8_t *data, uint16_t len) {
+  for (int i = 0; i < MAX_INET_SOCKETS; i++) {
+    socket_t *s = inet_table[i];
+    if (!s || s->type != SOCK_DGRAM || s->local_port != dst_port)
+      continue;
+    if (s->local_ip && s->local_ip != dst_ip)
+      continue;
+    if (s->state == SOCKET_CONNECTED &&
+        (s->remote_ip != src_ip || s->remote_port != src_port))
+      continue;
+
+    if (s->dgram_bytes + len > s->rcvbuf) {
+      serial_log("INET: UDP receive queue full, dropping datagram");
+      return 1;
+    }
+    inet_dgram_t *d = (inet_dgram_t *)kmalloc(sizeof(inet_dgram_t) + len);
+    if (!d)
+      return 1;
+    d->next = 0;
+    d->src_ip = src_ip;
+    d->src_port = src_port;
+    d->len = len;
+    memcpy(d->data, data, len);
+
+    if (s->dgram_tail)
+      s->dgram_tail->next = d;
+    else
+      s->dgram_head = d;
+    s->dgram_tail = d;
+    s->dgram_bytes += len;
+    wake_up_all(&s->rx_wait);
+    return 1;
+  }
+  return 0;
+}
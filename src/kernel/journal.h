@@ -0,0 +1,53 @@
+// Journal - on-disk circular write-ahead log (block level)
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "../include/types.h"
+
+// ============================================================================
+// Log device: block 0 = journal superblock, baaki circular area.
+// Ek transaction = [descriptor][data blocks...][commit]. Commit mein seq aur
+// checksum hai, isliye poora txn ek hi cache flush mein jaata hai - aadha
+// likha txn replay pe checksum se pakda jaata hai.
+// Blocks apni asli jagah (home device) pe sirf checkpoint pe jaate hain: log
+// bharne lage tab, ya client ke idle hone pe. Mount pe journal_open wahi
+// replay karta hai jo commit hua par checkpoint nahi.
+// ============================================================================
+#define JOURNAL_BLOCK 512
+#define JOURNAL_TXN_MAX 124 // Ek descriptor block mein itne targets
+
+struct block_device;
+
+typedef struct journal {
+  struct block_device *log;  // Superblock + circular area
+  struct block_device *home; // Blocks ki asli jagah
+  uint32_t area;             // Circular area ke blocks
+  uint32_t start;            // Sabse purana un-checkpointed txn
+  uint32_t head;             // Agla txn yahan likha jayega
+  uint32_t start_seq;        // start wale txn ka seq
+  uint32_t next_seq;
+  uint32_t txns; // Log mein checkpoint ka intezaar karte txns
+} journal_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Superblock padho (na mile toh format), committed txns home pe replay.
+// Return = kitne txns replay hue, ya -errno.
+int journal_open(journal_t *j, struct block_device *log,
+                 struct block_device *home);
+
+// Ek atomic txn: data ke `count` blocks home ke `targets` ke liye.
+// Log mein jagah na ho toh pehle checkpoint.
+int journal_commit(journal_t *j, const uint32_t *targets, const uint8_t *data,
+                   uint32_t count);
+
+// Log ke saare txns home pe likho, phir log khaali
+int journal_checkpoint(journal_t *j);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // JOURNAL_H
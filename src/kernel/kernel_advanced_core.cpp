@@ -3,16 +3,293 @@
  * Journaling + Crash Recovery + History
  ************************************************************/
 
+#include "../drivers/serial.h"
+#include "../include/errno.h"
+#include "../include/string.h"
+#include "block_device.h"
+#include "heap.h"
+#include "journal.h"
+#include "memory.h"
 #include <stddef.h>
 #include <stdint.h>
 
 
 /* =========================================================
    SECTION 1: JOURNALING & CRASH RECOVERY
+   On-disk circular journal (journal.h). Pehle yahan ek static array tha
+   jiska replay khaali tha - ab log block device pe hai aur mount pe replay.
 ========================================================= */
 
-#define JOURNAL_SIZE 1024
+#define JOURNAL_MAGIC_SUPER 0x4C4E524A  // 'JRNL'
+#define JOURNAL_MAGIC_DESC 0x4353444A   // 'JDSC'
+#define JOURNAL_MAGIC_COMMIT 0x544D434A // 'JCMT'
 
+typedef struct journal_super {
+  uint32_t magic;
+  uint32_t area;  // Format ke waqt ka size - badla toh dobara format
+  uint32_t start; // Yahan se replay
+  uint32_t seq;   // start wale txn ka seq
+  uint8_t pad[JOURNAL_BLOCK - 16];
+} journal_super_t;
+
+typedef struct journal_desc {
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t count;
+  uint32_t reserved;
+  uint32_t target[JOURNAL_TXN_MAX]; // Home device ke block numbers
+} journal_desc_t;
+
+typedef struct journal_commit_rec {
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t count;
+  uint32_t checksum; // seq + targets + data ka FNV-1a
+  uint8_t pad[JOURNAL_BLOCK - 16];
+} journal_commit_rec_t;
+
+// Circular area ka index -> log device ka block (0 superblock hai)
+static inline uint32_t journal_block(journal_t *j, uint32_t index) {
+  return 1 + index % j->area;
+}
+
+static uint32_t journal_used(journal_t *j) {
+  return (j->head + j->area - j->start) % j->area;
+}
+
+static uint32_t journal_fnv(uint32_t h, const uint8_t *p, uint32_t len) {
+  for (uint32_t i = 0; i < len; i++)
+    h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+static uint32_t journal_checksum(const journal_desc_t *d, const uint8_t *data) {
+  uint32_t h = journal_fnv(2166136261u, (const uint8_t *)&d->seq, 4);
+  h = journal_fnv(h, (const uint8_t *)d->target, d->count * 4);
+  return journal_fnv(h, data, d->count * JOURNAL_BLOCK);
+}
+
+static int journal_write_super(journal_t *j) {
+  journal_super_t *sb = (journal_super_t *)kmalloc(sizeof(journal_super_t));
+  if (!sb)
+    return -ENOMEM;
+  memset(sb, 0, sizeof(*sb));
+  sb->magic = JOURNAL_MAGIC_SUPER;
+  sb->area = j->area;
+  sb->start = j->start;
+  sb->seq = j->start_seq;
+  int ret = block_write(j->log, 0, (uint8_t *)sb);
+  kfree(sb);
+  if (ret < 0 || block_flush(j->log) < 0)
+    return -EIO;
+  return 0;
+}
+
+// start se committed txns ek ek karke. apply = home pe likho (replay /
+// checkpoint). Pehla toota ya purana txn = log ka ant. Return = txns.
+static int journal_scan(journal_t *j, bool apply) {
+  journal_desc_t *d = (journal_desc_t *)kmalloc(sizeof(journal_desc_t));
+  journal_commit_rec_t *c =
+      (journal_commit_rec_t *)kmalloc(sizeof(journal_commit_rec_t));
+  uint8_t *data = (uint8_t *)kmalloc(JOURNAL_TXN_MAX * JOURNAL_BLOCK);
+  int found = 0;
+  if (!d || !c || !data) {
+    found = -ENOMEM;
+    goto out;
+  }
+
+  j->head = j->start;
+  j->next_seq = j->start_seq;
+  while (journal_used(j) + 2 < j->area) {
+    if (block_read(j->log, journal_block(j, j->head), (uint8_t *)d) < 0)
+      break;
+    if (d->magic != JOURNAL_MAGIC_DESC || d->seq != j->next_seq ||
+        d->count == 0 || d->count > JOURNAL_TXN_MAX ||
+        journal_used(j) + d->count + 2 >= j->area)
+      break;
+    uint32_t i;
+    for (i = 0; i < d->count; i++)
+      if (block_read(j->log, journal_block(j, j->head + 1 + i),
+                     data + i * JOURNAL_BLOCK) < 0)
+        break;
+    if (i < d->count ||
+        block_read(j->log, journal_block(j, j->head + 1 + d->count),
+                   (uint8_t *)c) < 0)
+      break;
+    if (c->magic != JOURNAL_MAGIC_COMMIT || c->seq != d->seq ||
+        c->count != d->count || c->checksum != journal_checksum(d, data))
+      break; // Commit se pehle crash - yeh txn hua hi nahi
+
+    if (apply) {
+      // Home pe likhna fail = txn log mein hi rahe, start aage mat badhao
+      for (i = 0; i < d->count; i++)
+        if (block_write(j->home, d->target[i], data + i * JOURNAL_BLOCK) < 0)
+          break;
+      if (i < d->count) {
+        serial_log("JOURNAL: Home write failed during replay");
+        found = -EIO;
+        goto out;
+      }
+    }
+    j->head = (j->head + d->count + 2) % j->area;
+    j->next_seq++;
+    found++;
+  }
+  if (apply && found)
+    block_flush(j->home);
+
+out:
+  if (d)
+    kfree(d);
+  if (c)
+    kfree(c);
+  if (data)
+    kfree(data);
+  return found;
+}
+
+extern "C" int journal_open(journal_t *j, block_device_t *log,
+                            block_device_t *home) {
+  if (!j || !log || !home || log->total_blocks < 2 + JOURNAL_TXN_MAX + 2)
+    return -EINVAL;
+  memset(j, 0, sizeof(*j));
+  j->log = log;
+  j->home = home;
+  j->area = log->total_blocks - 1;
+
+  journal_super_t *sb = (journal_super_t *)kmalloc(sizeof(journal_super_t));
+  if (!sb)
+    return -ENOMEM;
+  int ok = block_read(log, 0, (uint8_t *)sb) == 0 &&
+           sb->magic == JOURNAL_MAGIC_SUPER && sb->area == j->area &&
+           sb->start < j->area;
+  if (ok) {
+    j->start = sb->start;
+    j->start_seq = sb->seq;
+  }
+  kfree(sb);
+
+  if (!ok) {
+    // Naya log: area ka pehla block saaf, taaki purana kachra txn na lage
+    uint8_t *zero = (uint8_t *)kmalloc(JOURNAL_BLOCK);
+    if (!zero)
+      return -ENOMEM;
+    memset(zero, 0, JOURNAL_BLOCK);
+    int wr = block_write(log, journal_block(j, 0), zero);
+    kfree(zero);
+    if (wr < 0)
+      return -EIO;
+    j->start = 0;
+    j->start_seq = 1;
+    j->head = 0;
+    j->next_seq = 1;
+    serial_log("JOURNAL: Formatted log device");
+    return journal_write_super(j);
+  }
+
+  // Commit hue par checkpoint nahi hue txns ab home pe, phir log khaali
+  int replayed = journal_scan(j, true);
+  if (replayed < 0)
+    return replayed;
+  if (replayed > 0) {
+    serial_log("JOURNAL: Replayed committed transactions");
+    j->start = j->head;
+    j->start_seq = j->next_seq;
+    int ret = journal_write_super(j);
+    if (ret < 0)
+      return ret;
+  }
+  return replayed;
+}
+
+extern "C" int journal_checkpoint(journal_t *j) {
+  if (!j || !j->log || !j->txns)
+    return 0;
+  uint32_t head = j->head, seq = j->next_seq;
+  int n = journal_scan(j, true);
+  if (n < 0) {
+    j->head = head; // Scan beech mein ruka - log wahi ka wahi
+    j->next_seq = seq;
+    return n;
+  }
+  // Scan wahi tak pahunchna chahiye jahan tak humne likha tha
+  if (j->head != head || j->next_seq != seq) {
+    serial_log("JOURNAL: Checkpoint scan mismatch");
+    j->head = head;
+    j->next_seq = seq;
+    return -EIO;
+  }
+  j->start = head;
+  j->start_seq = seq;
+  j->txns = 0;
+  return journal_write_super(j);
+}
+
+extern "C" int journal_commit(journal_t *j, const uint32_t *targets,
+                              const uint8_t *data, uint32_t count) {
+  if (!j || !j->log)
+    return -EINVAL;
+  if (count == 0)
+    return 0;
+  if (count > JOURNAL_TXN_MAX || count + 3 >= j->area)
+    return -EINVAL;
+  if (journal_used(j) + count + 2 >= j->area) {
+    int ret = journal_checkpoint(j);
+    if (ret < 0)
+      return ret;
+  }
+
+  journal_desc_t *d = (journal_desc_t *)kmalloc(sizeof(journal_desc_t));
+  journal_commit_rec_t *c =
+      (journal_commit_rec_t *)kmalloc(sizeof(journal_commit_rec_t));
+  int ret = 0;
+  if (!d || !c) {
+    ret = -ENOMEM;
+    goto out;
+  }
+  memset(d, 0, sizeof(*d));
+  memset(c, 0, sizeof(*c));
+  d->magic = JOURNAL_MAGIC_DESC;
+  d->seq = j->next_seq;
+  d->count = count;
+  memcpy(d->target, targets, count * sizeof(uint32_t));
+  c->magic = JOURNAL_MAGIC_COMMIT;
+  c->seq = d->seq;
+  c->count = count;
+  c->checksum = journal_checksum(d, data);
+
+  // Group commit: descriptor + data + commit, ek hi barrier. Koi bhi
+  // block fail = commit record likho hi mat, txn replay mein nahi aayega
+  if (block_write(j->log, journal_block(j, j->head), (uint8_t *)d) < 0) {
+    ret = -EIO;
+    goto out;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    if (block_write(j->log, journal_block(j, j->head + 1 + i),
+                    (uint8_t *)data + i * JOURNAL_BLOCK) < 0) {
+      ret = -EIO;
+      goto out;
+    }
+  }
+  if (block_write(j->log, journal_block(j, j->head + 1 + count),
+                  (uint8_t *)c) < 0 ||
+      block_flush(j->log) < 0) {
+    ret = -EIO;
+    goto out;
+  }
+  j->head = (j->head + count + 2) % j->area;
+  j->next_seq++;
+  j->txns++;
+
+out:
+  if (d)
+    kfree(d);
+  if (c)
+    kfree(c);
+  return ret;
+}
+
+/* Operation log (undo/redo history ke records) */
 enum JournalOp { J_CREATE, J_WRITE, J_DELETE };
 
 struct JournalEntry {
@@ -22,26 +299,6 @@ struct JournalEntry {
   uint32_t size;
 };
 
-static JournalEntry journal[JOURNAL_SIZE];
-static uint32_t journal_head = 0;
-
-extern "C" void journal_log_advanced(JournalOp op, uint32_t inode,
-                                     uint32_t block, uint32_t size) {
-  if (journal_head >= JOURNAL_SIZE)
-    journal_head = 0;
-  journal[journal_head++] = {op, inode, block, size};
-}
-
-extern "C" void journal_replay_advanced() {
-  for (uint32_t i = 0; i < journal_head; i++) {
-    // JournalEntry& j = journal[i];
-    // Replay logic:
-    // 1. If J_CREATE: Ensure inode marked used
-    // 2. If J_WRITE: Sync blocks to disk
-    // 3. If J_DELETE: Ensure inode marked free
-  }
-}
-
 /* =========================================================
    SECTION 2: UNDO / REDO KERNEL HISTORY
 ========================================================= */
@@ -91,4 +348,7 @@ extern "C" void redo_last_advanced() {
 
 /* ===================== KERNEL BOOT ===================== */
 
-extern "C" void kernel_advanced_init() { journal_replay_advanced(); }
+// Journals apne filesystem ke mount pe replay hote hain (phase_vfs_load)
+extern "C" void kernel_advanced_init() {
+  serial_log("ADVANCED_CORE: Journal replay runs at filesystem mount");
+}
@@ -154,6 +154,9 @@ int fs_write_internal(uint32_t inode_id, const void *buffer, uint32_t size) {
   uint32_t current_offset = 0;
 
   // Simplification: Write fills blocks sequentially from 0
+  // Purane blocks wapas do, warna har rewrite bitmap khaata rehta hai
+  for (uint32_t i = 0; i < node->block_count; i++)
+    free_block(node->blocks[i]);
   node->block_count = 0; // Reset (Overwrite)
   node->size = 0;
 
@@ -305,8 +308,11 @@ struct filesystem kernel_fs = {
     .write = kfs_write_wrapper,
     .close = 0, // Default cleanup
     .readdir = kfs_readdir_wrapper,
-    .mkdir = 0, // Should map to create
-    .unlink = 0 // Not impl yet
+    .mkdir = 0,  // Should map to create
+    .unlink = 0, // Not impl yet
+    .rmdir = 0,
+    .rename = 0,
+    .truncate = 0,
 };
 
 /* ==========================================================
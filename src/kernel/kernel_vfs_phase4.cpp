@@ -1,5 +1,6 @@
 #include "../include/kernel_vfs_phase4.h"
 #include "../drivers/serial.h"
+#include "../include/epoll.h"
 #include "../include/errno.h"
 #include "../include/kernel_fs.h"
 #include "../include/kernel_fs_phase3.h" // For secure ops
@@ -52,27 +53,16 @@ int v_open(const char *path, int flags) {
   // But vfs_node wraps it. Node->mask contains perms?
   // Let's assume vfs_node was populated with real perms by lookup.
 
-  // 4. Allocate FD in Process
-  int fd = -1;
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (!current_process->fd_table[i]) {
-      fd = i;
-      break;
-    }
+  // 4. Allocate FD in Process (lowest free, RLIMIT_NOFILE tak)
+  file_description_t *desc = fd_desc_alloc(node, flags & ~O_CLOEXEC);
+  if (!desc)
+    return -ENOMEM;
+  int fd = fd_alloc(desc, 0, (flags & O_CLOEXEC) != 0);
+  if (fd < 0) {
+    kfree(desc);
+    return fd;
   }
 
-  if (fd == -1)
-    return -EMFILE;
-
-  // 5. Store Description
-  file_description_t *desc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
-  desc->node = node;
-  desc->offset = 0;
-  desc->flags = flags;
-  desc->ref_count = 1;
-  current_process->fd_table[fd] = desc;
-
   // Open hook
   if (node->open)
     node->open(node); // Legacy
@@ -82,9 +72,7 @@ int v_open(const char *path, int flags) {
 }
 
 int v_read(int fd, void *buf, int size) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES)
-    return -EBADF;
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   if (!desc)
     return -EBADF;
 
@@ -96,9 +84,7 @@ int v_read(int fd, void *buf, int size) {
 }
 
 int v_write(int fd, const void *buf, int size) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES)
-    return -EBADF;
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   if (!desc)
     return -EBADF;
 
@@ -110,22 +96,19 @@ int v_write(int fd, const void *buf, int size) {
 }
 
 int v_close(int fd) {
-  if (fd < 0 || fd >= MAX_PROCESS_FILES)
-    return -EBADF;
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_detach(fd);
   if (!desc)
     return -EBADF;
 
   vfs_node_t *node = desc->node;
   desc->ref_count--;
   if (desc->ref_count == 0) {
+    epoll_node_release(node);
     if (node->close)
       node->close(node);
     vfs_close(node);
     kfree(desc);
   }
-
-  current_process->fd_table[fd] = 0;
   return 0;
 }
 
@@ -0,0 +1,75 @@
+// loopback.cpp - "lo" network interface (127.0.0.0/8)
+// Jo frame bheja wahi queue mein daal do; net_poll use wapas stack mein
+// deta hai. Ek hi VM ke andar TCP/UDP chalane aur benchmark ke liye.
+// Checksum kabhi nahi jodte: data memory se bahar jaata hi nahi.
+
+#include "../drivers/serial.h"
+#include "../include/string.h"
+#include "checksum.h"
+#include "net.h"
+#include "wait_queue.h"
+
+#define LO_QUEUE_LEN 64 // TCP sndbuf (8KB) ke ~6 segments + ACKs se kaafi zyada
+#define LO_FRAME_MAX 1514
+
+struct lo_frame {
+  u16 len;
+  u8 data[LO_FRAME_MAX];
+};
+
+// Ring: head pe daalo, tail se nikalo. User process (send) aur net thread
+// dono daalte hain, isliye interrupts band karke.
+static lo_frame lo_queue[LO_QUEUE_LEN];
+static u32 lo_head = 0;
+static u32 lo_tail = 0;
+static u32 lo_full_drops = 0; // Sirf pehla log hota hai, baaki gine jaate hain
+
+static void lo_xmit(netdev_t *dev, u8 *frame, u16 len, int l4_csum_off,
+                    u8 proto) {
+  (void)l4_csum_off;
+  (void)proto;
+  if (len > LO_FRAME_MAX) {
+    dev->stats.tx_dropped++;
+    return;
+  }
+
+  u32 flags = irq_save();
+  u32 next = (lo_head + 1) % LO_QUEUE_LEN;
+  if (next == lo_tail) {
+    dev->stats.tx_dropped++;
+    u32 first = (lo_full_drops++ == 0);
+    irq_restore(flags);
+    if (first)
+      serial_log("LO: queue full, dropping frames");
+    return;
+  }
+  memcpy(lo_queue[lo_head].data, frame, len);
+  lo_queue[lo_head].len = len;
+  lo_head = next;
+  dev->stats.tx_packets++;
+  dev->stats.tx_bytes += len;
+  irq_restore(flags);
+}
+
+static int lo_poll(netdev_t *dev, u8 *out, u32 *rx_csum) {
+  u32 flags = irq_save();
+  if (lo_tail == lo_head) {
+    irq_restore(flags);
+    return 0;
+  }
+  u16 len = lo_queue[lo_tail].len;
+  memcpy(out, lo_queue[lo_tail].data, len);
+  lo_tail = (lo_tail + 1) % LO_QUEUE_LEN;
+  dev->stats.rx_packets++;
+  dev->stats.rx_bytes += len;
+  irq_restore(flags);
+
+  // Sender ne checksum bhara hi nahi tha - dobara check mat karo
+  if (rx_csum)
+    *rx_csum = CSUM_RX_IP_OK | CSUM_RX_L4_OK;
+  return len;
+}
+
+netdev_t loopback_dev = {
+    "lo", INADDR_LOOPBACK_NET, NETDEV_F_NO_CSUM, lo_xmit, lo_poll, {},
+};
@@ -78,6 +78,12 @@ int sys_mprotect(void *addr, size_t len, int prot) {
 
     // Preserve physical address, update flags
     uint32_t phys = *pte & ~0xFFF;
+    if (*pte & PTE_SHARED) {
+      // Exec page cache ka frame kabhi writable nahi - write maanga toh COW
+      uint32_t f = (flags & ~PTE_WRITE) | PTE_SHARED | (*pte & PTE_USER);
+      *pte = phys | f | ((flags & PTE_WRITE) ? PTE_COW : 0);
+      continue;
+    }
     *pte = phys | flags;
   }
 
@@ -1,6 +1,7 @@
 #include "net.h"
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "checksum.h"
 #include "e1000.h"
 
 static u8 my_mac[6] = {0x52, 0x54, 0x00, 0x12, 0x34, 0x56};
@@ -13,18 +14,62 @@ static inline u32 htonl(u32 x) {
          ((x & 0xFF000000) >> 24);
 }
 
-static u16 checksum(void *data, int len) {
-  u32 sum = 0;
-  u16 *ptr = (u16 *)data;
-  while (len > 1) {
-    sum += *ptr++;
-    len -= 2;
+// TX checksum offload (e1000 context descriptors). 0 karne pe software
+// fallback chalta hai - debugging ke liye.
+static int tx_csum_offload = 1;
+
+#define NET_LO_BUDGET 32 // net_poll ek call mein itne loopback frames
+
+/* ================= eth0 (e1000) ================= */
+
+static void eth0_xmit(netdev_t *dev, u8 *frame, u16 len, int l4_csum_off,
+                      u8 proto) {
+  if (l4_csum_off >= 0)
+    e1000_send_csum(frame, len, sizeof(eth_hdr),
+                    sizeof(eth_hdr) + sizeof(ip_hdr), l4_csum_off, proto == 6);
+  else
+    e1000_send(frame, len);
+  dev->stats.tx_packets++;
+  dev->stats.tx_bytes += len;
+}
+
+static int eth0_poll(netdev_t *dev, u8 *out, u32 *rx_csum) {
+  int len = e1000_receive_csum(out, rx_csum);
+  if (len > 0) {
+    dev->stats.rx_packets++;
+    dev->stats.rx_bytes += len;
   }
-  if (len)
-    sum += *(u8 *)ptr;
-  while (sum >> 16)
-    sum = (sum & 0xFFFF) + (sum >> 16);
-  return ~sum;
+  return len;
+}
+
+static netdev_t eth0_dev = {
+    "eth0", 0x0F02000A, NETDEV_F_HW_CSUM, eth0_xmit, eth0_poll, {},
+};
+
+static netdev_t *net_devs[NETDEV_COUNT] = {&loopback_dev, &eth0_dev};
+
+// Apne hi address (127/8 ya 10.0.2.15) ka traffic lo se jaata hai
+static netdev_t *net_route(u32 dst_ip) {
+  if (NET_IS_LOOPBACK(dst_ip) || dst_ip == my_ip)
+    return &loopback_dev;
+  return &eth0_dev;
+}
+
+extern "C" u32 net_route_src(u32 dst_ip) {
+  if (NET_IS_LOOPBACK(dst_ip))
+    return INADDR_LOOPBACK_NET;
+  return my_ip;
+}
+
+extern "C" int net_local_addr(u32 ip) {
+  return ip == my_ip || NET_IS_LOOPBACK(ip);
+}
+
+extern "C" int net_get_stats(int ifindex, struct netdev_stats *out) {
+  if (ifindex < 0 || ifindex >= NETDEV_COUNT || !out)
+    return -1;
+  *out = net_devs[ifindex]->stats;
+  return 0;
 }
 
 void send_arp_reply(arp_pkt *req) {
@@ -64,7 +109,10 @@ void handle_arp(u8 *packet) {
 
 void send_icmp_reply(ip_hdr *ip, icmp_hdr *icmp, u8 *data, int data_len) {
   u8 buf[512];
-  memset(buf, 0, 512);
+  if (sizeof(eth_hdr) + sizeof(ip_hdr) + sizeof(icmp_hdr) + data_len >
+      sizeof(buf))
+    return;
+  memset(buf, 0, sizeof(eth_hdr) + sizeof(ip_hdr) + sizeof(icmp_hdr));
 
   eth_hdr *eth_req = (eth_hdr *)((u8 *)ip - sizeof(eth_hdr));
   eth_hdr *eth = (eth_hdr *)buf;
@@ -79,38 +127,51 @@ void send_icmp_reply(ip_hdr *ip, icmp_hdr *icmp, u8 *data, int data_len) {
   eth->type = htons(ETH_TYPE_IP);
 
   *ip2 = *ip;
+  ip2->ver_ihl = 0x45; // Options wapas nahi bhejte
+  ip2->len = htons(sizeof(ip_hdr) + sizeof(icmp_hdr) + data_len);
   ip2->src = my_ip;
   ip2->dst = ip->src;
   ip2->checksum = 0;
-  ip2->checksum = htons(checksum(ip2, sizeof(ip_hdr)));
+  ip2->checksum = ip_fast_csum(ip2, 5);
 
   icmp2->type = 0; // Echo Reply
   icmp2->code = 0;
   icmp2->id = icmp->id;
   icmp2->seq = icmp->seq;
-  icmp2->checksum = 0;
 
   // Copy data back if any
   if (data_len > 0) {
     memcpy((u8 *)icmp2 + sizeof(icmp_hdr), data, data_len);
   }
 
-  icmp2->checksum = htons(checksum(icmp2, sizeof(icmp_hdr) + data_len));
+  // Sirf type/code word badla hai - poore payload ko dobara jodne ki
+  // zaroorat nahi, request ke checksum ko incrementally update karo
+  icmp2->checksum = csum_update16(icmp->checksum, icmp->type | (icmp->code << 8),
+                                  icmp2->type | (icmp2->code << 8));
 
   serial_log("NET: Sending ICMP Echo Reply");
   e1000_send(buf,
              sizeof(eth_hdr) + sizeof(ip_hdr) + sizeof(icmp_hdr) + data_len);
 }
 
-// Generic IP send function for UDP/TCP
-extern "C" void ip_send(uint32_t dst_ip, uint8_t protocol, uint8_t *data,
-                        uint16_t length) {
+// IPv4 header + Ethernet frame banao aur route wale device pe bhejo.
+// csum_off >= 0 ho toh data ke us offset pe TCP/UDP checksum field hai
+// jismein pseudo-header seed pada hai; NIC (ya software fallback) baaki sum
+// poora karta hai. src_ip 0 = route se chuno.
+static void ip_output(uint32_t src_ip, uint32_t dst_ip, uint8_t protocol,
+                      uint8_t *data, uint16_t length, int csum_off) {
   static uint16_t ip_id = 1;
-  u8 buf[1500];
-  memset(buf, 0, sizeof(buf));
+  u8 buf[1514];
+
+  if (length > sizeof(buf) - sizeof(eth_hdr) - sizeof(ip_hdr)) {
+    serial_log("NET: ip_send packet too large");
+    return;
+  }
 
+  netdev_t *dev = net_route(dst_ip);
   eth_hdr *eth = (eth_hdr *)buf;
   ip_hdr *ip = (ip_hdr *)(buf + sizeof(eth_hdr));
+  u8 *l4 = buf + sizeof(eth_hdr) + sizeof(ip_hdr);
 
   // Use broadcast MAC for now (ARP resolution todo)
   for (int i = 0; i < 6; i++) {
@@ -126,15 +187,76 @@ extern "C" void ip_send(uint32_t dst_ip, uint8_t protocol, uint8_t *data,
   ip->flags = 0;
   ip->ttl = 64;
   ip->proto = protocol;
-  ip->src = 0x0F02000A; // 10.0.2.15
+  ip->src = src_ip ? src_ip : net_route_src(dst_ip);
   ip->dst = dst_ip;
   ip->checksum = 0;
-  ip->checksum = checksum(ip, sizeof(ip_hdr));
 
-  memcpy(buf + sizeof(eth_hdr) + sizeof(ip_hdr), data, length);
+  memcpy(l4, data, length);
+
+  uint16_t frame_len = sizeof(eth_hdr) + sizeof(ip_hdr) + length;
+
+  // Loopback pe checksum ki zaroorat nahi, receiver bhi check nahi karta
+  if (dev->features & NETDEV_F_NO_CSUM) {
+    dev->xmit(dev, buf, frame_len, -1, protocol);
+    return;
+  }
 
   serial_log_hex("NET: ip_send proto=", protocol);
-  e1000_send(buf, sizeof(eth_hdr) + sizeof(ip_hdr) + length);
+
+  if (csum_off >= 0 && tx_csum_offload && (dev->features & NETDEV_F_HW_CSUM)) {
+    dev->xmit(dev, buf, frame_len, csum_off, protocol);
+    return;
+  }
+
+  ip->checksum = ip_fast_csum(ip, 5);
+  if (csum_off >= 0) {
+    // Software fallback: seed already field mein hai, bas L4 ko jodo
+    uint16_t cs = csum_fold(csum_partial(l4, length, 0));
+    if (cs == 0 && protocol == IP_PROTO_UDP)
+      cs = 0xFFFF; // UDP mein 0 ka matlab "no checksum" hai
+    memcpy(l4 + csum_off, &cs, sizeof(cs));
+  }
+  dev->xmit(dev, buf, frame_len, -1, protocol);
+}
+
+// Generic IP send function for UDP/TCP (payload ka checksum caller ka kaam)
+extern "C" void ip_send(uint32_t dst_ip, uint8_t protocol, uint8_t *data,
+                        uint16_t length) {
+  ip_output(0, dst_ip, protocol, data, length, -1);
+}
+
+// TCP/UDP ke liye: checksum field (csum_off) mein csum_pseudo_seed daal ke
+// bhejo, baaki checksum NIC ya fallback bharega. src_ip wahi jo seed mein tha.
+extern "C" void ip_send_csum(uint32_t src_ip, uint32_t dst_ip,
+                             uint8_t protocol, uint8_t *data, uint16_t length,
+                             uint16_t csum_off) {
+  ip_output(src_ip, dst_ip, protocol, data, length, csum_off);
+}
+
+// RX checksum: NIC ne verify kiya ho toh skip, warna software se check.
+// 1 = packet theek hai.
+static int ip_rx_csum_ok(ip_hdr *ip, int ip_hdr_len, int l4_len,
+                         uint32_t rx_csum) {
+  if (rx_csum & CSUM_RX_BAD)
+    return 0;
+
+  if (!(rx_csum & CSUM_RX_IP_OK) && ip_fast_csum(ip, ip_hdr_len / 4) != 0)
+    return 0;
+
+  if (ip->proto != 6 && ip->proto != IP_PROTO_UDP)
+    return 1;
+  if (rx_csum & CSUM_RX_L4_OK)
+    return 1;
+
+  u8 *l4 = (u8 *)ip + ip_hdr_len;
+  if (ip->proto == IP_PROTO_UDP) {
+    if (l4_len < (int)sizeof(udp_hdr))
+      return 0;
+    if (((udp_hdr *)l4)->checksum == 0)
+      return 1; // Sender ne checksum nahi bheja
+  }
+  return csum_tcpudp_magic(ip->src, ip->dst, l4_len, ip->proto,
+                           csum_partial(l4, l4_len, 0)) == 0;
 }
 
 void handle_icmp(u8 *pkt) {
@@ -180,7 +302,7 @@ void handle_tcp(u8 *pkt, int total_len) {
   tcp_handle_packet(ip->src, ip->dst, (u8 *)ip + ip_hdr_len, tcp_len);
 }
 
-void handle_ethernet(u8 *packet, int len) {
+void handle_ethernet(u8 *packet, int len, uint32_t rx_csum) {
   eth_hdr *eth = (eth_hdr *)packet;
   u16 type = htons(eth->type);
 
@@ -188,6 +310,15 @@ void handle_ethernet(u8 *packet, int len) {
     handle_arp(packet);
   } else if (type == ETH_TYPE_IP) {
     ip_hdr *ip = (ip_hdr *)(packet + sizeof(eth_hdr));
+    int ip_hdr_len = (ip->ver_ihl & 0x0F) * 4;
+    int ip_len = htons(ip->len);
+    if (ip_hdr_len < (int)sizeof(ip_hdr) || ip_len < ip_hdr_len ||
+        ip_len > len - (int)sizeof(eth_hdr))
+      return;
+    if (!ip_rx_csum_ok(ip, ip_hdr_len, ip_len - ip_hdr_len, rx_csum)) {
+      serial_log("NET: Dropping packet with bad checksum");
+      return;
+    }
     if (ip->proto == IP_PROTO_ICMP)
       handle_icmp((u8 *)ip);
     else if (ip->proto == IP_PROTO_UDP)
@@ -223,13 +354,23 @@ extern "C" void net_poll() {
   }
 
   u8 buf[2048];
-  int len = e1000_receive(buf);
+  uint32_t rx_csum = CSUM_RX_NONE;
+  int len = eth0_dev.poll(&eth0_dev, buf, &rx_csum);
   if (len > 0) {
     serial_log_hex("NET: Incoming Packet, len: ", len);
     // Route to new net_stack for proper ARP/TCP handling
     net_stack_rx(buf, len);
     // Also call old handler for compatibility
-    handle_ethernet(buf, len);
+    handle_ethernet(buf, len, rx_csum);
+  }
+
+  // Loopback queue: ek baar mein kuch frames nikaal do taaki local TCP
+  // stream ek frame per scheduler round pe na atke
+  for (int budget = 0; budget < NET_LO_BUDGET; budget++) {
+    len = loopback_dev.poll(&loopback_dev, buf, &rx_csum);
+    if (len <= 0)
+      break;
+    handle_ethernet(buf, len, rx_csum);
   }
 }
 
@@ -239,6 +380,8 @@ extern "C" void net_init() {
   net_stack_init();
 }
 
+extern "C" u32 net_get_local_ip() { return my_ip; }
+
 extern "C" void net_ping(u32 target_ip) {
   u8 buf[128];
   memset(buf, 0, 128);
@@ -272,14 +415,14 @@ extern "C" void net_ping(u32 target_ip) {
   ip->src = 0x0F02000A; // 10.0.2.15 in little-endian storage
   ip->dst = 0x0202000A; // 10.0.2.2 in little-endian storage
   ip->checksum = 0;
-  ip->checksum = checksum(ip, sizeof(ip_hdr));
+  ip->checksum = ip_fast_csum(ip, 5);
 
   icmp->type = 8; // Echo Request
   icmp->code = 0;
   icmp->id = htons(0x1234);
   icmp->seq = htons(1);
   icmp->checksum = 0;
-  icmp->checksum = checksum(icmp, sizeof(icmp_hdr));
+  icmp->checksum = csum_fold(csum_partial(icmp, sizeof(icmp_hdr), 0));
 
   serial_log("NET: Sending ICMP Echo Request to Gateway (10.0.2.2)...");
 
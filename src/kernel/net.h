@@ -67,7 +67,50 @@ struct dns_hdr {
   u16 arcount;
 } __attribute__((packed));
 
+// ================= NETDEV =================
+// Stack ke neeche ka interface: e1000 (eth0) aur loopback (lo). ip_output
+// route dekh ke device chunta hai, net_poll dono se frames nikalta hai.
+
+#define NETDEV_F_HW_CSUM 0x1 // TX pe IP + TCP/UDP checksum NIC bharta hai
+#define NETDEV_F_NO_CSUM 0x2 // Checksum chahiye hi nahi (loopback)
+
+#define INADDR_LOOPBACK_NET 0x0100007F // 127.0.0.1, network byte order
+#define NET_IS_LOOPBACK(ip) (((ip) & 0xFF) == 127) // 127.0.0.0/8
+
+struct netdev_stats {
+  u32 rx_packets;
+  u32 tx_packets;
+  u32 rx_bytes;
+  u32 tx_bytes;
+  u32 rx_dropped;
+  u32 tx_dropped;
+};
+
+typedef struct netdev {
+  const char *name;
+  u32 ip; // Network byte order
+  u32 features;
+  // Poora Ethernet frame bhejo. l4_csum_off >= 0 (sirf HW_CSUM devices pe):
+  // L4 header ke andar checksum field ka offset, seed already bhara hua.
+  void (*xmit)(struct netdev *dev, u8 *frame, u16 len, int l4_csum_off,
+               u8 proto);
+  // Ek frame nikalo; 0 = queue khali. rx_csum mein CSUM_RX_* flags.
+  int (*poll)(struct netdev *dev, u8 *out, u32 *rx_csum);
+  struct netdev_stats stats;
+} netdev_t;
+
+#define NETDEV_LO 0
+#define NETDEV_ETH0 1
+#define NETDEV_COUNT 2
+
+extern netdev_t loopback_dev; // loopback.cpp
+
 extern "C" void net_poll();
 extern "C" void net_init();
+extern "C" u32 net_get_local_ip(); // Network byte order (10.0.2.15)
+// Destination ke hisaab se source address (127.x ke liye 127.0.0.1)
+extern "C" u32 net_route_src(u32 dst_ip);
+extern "C" int net_local_addr(u32 ip); // Hamara koi address hai?
+extern "C" int net_get_stats(int ifindex, struct netdev_stats *out);
 
 #endif
@@ -3,6 +3,7 @@
 
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "checksum.h"
 #include <stdint.h>
 
 /* =================== BASIC TYPES =================== */
@@ -88,14 +89,6 @@ struct tcp_header {
   u16 urgent;
 } __attribute__((packed));
 
-struct tcp_pseudo {
-  u32 src_ip;
-  u32 dst_ip;
-  u8 zero;
-  u8 proto;
-  u16 tcp_len;
-} __attribute__((packed));
-
 enum tcp_state { TCP_CLOSED, TCP_SYN_SENT, TCP_ESTABLISHED };
 
 struct tcp_socket {
@@ -174,46 +167,14 @@ void arp_send_request(u32 target_ip) {
 /* =================== PHASE 2 — FIX CHECKSUMS =================== */
 
 uint16_t net_checksum(const void *data, uint32_t len) {
-  uint32_t sum = 0;
-  const uint16_t *ptr = (const uint16_t *)data;
-
-  while (len > 1) {
-    sum += *ptr++;
-    if (sum & 0x80000000)
-      sum = (sum & 0xFFFF) + (sum >> 16);
-    len -= 2;
-  }
-
-  if (len)
-    sum += *(const uint8_t *)ptr;
-
-  while (sum >> 16)
-    sum = (sum & 0xFFFF) + (sum >> 16);
-
-  return ~sum;
+  return csum_fold(csum_partial(data, len, 0));
 }
 
 uint16_t tcp_checksum(uint32_t src_ip, uint32_t dst_ip, struct tcp_header *tcp,
                       uint16_t tcp_len) {
-  struct tcp_pseudo psh;
-
-  psh.src_ip = src_ip;
-  psh.dst_ip = dst_ip;
-  psh.zero = 0;
-  psh.proto = 6;
-  psh.tcp_len = net_htons(tcp_len);
-
-  uint32_t size = sizeof(psh) + tcp_len;
-  uint8_t *buf = (uint8_t *)kmalloc(size);
-  if (!buf)
-    return 0;
-
-  memcpy(buf, &psh, sizeof(psh));
-  memcpy(buf + sizeof(psh), tcp, tcp_len);
-
-  uint16_t cs = net_checksum(buf, size);
-  kfree(buf);
-  return cs;
+  // Pseudo-header alag se jodo - pehle yahan kmalloc + copy hota tha
+  return csum_tcpudp_magic(src_ip, dst_ip, tcp_len, IP_PROTO_TCP,
+                           csum_partial(tcp, tcp_len, 0));
 }
 
 /* =================== PHASE 4 — FIX ROUTING =================== */
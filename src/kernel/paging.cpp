@@ -5,6 +5,7 @@
 #include "../include/string.h"
 #include "../kernel/memory.h"
 #include "apic.h"
+#include "elf_loader.h"
 #include "pmm.h"
 #include "process.h"
 
@@ -30,6 +31,11 @@ void page_fault_handler(registers_t *regs) {
   uint32_t faulting_address;
   asm volatile("mov %%cr2, %0" : "=r"(faulting_address));
 
+  // ELF segments: page cache se shared map, COW copy, ya demand-zero BSS
+  if (elf_handle_fault(faulting_address, regs->err_code)) {
+    return;
+  }
+
   if (handle_demand_paging(faulting_address)) {
     return; // Galti sudhar li!
   }
@@ -31,6 +31,15 @@ extern uint32_t *current_directory;
 #undef PTE_NX
 #define PTE_NX 0 // Disabled for now
 
+// Available bits (9-11) - hardware inhe ignore karta hai
+#define PTE_SHARED 0x200 // Frame exec page cache ka hai (refcounted), free mat karo
+#define PTE_COW 0x400    // Private writable page abhi shared frame pe - write pe copy
+
+// Page fault error code
+#define PF_ERR_PRESENT 0x1
+#define PF_ERR_WRITE 0x2
+#define PF_ERR_USER 0x4
+
 uint32_t *paging_get_pte(uint32_t virt);
 
 #endif
@@ -1,5 +1,6 @@
 #include "pipe.h"
 #include "../drivers/serial.h"
+#include "../include/poll.h"
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
@@ -27,8 +28,11 @@ uint32_t pipe_read(vfs_node_t *node, uint32_t offset, uint32_t size,
         break; // Jitna mila utna leke khush raho
 
       // Ruko zara, sabar karo (Data ka wait)
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      asm volatile("cli");
+      if (pipe->head == pipe->tail && !pipe->write_closed)
+        sleep_on(&pipe->wait);
+      else
+        asm volatile("sti");
       continue;
     }
 
@@ -37,15 +41,8 @@ uint32_t pipe_read(vfs_node_t *node, uint32_t offset, uint32_t size,
   }
 
   // Jo wait kar rahe hain unhe jagao (shayad koi likhne wala ho)
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  if (read_bytes > 0)
+    wake_up_all(&pipe->wait);
 
   return read_bytes;
 }
@@ -65,8 +62,13 @@ uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
         break; // Jitna likha gaya utna kaafi hai abhi ke liye
 
       // Jagah nahi hai, thoda ruko
-      current_process->state = PROCESS_WAITING;
-      schedule();
+      asm volatile("cli");
+      if ((pipe->tail + 1) % PIPE_SIZE == pipe->head && !pipe->read_closed)
+        sleep_on(&pipe->wait);
+      else
+        asm volatile("sti");
+      if (pipe->read_closed)
+        break;
       continue;
     }
 
@@ -75,15 +77,8 @@ uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
   }
 
   // Padhne walon ko jagao, maal aa gaya hai
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  if (written_bytes > 0)
+    wake_up_all(&pipe->wait);
 
   return written_bytes;
 }
@@ -101,18 +96,33 @@ void pipe_close(vfs_node_t *node) {
   if (pipe->read_closed && pipe->write_closed) {
     kfree(pipe->buffer);
     kfree(pipe);
+    return;
   }
 
-  // Baakiyo ko batao ki dukaan band ho rahi hai ya khul rahi hai
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
+  // Baakiyo ko batao ki dukaan band ho rahi hai (EOF / EPIPE / POLLHUP)
+  wake_up_all(&pipe->wait);
+}
+
+int pipe_poll(vfs_node_t *node, poll_table_t *pt) {
+  pipe_t *pipe = (pipe_t *)node->impl;
+  if (!pipe)
+    return POLLNVAL;
+  poll_wait(&pipe->wait, pt);
+
+  int mask = 0;
+  if (node->flags & 0x1) {
+    if (pipe->head != pipe->tail)
+      mask |= POLLIN | POLLRDNORM;
+    if (pipe->write_closed)
+      mask |= POLLHUP;
+  }
+  if (node->flags & 0x2) {
+    if (pipe->read_closed)
+      mask |= POLLERR;
+    else if ((pipe->tail + 1) % PIPE_SIZE != pipe->head)
+      mask |= POLLOUT | POLLWRNORM;
   }
+  return mask;
 }
 
 int sys_pipe(uint32_t *filedes) {
@@ -136,6 +146,7 @@ int sys_pipe(uint32_t *filedes) {
   pipe->tail = 0;
   pipe->read_closed = 0;
   pipe->write_closed = 0;
+  wait_queue_init(&pipe->wait);
 
   // Read end ke liye VFS node banao
   vfs_node_t *read_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
@@ -144,7 +155,9 @@ int sys_pipe(uint32_t *filedes) {
   read_node->impl = (void *)pipe;
   read_node->read = pipe_read;
   read_node->close = pipe_close;
+  read_node->poll = pipe_poll;
   read_node->flags = 0x1; // READ side
+  read_node->type = VFS_PIPE;
   read_node->ref_count = 1;
 
   // Write end ke liye VFS node banao
@@ -154,23 +167,24 @@ int sys_pipe(uint32_t *filedes) {
   write_node->impl = (void *)pipe;
   write_node->write = pipe_write;
   write_node->close = pipe_close;
+  write_node->poll = pipe_poll;
   write_node->flags = 0x2; // WRITE side
+  write_node->type = VFS_PIPE;
   write_node->ref_count = 1;
 
   // Process ke fd_table mein jagah dhundo
-  int f1 = -1, f2 = -1;
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (current_process->fd_table[i] == 0) {
-      if (f1 == -1)
-        f1 = i;
-      else if (f2 == -1) {
-        f2 = i;
-        break;
-      }
-    }
-  }
-
-  if (f1 == -1 || f2 == -1) {
+  file_description_t *desc1 = fd_desc_alloc(read_node, 0);  // O_RDONLY
+  file_description_t *desc2 = fd_desc_alloc(write_node, 1); // O_WRONLY
+  int f1 = desc1 ? fd_alloc(desc1, 0, 0) : -1;
+  int f2 = (f1 >= 0 && desc2) ? fd_alloc(desc2, 0, 0) : -1;
+
+  if (f1 < 0 || f2 < 0) {
+    if (f1 >= 0)
+      fd_detach(f1);
+    if (desc1)
+      kfree(desc1);
+    if (desc2)
+      kfree(desc2);
     kfree(read_node);
     kfree(write_node);
     kfree(pipe->buffer);
@@ -178,23 +192,6 @@ int sys_pipe(uint32_t *filedes) {
     return -1;
   }
 
-  file_description_t *desc1 =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
-  desc1->node = read_node;
-  desc1->offset = 0;
-  desc1->flags = 0; // O_RDONLY
-  desc1->ref_count = 1;
-
-  file_description_t *desc2 =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
-  desc2->node = write_node;
-  desc2->offset = 0;
-  desc2->flags = 1; // O_WRONLY
-  desc2->ref_count = 1;
-
-  current_process->fd_table[f1] = desc1;
-  current_process->fd_table[f2] = desc2;
-
   filedes[0] = (uint32_t)f1;
   filedes[1] = (uint32_t)f2;
 
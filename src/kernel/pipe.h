@@ -3,6 +3,7 @@
 
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "wait_queue.h"
 
 #define PIPE_SIZE 4096
 
@@ -13,7 +14,7 @@ typedef struct {
   uint32_t size;
   uint8_t read_closed;
   uint8_t write_closed;
-  // We'll add wait queues here later if needed for advanced blocking
+  wait_queue_t wait; // Readers, writers aur poll/epoll watchers sab yahin
 } pipe_t;
 
 #ifdef __cplusplus
@@ -29,6 +30,7 @@ uint32_t pipe_read(vfs_node_t *node, uint32_t offset, uint32_t size,
 uint32_t pipe_write(vfs_node_t *node, uint32_t offset, uint32_t size,
                     uint8_t *buffer);
 void pipe_close(vfs_node_t *node);
+int pipe_poll(vfs_node_t *node, poll_table_t *pt);
 
 #ifdef __cplusplus
 }
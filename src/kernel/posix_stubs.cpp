@@ -138,14 +138,6 @@ int fchown(int fd, int owner, int group) {
   return -ENOSYS;
 }
 
-int fcntl(int fd, int cmd, int arg) {
-  (void)fd;
-  (void)cmd;
-  (void)arg;
-  serial_log("fcntl: stub called");
-  return -ENOSYS;
-}
-
 // ============================================================================
 // Directory Operations Stubs
 // ============================================================================
@@ -164,102 +156,4 @@ int getdents(int fd, void *dirp, unsigned int count) {
   return -ENOSYS;
 }
 
-// ============================================================================
-// Socket Operations Stubs
-// ============================================================================
-
-int listen(int sockfd, int backlog) {
-  (void)sockfd;
-  (void)backlog;
-  serial_log("listen: stub called");
-  return -ENOSYS;
-}
-
-int send(int sockfd, const void *buf, size_t len, int flags) {
-  (void)sockfd;
-  (void)buf;
-  (void)len;
-  (void)flags;
-  serial_log("send: stub called");
-  return -ENOSYS;
-}
-
-int recv(int sockfd, void *buf, size_t len, int flags) {
-  (void)sockfd;
-  (void)buf;
-  (void)len;
-  (void)flags;
-  serial_log("recv: stub called");
-  return -ENOSYS;
-}
-
-int sendto(int sockfd, const void *buf, size_t len, int flags,
-           const void *dest_addr, unsigned int addrlen) {
-  (void)sockfd;
-  (void)buf;
-  (void)len;
-  (void)flags;
-  (void)dest_addr;
-  (void)addrlen;
-  serial_log("sendto: stub called");
-  return -ENOSYS;
-}
-
-int recvfrom(int sockfd, void *buf, size_t len, int flags, void *src_addr,
-             unsigned int *addrlen) {
-  (void)sockfd;
-  (void)buf;
-  (void)len;
-  (void)flags;
-  (void)src_addr;
-  (void)addrlen;
-  serial_log("recvfrom: stub called");
-  return -ENOSYS;
-}
-
-int getsockname(int sockfd, void *addr, unsigned int *addrlen) {
-  (void)sockfd;
-  (void)addr;
-  (void)addrlen;
-  serial_log("getsockname: stub called");
-  return -ENOSYS;
-}
-
-int getpeername(int sockfd, void *addr, unsigned int *addrlen) {
-  (void)sockfd;
-  (void)addr;
-  (void)addrlen;
-  serial_log("getpeername: stub called");
-  return -ENOSYS;
-}
-
-int setsockopt(int sockfd, int level, int optname, const void *optval,
-               unsigned int optlen) {
-  (void)sockfd;
-  (void)level;
-  (void)optname;
-  (void)optval;
-  (void)optlen;
-  serial_log("setsockopt: stub called");
-  return -ENOSYS;
-}
-
-int getsockopt(int sockfd, int level, int optname, void *optval,
-               unsigned int *optlen) {
-  (void)sockfd;
-  (void)level;
-  (void)optname;
-  (void)optval;
-  (void)optlen;
-  serial_log("getsockopt: stub called");
-  return -ENOSYS;
-}
-
-int shutdown(int sockfd, int how) {
-  (void)sockfd;
-  (void)how;
-  serial_log("shutdown: stub called");
-  return -ENOSYS;
-}
-
 } // extern "C"
@@ -1,7 +1,9 @@
 #include "process.h"
 #include "../drivers/serial.h"
+#include "../include/errno.h"
 #include "../include/isr.h"
 #include "../include/signal.h"
+#include "../include/spawn.h"
 #include "../include/string.h"
 #include "../kernel/memory.h"
 #include "elf_loader.h"
@@ -11,6 +13,7 @@
 #include "paging.h"
 #include "pmm.h"
 #include "shm.h"
+#include "syscall.h"
 #include "vm.h"
 
 process_t *current_process = 0;
@@ -30,13 +33,16 @@ void init_multitasking() {
   current_process->id = 0;
   current_process->state = PROCESS_RUNNING;
   current_process->parent = 0;
+  current_process->vfork_parent = 0;
   current_process->exit_code = 0;
   current_process->page_directory =
       (uint32_t *)VIRT_TO_PHYS(kernel_directory); // Directory set ho gayi
   current_process->kernel_stack_top = (uint32_t)&stack_top;
+  elf_mm_init(&current_process->exec_mm);
 
-  for (int i = 0; i < MAX_PROCESS_FILES; i++)
-    current_process->fd_table[i] = 0;
+  current_process->files = 0; // Kernel: pehli zaroorat pe banega
+  current_process->nofile_cur = NR_OPEN_DEFAULT;
+  current_process->nofile_max = NR_OPEN_MAX;
 
   current_process->priority = DEFAULT_PRIORITY;
   current_process->time_slice = DEFAULT_TIME_SLICE;
@@ -57,10 +63,15 @@ void create_kernel_thread(void (*fn)()) {
   new_proc->id = next_pid++;
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
+  new_proc->vfork_parent = 0;
   new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)VIRT_TO_PHYS(kernel_directory);
   new_proc->heap_end = 0;
+  elf_mm_init(&new_proc->exec_mm);
   new_proc->pledges = PLEDGE_ALL;
+  new_proc->files = 0;
+  new_proc->nofile_cur = NR_OPEN_DEFAULT;
+  new_proc->nofile_max = NR_OPEN_MAX;
 
   new_proc->priority = DEFAULT_PRIORITY;
   new_proc->time_slice = DEFAULT_TIME_SLICE;
@@ -107,6 +118,87 @@ void user_mode_entry(uint32_t entry, uint32_t utop) {
                : "eax");
 }
 
+// ============================================================================
+// argv/envp - address space badalne se pehle kernel buffer mein
+// ============================================================================
+#define PROC_ARG_MAX 32     // argv aur envp, har ek
+#define PROC_ARG_BYTES 2048 // Saari strings - user stack ke pehle page mein
+
+typedef struct proc_args {
+  int argc, envc;
+  uint32_t len;              // data mein kitne bytes
+  char data[PROC_ARG_BYTES]; // argv strings, phir envp strings
+} proc_args_t;
+
+// User ka array aur har string - padhne se pehle pointer check, aur string
+// ki lambai buffer ki bachi jagah tak hi naapo
+static int proc_args_add(proc_args_t *a, char *const v[], int *count) {
+  *count = 0;
+  if (!v)
+    return 0;
+  for (;; (*count)++) {
+    if (!validate_user_pointer(&v[*count], sizeof(char *)))
+      return -EFAULT;
+    const char *s = v[*count];
+    if (!s)
+      break;
+    if (*count == PROC_ARG_MAX)
+      return -E2BIG;
+    if (!validate_user_pointer(s, 1))
+      return -EFAULT;
+    uint32_t room = PROC_ARG_BYTES - a->len, n = 0;
+    while (n < room && s[n])
+      n++;
+    if (n == room)
+      return -E2BIG;
+    memcpy(a->data + a->len, s, n + 1);
+    a->len += n + 1;
+  }
+  return 0;
+}
+
+// kmalloc'd block (caller kfree kare), nullptr + *err pe fail
+static proc_args_t *proc_args_copy(char *const argv[], char *const envp[],
+                                   int *err) {
+  proc_args_t *a = (proc_args_t *)kmalloc(sizeof(proc_args_t));
+  if (!a) {
+    *err = -ENOMEM;
+    return nullptr;
+  }
+  a->len = 0;
+  *err = proc_args_add(a, argv, &a->argc);
+  if (*err == 0)
+    *err = proc_args_add(a, envp, &a->envc);
+  if (*err < 0) {
+    kfree(a);
+    return nullptr;
+  }
+  return a;
+}
+
+// Naye process ke stack pe (uska PD active ho): strings, argv[], envp[],
+// phir create_user_process jaisa [argc][argv] aur uske baad envp. Naya sp.
+static uint32_t proc_args_push(const proc_args_t *a, uint32_t top) {
+  uint32_t strs = top - a->len;
+  memcpy((void *)strs, a->data, a->len);
+
+  uint32_t *v = (uint32_t *)(strs & ~3) - (a->argc + a->envc + 2);
+  uint32_t s = strs;
+  for (int i = 0; i < a->argc + a->envc; i++) {
+    v[i < a->argc ? i : i + 1] = s;
+    s += strlen((const char *)s) + 1;
+  }
+  v[a->argc] = 0;
+  v[a->argc + a->envc + 1] = 0;
+
+  uint32_t argv_base = (uint32_t)v;
+  uint32_t envp_base = (uint32_t)(v + a->argc + 1);
+  *(--v) = envp_base;
+  *(--v) = argv_base;
+  *(--v) = (uint32_t)a->argc;
+  return (uint32_t)v;
+}
+
 extern "C" void create_user_process(const char *filename, char *const argv[]) {
   // Disable interrupts during process creation to prevent race conditions
   uint32_t eflags;
@@ -129,7 +221,8 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
   pd_switch((uint32_t *)phys_pd);
 
   uint32_t top_addr = 0;
-  uint32_t entry = load_elf(filename, &top_addr);
+  elf_mm_t mm;
+  uint32_t entry = load_elf(filename, &top_addr, &mm);
 
   // Restore parent PD in current process struct
   current_process->page_directory = old_pd_ptr;
@@ -150,25 +243,22 @@ extern "C" void create_user_process(const char *filename, char *const argv[]) {
   new_proc->id = next_pid++;
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
+  new_proc->vfork_parent = 0;
   new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)phys_pd;
   new_proc->heap_end = top_addr;
+  new_proc->exec_mm = mm;
   new_proc->pledges = PLEDGE_ALL;
 
-  for (int i = 0; i < MAX_PROCESS_FILES; i++)
-    new_proc->fd_table[i] = 0;
+  new_proc->files = files_alloc();
+  new_proc->nofile_cur = NR_OPEN_DEFAULT;
+  new_proc->nofile_max = NR_OPEN_MAX;
 
+  // stdin/stdout/stderr = /dev/tty
   vfs_node_t *tty = vfs_resolve_path("/dev/tty");
-  if (tty) {
-    for (int i = 0; i < 3; i++) {
-      file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
-      desc->node = tty;
-      desc->offset = 0;
-      desc->flags = O_RDWR;
-      desc->ref_count = 1;
-      new_proc->fd_table[i] = desc;
-    }
+  if (tty && new_proc->files) {
+    for (int i = 0; i < 3; i++)
+      files_install_at(new_proc->files, i, fd_desc_alloc(tty, O_RDWR), 0);
   }
 
   // CWD inherit karo agar parent hai
@@ -355,32 +445,37 @@ void enter_user_mode() {
 
 int get_pid() { return current_process ? current_process->id : -1; }
 
-int fork_process(registers_t *parent_regs) {
+// fork aur vfork dono: `share_vm` pe child parent ka hi PD chalata hai
+// (pd_clone ki poori page copy nahi) jab tak exec ya exit na kare
+static process_t *fork_common(registers_t *parent_regs, bool share_vm) {
   asm volatile("cli");
 
-  uint32_t phys_new_pd = (uint32_t)pd_clone(current_process->page_directory);
+  uint32_t phys_new_pd =
+      share_vm ? (uint32_t)current_process->page_directory
+               : (uint32_t)pd_clone(current_process->page_directory);
   if (!phys_new_pd) {
     asm volatile("sti");
-    return -1;
+    return 0;
   }
 
   process_t *child = (process_t *)kmalloc(sizeof(process_t));
   child->id = next_pid++;
   child->state = PROCESS_READY;
   child->parent = current_process;
+  child->vfork_parent = share_vm ? current_process : 0;
   child->exit_code = 0;
   child->page_directory = (uint32_t *)phys_new_pd;
   child->entry_point = current_process->entry_point;
   child->user_stack_top = current_process->user_stack_top;
   child->heap_end = current_process->heap_end;
+  elf_mm_dup(&child->exec_mm, &current_process->exec_mm);
   strcpy(child->cwd, current_process->cwd);
   child->pledges = current_process->pledges;
 
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    child->fd_table[i] = current_process->fd_table[i];
-    if (child->fd_table[i])
-      child->fd_table[i]->ref_count++;
-  }
+  // Fork: table ki copy (descriptions share hoti hain, ref_count++)
+  child->files = files_dup(current_process->files);
+  child->nofile_cur = current_process->nofile_cur;
+  child->nofile_max = current_process->nofile_max;
 
   uint32_t *child_kstack = (uint32_t *)kmalloc(4096);
   child->kernel_stack_top = (uint32_t)child_kstack + 4096;
@@ -418,25 +513,52 @@ int fork_process(registers_t *parent_regs) {
   current_process->next = child;
 
   asm volatile("sti");
-  return child->id;
+  return child;
+}
+
+int fork_process(registers_t *parent_regs) {
+  process_t *child = fork_common(parent_regs, false);
+  return child ? (int)child->id : -1;
+}
+
+// vfork child exec/exit tak parent ka PD chalata hai. Ab parent jaag sakta hai.
+static void vfork_release(process_t *child) {
+  process_t *parent = child->vfork_parent;
+  child->vfork_parent = 0;
+  if (parent->state == PROCESS_WAITING)
+    parent->state = PROCESS_READY;
+}
+
+// Launch ka kharcha parent ki memory pe nirbhar nahi: na PD copy, na page
+// copy. Parent tab tak soya rehta hai jab tak child exec ya exit na kare.
+int vfork_process(registers_t *parent_regs) {
+  process_t *child = fork_common(parent_regs, true);
+  if (!child)
+    return -ENOMEM;
+
+  while (true) {
+    asm volatile("cli");
+    if (!child->vfork_parent)
+      break;
+    current_process->state = PROCESS_WAITING; // Signal se jaage toh phir so
+    asm volatile("sti");
+    schedule();
+  }
+  asm volatile("sti");
+  return (int)child->id;
 }
 
 void exit_process(int status) {
   asm volatile("cli");
+  if (current_process->vfork_parent) {
+    current_process->page_directory = 0; // Parent ka PD - reap pe destroy nahi
+    vfork_release(current_process);
+  }
   current_process->state = PROCESS_ZOMBIE;
   current_process->exit_code = (uint32_t)status;
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (current_process->fd_table[i]) {
-      file_description_t *desc = current_process->fd_table[i];
-      current_process->fd_table[i] = 0;
-      desc->ref_count--;
-      if (desc->ref_count == 0) {
-        if (desc->node->close)
-          desc->node->close(desc->node);
-        kfree(desc);
-      }
-    }
-  }
+  files_struct_t *files = current_process->files;
+  current_process->files = 0;
+  files_put(files);
   if (current_process->parent)
     sys_kill(current_process->parent->id, SIGCHLD);
   schedule();
@@ -470,7 +592,9 @@ int wait_process(int *status) {
           ready_queue = child->next;
       }
       kfree((void *)(child->kernel_stack_top - 4096));
-      pd_destroy(child->page_directory);
+      if (child->page_directory)
+        pd_destroy(child->page_directory);
+      elf_mm_release(&child->exec_mm);
       kfree(child);
       asm volatile("sti");
       return (int)pid;
@@ -510,13 +634,45 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
     return -1;
   }
 
-  vm_clear_user_mappings();
+  // argv/envp bhi - user mappings ab jaane wali hain
+  int err;
+  proc_args_t *args = proc_args_copy(argv, envp, &err);
+  if (!args)
+    return err;
+
+  process_t *vparent = current_process->vfork_parent;
+  uint32_t *borrowed_pd = current_process->page_directory;
+  if (vparent) {
+    // vfork child: PD parent ka hai, use chhedna nahi - apna naya PD
+    uint32_t *pd = pd_create();
+    if (!pd) {
+      kfree(args);
+      return -ENOMEM;
+    }
+    current_process->page_directory = pd;
+    pd_switch(pd);
+  } else {
+    vm_clear_user_mappings();
+  }
+
+  elf_mm_release(&current_process->exec_mm); // Purane PTEs hat chuke
   uint32_t top_addr = 0;
-  uint32_t entry = load_elf(kernel_path, &top_addr);
+  uint32_t entry = load_elf(kernel_path, &top_addr, &current_process->exec_mm);
   if (entry == 0) {
     serial_log("EXEC: Failed to load ELF.");
+    if (vparent) {
+      // Parent ke address space mein wapas - child _exit karega
+      uint32_t *pd = current_process->page_directory;
+      current_process->page_directory = borrowed_pd;
+      pd_switch(borrowed_pd);
+      pd_destroy(pd);
+      elf_mm_dup(&current_process->exec_mm, &vparent->exec_mm);
+    }
+    kfree(args);
     return -1;
   }
+  if (vparent)
+    vfork_release(current_process);
 
   serial_log_hex("EXEC: Entry point loaded at ", entry);
 
@@ -526,9 +682,12 @@ int exec_process(registers_t *regs, const char *path, char *const argv[],
   vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
 
   current_process->entry_point = entry;
-  current_process->user_stack_top = user_stack_virt + 4096;
+  current_process->user_stack_top =
+      proc_args_push(args, user_stack_virt + 4096);
+  kfree(args);
   current_process->heap_end = top_addr;
   current_process->pledges = PLEDGE_ALL; // Reset pledges for new exec
+  files_close_on_exec(current_process->files);
   regs->eip = entry;
   regs->useresp = current_process->user_stack_top;
 
@@ -609,7 +768,9 @@ int sys_waitpid(int pid, int *status, int options) {
 
       // Free resources
       kfree((void *)(found->kernel_stack_top - 4096));
-      pd_destroy(found->page_directory);
+      if (found->page_directory)
+        pd_destroy(found->page_directory);
+      elf_mm_release(&found->exec_mm);
       kfree(found);
 
       asm volatile("sti");
@@ -720,6 +881,10 @@ int sys_waitid(int idtype, int id, void *infop, int options) {
 
 void sys__exit(int status) {
   asm volatile("cli");
+  if (current_process->vfork_parent) {
+    current_process->page_directory = 0;
+    vfork_release(current_process);
+  }
 
   current_process->state = PROCESS_ZOMBIE;
   current_process->exit_code = (uint32_t)status;
@@ -790,52 +955,167 @@ void check_process_alarms(void) {
 }
 
 // ============================================================================
-// sys_posix_spawn - Spawn new process (simplified fork+exec)
+// sys_posix_spawn - Naya process seedha naye PD mein (fork+exec ke bina)
 // ============================================================================
+// Parent ka address space kabhi copy nahi hota, toh launch ka kharcha parent
+// ki memory pe nirbhar nahi. File actions child ke table pe order mein lagte
+// hain, attributes (pgroup, sigmask, sigdef, priority) exec ke baad jaise.
+
+// Child abhi chala nahi - uske table pe seedha kaam
+static int spawn_file_actions(files_struct_t *files,
+                              const posix_spawn_file_actions_t *fa) {
+  for (int i = 0; i < fa->count; i++) {
+    const posix_spawn_file_action_t *a = &fa->actions[i];
+    switch (a->type) {
+    case SPAWN_FA_OPEN: {
+      vfs_node_t *node = vfs_resolve_path(a->path);
+      if (!node && (a->oflag & O_CREAT) && vfs_create(a->path, VFS_FILE) == 0)
+        node = vfs_resolve_path(a->path);
+      if (!node)
+        return -ENOENT;
+      file_description_t *desc = fd_desc_alloc(node, a->oflag & ~O_CLOEXEC);
+      if (!desc)
+        return -ENOMEM;
+      if (node->open)
+        node->open(node);
+      int ret =
+          files_install_at(files, a->fd, desc, (a->oflag & O_CLOEXEC) != 0);
+      if (ret < 0) {
+        fd_desc_put(desc);
+        return ret;
+      }
+      break;
+    }
+    case SPAWN_FA_CLOSE:
+      files_close_at(files, a->fd); // Pehle se band ho toh bhi theek
+      break;
+    case SPAWN_FA_DUP2: {
+      file_description_t *desc = files_get(files, a->fd);
+      if (!desc)
+        return -EBADF;
+      if (a->fd == a->newfd) {
+        files_set_cloexec(files, a->fd, 0); // POSIX: sirf cloexec hatao
+        break;
+      }
+      desc->ref_count++;
+      int ret = files_install_at(files, a->newfd, desc, 0);
+      if (ret < 0) {
+        fd_desc_put(desc);
+        return ret;
+      }
+      break;
+    }
+    default:
+      return -EINVAL;
+    }
+  }
+  return 0;
+}
+
+static void spawn_attrs(process_t *p, const posix_spawnattr_t *attr) {
+  // Exec jaisa: handlers default, sirf ignored signals ignored rehte hain
+  for (int sig = 0; sig < NSIG; sig++) {
+    bool ign = current_process->signal_actions[sig].sa_handler == SIG_IGN;
+    if (ign && !(attr && (attr->flags & POSIX_SPAWN_SETSIGDEF) &&
+                 (attr->sigdefault & ((sigset_t)1 << sig))))
+      p->signal_actions[sig].sa_handler = SIG_IGN;
+  }
+  p->signal_mask = current_process->signal_mask;
+  if (!attr)
+    return;
+
+  if (attr->flags & POSIX_SPAWN_SETPGROUP)
+    p->pgid = attr->pgroup ? attr->pgroup : p->id;
+  if (attr->flags & POSIX_SPAWN_SETSIGMASK)
+    p->signal_mask = attr->sigmask;
+  if (attr->flags & POSIX_SPAWN_SETSCHEDPARAM)
+    p->priority = attr->priority;
+  if (attr->flags & POSIX_SPAWN_RESETIDS) {
+    p->euid = p->suid = p->uid;
+    p->egid = p->sgid = p->gid;
+  }
+}
 
 int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
                     void *attrp, char *const argv[], char *const envp[]) {
-  (void)file_actions; // Not implemented
-  (void)attrp;        // Not implemented
-  (void)argv;         // Not fully implemented
-  (void)envp;         // Not fully implemented
-
   if (!path)
-    return -22; // EINVAL
+    return -EINVAL;
+  // Har user pointer chhoone se pehle - kernel mode fault = panic
+  if (!validate_user_pointer(path, 1) ||
+      (pid_out && !validate_user_pointer(pid_out, sizeof(int))) ||
+      (attrp && !validate_user_pointer(attrp, sizeof(posix_spawnattr_t))) ||
+      (file_actions &&
+       !validate_user_pointer(file_actions,
+                              sizeof(posix_spawn_file_actions_t))))
+    return -EFAULT;
+
+  // Parent ki memory se sab kuch PD badalne se pehle kernel mein
+  char kernel_path[256];
+  strncpy(kernel_path, path, 255);
+  kernel_path[255] = 0;
+
+  posix_spawnattr_t attr;
+  if (attrp) {
+    memcpy(&attr, attrp, sizeof(attr));
+    if ((attr.flags & POSIX_SPAWN_SETSCHEDPARAM) &&
+        (attr.priority < 0 || attr.priority > 139))
+      return -EINVAL;
+  }
+
+  posix_spawn_file_actions_t *fa = 0;
+  if (file_actions) {
+    fa = (posix_spawn_file_actions_t *)kmalloc(sizeof(*fa));
+    if (!fa)
+      return -ENOMEM;
+    memcpy(fa, file_actions, sizeof(*fa));
+    if (fa->count < 0 || fa->count > SPAWN_MAX_ACTIONS) {
+      kfree(fa);
+      return -EINVAL;
+    }
+    // User ne NUL nahi diya toh bhi vfs_resolve_path buffer ke bahar na jaye
+    for (int i = 0; i < fa->count; i++)
+      fa->actions[i].path[SPAWN_PATH_MAX - 1] = 0;
+  }
+
+  int err;
+  proc_args_t *args = proc_args_copy(argv, envp, &err);
+  if (!args) {
+    if (fa)
+      kfree(fa);
+    return err;
+  }
 
-  // Create new process directly (more efficient than fork+exec)
   uint32_t phys_pd = (uint32_t)pd_create();
-  if (!phys_pd)
-    return -12; // ENOMEM
+  process_t *new_proc = (process_t *)kmalloc(sizeof(process_t));
+  uint32_t *kstack = (uint32_t *)kmalloc(4096);
+  uint32_t *ktop;
+  elf_mm_t mm;
+  elf_mm_init(&mm);
+  uint32_t top_addr = 0, entry = 0, phys_old_pd;
+  uint32_t user_stack_virt = 0xB0000000;
+  err = -ENOMEM;
+  if (!phys_pd || !new_proc || !kstack)
+    goto fail;
 
-  uint32_t phys_old_pd;
   asm volatile("mov %%cr3, %0" : "=r"(phys_old_pd));
 
   pd_switch((uint32_t *)phys_pd);
-
-  uint32_t top_addr = 0;
-  uint32_t entry = load_elf(path, &top_addr);
-
+  entry = load_elf(kernel_path, &top_addr, &mm);
   pd_switch((uint32_t *)phys_old_pd);
 
   if (entry == 0) {
-    pd_destroy((uint32_t *)phys_pd);
-    return -2; // ENOENT
-  }
-
-  process_t *new_proc = (process_t *)kmalloc(sizeof(process_t));
-  if (!new_proc) {
-    pd_destroy((uint32_t *)phys_pd);
-    return -12; // ENOMEM
+    err = -ENOENT;
+    goto fail;
   }
 
   // Initialize new process
+  memset(new_proc, 0, sizeof(process_t));
   new_proc->id = next_pid++;
   new_proc->state = PROCESS_READY;
   new_proc->parent = current_process;
-  new_proc->exit_code = 0;
   new_proc->page_directory = (uint32_t *)phys_pd;
   new_proc->heap_end = top_addr;
+  new_proc->exec_mm = mm;
   new_proc->pledges = PLEDGE_ALL;
   new_proc->pgid = current_process->pgid;
   new_proc->sid = current_process->sid;
@@ -848,64 +1128,55 @@ int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
   new_proc->egid = current_process->egid;
   new_proc->sgid = current_process->sgid;
 
-  // Initialize file descriptors (inherit from parent)
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    new_proc->fd_table[i] = current_process->fd_table[i];
-    if (new_proc->fd_table[i])
-      new_proc->fd_table[i]->ref_count++;
-  }
-
   strcpy(new_proc->cwd, current_process->cwd);
 
-  new_proc->priority = DEFAULT_PRIORITY;
+  new_proc->priority = current_process->priority;
   new_proc->time_slice = DEFAULT_TIME_SLICE;
   new_proc->time_remaining = DEFAULT_TIME_SLICE;
-  new_proc->sleep_until = 0;
-  new_proc->alarm_time = 0;
-
-  // Initialize signal state
-  new_proc->pending_signals = 0;
-  new_proc->signal_mask = 0;
-  new_proc->in_signal_handler = 0;
-
-  // Resource usage
-  new_proc->utime = 0;
-  new_proc->stime = 0;
-  new_proc->cutime = 0;
-  new_proc->cstime = 0;
   new_proc->start_time = tick;
-  new_proc->unveils = 0;
+  spawn_attrs(new_proc, attrp ? &attr : 0);
+
+  // File descriptors: parent ki copy, phir file actions, phir close-on-exec
+  new_proc->files = files_dup(current_process->files);
+  new_proc->nofile_cur = current_process->nofile_cur;
+  new_proc->nofile_max = current_process->nofile_max;
+  if (!new_proc->files)
+    goto fail;
+  if (fa && (err = spawn_file_actions(new_proc->files, fa)) < 0) {
+    files_put(new_proc->files);
+    goto fail;
+  }
+  files_close_on_exec(new_proc->files);
 
-  // Allocate kernel stack
-  uint32_t *kstack = (uint32_t *)kmalloc(4096);
   new_proc->kernel_stack_top = (uint32_t)kstack + 4096;
 
-  // Allocate user stack
+  // User stack + argv/envp
   pd_switch((uint32_t *)phys_pd);
-  uint32_t user_stack_virt = 0xB0000000;
   vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt, 7);
   vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt - 0x1000, 7);
   vm_map_page((uint32_t)pmm_alloc_block(), user_stack_virt + 0x1000, 7);
+  new_proc->user_stack_top = proc_args_push(args, user_stack_virt + 4096);
   pd_switch((uint32_t *)phys_old_pd);
 
   new_proc->entry_point = entry;
-  new_proc->user_stack_top = user_stack_virt + 4096;
 
   // Setup kernel stack for first context switch
-  uint32_t *ktop = (uint32_t *)new_proc->kernel_stack_top;
+  ktop = (uint32_t *)new_proc->kernel_stack_top;
   *(--ktop) = new_proc->user_stack_top;
   *(--ktop) = entry;
   *(--ktop) = 0;
-  extern void user_mode_entry(uint32_t entry, uint32_t utop);
   *(--ktop) = (uint32_t)user_mode_entry;
   *(--ktop) = 0;      // ebp
   *(--ktop) = 0;      // ebx
   *(--ktop) = 0;      // esi
   *(--ktop) = 0;      // edi
   *(--ktop) = 0x0202; // flags
-
   new_proc->esp = (uint32_t)ktop;
 
+  kfree(args);
+  if (fa)
+    kfree(fa);
+
   // Add to process list
   new_proc->next = current_process->next;
   current_process->next = new_proc;
@@ -915,4 +1186,17 @@ int sys_posix_spawn(int *pid_out, const char *path, void *file_actions,
 
   serial_log_hex("POSIX_SPAWN: Created process ", new_proc->id);
   return 0;
+
+fail:
+  if (phys_pd)
+    pd_destroy((uint32_t *)phys_pd);
+  elf_mm_release(&mm);
+  if (new_proc)
+    kfree(new_proc);
+  if (kstack)
+    kfree(kstack);
+  if (fa)
+    kfree(fa);
+  kfree(args);
+  return err;
 }
@@ -5,9 +5,10 @@
 #include "../include/signal.h"
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "elf_loader.h"
+#include "fd_table.h"
 #include "paging.h"
 
-#define MAX_PROCESS_FILES 16
 #define DEFAULT_TIME_SLICE 10 // 10 timer ticks (~100ms at 100Hz)
 #define DEFAULT_PRIORITY 120  // Linux-like, 0-139 range
 
@@ -19,13 +20,6 @@ typedef enum {
   PROCESS_SLEEPING // Sleeping on timer
 } process_state_t;
 
-typedef struct file_description {
-  vfs_node_t *node;   // The actual VFS node
-  uint64_t offset;    // Current seek position (cursor)
-  uint32_t flags;     // Open flags (O_RDONLY, etc)
-  uint32_t ref_count; // Reference count for fork/dup
-} file_description_t;
-
 typedef struct process {
   uint32_t id;               // Process ID
   uint32_t pgid;             // Process Group ID
@@ -33,13 +27,17 @@ typedef struct process {
   process_state_t state;     // Current state
   uint32_t exit_code;        // Exit code (for ZOMBIE state)
   struct process *parent;    // Parent process
+  struct process *vfork_parent; // vfork: iska PD udhaar hai, exec/exit tak
   uint32_t esp;              // Stack Pointer (Kernel Stack)
   uint32_t kernel_stack_top; // Top of kernel stack for TSS
   uint32_t *page_directory;  // Page Directory (Physical Address)
   uint32_t entry_point;      // User mode entry point
   uint32_t user_stack_top;   // Top of user stack
   uint32_t heap_end;         // Current program break (end of heap)
-  file_description_t *fd_table[MAX_PROCESS_FILES]; // File Descriptor Table
+  elf_mm_t exec_mm;          // Lazy ELF segments (elf_loader.cpp)
+  files_struct_t *files;     // File Descriptor Table (fd_table.cpp)
+  uint32_t nofile_cur;       // RLIMIT_NOFILE soft limit
+  uint32_t nofile_max;       // RLIMIT_NOFILE hard limit
 
   // User/Group IDs
   uint32_t uid;  // Real user ID
@@ -108,6 +106,7 @@ void schedule();
 int get_pid();
 void enter_user_mode();
 int fork_process(registers_t *regs);
+int vfork_process(registers_t *regs);
 void exit_process(int status);
 int wait_process(int *status);
 int sys_waitpid(int pid, int *status, int options);
@@ -128,7 +127,7 @@ uint32_t sys_alarm(uint32_t seconds);
 // Check and deliver alarms (called from timer)
 void check_process_alarms(void);
 
-// posix_spawn (simplified fork+exec)
+// posix_spawn: naya PD seedha, parent ka address space kabhi copy nahi hota
 int sys_posix_spawn(int *pid, const char *path, void *file_actions, void *attrp,
                     char *const argv[], char *const envp[]);
 
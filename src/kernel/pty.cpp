@@ -1,5 +1,6 @@
 #include "pty.h"
 #include "../include/errno.h"
+#include "../include/poll.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
 #include "heap.h"
@@ -31,7 +32,11 @@ static int pty_fifo_read(pty_fifo_t *fifo, char *buf, int len, bool nonblock) {
   if (fifo->count == 0) {
     if (nonblock)
       return -11; // -EAGAIN
-    sleep_on(&fifo->wait);
+    asm volatile("cli");
+    if (fifo->count == 0)
+      sleep_on(&fifo->wait);
+    else
+      asm volatile("sti");
   }
   int read_bytes = 0;
   while (read_bytes < len && fifo->count > 0) {
@@ -39,6 +44,9 @@ static int pty_fifo_read(pty_fifo_t *fifo, char *buf, int len, bool nonblock) {
     fifo->tail = (fifo->tail + 1) % PTY_BUFFER_SIZE;
     fifo->count--;
   }
+  // Jagah bani - writer side ke POLLOUT watchers ko batao
+  if (read_bytes > 0)
+    wake_up_all(&fifo->wait);
   return read_bytes;
 }
 
@@ -91,6 +99,33 @@ static uint32_t pty_slave_write(vfs_node_t *node, uint32_t offset,
   return tty_write(&pty->slave_tty, (const char *)buffer, size);
 }
 
+// ============================================================================
+// POLL
+// ============================================================================
+static int pty_master_poll(vfs_node_t *node, poll_table_t *pt) {
+  pty_t *pty = (pty_t *)node->impl;
+  poll_wait(&pty->slave_to_master.wait, pt);
+
+  int mask = POLLOUT | POLLWRNORM; // Master write seedha slave TTY mein jaata hai
+  if (pty->slave_to_master.count > 0)
+    mask |= POLLIN | POLLRDNORM;
+  else if (!pty->slave_open)
+    mask |= POLLHUP;
+  return mask;
+}
+
+static int pty_slave_poll(vfs_node_t *node, poll_table_t *pt) {
+  pty_t *pty = (pty_t *)node->impl;
+  poll_wait(&pty->slave_to_master.wait, pt);
+
+  int mask = tty_poll(&pty->slave_tty, pt) & ~(POLLOUT | POLLWRNORM);
+  if (pty->slave_to_master.count < PTY_BUFFER_SIZE)
+    mask |= POLLOUT | POLLWRNORM;
+  if (!pty->master_open)
+    mask |= POLLHUP;
+  return mask;
+}
+
 // ============================================================================
 // IOCTL
 // ============================================================================
@@ -121,6 +156,10 @@ static void pty_close(vfs_node_t *node) {
   else
     pty->slave_open = false;
 
+  // Doosri side ke pollers ko hangup dikhna chahiye
+  wake_up_all(&pty->slave_to_master.wait);
+  wake_up_all(&pty->slave_tty.read_wait);
+
   if (!pty->master_open && !pty->slave_open) {
     // Both sides closed, free pty
     pty_table[pty->id] = 0;
@@ -177,6 +216,7 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
   master_node->write = pty_master_write;
   master_node->ioctl = pty_ioctl;
   master_node->close = pty_close;
+  master_node->poll = pty_master_poll;
   master_node->impl = pty;
 
   vfs_node_t *slave_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
@@ -188,46 +228,32 @@ int sys_pty_create(int *master_fd_out, int *slave_fd_out) {
   slave_node->write = pty_slave_write;
   slave_node->ioctl = pty_ioctl;
   slave_node->close = pty_close;
+  slave_node->poll = pty_slave_poll;
   slave_node->impl = pty;
 
   pty->master_node = master_node;
   pty->slave_node = slave_node;
 
-  // Allocate file descriptors
-  int mfd = -1, sfd = -1;
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (!current_process->fd_table[i]) {
-      if (mfd == -1)
-        mfd = i;
-      else if (sfd == -1) {
-        sfd = i;
-        break;
-      }
-    }
-  }
-
-  if (mfd == -1 || sfd == -1) {
-    // Cleanup would go here
-    return -EMFILE;
+  // Allocate file descriptors (wrap in file_description_t)
+  file_description_t *mdesc = fd_desc_alloc(master_node, 3); // O_RDWR
+  file_description_t *sdesc = fd_desc_alloc(slave_node, 3);  // O_RDWR
+  int mfd = mdesc ? fd_alloc(mdesc, 0, 0) : -ENOMEM;
+  int sfd = (mfd >= 0 && sdesc) ? fd_alloc(sdesc, 0, 0) : -ENOMEM;
+
+  if (mfd < 0 || sfd < 0) {
+    if (mfd >= 0)
+      fd_detach(mfd);
+    if (mdesc)
+      kfree(mdesc);
+    if (sdesc)
+      kfree(sdesc);
+    pty_table[pty_idx] = 0;
+    kfree(master_node);
+    kfree(slave_node);
+    kfree(pty);
+    return mfd < 0 ? mfd : sfd;
   }
 
-  // Wrap in file_description_t
-  file_description_t *mdesc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
-  mdesc->node = master_node;
-  mdesc->offset = 0;
-  mdesc->flags = 3; // O_RDWR
-  mdesc->ref_count = 1;
-  current_process->fd_table[mfd] = mdesc;
-
-  file_description_t *sdesc =
-      (file_description_t *)kmalloc(sizeof(file_description_t));
-  sdesc->node = slave_node;
-  sdesc->offset = 0;
-  sdesc->flags = 3; // O_RDWR
-  sdesc->ref_count = 1;
-  current_process->fd_table[sfd] = sdesc;
-
   if (master_fd_out)
     *master_fd_out = mfd;
   if (slave_fd_out)
@@ -8,46 +8,85 @@
 #include "../include/poll.h"
 #include "../include/time.h"
 #include "../include/vfs.h"
+#include "heap.h"
+#include "memory.h"
 #include "process.h"
+#include "wait_queue.h"
 
 extern "C" {
 
-extern uint32_t tick;
-#define TICKS_PER_SEC 100
-
 // ============================================================================
-// Check if fd is ready for I/O
+// Poll wait table - har fd ki wait queue pe ek callback entry
 // ============================================================================
-static int fd_is_readable(int fd) {
-  if (!current_process || fd < 0 || fd >= MAX_PROCESS_FILES)
-    return 0;
-  vfs_node_t *node = current_process->fd_table[fd]->node;
-  if (!node)
-    return 0;
-
-  // For pipes and sockets, check if there's data
-  // For regular files, always readable
-  // Simplified: assume always readable for now
-  return 1;
+// Driver ka poll op poll_wait() bulata hai; hum us queue pe entry laga dete
+// hain jo wake_up hone pe triggered set karke hume jagati hai. Isse idle fd
+// sets pe process WAITING/SLEEPING rehta hai, koi busy schedule() loop nahi.
+typedef struct poll_entry {
+  wait_queue_entry_t wait;
+  wait_queue_t *wq;
+  struct poll_entry *next;
+} poll_entry_t;
+
+typedef struct poll_wqueues {
+  poll_table_t pt; // Pehla member - qproc isse wapas table banata hai
+  process_t *proc;
+  volatile int triggered;
+  poll_entry_t *entries;
+} poll_wqueues_t;
+
+static void pollwake(wait_queue_entry_t *wait) {
+  poll_wqueues_t *table = (poll_wqueues_t *)wait->priv;
+  table->triggered = 1;
+  wake_up_process(table->proc);
+}
+
+static void poll_queue_proc(poll_table_t *pt, wait_queue_t *wq) {
+  poll_wqueues_t *table = (poll_wqueues_t *)pt;
+  poll_entry_t *entry = (poll_entry_t *)kmalloc(sizeof(poll_entry_t));
+  if (!entry)
+    return; // Timeout/dusre fds se phir bhi jaagenge
+  entry->wq = wq;
+  entry->wait.proc = table->proc;
+  entry->wait.next = 0;
+  entry->wait.func = pollwake;
+  entry->wait.priv = table;
+  entry->next = table->entries;
+  table->entries = entry;
+  add_wait_queue(wq, &entry->wait);
+}
+
+static void poll_initwait(poll_wqueues_t *table) {
+  table->pt.qproc = poll_queue_proc;
+  table->proc = current_process;
+  table->triggered = 0;
+  table->entries = 0;
 }
 
-static int fd_is_writable(int fd) {
-  if (!current_process || fd < 0 || fd >= MAX_PROCESS_FILES)
-    return 0;
-  vfs_node_t *node = current_process->fd_table[fd]->node;
-  if (!node)
-    return 0;
-
-  // For pipes and sockets, check if buffer has space
-  // For regular files, always writable
-  // Simplified: assume always writable for now
-  return 1;
+static void poll_freewait(poll_wqueues_t *table) {
+  poll_entry_t *entry = table->entries;
+  while (entry) {
+    poll_entry_t *next = entry->next;
+    remove_wait_queue(entry->wq, &entry->wait);
+    kfree(entry);
+    entry = next;
+  }
+  table->entries = 0;
+}
+
+// ============================================================================
+// Check if fd is ready for I/O
+// ============================================================================
+static vfs_node_t *fd_node(int fd) {
+  file_description_t *desc = fd_get(fd);
+  return desc ? desc->node : 0;
 }
 
-static int fd_has_exception(int fd) {
-  (void)fd;
-  // No exceptional conditions tracked
-  return 0;
+// Pipes/sockets/TTY apna readiness poll op se batate hain
+static int fd_poll_mask(vfs_node_t *node, poll_table_t *pt) {
+  if (node->poll)
+    return node->poll(node, pt);
+  // Regular files are always readable/writable
+  return POLLIN | POLLRDNORM | POLLOUT | POLLWRNORM;
 }
 
 // ============================================================================
@@ -57,63 +96,42 @@ int poll(struct pollfd *fds, unsigned int nfds, int timeout) {
   if (!fds && nfds > 0)
     return -EFAULT;
 
-  uint32_t start_tick = tick;
-  uint32_t wait_ticks = (timeout > 0) ? (timeout * TICKS_PER_SEC / 1000) : 0;
-  int ready_count = 0;
+  poll_wqueues_t table;
+  poll_initwait(&table);
+  poll_table_t *pt = &table.pt; // Sirf pehle pass mein register karo
 
-  // Initialize revents
-  for (unsigned int i = 0; i < nfds; i++)
-    fds[i].revents = 0;
+  uint32_t deadline = (timeout > 0) ? timeout_to_deadline(timeout) : 0;
+  int timed_out = (timeout == 0);
+  int ready_count;
 
-  do {
+  for (;;) {
     ready_count = 0;
+    table.triggered = 0;
 
     for (unsigned int i = 0; i < nfds; i++) {
-      int fd = fds[i].fd;
-
-      // Check for invalid fd
-      if (fd < 0 || !current_process || fd >= MAX_PROCESS_FILES ||
-          !current_process->fd_table[fd]) {
-        fds[i].revents |= POLLNVAL;
-        ready_count++;
-        continue;
+      vfs_node_t *node = fd_node(fds[i].fd);
+      if (!node) {
+        // Negative fd ko POSIX ignore karta hai
+        fds[i].revents = (fds[i].fd < 0) ? 0 : POLLNVAL;
+      } else {
+        int mask = fd_poll_mask(node, pt);
+        fds[i].revents =
+            (short)(mask & (fds[i].events | POLLERR | POLLHUP | POLLNVAL));
       }
-
-      // Check for readable
-      if (fds[i].events & (POLLIN | POLLRDNORM)) {
-        if (fd_is_readable(fd)) {
-          fds[i].revents |= POLLIN | POLLRDNORM;
-          ready_count++;
-        }
-      }
-
-      // Check for writable
-      if (fds[i].events & (POLLOUT | POLLWRNORM)) {
-        if (fd_is_writable(fd)) {
-          fds[i].revents |= POLLOUT | POLLWRNORM;
-          ready_count++;
-        }
-      }
-
-      // Check for error/hangup
-      if (fd_has_exception(fd)) {
-        fds[i].revents |= POLLERR;
+      if (fds[i].revents)
         ready_count++;
-      }
     }
+    pt = 0;
 
-    if (ready_count > 0 || timeout == 0)
+    if (ready_count > 0 || timed_out)
       break;
 
-    // Wait if no events and timeout not reached
-    if (timeout < 0 || (tick - start_tick) < wait_ticks) {
-      schedule();
-    } else {
-      break;
-    }
-
-  } while (1);
+    // Callback (ya deadline pe timer) jagayega
+    if (!schedule_timeout(deadline, &table.triggered))
+      timed_out = 1;
+  }
 
+  poll_freewait(&table);
   return ready_count;
 }
 
@@ -145,11 +163,6 @@ int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
     timeout_ms = tv->tv_sec * 1000 + tv->tv_usec / 1000;
   }
 
-  uint32_t start_tick = tick;
-  uint32_t wait_ticks =
-      (timeout_ms > 0) ? (timeout_ms * TICKS_PER_SEC / 1000) : 0;
-  int ready_count = 0;
-
   // Save original sets for checking
   fd_set read_copy, write_copy, except_copy;
   if (readfds)
@@ -165,8 +178,25 @@ int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
   else
     FD_ZERO(&except_copy);
 
-  do {
+  // Bad fd set mein ho toh seedha EBADF
+  for (int fd = 0; fd < nfds; fd++) {
+    if ((FD_ISSET(fd, &read_copy) || FD_ISSET(fd, &write_copy) ||
+         FD_ISSET(fd, &except_copy)) &&
+        !fd_node(fd))
+      return -EBADF;
+  }
+
+  poll_wqueues_t table;
+  poll_initwait(&table);
+  poll_table_t *pt = &table.pt;
+
+  uint32_t deadline = (timeout_ms > 0) ? timeout_to_deadline(timeout_ms) : 0;
+  int timed_out = (timeout_ms == 0);
+  int ready_count;
+
+  for (;;) {
     ready_count = 0;
+    table.triggered = 0;
 
     // Clear result sets
     if (readfds)
@@ -177,46 +207,42 @@ int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
       FD_ZERO(exceptfds);
 
     for (int fd = 0; fd < nfds; fd++) {
+      int want_r = FD_ISSET(fd, &read_copy);
+      int want_w = FD_ISSET(fd, &write_copy);
+      int want_e = FD_ISSET(fd, &except_copy);
+      if (!want_r && !want_w && !want_e)
+        continue;
+
+      int mask = fd_poll_mask(fd_node(fd), pt);
+
       // Check readability
-      if (FD_ISSET(fd, &read_copy)) {
-        if (fd_is_readable(fd)) {
-          if (readfds)
-            FD_SET(fd, readfds);
-          ready_count++;
-        }
+      if (want_r && (mask & (POLLIN | POLLHUP | POLLERR))) {
+        FD_SET(fd, readfds);
+        ready_count++;
       }
 
       // Check writability
-      if (FD_ISSET(fd, &write_copy)) {
-        if (fd_is_writable(fd)) {
-          if (writefds)
-            FD_SET(fd, writefds);
-          ready_count++;
-        }
+      if (want_w && (mask & (POLLOUT | POLLERR))) {
+        FD_SET(fd, writefds);
+        ready_count++;
       }
 
       // Check exceptions
-      if (FD_ISSET(fd, &except_copy)) {
-        if (fd_has_exception(fd)) {
-          if (exceptfds)
-            FD_SET(fd, exceptfds);
-          ready_count++;
-        }
+      if (want_e && (mask & (POLLERR | POLLPRI))) {
+        FD_SET(fd, exceptfds);
+        ready_count++;
       }
     }
+    pt = 0;
 
-    if (ready_count > 0 || timeout_ms == 0)
+    if (ready_count > 0 || timed_out)
       break;
 
-    // Wait if no events and timeout not reached
-    if (timeout_ms < 0 || (tick - start_tick) < wait_ticks) {
-      schedule();
-    } else {
-      break;
-    }
-
-  } while (1);
+    if (!schedule_timeout(deadline, &table.triggered))
+      timed_out = 1;
+  }
 
+  poll_freewait(&table);
   return ready_count;
 }
 
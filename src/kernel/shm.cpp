@@ -23,8 +23,9 @@ void shm_init() {
 int sys_shmget(uint32_t key, uint32_t size, int flags) {
   (void)flags;
 
-  // Dekho agar is key ka segment pehle se bana hai kya
-  for (int i = 0; i < SHM_MAX_SEGMENTS; i++) {
+  // Dekho agar is key ka segment pehle se bana hai kya. IPC_PRIVATE hamesha
+  // naya - warna har window ko pehle wale client ka hi buffer mil jaata tha.
+  for (int i = 0; key != IPC_PRIVATE && i < SHM_MAX_SEGMENTS; i++) {
     if (shm_segments[i].in_use && shm_segments[i].key == key) {
       return i;
     }
@@ -45,6 +46,8 @@ int sys_shmget(uint32_t key, uint32_t size, int flags) {
   // Window resize wagera ke liye kam se kam 4MB toh chahiye hi
   uint32_t min_size = 4 * 1024 * 1024; // 4MB
   uint32_t final_size = (size > min_size) ? size : min_size;
+  if (final_size > SHM_SEGMENT_SPAN)
+    return -1; // Agle segment ki jagah mein chala jaata
 
   uint32_t pages = (final_size + SHM_PAGE_SIZE - 1) / SHM_PAGE_SIZE;
 
@@ -95,7 +98,7 @@ void *sys_shmat(int shmid) {
   // FIXED MAPPING: Har segment ke liye 0x70000000 range mein 8MB ki jagah fix
   // hai. Isse pointers sabhi processes ke beech interchange ho sakte hain bina
   // tension ke.
-  uint32_t virt = 0x70000000 + (shmid * 0x800000);
+  uint32_t virt = 0x70000000 + (shmid * SHM_SEGMENT_SPAN);
   seg->virt_start = virt; // Documentation aur lookup ke liye set kar liya
 
   // Physical pages ko virtual address pe map karo
@@ -123,12 +126,12 @@ shm_segment_t *shm_get_segment(uint32_t virt_addr) {
   if (virt_addr < 0x70000000 || virt_addr >= 0x80000000)
     return nullptr;
 
-  int shmid = (virt_addr - 0x70000000) / 0x800000;
+  int shmid = (virt_addr - 0x70000000) / SHM_SEGMENT_SPAN;
   if (shmid >= 0 && shmid < SHM_MAX_SEGMENTS) {
     if (shm_segments[shmid].in_use) {
       // Optional: Verify address is within this segment's allocated size
       if (virt_addr <
-          0x70000000 + (shmid * 0x800000) + shm_segments[shmid].size) {
+          0x70000000 + (shmid * SHM_SEGMENT_SPAN) + shm_segments[shmid].size) {
         return &shm_segments[shmid];
       }
     }
@@ -6,6 +6,7 @@
 
 #define SHM_MAX_SEGMENTS 32
 #define SHM_PAGE_SIZE 4096
+#define SHM_SEGMENT_SPAN 0x800000 // Har segment ki fixed virtual jagah (8MB)
 #define IPC_PRIVATE 0
 
 typedef struct shm_segment {
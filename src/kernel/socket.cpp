@@ -1,5 +1,7 @@
 #include "socket.h"
 #include "../drivers/serial.h"
+#include "../include/errno.h"
+#include "../include/poll.h"
 #include "../include/string.h"
 #include "heap.h"
 #include "memory.h"
@@ -13,7 +15,7 @@ void socket_init() {
     sockets[i] = 0;
 }
 
-static socket_t *alloc_socket() {
+socket_t *socket_alloc(int domain) {
   for (int i = 0; i < MAX_SOCKETS; i++) {
     if (!sockets[i]) {
       sockets[i] = (socket_t *)kmalloc(sizeof(socket_t));
@@ -23,6 +25,13 @@ static socket_t *alloc_socket() {
       }
       memset(sockets[i], 0, sizeof(socket_t));
       sockets[i]->id = i;
+      sockets[i]->domain = domain;
+      wait_queue_init(&sockets[i]->rx_wait);
+      wait_queue_init(&sockets[i]->tx_wait);
+      if (domain != AF_UNIX)
+        return sockets[i]; // AF_INET ka data TCB / datagram queue mein rehta hai
+      sockets[i]->rcvbuf = 4096;
+      sockets[i]->sndbuf = 4096;
       sockets[i]->buffer = (uint8_t *)kmalloc(4096);
       if (!sockets[i]->buffer) {
         serial_log("SOCKET ERROR: OOM for buffer in alloc_socket");
@@ -37,10 +46,37 @@ static socket_t *alloc_socket() {
   return 0;
 }
 
+static socket_t *alloc_socket() { return socket_alloc(AF_UNIX); }
+
+// fd se socket nikalo; galat fd ho to negative errno
+static int socket_lookup(int sockfd, socket_t **out) {
+  if (!fd_get(sockfd))
+    return -EBADF;
+  vfs_node_t *node = fd_get(sockfd)->node;
+  if (!node || node->flags != VFS_SOCKET || !node->impl)
+    return -ENOTSOCK;
+  *out = (socket_t *)node->impl;
+  return 0;
+}
+
+static void wake_waiting_processes() {
+  process_t *p = ready_queue;
+  if (p) {
+    process_t *start = p;
+    do {
+      if (p->state == PROCESS_WAITING)
+        p->state = PROCESS_READY;
+      p = p->next;
+    } while (p && p != start);
+  }
+}
+
 uint32_t socket_read(vfs_node_t *node, uint32_t offset, uint32_t size,
                      uint8_t *buffer) {
   (void)offset;
   socket_t *sock = (socket_t *)node->impl;
+  if (sock && sock->domain == AF_INET)
+    return (uint32_t)inet_recv(sock, buffer, size, 0, 0);
   if (!sock || sock->state != SOCKET_CONNECTED)
     return 0;
 
@@ -49,6 +85,8 @@ uint32_t socket_read(vfs_node_t *node, uint32_t offset, uint32_t size,
     if (sock->head == sock->tail) {
       if (read_bytes > 0)
         break;
+      if (sock->nonblock)
+        return (uint32_t)-EAGAIN;
       // Block
       current_process->state = PROCESS_WAITING;
       schedule();
@@ -59,15 +97,10 @@ uint32_t socket_read(vfs_node_t *node, uint32_t offset, uint32_t size,
   }
 
   // Baaki processes ko jagao agar wo wait kar rahe hain
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  wake_waiting_processes();
+  // Peer ke liye jagah bani - uske POLLOUT watchers ko batao
+  if (sock->peer)
+    wake_up_all(&sock->peer->tx_wait);
 
   return read_bytes;
 }
@@ -76,6 +109,8 @@ uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
                       uint8_t *buffer) {
   (void)offset;
   socket_t *sock = (socket_t *)node->impl;
+  if (sock && sock->domain == AF_INET)
+    return (uint32_t)inet_send(sock, buffer, size, 0, 0);
   if (!sock || sock->state != SOCKET_CONNECTED || !sock->peer)
     return 0;
 
@@ -86,6 +121,8 @@ uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
     if (next_tail == peer->head) {
       if (written > 0)
         break;
+      if (sock->nonblock)
+        return (uint32_t)-EAGAIN;
       // Block
       current_process->state = PROCESS_WAITING;
       schedule();
@@ -96,15 +133,8 @@ uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
   }
 
   // Peer side pe jo wait kar rahe hain unhe jagao
-  process_t *p = ready_queue;
-  if (p) {
-    process_t *start = p;
-    do {
-      if (p->state == PROCESS_WAITING)
-        p->state = PROCESS_READY;
-      p = p->next;
-    } while (p && p != start);
-  }
+  wake_waiting_processes();
+  wake_up_all(&peer->rx_wait);
 
   return written;
 }
@@ -114,8 +144,19 @@ void socket_close(vfs_node_t *node) {
   if (!sock)
     return;
 
+  if (sock->domain == AF_INET)
+    inet_release(sock);
   sock->state = SOCKET_CLOSED;
 
+  // Peer ko dangling pointer na rahe; uske pollers ko POLLHUP dikhega
+  if (sock->domain == AF_UNIX && sock->peer) {
+    socket_t *peer = sock->peer;
+    peer->peer = 0;
+    wake_up_all(&peer->rx_wait);
+    wake_up_all(&peer->tx_wait);
+    wake_waiting_processes();
+  }
+
   // Global array se hatao isse
   for (int i = 0; i < MAX_SOCKETS; i++) {
     if (sockets[i] == sock) {
@@ -131,61 +172,150 @@ void socket_close(vfs_node_t *node) {
   kfree(sock);
 }
 
-int sys_socket(int domain, int type, int protocol) {
-  if (domain != AF_UNIX || type != SOCK_STREAM)
-    return -1;
+// FIONBIO / FIONREAD (fcntl O_NONBLOCK bhi yahin aata hai)
+static int socket_ioctl(vfs_node_t *node, int request, void *argp) {
+  socket_t *sock = (socket_t *)node->impl;
+  switch (request) {
+  case FIONBIO:
+    sock->nonblock = (argp && *(int *)argp) ? 1 : 0;
+    return 0;
+  case FIONREAD:
+    if (!argp)
+      return -EFAULT;
+    if (sock->domain == AF_INET)
+      *(int *)argp = (int)inet_pending_bytes(sock);
+    else
+      *(int *)argp = (int)((sock->tail + 4096 - sock->head) % 4096);
+    return 0;
+  default:
+    return -ENOTTY;
+  }
+}
 
-  socket_t *sock = alloc_socket();
-  if (!sock) {
-    serial_log("SOCKET ERROR: alloc_socket fail ho gaya");
-    return -1;
+int socket_poll(vfs_node_t *node, poll_table_t *pt) {
+  socket_t *sock = (socket_t *)node->impl;
+  if (!sock)
+    return POLLNVAL;
+  poll_wait(&sock->rx_wait, pt);
+  poll_wait(&sock->tx_wait, pt);
+  if (sock->domain == AF_INET)
+    return inet_poll(sock);
+
+  int mask = 0;
+  if (sock->state == SOCKET_LISTENING) {
+    if (sock->backlog_count > 0)
+      mask |= POLLIN | POLLRDNORM;
+    return mask;
   }
+  if (sock->state != SOCKET_CONNECTED)
+    return mask;
+  if (sock->head != sock->tail)
+    mask |= POLLIN | POLLRDNORM;
+  if (!sock->peer)
+    return mask | POLLHUP;
+  if ((sock->peer->tail + 1) % 4096 != sock->peer->head)
+    mask |= POLLOUT | POLLWRNORM;
+  return mask;
+}
 
-  sock->domain = domain;
-  sock->type = type;
-  sock->state = SOCKET_FREE;
+// Jo socket kabhi fd tak nahi pahuncha use seedha free karo
+void socket_discard(socket_t *sock) {
+  if (sock->domain == AF_INET)
+    inet_release(sock);
+  sockets[sock->id] = 0;
+  if (sock->buffer)
+    kfree(sock->buffer);
+  kfree(sock);
+}
 
+static vfs_node_t *socket_make_node(socket_t *sock, const char *name) {
   vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
-  if (!node) {
-    serial_log("SOCKET ERROR: OOM for vfs_node");
-    // TODO: sock ko free karna hai
-    return -1;
-  }
+  if (!node)
+    return 0;
   memset(node, 0, sizeof(vfs_node_t));
-  strcpy(node->name, "socket");
+  strcpy(node->name, name);
   node->impl = (void *)sock;
   node->read = socket_read;
   node->write = socket_write;
   node->close = socket_close;
+  node->ioctl = socket_ioctl;
+  node->poll = socket_poll;
   node->flags = VFS_SOCKET;
   node->ref_count = 1;
+  return node;
+}
+
+static int socket_install_fd(vfs_node_t *node) {
+  file_description_t *desc = fd_desc_alloc(node, O_RDWR);
+  if (!desc)
+    return -ENOMEM;
+  int fd = fd_alloc(desc, 0, 0);
+  if (fd < 0)
+    kfree(desc);
+  return fd;
+}
+
+int sys_socket(int domain, int type, int protocol) {
+  int nonblock = (type & SOCK_NONBLOCK) ? 1 : 0;
+  type &= ~SOCK_NONBLOCK;
+
+  if (domain == AF_UNIX) {
+    if (type != SOCK_STREAM)
+      return -1;
+  } else if (domain != AF_INET) {
+    return -EAFNOSUPPORT;
+  }
+
+  socket_t *sock = socket_alloc(domain);
+  if (!sock) {
+    serial_log("SOCKET ERROR: alloc_socket fail ho gaya");
+    return -1;
+  }
 
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (!current_process->fd_table[i]) {
-      file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
-      desc->node = node;
-      desc->offset = 0;
-      desc->flags = O_RDWR;
-      desc->ref_count = 1;
-      current_process->fd_table[i] = desc;
-      return i;
+  sock->domain = domain;
+  sock->type = type;
+  sock->state = SOCKET_FREE;
+  sock->nonblock = nonblock;
+
+  if (domain == AF_INET) {
+    int err = inet_socket_init(sock, type, protocol);
+    if (err < 0) {
+      socket_discard(sock);
+      return err;
     }
   }
 
-  serial_log("SOCKET ERROR: FD table full hai bhai");
-  return -1;
+  vfs_node_t *node = socket_make_node(sock, "socket");
+  if (!node) {
+    serial_log("SOCKET ERROR: OOM for vfs_node");
+    socket_discard(sock);
+    return -ENOMEM;
+  }
+
+  int fd = socket_install_fd(node);
+  if (fd < 0) {
+    serial_log("SOCKET ERROR: FD table full hai bhai");
+    kfree(node);
+    socket_discard(sock);
+  }
+  return fd;
 }
 
-int sys_bind(int sockfd, const char *path) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
+int sys_bind(int sockfd, const void *addr, uint32_t addrlen) {
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (!addr)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    if (addrlen < sizeof(struct sockaddr_in))
+      return -EINVAL;
+    return inet_bind(sock, (const struct sockaddr_in *)addr);
+  }
 
-  socket_t *sock = (socket_t *)node->impl;
+  const char *path = (const char *)addr;
   strncpy(sock->bind_path, path, 127);
   sock->bind_path[127] = 0;
   sock->state = SOCKET_BOUND;
@@ -197,44 +327,35 @@ int sys_bind(int sockfd, const char *path) {
   return 0;
 }
 
-int sys_connect(int sockfd, const char *path) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd]) {
+int sys_connect(int sockfd, const void *addr, uint32_t addrlen) {
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0) {
     serial_log("SOCKET ERROR: Invalid sockfd");
-    return -1;
-  }
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node) {
-    serial_log("SOCKET ERROR: Node is null");
-    return -1;
+    return err;
   }
-  if (node->flags != VFS_SOCKET) {
-    serial_log_hex("SOCKET ERROR: Node flags mismatch. Expected SOCKET, got: ",
-                   node->flags);
-    return -1;
-  }
-  serial_log_hex("SOCKET: Global sockets array at ", (uint32_t)sockets);
-  for (int i = 0; i < MAX_SOCKETS; i++) {
-    if (sockets[i]) {
-      serial_log_hex("SOCKET: i=", i);
-      serial_log_hex("  State: ", sockets[i]->state);
-      serial_log("  Path: ");
-      serial_log(sockets[i]->bind_path);
-    }
+  if (!addr)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    if (addrlen < sizeof(struct sockaddr_in))
+      return -EINVAL;
+    return inet_connect(sock, (const struct sockaddr_in *)addr);
   }
 
+  const char *path = (const char *)addr;
   char kpath[128];
   strncpy(kpath, path, 127);
   kpath[127] = 0;
 
-  socket_t *sock = (socket_t *)node->impl;
   serial_log("SOCKET: sys_connect looking for path:");
   serial_log(kpath);
 
   // Bound socket dhundo
   socket_t *server = 0;
   for (int i = 0; i < MAX_SOCKETS; i++) {
-    if (sockets[i] && (sockets[i]->state == SOCKET_BOUND ||
+    if (sockets[i] && sockets[i]->domain == AF_UNIX &&
+        (sockets[i]->state == SOCKET_BOUND ||
                        sockets[i]->state == SOCKET_LISTENING)) {
       serial_log("SOCKET: Bound socket check kar rahe hain:");
       serial_log(sockets[i]->bind_path);
@@ -254,15 +375,8 @@ int sys_connect(int sockfd, const char *path) {
     sock->state = SOCKET_CONNECTING;
 
     // Server ko jagao! (Accept mein betha hoga bechara)
-    process_t *p = ready_queue;
-    if (p) {
-      process_t *start = p;
-      do {
-        if (p->state == PROCESS_WAITING)
-          p->state = PROCESS_READY;
-        p = p->next;
-      } while (p && p != start);
-    }
+    wake_waiting_processes();
+    wake_up_all(&server->rx_wait);
 
     // Sula do jab tak connect nahi hota
     while (sock->state == SOCKET_CONNECTING) {
@@ -275,16 +389,34 @@ int sys_connect(int sockfd, const char *path) {
   return -1;
 }
 
-int sys_accept(int sockfd) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *server = (socket_t *)(uintptr_t)node->impl;
+int sys_accept(int sockfd, void *addr, uint32_t *addrlen) {
+  socket_t *server;
+  int err = socket_lookup(sockfd, &server);
+  if (err < 0)
+    return err;
+
+  if (server->domain == AF_INET) {
+    socket_t *conn = inet_accept(server, &err);
+    if (!conn)
+      return err;
+    vfs_node_t *conn_node = socket_make_node(conn, "socket_conn");
+    int fd = conn_node ? socket_install_fd(conn_node) : -ENOMEM;
+    if (fd < 0) {
+      if (conn_node)
+        kfree(conn_node);
+      socket_discard(conn);
+      return fd;
+    }
+    if (addr && addrlen && *addrlen >= sizeof(struct sockaddr_in)) {
+      inet_getname(conn, 1, (struct sockaddr_in *)addr);
+      *addrlen = sizeof(struct sockaddr_in);
+    }
+    return fd;
+  }
 
   while (server->backlog_count == 0) {
+    if (server->nonblock)
+      return -EAGAIN;
     current_process->state = PROCESS_WAITING;
     schedule();
   }
@@ -296,90 +428,68 @@ int sys_accept(int sockfd) {
 
   // Connection ke liye naya socket banao
   socket_t *conn = alloc_socket();
+  if (!conn)
+    return -ENOMEM;
+  conn->domain = AF_UNIX;
+  conn->type = SOCK_STREAM;
   conn->state = SOCKET_CONNECTED;
   conn->peer = client;
   client->peer = conn;
   client->state = SOCKET_CONNECTED;
 
-  vfs_node_t *conn_node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
-  memset(conn_node, 0, sizeof(vfs_node_t));
-  strcpy(conn_node->name, "socket_conn");
-  conn_node->impl = (void *)conn;
-  conn_node->read = socket_read;
-  conn_node->write = socket_write;
-  conn_node->close = socket_close;
-  conn_node->flags = VFS_SOCKET;
-  conn_node->ref_count = 1;
-
-  for (int i = 0; i < MAX_PROCESS_FILES; i++) {
-    if (!current_process->fd_table[i]) {
-      file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
-      desc->node = conn_node;
-      desc->offset = 0;
-      desc->flags = O_RDWR;
-      desc->ref_count = 1;
-      current_process->fd_table[i] = desc;
-
-      // Client ko jagao!
-      process_t *p = ready_queue;
-      if (p) {
-        process_t *start = p;
-        do {
-          if (p->state == PROCESS_WAITING)
-            p->state = PROCESS_READY;
-          p = p->next;
-        } while (p && p != start);
-      }
+  vfs_node_t *conn_node = socket_make_node(conn, "socket_conn");
+  if (!conn_node)
+    return -ENOMEM;
 
-      return i;
-    }
+  int fd = socket_install_fd(conn_node);
+  if (fd >= 0) {
+    // Client ko jagao!
+    wake_waiting_processes();
+    wake_up_all(&client->rx_wait);
+    wake_up_all(&client->tx_wait);
   }
-
-  return -1;
+  return fd;
 }
 
 // Check if accept will block
 int socket_can_accept(int sockfd) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
+  socket_t *server;
+  if (socket_lookup(sockfd, &server) < 0)
     return 0;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return 0;
-  socket_t *server = (socket_t *)(uintptr_t)node->impl;
+  if (server->domain == AF_INET)
+    return server->state == SOCKET_LISTENING && (inet_poll(server) & POLLIN);
   return server->backlog_count > 0;
 }
 
 // Check if socket has data
 int socket_can_read(int sockfd) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return 0;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
+  socket_t *sock;
+  if (socket_lookup(sockfd, &sock) < 0)
     return 0;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
+  if (sock->domain == AF_INET)
+    return (inet_poll(sock) & POLLIN) != 0;
   return sock->head != sock->tail; // Buffer not empty
 }
 
 // Listen for connections
 int sys_listen(int sockfd, int backlog) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+
+  int max_backlog = (backlog > 0) ? backlog : 5;
+  if (max_backlog > MAX_BACKLOG)
+    max_backlog = MAX_BACKLOG;
+
+  if (sock->domain == AF_INET)
+    return inet_listen(sock, max_backlog);
 
   if (sock->state != SOCKET_BOUND)
     return -1; // Must be bound first
 
   sock->state = SOCKET_LISTENING;
-  sock->max_backlog = (backlog > 0) ? backlog : 5;
-  if (sock->max_backlog > MAX_BACKLOG)
-    sock->max_backlog = MAX_BACKLOG;
+  sock->max_backlog = max_backlog;
 
   serial_log("SOCKET: Now listening");
   return 0;
@@ -387,37 +497,53 @@ int sys_listen(int sockfd, int backlog) {
 
 // Send data (same as write but with flags)
 ssize_t sys_send(int sockfd, const void *buf, size_t len, int flags) {
-  (void)flags; // Flags not fully implemented
-
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd] || !buf)
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-
-  return socket_write(node, 0, len, (uint8_t *)buf);
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (!buf)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET)
+    return inet_send(sock, buf, len, flags, 0);
+
+  vfs_node_t *node = fd_get(sockfd)->node;
+  return (int)socket_write(node, 0, len, (uint8_t *)buf);
 }
 
 // Receive data (same as read but with flags)
 ssize_t sys_recv(int sockfd, void *buf, size_t len, int flags) {
-  (void)flags; // Flags not fully implemented
-
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd] || !buf)
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-
-  return socket_read(node, 0, len, (uint8_t *)buf);
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (!buf)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET)
+    return inet_recv(sock, buf, len, flags, 0);
+
+  vfs_node_t *node = fd_get(sockfd)->node;
+  return (int)socket_read(node, 0, len, (uint8_t *)buf);
 }
 
 // Send datagram (for UDP-style sockets)
 ssize_t sys_sendto(int sockfd, const void *buf, size_t len, int flags,
                    const void *dest_addr, uint32_t addrlen) {
-  (void)dest_addr;
-  (void)addrlen;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (!buf)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    if (dest_addr && addrlen < sizeof(struct sockaddr_in))
+      return -EINVAL;
+    return inet_send(sock, buf, len, flags,
+                     (const struct sockaddr_in *)dest_addr);
+  }
+
   // For UNIX domain sockets, sendto works like send
   return sys_send(sockfd, buf, len, flags);
 }
@@ -425,30 +551,54 @@ ssize_t sys_sendto(int sockfd, const void *buf, size_t len, int flags,
 // Receive datagram
 ssize_t sys_recvfrom(int sockfd, void *buf, size_t len, int flags,
                      void *src_addr, uint32_t *addrlen) {
-  (void)src_addr;
-  (void)addrlen;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (!buf)
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    struct sockaddr_in from;
+    int n = inet_recv(sock, buf, len, flags, &from);
+    if (n >= 0 && src_addr && addrlen &&
+        *addrlen >= sizeof(struct sockaddr_in)) {
+      memcpy(src_addr, &from, sizeof(from));
+      *addrlen = sizeof(struct sockaddr_in);
+    }
+    return n;
+  }
+
   // For UNIX domain sockets, recvfrom works like recv
   return sys_recv(sockfd, buf, len, flags);
 }
 
+// UNIX socket address (sirf getsockname/getpeername ke liye)
+struct sockaddr_un {
+  uint16_t sun_family;
+  char sun_path[108];
+};
+
 // Get local socket name
 int sys_getsockname(int sockfd, void *addr, uint32_t *addrlen) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
 
   if (!addr || !addrlen)
-    return -1;
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    if (*addrlen < sizeof(struct sockaddr_in))
+      return -EINVAL;
+    inet_getname(sock, 0, (struct sockaddr_in *)addr);
+    *addrlen = sizeof(struct sockaddr_in);
+    return 0;
+  }
 
   // Return socket address (simplified - just path for UNIX sockets)
-  struct sockaddr_un {
-    uint16_t sun_family;
-    char sun_path[108];
-  } *un_addr = (struct sockaddr_un *)addr;
+  struct sockaddr_un *un_addr = (struct sockaddr_un *)addr;
 
   un_addr->sun_family = AF_UNIX;
   strncpy(un_addr->sun_path, sock->path, 107);
@@ -460,25 +610,29 @@ int sys_getsockname(int sockfd, void *addr, uint32_t *addrlen) {
 
 // Get peer socket name
 int sys_getpeername(int sockfd, void *addr, uint32_t *addrlen) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
-
-  if (!sock->peer || sock->state != SOCKET_CONNECTED)
-    return -1; // Not connected
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
 
   if (!addr || !addrlen)
-    return -1;
+    return -EFAULT;
+
+  if (sock->domain == AF_INET) {
+    if (sock->state != SOCKET_CONNECTED)
+      return -ENOTCONN;
+    if (*addrlen < sizeof(struct sockaddr_in))
+      return -EINVAL;
+    inet_getname(sock, 1, (struct sockaddr_in *)addr);
+    *addrlen = sizeof(struct sockaddr_in);
+    return 0;
+  }
+
+  if (!sock->peer || sock->state != SOCKET_CONNECTED)
+    return -ENOTCONN; // Not connected
 
   // Return peer address
-  struct sockaddr_un {
-    uint16_t sun_family;
-    char sun_path[108];
-  } *un_addr = (struct sockaddr_un *)addr;
+  struct sockaddr_un *un_addr = (struct sockaddr_un *)addr;
 
   un_addr->sun_family = AF_UNIX;
   strncpy(un_addr->sun_path, sock->peer->path, 107);
@@ -488,94 +642,82 @@ int sys_getpeername(int sockfd, void *addr, uint32_t *addrlen) {
   return 0;
 }
 
-// Socket option flags
-#define SO_DEBUG 1
-#define SO_REUSEADDR 2
-#define SO_KEEPALIVE 9
-#define SO_BROADCAST 6
-#define SO_LINGER 13
-#define SO_RCVBUF 8
-#define SO_SNDBUF 7
-#define SO_RCVTIMEO 20
-#define SO_SNDTIMEO 21
-#define SO_ERROR 4
-#define SO_TYPE 3
-
-#define SOL_SOCKET 1
-
 // Set socket options
 int sys_setsockopt(int sockfd, int level, int optname, const void *optval,
                    uint32_t optlen) {
-  (void)level;
-  (void)optval;
-  (void)optlen;
-
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+
+  int value = 0;
+  if (optval && optlen >= sizeof(int))
+    value = *(const int *)optval;
+
+  if (sock->domain == AF_INET) {
+    if (!optval || optlen < sizeof(int))
+      return -EINVAL;
+    return inet_setsockopt(sock, level, optname, value);
+  }
 
-  // Socket options are not fully implemented
-  // Just return success for common options
+  // UNIX sockets ka ring buffer fixed hai, options bas yaad rakhte hain
   switch (optname) {
+  case SO_RCVBUF:
+  case SO_SNDBUF:
   case SO_REUSEADDR:
   case SO_KEEPALIVE:
   case SO_BROADCAST:
   case SO_LINGER:
-  case SO_RCVBUF:
-  case SO_SNDBUF:
   case SO_RCVTIMEO:
   case SO_SNDTIMEO:
     return 0;
   default:
-    return -1;
+    return -ENOPROTOOPT;
   }
 }
 
 // Get socket options
 int sys_getsockopt(int sockfd, int level, int optname, void *optval,
                    uint32_t *optlen) {
-  (void)level;
-
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
 
   if (!optval || !optlen)
-    return -1;
-
-  switch (optname) {
-  case SO_ERROR: {
-    if (*optlen >= sizeof(int)) {
-      *(int *)optval = 0; // No pending error
-      *optlen = sizeof(int);
-    }
-    return 0;
-  }
-  case SO_TYPE: {
-    if (*optlen >= sizeof(int)) {
-      *(int *)optval = sock->type;
-      *optlen = sizeof(int);
-    }
-    return 0;
-  }
-  case SO_RCVBUF:
-  case SO_SNDBUF: {
-    if (*optlen >= sizeof(int)) {
-      *(int *)optval = 4096; // Our buffer size
-      *optlen = sizeof(int);
+    return -EFAULT;
+  if (*optlen < sizeof(int))
+    return -EINVAL;
+
+  int value;
+  if (level == IPPROTO_TCP) {
+    if (sock->domain != AF_INET || sock->type != SOCK_STREAM ||
+        optname != TCP_NODELAY)
+      return -ENOPROTOOPT;
+    value = sock->nodelay;
+  } else {
+    switch (optname) {
+    case SO_ERROR:
+      value = sock->error; // Padhne ke baad clear
+      sock->error = 0;
+      break;
+    case SO_TYPE:
+      value = sock->type;
+      break;
+    case SO_RCVBUF:
+      value = (int)sock->rcvbuf;
+      break;
+    case SO_SNDBUF:
+      value = (int)sock->sndbuf;
+      break;
+    default:
+      return -ENOPROTOOPT;
     }
-    return 0;
-  }
-  default:
-    return -1;
   }
+
+  *(int *)optval = value;
+  *optlen = sizeof(int);
+  return 0;
 }
 
 // Shutdown socket
@@ -584,13 +726,15 @@ int sys_getsockopt(int sockfd, int level, int optname, void *optval,
 #define SHUT_RDWR 2
 
 int sys_shutdown(int sockfd, int how) {
-  if (sockfd < 0 || sockfd >= MAX_PROCESS_FILES ||
-      !current_process->fd_table[sockfd])
-    return -1;
-  vfs_node_t *node = current_process->fd_table[sockfd]->node;
-  if (!node || node->flags != VFS_SOCKET)
-    return -1;
-  socket_t *sock = (socket_t *)(uintptr_t)node->impl;
+  socket_t *sock;
+  int err = socket_lookup(sockfd, &sock);
+  if (err < 0)
+    return err;
+  if (how < SHUT_RD || how > SHUT_RDWR)
+    return -EINVAL;
+
+  if (sock->domain == AF_INET)
+    return inet_shutdown(sock, how);
 
   switch (how) {
   case SHUT_RD:
@@ -607,8 +751,6 @@ int sys_shutdown(int sockfd, int how) {
     if (sock->peer)
       sock->peer->peer = 0;
     break;
-  default:
-    return -1;
   }
 
   return 0;
@@ -635,6 +777,8 @@ int sys_socketpair(int domain, int type, int protocol, int sv[2]) {
     return -1;
   }
 
+  sock1->type = SOCK_STREAM;
+  sock2->type = SOCK_STREAM;
   sock1->state = SOCKET_CONNECTED;
   sock2->state = SOCKET_CONNECTED;
   sock1->peer = sock2;
@@ -667,37 +811,23 @@ int sys_socketpair(int domain, int type, int protocol, int sv[2]) {
   node2->write = socket_write;
   node1->close = socket_close;
   node2->close = socket_close;
+  node1->ioctl = socket_ioctl;
+  node2->ioctl = socket_ioctl;
+  node1->poll = socket_poll;
+  node2->poll = socket_poll;
   node1->flags = VFS_SOCKET;
   node2->flags = VFS_SOCKET;
   node1->ref_count = 1;
   node2->ref_count = 1;
 
   // Find two free file descriptors
-  int fd1 = -1, fd2 = -1;
-  for (int i = 0; i < MAX_PROCESS_FILES && (fd1 < 0 || fd2 < 0); i++) {
-    if (!current_process->fd_table[i]) {
-      file_description_t *desc =
-          (file_description_t *)kmalloc(sizeof(file_description_t));
-      desc->offset = 0;
-      desc->flags = O_RDWR;
-      desc->ref_count = 1;
-
-      if (fd1 < 0) {
-        fd1 = i;
-        desc->node = node1;
-        current_process->fd_table[i] = desc;
-      } else {
-        fd2 = i;
-        desc->node = node2;
-        current_process->fd_table[i] = desc;
-      }
-    }
-  }
+  int fd1 = socket_install_fd(node1);
+  int fd2 = fd1 >= 0 ? socket_install_fd(node2) : -1;
 
   if (fd1 < 0 || fd2 < 0) {
     // Cleanup on failure
     if (fd1 >= 0)
-      current_process->fd_table[fd1] = 0;
+      kfree(fd_detach(fd1));
     kfree(node1);
     kfree(node2);
     sockets[sock1->id] = 0;
@@ -3,12 +3,62 @@
 
 #include "../include/types.h"
 #include "../include/vfs.h"
+#include "wait_queue.h"
 
 #define AF_UNIX 1
+#define AF_INET 2
 #define SOCK_STREAM 1
 #define SOCK_DGRAM 2
+#define SOCK_NONBLOCK 0x800 // type ke saath OR karo (O_NONBLOCK jaisa)
 #define MAX_BACKLOG 16
 
+#define IPPROTO_TCP 6
+#define IPPROTO_UDP 17
+#define INADDR_ANY 0
+
+// Socket options (level SOL_SOCKET)
+#define SOL_SOCKET 1
+#define SO_DEBUG 1
+#define SO_REUSEADDR 2
+#define SO_TYPE 3
+#define SO_ERROR 4
+#define SO_BROADCAST 6
+#define SO_SNDBUF 7
+#define SO_RCVBUF 8
+#define SO_KEEPALIVE 9
+#define SO_LINGER 13
+#define SO_RCVTIMEO 20
+#define SO_SNDTIMEO 21
+
+// Socket options (level IPPROTO_TCP)
+#define TCP_NODELAY 1
+
+// send/recv flags
+#define MSG_DONTWAIT 0x40
+
+// ioctl requests jo socket node samajhta hai
+#define FIONREAD 0x541B
+#define FIONBIO 0x5421
+
+// IPv4 socket address. Port aur address dono network byte order mein.
+struct sockaddr_in {
+  uint16_t sin_family;
+  uint16_t sin_port;
+  uint32_t sin_addr;
+  uint8_t sin_zero[8];
+};
+
+struct tcp_tcb;
+
+// Queued UDP datagram (AF_INET, SOCK_DGRAM)
+typedef struct inet_dgram {
+  struct inet_dgram *next;
+  uint32_t src_ip;
+  uint16_t src_port; // Host byte order
+  uint16_t len;
+  uint8_t data[];
+} inet_dgram_t;
+
 typedef enum {
   SOCKET_FREE,
   SOCKET_BOUND,
@@ -36,6 +86,26 @@ typedef struct socket {
   uint32_t tail;
 
   // We'll reuse the pipe-like ring buffer logic for simplicity
+
+  int nonblock;    // FIONBIO / O_NONBLOCK / SOCK_NONBLOCK
+  uint32_t rcvbuf; // SO_RCVBUF
+  uint32_t sndbuf; // SO_SNDBUF
+  int error;       // Pending SO_ERROR
+
+  // AF_INET state (inet.cpp). IPs network order, ports host order.
+  int protocol;
+  uint32_t local_ip;
+  uint32_t remote_ip;
+  uint16_t local_port;
+  uint16_t remote_port;
+  int nodelay;              // TCP_NODELAY
+  struct tcp_tcb *tcb;      // SOCK_STREAM connection ya listener
+  inet_dgram_t *dgram_head; // SOCK_DGRAM receive queue
+  inet_dgram_t *dgram_tail;
+  uint32_t dgram_bytes;
+
+  wait_queue_t rx_wait; // Data / connection aane ka intezar
+  wait_queue_t tx_wait; // Send window khulne ka intezar
 } socket_t;
 
 #ifdef __cplusplus
@@ -43,11 +113,15 @@ extern "C" {
 #endif
 
 void socket_init();
+socket_t *socket_alloc(int domain);
+void socket_discard(socket_t *sock);
 
 int sys_socket(int domain, int type, int protocol);
-int sys_bind(int sockfd, const char *path);
-int sys_connect(int sockfd, const char *path);
-int sys_accept(int sockfd);
+// AF_UNIX callers pass the path string as addr (addrlen is ignored for them);
+// AF_INET callers pass a struct sockaddr_in.
+int sys_bind(int sockfd, const void *addr, uint32_t addrlen);
+int sys_connect(int sockfd, const void *addr, uint32_t addrlen);
+int sys_accept(int sockfd, void *addr, uint32_t *addrlen);
 int sys_listen(int sockfd, int backlog);
 ssize_t sys_send(int sockfd, const void *buf, size_t len, int flags);
 ssize_t sys_recv(int sockfd, void *buf, size_t len, int flags);
@@ -72,6 +146,26 @@ uint32_t socket_read(vfs_node_t *node, uint32_t offset, uint32_t size,
 uint32_t socket_write(vfs_node_t *node, uint32_t offset, uint32_t size,
                       uint8_t *buffer);
 void socket_close(vfs_node_t *node);
+int socket_poll(vfs_node_t *node, poll_table_t *pt);
+
+// AF_INET backend (inet.cpp)
+int inet_socket_init(socket_t *sock, int type, int protocol);
+int inet_bind(socket_t *sock, const struct sockaddr_in *addr);
+int inet_connect(socket_t *sock, const struct sockaddr_in *addr);
+int inet_listen(socket_t *sock, int backlog);
+socket_t *inet_accept(socket_t *sock, int *err);
+int inet_send(socket_t *sock, const void *buf, uint32_t len, int flags,
+              const struct sockaddr_in *dest);
+int inet_recv(socket_t *sock, void *buf, uint32_t len, int flags,
+              struct sockaddr_in *src);
+int inet_poll(socket_t *sock);
+uint32_t inet_pending_bytes(socket_t *sock);
+int inet_setsockopt(socket_t *sock, int level, int optname, int value);
+int inet_shutdown(socket_t *sock, int how);
+void inet_getname(socket_t *sock, int peer, struct sockaddr_in *out);
+void inet_release(socket_t *sock);
+int inet_udp_input(uint32_t src_ip, uint32_t dst_ip, uint16_t src_port,
+                   uint16_t dst_port, uint8_t *data, uint16_t len);
 
 #ifdef __cplusplus
 }
@@ -1,13 +1,17 @@
 // Drivers aur headers mangwao
 #include "syscall.h"
+#include "../drivers/fat16.h"
 #include "../drivers/rtc.h"
 #include "../drivers/serial.h"
+#include "../include/epoll.h"
 #include "../include/errno.h"
+#include "../include/fs_phase.h"
 #include "../include/signal.h"
 #include "../include/string.h"
 #include "../include/vfs.h"
 #include "heap.h"
 #include "memory.h"
+#include "net.h"
 #include "paging.h"
 #include "pipe.h"
 #include "pmm.h"
@@ -41,7 +45,7 @@ static const char *version = "#1 SMP";
 static const char *machine = "i686";
 
 // Dekho pointer user space ka hai ya nahi
-static bool validate_user_pointer(const void *ptr, uint32_t size) {
+bool validate_user_pointer(const void *ptr, uint32_t size) {
   uintptr_t p = (uintptr_t)ptr;
   if (p < 0x20000000)
     return false;
@@ -100,6 +104,14 @@ int sys_tcp_test_call(registers_t *regs) {
   return net_stack_tcp_test();
 }
 
+// Interface counters (0 = lo, 1 = eth0) - netbench inhi se packets/s nikalta hai
+int sys_net_stats_call(registers_t *regs) {
+  struct netdev_stats *out = (struct netdev_stats *)regs->ecx;
+  if (!out)
+    return -EFAULT;
+  return net_get_stats((int)regs->ebx, out) < 0 ? -ENODEV : 0;
+}
+
 int sys_get_framebuffer_call(registers_t *regs) {
   (void)regs;
   return (int)(uintptr_t)sys_get_framebuffer();
@@ -164,23 +176,17 @@ int sys_open(registers_t *regs) {
 
   vfs_node_t *node = vfs_resolve_path(path);
   if (node) {
-    file_description_t *desc =
-        (file_description_t *)kmalloc(sizeof(file_description_t));
-    desc->node = node;
-    desc->flags = flags;
-    desc->offset = 0;
-    desc->ref_count = 1;
-
-    for (int j = 0; j < MAX_PROCESS_FILES; j++) {
-      if (current_process->fd_table[j] == 0) {
-        current_process->fd_table[j] = desc;
-        if (node->open)
-          node->open(node);
-        return j;
-      }
+    file_description_t *desc = fd_desc_alloc(node, flags & ~O_CLOEXEC);
+    if (!desc)
+      return -ENOMEM;
+    int fd = fd_alloc(desc, 0, (flags & O_CLOEXEC) != 0);
+    if (fd < 0) {
+      kfree(desc);
+      return fd;
     }
-    kfree(desc);
-    return -EMFILE;
+    if (node->open)
+      node->open(node);
+    return fd;
   }
   return -ENOENT;
 }
@@ -192,31 +198,24 @@ int sys_openat(registers_t *regs) {
 
   vfs_node_t *dir_node = vfs_root;
   if (dirfd != AT_FDCWD) {
-    if (dirfd < 0 || dirfd >= MAX_PROCESS_FILES ||
-        !current_process->fd_table[dirfd])
+    if (!fd_get(dirfd))
       return -EBADF;
-    dir_node = current_process->fd_table[dirfd]->node;
+    dir_node = fd_get(dirfd)->node;
   }
 
   vfs_node_t *node = vfs_resolve_path_relative(dir_node, path);
   if (node) {
-    file_description_t *desc =
-        (file_description_t *)kmalloc(sizeof(file_description_t));
-    desc->node = node;
-    desc->flags = flags;
-    desc->offset = 0;
-    desc->ref_count = 1;
-
-    for (int j = 0; j < MAX_PROCESS_FILES; j++) {
-      if (current_process->fd_table[j] == 0) {
-        current_process->fd_table[j] = desc;
-        if (node->open)
-          node->open(node);
-        return j;
-      }
+    file_description_t *desc = fd_desc_alloc(node, flags & ~O_CLOEXEC);
+    if (!desc)
+      return -ENOMEM;
+    int fd = fd_alloc(desc, 0, (flags & O_CLOEXEC) != 0);
+    if (fd < 0) {
+      kfree(desc);
+      return fd; // Bahut saare files khul gaye hain bhai
     }
-    kfree(desc);
-    return -EMFILE; // Bahut saare files khul gaye hain bhai
+    if (node->open)
+      node->open(node);
+    return fd;
   }
   return -ENOENT; // Aisa koi file nahi hai
 }
@@ -225,10 +224,9 @@ int sys_read(registers_t *regs) {
   int fd = (int)regs->ebx;
   uint8_t *buf = (uint8_t *)regs->ecx;
   uint32_t size = (uint32_t)regs->edx;
-  if (validate_user_pointer(buf, size) && fd >= 0 && fd < MAX_PROCESS_FILES &&
-      current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
-    int n = vfs_read(desc->node, desc->offset, buf, size);
+  if (validate_user_pointer(buf, size) && fd_get(fd)) {
+    file_description_t *desc = fd_get(fd);
+    int n = vfs_read_ra(desc->node, &desc->ra, desc->offset, buf, size);
     if (n > 0)
       desc->offset += n;
     return n;
@@ -236,38 +234,141 @@ int sys_read(registers_t *regs) {
   return -EBADF;
 }
 
-int sys_readv(registers_t *regs) {
-  int fd = (int)regs->ebx;
-  const struct iovec *iov = (const struct iovec *)regs->ecx;
-  int iovcnt = (int)regs->edx;
+// ----------------------------------------------------------------------------
+// Vectored I/O: saare segments pehle validate, phir 64KB tak ke kernel chunks
+// - har chunk filesystem/pipe/socket ke liye ek hi request, per-iovec nahi
+// ----------------------------------------------------------------------------
+#define IOV_MAX 1024
+#define IOV_CHUNK (64 * 1024)
+#define IOV_FAST 8 // Itne iovecs tak kernel copy stack pe
+
+// Har segment user space mein, kul length int mein samaye. `iov` kernel ki
+// copy hai - user array check ke baad badle toh bhi yahan asar nahi.
+static int validate_iov(const struct iovec *iov, int iovcnt, uint32_t *total) {
+  uint32_t sum = 0;
+  for (int i = 0; i < iovcnt; i++) {
+    if (iov[i].iov_len > 0x7FFFFFFFu - sum)
+      return -EINVAL;
+    if (iov[i].iov_len &&
+        !validate_user_pointer(iov[i].iov_base, iov[i].iov_len))
+      return -EFAULT;
+    sum += iov[i].iov_len;
+  }
+  *total = sum;
+  return 0;
+}
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
-    return -EBADF;
-  if (!iov || iovcnt <= 0)
-    return -EINVAL;
+// (seg, seg_off) cursor se `len` bytes: iovecs <-> kbuf
+static void iov_copy(const struct iovec *iov, int iovcnt, int *seg,
+                     uint32_t *seg_off, uint8_t *kbuf, uint32_t len,
+                     bool to_user) {
+  while (len && *seg < iovcnt) {
+    uint32_t avail = iov[*seg].iov_len - *seg_off;
+    if (!avail) {
+      (*seg)++;
+      *seg_off = 0;
+      continue;
+    }
+    uint32_t n = avail < len ? avail : len;
+    uint8_t *u = (uint8_t *)iov[*seg].iov_base + *seg_off;
+    if (to_user)
+      memcpy(u, kbuf, n);
+    else
+      memcpy(kbuf, u, n);
+    kbuf += n;
+    len -= n;
+    *seg_off += n;
+  }
+}
 
-  file_description_t *desc = current_process->fd_table[fd];
-  ssize_t total_read = 0;
+static int iov_transfer(file_description_t *desc, uint64_t offset,
+                        const struct iovec *iov, int iovcnt, bool write) {
+  uint32_t total;
+  int err = validate_iov(iov, iovcnt, &total);
+  if (err < 0 || !total)
+    return err;
+
+  // Ek hi non-empty segment - seedha user buffer, bounce nahi
+  int nonempty = 0, only = 0;
   for (int i = 0; i < iovcnt; i++) {
-    uint32_t n = vfs_read(desc->node, desc->offset, (uint8_t *)iov[i].iov_base,
-                          iov[i].iov_len);
-    if (n > 0) {
-      desc->offset += n;
-      total_read += n;
+    if (iov[i].iov_len) {
+      nonempty++;
+      only = i;
     }
-    if (n < iov[i].iov_len)
+  }
+  uint32_t chunk = total < IOV_CHUNK ? total : IOV_CHUNK;
+  uint8_t *kbuf = 0;
+  if (nonempty > 1) {
+    kbuf = (uint8_t *)kmalloc(chunk);
+    if (!kbuf)
+      return -ENOMEM;
+  }
+
+  int seg = 0, ret = 0;
+  uint32_t seg_off = 0, done = 0;
+  while (done < total) {
+    uint32_t want = total - done < chunk ? total - done : chunk;
+    uint8_t *buf = kbuf ? kbuf : (uint8_t *)iov[only].iov_base + done;
+    if (kbuf && write)
+      iov_copy(iov, iovcnt, &seg, &seg_off, kbuf, want, false);
+    int n = write ? vfs_write(desc->node, offset + done, buf, want)
+                  : vfs_read_ra(desc->node, &desc->ra, offset + done, buf,
+                                want);
+    if (n <= 0) {
+      ret = n;
       break;
+    }
+    if (kbuf && !write)
+      iov_copy(iov, iovcnt, &seg, &seg_off, kbuf, n, true);
+    done += n;
+    if ((uint32_t)n < want)
+      break; // Pipe/socket ne jitna tha utna diya - aage block mat karo
   }
-  return (int)total_read;
+  if (kbuf)
+    kfree(kbuf);
+  return done ? (int)done : ret;
+}
+
+// User ka iovec array ek hi baar kernel mein copy, phir sirf wahi copy
+// validate aur use hoti hai (doosra thread beech mein base/len na badal sake)
+static int iov_rw(file_description_t *desc, uint64_t offset,
+                  const struct iovec *uiov, int iovcnt, bool write) {
+  if (iovcnt < 0 || iovcnt > IOV_MAX)
+    return -EINVAL;
+  uint32_t bytes = (uint32_t)iovcnt * sizeof(struct iovec);
+  if (iovcnt && !validate_user_pointer(uiov, bytes))
+    return -EFAULT;
+  struct iovec fast[IOV_FAST];
+  struct iovec *iov = fast;
+  if (iovcnt > IOV_FAST) {
+    iov = (struct iovec *)kmalloc(bytes);
+    if (!iov)
+      return -ENOMEM;
+  }
+  memcpy(iov, uiov, bytes);
+  int ret = iov_transfer(desc, offset, iov, iovcnt, write);
+  if (iov != fast)
+    kfree(iov);
+  return ret;
+}
+
+int sys_readv(registers_t *regs) {
+  file_description_t *desc = fd_get((int)regs->ebx);
+  if (!desc)
+    return -EBADF;
+  int n = iov_rw(desc, desc->offset, (const struct iovec *)regs->ecx,
+                 (int)regs->edx, false);
+  if (n > 0)
+    desc->offset += n;
+  return n;
 }
 
 int sys_write(registers_t *regs) {
   int fd = (int)regs->ebx;
   uint8_t *buf = (uint8_t *)regs->ecx;
   uint32_t size = (uint32_t)regs->edx;
-  if (validate_user_pointer(buf, size) && fd >= 0 && fd < MAX_PROCESS_FILES &&
-      current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
+  if (validate_user_pointer(buf, size) && fd_get(fd)) {
+    file_description_t *desc = fd_get(fd);
     int n = vfs_write(desc->node, desc->offset, buf, size);
     if (n > 0)
       desc->offset += n;
@@ -277,47 +378,39 @@ int sys_write(registers_t *regs) {
 }
 
 int sys_writev(registers_t *regs) {
-  int fd = (int)regs->ebx;
-  const struct iovec *iov = (const struct iovec *)regs->ecx;
-  int iovcnt = (int)regs->edx;
+  file_description_t *desc = fd_get((int)regs->ebx);
+  if (!desc)
+    return -EBADF;
+  int n = iov_rw(desc, desc->offset, (const struct iovec *)regs->ecx,
+                 (int)regs->edx, true);
+  if (n > 0)
+    desc->offset += n;
+  return n;
+}
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+// Offset pe, file position badle bina
+int sys_preadv_call(registers_t *regs) {
+  file_description_t *desc = fd_get((int)regs->ebx);
+  if (!desc)
     return -EBADF;
-  if (!iov || iovcnt <= 0)
+  if ((int)regs->esi < 0)
     return -EINVAL;
-
-  file_description_t *desc = current_process->fd_table[fd];
-  ssize_t total_written = 0;
-  for (int i = 0; i < iovcnt; i++) {
-    uint32_t n = vfs_write(desc->node, desc->offset, (uint8_t *)iov[i].iov_base,
-                           iov[i].iov_len);
-    if (n > 0) {
-      desc->offset += n;
-      total_written += n;
-    }
-    if (n < iov[i].iov_len)
-      break;
-  }
-  return (int)total_written;
+  return iov_rw(desc, (uint32_t)regs->esi, (const struct iovec *)regs->ecx,
+                (int)regs->edx, false);
 }
 
-int sys_close(registers_t *regs) {
-  int fd = (int)regs->ebx;
-  if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
-    current_process->fd_table[fd] = 0;
-
-    desc->ref_count--;
-    if (desc->ref_count == 0) {
-      if (desc->node->close)
-        desc->node->close(desc->node);
-      kfree(desc);
-    }
-    return 0;
-  }
-  return -EBADF;
+int sys_pwritev_call(registers_t *regs) {
+  file_description_t *desc = fd_get((int)regs->ebx);
+  if (!desc)
+    return -EBADF;
+  if ((int)regs->esi < 0)
+    return -EINVAL;
+  return iov_rw(desc, (uint32_t)regs->esi, (const struct iovec *)regs->ecx,
+                (int)regs->edx, true);
 }
 
+int sys_close(registers_t *regs) { return fd_close((int)regs->ebx); }
+
 int sys_sbrk(registers_t *regs) {
   intptr_t increment = (intptr_t)regs->ebx;
   uint32_t old_brk = current_process->heap_end;
@@ -375,6 +468,12 @@ int sys_fork(registers_t *regs) {
   return fork_process(regs);
 }
 
+int sys_vfork(registers_t *regs) {
+  if (!(current_process->pledges & PLEDGE_PROC))
+    return -EPERM;
+  return vfork_process(regs);
+}
+
 int sys_execve(registers_t *regs) {
   if (!(current_process->pledges & PLEDGE_EXEC))
     return -EPERM;
@@ -406,14 +505,16 @@ int sys_socket_call(registers_t *regs) {
 }
 
 int sys_bind_call(registers_t *regs) {
-  return sys_bind(regs->ebx, (const char *)regs->ecx);
+  return sys_bind(regs->ebx, (const void *)regs->ecx, regs->edx);
 }
 
 int sys_connect_call(registers_t *regs) {
-  return sys_connect(regs->ebx, (const char *)regs->ecx);
+  return sys_connect(regs->ebx, (const void *)regs->ecx, regs->edx);
 }
 
-int sys_accept_call(registers_t *regs) { return sys_accept(regs->ebx); }
+int sys_accept_call(registers_t *regs) {
+  return sys_accept(regs->ebx, (void *)regs->ecx, (uint32_t *)regs->edx);
+}
 
 int sys_signal_call(registers_t *regs) {
   return sys_signal(regs->ebx, (sighandler_t)regs->ecx);
@@ -431,8 +532,8 @@ int sys_readdir_call(registers_t *regs) {
   int fd = (int)regs->ebx;
   uint32_t index = (uint32_t)regs->ecx;
   struct dirent *de = (struct dirent *)regs->edx;
-  if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd]) {
-    file_description_t *desc = current_process->fd_table[fd];
+  if (fd_get(fd)) {
+    file_description_t *desc = fd_get(fd);
     struct dirent *res = readdir_vfs(desc->node, index);
     if (res) {
       memcpy(de, res, sizeof(struct dirent));
@@ -508,9 +609,9 @@ int sys_stat_call(registers_t *regs) {
 int sys_fstat_call(registers_t *regs) {
   int fd = (int)regs->ebx;
   struct stat *st = (struct stat *)regs->ecx;
-  if (fd >= 0 && fd < MAX_PROCESS_FILES && current_process->fd_table[fd] &&
+  if (fd_get(fd) &&
       st) {
-    file_description_t *desc = current_process->fd_table[fd];
+    file_description_t *desc = fd_get(fd);
     vfs_node_t *node = desc->node;
     st->st_dev = 0;
     st->st_ino = node->inode;
@@ -534,10 +635,9 @@ int sys_fstatat_call(registers_t *regs) {
 
   vfs_node_t *dir_node = vfs_root;
   if (dirfd != AT_FDCWD) {
-    if (dirfd < 0 || dirfd >= MAX_PROCESS_FILES ||
-        !current_process->fd_table[dirfd])
+    if (!fd_get(dirfd))
       return -EBADF;
-    dir_node = current_process->fd_table[dirfd]->node;
+    dir_node = fd_get(dirfd)->node;
   }
 
   vfs_node_t *node = vfs_resolve_path_relative(dir_node, path);
@@ -562,10 +662,10 @@ int sys_seek(registers_t *regs) {
   int64_t offset = (int64_t)regs->ecx;
   int whence = (int)regs->edx;
 
-  if (fd < 0 || fd >= MAX_PROCESS_FILES || !current_process->fd_table[fd])
+  if (!fd_get(fd))
     return -EBADF;
 
-  file_description_t *desc = current_process->fd_table[fd];
+  file_description_t *desc = fd_get(fd);
   if (whence == SEEK_SET) {
     desc->offset = offset;
   } else if (whence == SEEK_CUR) {
@@ -580,38 +680,29 @@ int sys_seek(registers_t *regs) {
 
 int sys_dup_call(registers_t *regs) {
   int oldfd = (int)regs->ebx;
-  if (oldfd >= 0 && oldfd < MAX_PROCESS_FILES &&
-      current_process->fd_table[oldfd]) {
-    for (int j = 0; j < MAX_PROCESS_FILES; j++) {
-      if (current_process->fd_table[j] == 0) {
-        current_process->fd_table[j] = current_process->fd_table[oldfd];
-        current_process->fd_table[j]->ref_count++;
-        return j;
-      }
-    }
-  }
-  return -EMFILE;
+  file_description_t *desc = fd_get(oldfd);
+  if (!desc)
+    return -EBADF;
+  int fd = fd_alloc(desc, 0, 0);
+  if (fd >= 0)
+    desc->ref_count++;
+  return fd;
 }
 
 int sys_dup2_call(registers_t *regs) {
   int oldfd = (int)regs->ebx;
   int newfd = (int)regs->ecx;
-  if (oldfd >= 0 && oldfd < MAX_PROCESS_FILES && newfd >= 0 &&
-      newfd < MAX_PROCESS_FILES && current_process->fd_table[oldfd]) {
-    if (current_process->fd_table[newfd]) {
-      file_description_t *old_desc = current_process->fd_table[newfd];
-      old_desc->ref_count--;
-      if (old_desc->ref_count == 0) {
-        if (old_desc->node->close)
-          old_desc->node->close(old_desc->node);
-        kfree(old_desc);
-      }
-    }
-    current_process->fd_table[newfd] = current_process->fd_table[oldfd];
-    current_process->fd_table[newfd]->ref_count++;
+  file_description_t *desc = fd_get(oldfd);
+  if (!desc)
+    return -EBADF;
+  if (oldfd == newfd)
     return newfd;
-  }
-  return -EBADF;
+  // Pehle ref badhao - agar newfd pe bhi yahi desc ho toh free na ho jaye
+  desc->ref_count++;
+  int fd = fd_install_at(newfd, desc, 0);
+  if (fd < 0)
+    desc->ref_count--;
+  return fd;
 }
 
 int sys_gettime_call(registers_t *regs) {
@@ -663,7 +754,11 @@ int sys_access_call(registers_t *regs) {
   return node ? 0 : -ENOENT;
 }
 int sys_chmod_call(registers_t *regs) { return 0; }
-int sys_ioctl_call(registers_t *regs) { return 0; }
+extern "C" int sys_ioctl(int fd, unsigned long request, void *argp);
+int sys_ioctl_call(registers_t *regs) {
+  return sys_ioctl((int)regs->ebx, (unsigned long)regs->ecx,
+                   (void *)regs->edx);
+}
 int sys_alarm_call(registers_t *regs);
 
 int sys_hostname_call(registers_t *regs) {
@@ -741,7 +836,11 @@ int sys_getsid_call(registers_t *regs) {
   return current_process->sid;
 }
 
-int sys_sync_call(registers_t *regs) { return 0; }
+int sys_sync_call(registers_t *regs) {
+  phase_vfs_sync(); // Phase A ke dirty sectors log ke through disk pe
+  fat16_sync();     // FAT16 write-back cache
+  return 0;
+}
 
 int sys_rmdir_call(registers_t *regs) {
   if (!(current_process->pledges & PLEDGE_CPATH))
@@ -791,9 +890,15 @@ int sys_clock_gettime_call(registers_t *regs);
 int sys_gettimeofday_call(registers_t *regs);
 int sys_pread_call(registers_t *regs);
 int sys_pwrite_call(registers_t *regs);
+int sys_preadv_call(registers_t *regs);
+int sys_pwritev_call(registers_t *regs);
+int sys_sendfile_call(registers_t *regs);
+int sys_splice_call(registers_t *regs);
 int sys_lseek_call(registers_t *regs);
 int sys_truncate_call(registers_t *regs);
 int sys_ftruncate_call(registers_t *regs);
+int sys_fsync_call(registers_t *regs);
+int sys_fdatasync_call(registers_t *regs);
 int sys_link_call(registers_t *regs);
 int sys_symlink_call(registers_t *regs);
 int sys_readlink_call(registers_t *regs);
@@ -850,7 +955,8 @@ int sys__exit_call(registers_t *regs) {
 int sys_posix_spawn_call(registers_t *regs) {
   return sys_posix_spawn((int *)regs->ebx, (const char *)regs->ecx,
                          (void *)regs->edx, (void *)regs->esi,
-                         (char *const *)regs->edi, 0);
+                         (char *const *)regs->edi,
+                         (char *const *)regs->ebp); // 6th arg: ebp
 }
 
 int sys_sigaction_call(registers_t *regs) {
@@ -893,16 +999,46 @@ int sys_alarm_call(registers_t *regs) {
 // Phase 2: File aur Directory Operations
 // Ye file_ops.cpp ke functions use karte hain (bina sys_ prefix ke)
 // ----------------------------------------------------------------------------
-extern "C" int pread(int fd, void *buf, size_t count, int offset);
+extern "C" ssize_t sys_pread(int fd, void *buf, size_t count, off_t offset);
 int sys_pread_call(registers_t *regs) {
-  return pread((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
-               (int)regs->esi);
+  if (!validate_user_pointer((void *)regs->ecx, regs->edx))
+    return -EFAULT;
+  if ((int)regs->esi < 0)
+    return -EINVAL;
+  return sys_pread((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
+                   (off_t)regs->esi);
 }
 
-extern "C" int pwrite(int fd, const void *buf, size_t count, int offset);
+extern "C" ssize_t sys_pwrite(int fd, const void *buf, size_t count,
+                              off_t offset);
 int sys_pwrite_call(registers_t *regs) {
-  return pwrite((int)regs->ebx, (const void *)regs->ecx, (size_t)regs->edx,
-                (int)regs->esi);
+  if (!validate_user_pointer((void *)regs->ecx, regs->edx))
+    return -EFAULT;
+  if ((int)regs->esi < 0)
+    return -EINVAL;
+  return sys_pwrite((int)regs->ebx, (const void *)regs->ecx,
+                    (size_t)regs->edx, (off_t)regs->esi);
+}
+
+extern "C" ssize_t sys_sendfile(int out_fd, int in_fd, off_t *offset,
+                                size_t count);
+int sys_sendfile_call(registers_t *regs) {
+  off_t *offset = (off_t *)regs->edx;
+  if (offset && !validate_user_pointer(offset, sizeof(off_t)))
+    return -EFAULT;
+  return sys_sendfile((int)regs->ebx, (int)regs->ecx, offset,
+                      (size_t)regs->esi);
+}
+
+extern "C" ssize_t sys_splice(int fd_in, off_t *off_in, int fd_out,
+                              off_t *off_out, size_t len, uint32_t flags);
+int sys_splice_call(registers_t *regs) {
+  off_t *off_in = (off_t *)regs->ecx, *off_out = (off_t *)regs->esi;
+  if ((off_in && !validate_user_pointer(off_in, sizeof(off_t))) ||
+      (off_out && !validate_user_pointer(off_out, sizeof(off_t))))
+    return -EFAULT;
+  return sys_splice((int)regs->ebx, off_in, (int)regs->edx, off_out,
+                    (size_t)regs->edi, (uint32_t)regs->ebp); // 6th arg: ebp
 }
 
 extern "C" int lseek(int fd, int offset, int whence);
@@ -920,6 +1056,14 @@ int sys_ftruncate_call(registers_t *regs) {
   return ftruncate((int)regs->ebx, (int)regs->ecx);
 }
 
+extern "C" int sys_fsync(int fd);
+int sys_fsync_call(registers_t *regs) { return sys_fsync((int)regs->ebx); }
+
+extern "C" int sys_fdatasync(int fd);
+int sys_fdatasync_call(registers_t *regs) {
+  return sys_fdatasync((int)regs->ebx);
+}
+
 extern "C" int link(const char *oldpath, const char *newpath);
 int sys_link_call(registers_t *regs) {
   return link((const char *)regs->ebx, (const char *)regs->ecx);
@@ -978,9 +1122,9 @@ int sys_fchown_call(registers_t *regs) {
   return fchown((int)regs->ebx, (int)regs->ecx, (int)regs->edx);
 }
 
-extern "C" int fcntl(int fd, int cmd, int arg);
+extern "C" int sys_fcntl(int fd, int cmd, int arg);
 int sys_fcntl_call(registers_t *regs) {
-  return fcntl((int)regs->ebx, (int)regs->ecx, (int)regs->edx);
+  return sys_fcntl((int)regs->ebx, (int)regs->ecx, (int)regs->edx);
 }
 
 // ----------------------------------------------------------------------------
@@ -1106,66 +1250,55 @@ int sys_mq_receive_call(registers_t *regs) {
 // ----------------------------------------------------------------------------
 // Phase 6: Sockets (Internet ki duniya)
 // ----------------------------------------------------------------------------
-extern "C" int listen(int sockfd, int backlog);
 int sys_listen_call(registers_t *regs) {
-  return listen((int)regs->ebx, (int)regs->ecx);
+  return sys_listen((int)regs->ebx, (int)regs->ecx);
 }
 
-extern "C" int send(int sockfd, const void *buf, size_t len, int flags);
 int sys_send_call(registers_t *regs) {
-  return send((int)regs->ebx, (const void *)regs->ecx, (size_t)regs->edx,
-              (int)regs->esi);
+  return sys_send((int)regs->ebx, (const void *)regs->ecx, (size_t)regs->edx,
+                  (int)regs->esi);
 }
 
-extern "C" int recv(int sockfd, void *buf, size_t len, int flags);
 int sys_recv_call(registers_t *regs) {
-  return recv((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
-              (int)regs->esi);
+  return sys_recv((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
+                  (int)regs->esi);
 }
 
-extern "C" int sendto(int sockfd, const void *buf, size_t len, int flags,
-                      const void *dest_addr, unsigned int addrlen);
+// Chhatha argument (addrlen) ebp mein aata hai
 int sys_sendto_call(registers_t *regs) {
-  return sendto((int)regs->ebx, (const void *)regs->ecx, (size_t)regs->edx,
-                (int)regs->esi, (const void *)regs->edi, 0);
+  return sys_sendto((int)regs->ebx, (const void *)regs->ecx, (size_t)regs->edx,
+                    (int)regs->esi, (const void *)regs->edi,
+                    (uint32_t)regs->ebp);
 }
 
-extern "C" int recvfrom(int sockfd, void *buf, size_t len, int flags,
-                        void *src_addr, unsigned int *addrlen);
 int sys_recvfrom_call(registers_t *regs) {
-  return recvfrom((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
-                  (int)regs->esi, (void *)regs->edi, 0);
+  return sys_recvfrom((int)regs->ebx, (void *)regs->ecx, (size_t)regs->edx,
+                      (int)regs->esi, (void *)regs->edi,
+                      (uint32_t *)regs->ebp);
 }
 
-extern "C" int getsockname(int sockfd, void *addr, unsigned int *addrlen);
 int sys_getsockname_call(registers_t *regs) {
-  return getsockname((int)regs->ebx, (void *)regs->ecx,
-                     (unsigned int *)regs->edx);
+  return sys_getsockname((int)regs->ebx, (void *)regs->ecx,
+                         (uint32_t *)regs->edx);
 }
 
-extern "C" int getpeername(int sockfd, void *addr, unsigned int *addrlen);
 int sys_getpeername_call(registers_t *regs) {
-  return getpeername((int)regs->ebx, (void *)regs->ecx,
-                     (unsigned int *)regs->edx);
+  return sys_getpeername((int)regs->ebx, (void *)regs->ecx,
+                         (uint32_t *)regs->edx);
 }
 
-extern "C" int setsockopt(int sockfd, int level, int optname,
-                          const void *optval, unsigned int optlen);
 int sys_setsockopt_call(registers_t *regs) {
-  return setsockopt((int)regs->ebx, (int)regs->ecx, (int)regs->edx,
-                    (const void *)regs->esi, (unsigned int)regs->edi);
+  return sys_setsockopt((int)regs->ebx, (int)regs->ecx, (int)regs->edx,
+                        (const void *)regs->esi, (uint32_t)regs->edi);
 }
 
-extern "C" int getsockopt(int sockfd, int level, int optname, void *optval,
-                          unsigned int *optlen);
 int sys_getsockopt_call(registers_t *regs) {
-  return getsockopt((int)regs->ebx, (int)regs->ecx, (int)regs->edx,
-                    (void *)regs->esi, (unsigned int *)regs->edi);
+  return sys_getsockopt((int)regs->ebx, (int)regs->ecx, (int)regs->edx,
+                        (void *)regs->esi, (uint32_t *)regs->edi);
 }
 
-extern "C" int shutdown(int sockfd, int how);
 int sys_shutdown_call(registers_t *regs) {
-  return shutdown((int)regs->ebx, (int)regs->ecx);
+  return sys_shutdown((int)regs->ebx, (int)regs->ecx);
 }
 
 // ----------------------------------------------------------------------------
@@ -1236,6 +1369,17 @@ extern "C" int poll(void *fds, unsigned int nfds, int timeout);
 int sys_poll_call(registers_t *regs) {
   return poll((void *)regs->ebx, (unsigned int)regs->ecx, (int)regs->edx);
 }
+int sys_epoll_create_call(registers_t *regs) {
+  return epoll_create1((int)regs->ebx);
+}
+int sys_epoll_ctl_call(registers_t *regs) {
+  return epoll_ctl((int)regs->ebx, (int)regs->ecx, (int)regs->edx,
+                   (struct epoll_event *)regs->esi);
+}
+int sys_epoll_wait_call(registers_t *regs) {
+  return epoll_wait((int)regs->ebx, (struct epoll_event *)regs->ecx,
+                    (int)regs->edx, (int)regs->esi);
+}
 
 // ----------------------------------------------------------------------------
 // Phase 11-12: Memory/Config (System settings)
@@ -1435,16 +1579,22 @@ static syscall_ptr syscall_table[256] = {
     sys_tcsetattr_call, // 132
     sys_select_call,    // 133
     sys_poll_call,      // 134
-    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+    // epoll
+    sys_epoll_create_call, // 135
+    sys_epoll_ctl_call,    // 136
+    sys_epoll_wait_call,   // 137
+    sys_vfork,             // 138
+    sys_fsync_call,        // 139
+    sys_fdatasync_call,    // 140
     // Phase 11-12: Memory/Config
     sys_mprotect_call,        // 141
     sys_msync_call,           // 142
     sys_mlock_call,           // 143
     sys_sysconf_call,         // 144
-    nullptr,                  // 145
-    nullptr,                  // 146
-    nullptr,                  // 147
-    nullptr,                  // 148
+    sys_preadv_call,          // 145
+    sys_pwritev_call,         // 146
+    sys_sendfile_call,        // 147
+    sys_splice_call,          // 148
     nullptr,                  // 149
     sys_get_framebuffer_call, // 150
     sys_fb_width_call,        // 151
@@ -1452,7 +1602,8 @@ static syscall_ptr syscall_table[256] = {
     sys_fb_swap_call,         // 153
     sys_pty_create_call,      // 154
     sys_net_ping_call,        // 155
-    sys_tcp_test_call         // 156
+    sys_tcp_test_call,        // 156
+    sys_net_stats_call        // 157
 };
 
 static const int num_syscalls = sizeof(syscall_table) / sizeof(syscall_ptr);
@@ -5,4 +5,7 @@
 
 void init_syscalls();
 
+// Pointer (aur [ptr, ptr + size) range) user space mein hai ya nahi
+bool validate_user_pointer(const void *ptr, uint32_t size);
+
 #endif
@@ -95,10 +95,10 @@ long sysconf(int name) {
     return 16;
 
   case _SC_OPEN_MAX:
-    return MAX_PROCESS_FILES;
+    return fd_limit();
 
   case _SC_STREAM_MAX:
-    return MAX_PROCESS_FILES;
+    return fd_limit();
 
   case _SC_TZNAME_MAX:
     return 6;
@@ -286,7 +286,7 @@ static struct rlimit default_limits[RLIM_NLIMITS] = {
     [RLIMIT_CORE] = {0, RLIM_INFINITY},
     [RLIMIT_RSS] = {RLIM_INFINITY, RLIM_INFINITY},
     [RLIMIT_NPROC] = {64, 64},
-    [RLIMIT_NOFILE] = {MAX_PROCESS_FILES, MAX_PROCESS_FILES},
+    [RLIMIT_NOFILE] = {NR_OPEN_DEFAULT, NR_OPEN_MAX},
     [RLIMIT_MEMLOCK] = {64 * 1024, 64 * 1024},
     [RLIMIT_AS] = {RLIM_INFINITY, RLIM_INFINITY},
     [RLIMIT_LOCKS] = {RLIM_INFINITY, RLIM_INFINITY},
@@ -304,6 +304,13 @@ int getrlimit(int resource, struct rlimit *rlim) {
   if (resource < 0 || resource >= RLIM_NLIMITS)
     return -EINVAL;
 
+  // NOFILE per-process hai (fd table usi se badhti hai)
+  if (resource == RLIMIT_NOFILE && current_process) {
+    rlim->rlim_cur = current_process->nofile_cur;
+    rlim->rlim_max = current_process->nofile_max;
+    return 0;
+  }
+
   *rlim = default_limits[resource];
   return 0;
 }
@@ -315,6 +322,17 @@ int setrlimit(int resource, const struct rlimit *rlim) {
   if (resource < 0 || resource >= RLIM_NLIMITS)
     return -EINVAL;
 
+  if (resource == RLIMIT_NOFILE && current_process) {
+    if (rlim->rlim_cur > rlim->rlim_max || rlim->rlim_max > NR_OPEN_MAX)
+      return -EINVAL;
+    if (current_process->euid != 0 &&
+        rlim->rlim_max > current_process->nofile_max)
+      return -EPERM;
+    current_process->nofile_cur = rlim->rlim_cur;
+    current_process->nofile_max = rlim->rlim_max;
+    return 0;
+  }
+
   // Only root can raise limits above current hard limit
   if (current_process && current_process->euid != 0) {
     if (rlim->rlim_max > default_limits[resource].rlim_max)
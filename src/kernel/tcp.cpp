@@ -3,8 +3,10 @@
 
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "checksum.h"
 #include "heap.h"
 #include "memory.h"
+#include "tcp.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -13,6 +15,7 @@
 
 #define MAX_TCP_CONNECTIONS 16
 #define TCP_DEFAULT_WINDOW 4096
+#define TCP_MAX_BACKLOG 8
 #define IPPROTO_TCP 6
 
 /* ================= TCP FLAGS ================= */
@@ -34,6 +37,7 @@ typedef enum {
   TCP_FIN_WAIT_1,
   TCP_FIN_WAIT_2,
   TCP_CLOSE_WAIT,
+  TCP_CLOSING,
   TCP_LAST_ACK,
   TCP_TIME_WAIT
 } tcp_state_t;
@@ -54,32 +58,51 @@ typedef struct __attribute__((packed)) {
 
 /* ================= TCP CONTROL BLOCK ================= */
 
-typedef struct {
+struct tcp_tcb {
   int used;
 
   uint32_t local_ip;
   uint32_t remote_ip;
-  uint16_t local_port;
-  uint16_t remote_port;
+  uint16_t local_port;  // Network byte order
+  uint16_t remote_port; // Network byte order
 
   uint32_t snd_una; // Oldest unacknowledged sequence number
   uint32_t snd_nxt; // Next sequence number to send
   uint32_t rcv_nxt; // Next expected receive sequence number
 
-  uint16_t snd_wnd; // Send window
-  uint16_t rcv_wnd; // Receive window
+  uint16_t snd_wnd; // Send window (peer ne jo advertise kiya)
+  uint16_t rcv_wnd; // Receive window (last advertised)
 
   tcp_state_t state;
 
-  // Receive buffer for incoming data
+  // Receive buffer for incoming data (size = SO_RCVBUF)
   uint8_t *rx_buffer;
-  uint16_t rx_len;
-  uint16_t rx_capacity;
-} tcp_tcb_t;
+  uint32_t rx_len;
+  uint32_t rx_capacity;
+
+  // Nagle: chhote writes yahan jama hote hain jab tak pichla data ACK na ho
+  uint8_t *tx_pending;
+  uint16_t tx_pending_len;
+  uint32_t snd_buf; // SO_SNDBUF: max bytes in flight + pending
+  int nodelay;
+
+  // Passive open
+  struct tcp_tcb *parent; // Listener jisne ye child banaya (accept se pehle)
+  struct tcp_tcb *accept_queue[TCP_MAX_BACKLOG];
+  int accept_count;
+  int backlog;
+
+  int peer_fin; // FIN aa chuka hai, aur data nahi aayega
+  int reset;    // RST mila (ECONNRESET / ECONNREFUSED)
+
+  void *owner;
+  tcp_notify_t notify;
+};
 
 /* ================= GLOBALS ================= */
 
 static tcp_tcb_t tcp_table[MAX_TCP_CONNECTIONS];
+static uint32_t tcp_next_iss = 0x1000;
 
 /* ================= BYTE ORDER HELPERS ================= */
 
@@ -94,17 +117,38 @@ static inline uint32_t tcp_htonl(uint32_t x) {
 
 static inline uint32_t tcp_ntohl(uint32_t x) { return tcp_htonl(x); }
 
+// Sequence number comparisons (wrap-around safe)
+static inline int seq_lt(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+static inline int seq_le(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b) <= 0;
+}
+
 /* ================= TCP HELPERS ================= */
 
 static tcp_tcb_t *tcp_alloc_tcb() {
   for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
     if (!tcp_table[i].used) {
-      memset(&tcp_table[i], 0, sizeof(tcp_tcb_t));
-      tcp_table[i].used = 1;
-      tcp_table[i].rx_capacity = 4096;
-      tcp_table[i].rx_buffer = (uint8_t *)kmalloc(4096);
-      tcp_table[i].rx_len = 0;
-      return &tcp_table[i];
+      tcp_tcb_t *tcb = &tcp_table[i];
+      memset(tcb, 0, sizeof(tcp_tcb_t));
+      tcb->rx_capacity = TCP_DEFAULT_RCVBUF;
+      tcb->rx_buffer = (uint8_t *)kmalloc(tcb->rx_capacity);
+      tcb->tx_pending = (uint8_t *)kmalloc(TCP_MSS);
+      if (!tcb->rx_buffer || !tcb->tx_pending) {
+        if (tcb->rx_buffer)
+          kfree(tcb->rx_buffer);
+        if (tcb->tx_pending)
+          kfree(tcb->tx_pending);
+        serial_log("TCP: OOM while allocating TCB buffers");
+        return nullptr;
+      }
+      tcb->used = 1;
+      tcb->rx_len = 0;
+      tcb->snd_buf = TCP_DEFAULT_SNDBUF;
+      tcb->snd_wnd = TCP_DEFAULT_WINDOW;
+      tcb->snd_nxt = tcp_next_iss;
+      tcb->snd_una = tcb->snd_nxt;
+      tcp_next_iss += 64000;
+      return tcb;
     }
   }
   return nullptr;
@@ -115,74 +159,72 @@ static void tcp_free_tcb(tcp_tcb_t *tcb) {
     if (tcb->rx_buffer) {
       kfree(tcb->rx_buffer);
     }
+    if (tcb->tx_pending) {
+      kfree(tcb->tx_pending);
+    }
     memset(tcb, 0, sizeof(tcp_tcb_t));
   }
 }
 
+// TCB tabhi free hota hai jab owner (socket) chhod chuka ho aur connection
+// khatam ho gaya ho. There is no 2MSL timer, so TIME_WAIT is released at once.
+static void tcp_maybe_free(tcp_tcb_t *tcb) {
+  if (!tcb->used || tcb->owner || tcb->parent)
+    return;
+  if (tcb->state == TCP_CLOSED || tcb->state == TCP_TIME_WAIT)
+    tcp_free_tcb(tcb);
+}
+
+static void tcp_notify_owner(tcp_tcb_t *tcb) {
+  if (tcb->notify && tcb->owner)
+    tcb->notify(tcb->owner);
+}
+
 static tcp_tcb_t *tcp_find(uint32_t src_ip, uint32_t dst_ip, uint16_t src_port,
                            uint16_t dst_port) {
   for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
     tcp_tcb_t *t = &tcp_table[i];
-    if (!t->used)
+    if (!t->used || t->state == TCP_LISTEN)
       continue;
     if (t->local_ip == dst_ip && t->remote_ip == src_ip &&
         t->local_port == dst_port && t->remote_port == src_port)
       return t;
   }
+  // Koi connection nahi mila, to listener dhundo
+  for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+    tcp_tcb_t *t = &tcp_table[i];
+    if (t->used && t->state == TCP_LISTEN && t->local_port == dst_port &&
+        (t->local_ip == 0 || t->local_ip == dst_ip))
+      return t;
+  }
   return nullptr;
 }
 
-/* ================= TCP CHECKSUM ================= */
-
-static uint16_t tcp_checksum(uint32_t src_ip, uint32_t dst_ip,
-                             tcp_header_t *tcp, uint16_t tcp_len) {
-  struct {
-    uint32_t src;
-    uint32_t dst;
-    uint8_t zero;
-    uint8_t proto;
-    uint16_t len;
-  } __attribute__((packed)) pseudo;
-
-  pseudo.src = src_ip;
-  pseudo.dst = dst_ip;
-  pseudo.zero = 0;
-  pseudo.proto = IPPROTO_TCP;
-  pseudo.len = tcp_htons(tcp_len);
-
-  uint32_t sum = 0;
-  uint16_t *p = (uint16_t *)&pseudo;
-  for (size_t i = 0; i < sizeof(pseudo) / 2; i++)
-    sum += p[i];
-
-  p = (uint16_t *)tcp;
-  for (size_t i = 0; i < tcp_len / 2; i++)
-    sum += p[i];
-
-  // Handle odd byte
-  if (tcp_len & 1)
-    sum += ((uint8_t *)tcp)[tcp_len - 1];
-
-  while (sum >> 16)
-    sum = (sum & 0xFFFF) + (sum >> 16);
-
-  return ~sum;
+static uint16_t tcp_window_free(tcp_tcb_t *tcb) {
+  uint32_t space = tcb->rx_capacity - tcb->rx_len;
+  return space > 0xFFFF ? 0xFFFF : (uint16_t)space;
 }
 
 /* ================= TCP SEND SEGMENT ================= */
 
-// Forward declaration
-extern "C" void ip_send(uint32_t dst_ip, uint8_t protocol, uint8_t *data,
-                        uint16_t length);
+// Forward declaration (net.cpp). Checksum field mein pseudo-header seed
+// daal ke bhejte hain; baaki sum NIC (e1000 offload) ya software bharta hai.
+extern "C" void ip_send_csum(uint32_t src_ip, uint32_t dst_ip,
+                             uint8_t protocol, uint8_t *data, uint16_t length,
+                             uint16_t csum_off);
 
 static void tcp_send_segment(tcp_tcb_t *tcb, uint8_t flags, void *data,
                              uint16_t len) {
   size_t total_len = sizeof(tcp_header_t) + len;
   uint8_t *buffer = (uint8_t *)kmalloc(total_len);
+  if (!buffer)
+    return;
   tcp_header_t *tcp = (tcp_header_t *)buffer;
 
   memset(tcp, 0, sizeof(tcp_header_t));
 
+  tcb->rcv_wnd = tcp_window_free(tcb);
+
   tcp->src_port = tcb->local_port;
   tcp->dst_port = tcb->remote_port;
   tcp->seq = tcp_htonl(tcb->snd_nxt);
@@ -196,13 +238,11 @@ static void tcp_send_segment(tcp_tcb_t *tcb, uint8_t flags, void *data,
   if (len > 0)
     memcpy(buffer + sizeof(tcp_header_t), data, len);
 
-  tcp->checksum = tcp_checksum(tcb->local_ip, tcb->remote_ip, tcp, total_len);
-
-  serial_log_hex("TCP: Sending segment, flags=", flags);
-  serial_log_hex("TCP: seq=", tcb->snd_nxt);
-  serial_log_hex("TCP: ack=", tcb->rcv_nxt);
+  tcp->checksum =
+      csum_pseudo_seed(tcb->local_ip, tcb->remote_ip, total_len, IPPROTO_TCP);
 
-  ip_send(tcb->remote_ip, IPPROTO_TCP, buffer, total_len);
+  ip_send_csum(tcb->local_ip, tcb->remote_ip, IPPROTO_TCP, buffer,
+               total_len, offsetof(tcp_header_t, checksum));
 
   // Advance sequence number
   if (flags & TCP_SYN || flags & TCP_FIN)
@@ -213,6 +253,40 @@ static void tcp_send_segment(tcp_tcb_t *tcb, uint8_t flags, void *data,
   kfree(buffer);
 }
 
+// Jis segment ka koi TCB nahi hai uska jawab RST se do (RFC 793 "CLOSED")
+static void tcp_send_reset(uint32_t src_ip, uint32_t dst_ip, tcp_header_t *in,
+                           uint16_t data_len) {
+  tcp_header_t rst;
+  memset(&rst, 0, sizeof(rst));
+  rst.src_port = in->dst_port;
+  rst.dst_port = in->src_port;
+  rst.offset_reserved = (sizeof(tcp_header_t) / 4) << 4;
+  if (in->flags & TCP_ACK) {
+    rst.seq = in->ack;
+    rst.flags = TCP_RST;
+  } else {
+    uint32_t seg_len = data_len;
+    if (in->flags & TCP_SYN)
+      seg_len++;
+    if (in->flags & TCP_FIN)
+      seg_len++;
+    rst.ack = tcp_htonl(tcp_ntohl(in->seq) + seg_len);
+    rst.flags = TCP_RST | TCP_ACK;
+  }
+  rst.checksum = csum_pseudo_seed(dst_ip, src_ip, sizeof(rst), IPPROTO_TCP);
+  ip_send_csum(dst_ip, src_ip, IPPROTO_TCP, (uint8_t *)&rst, sizeof(rst),
+               offsetof(tcp_header_t, checksum));
+}
+
+// Nagle buffer mein jo pada hai use ek segment mein bhej do
+static void tcp_flush_pending(tcp_tcb_t *tcb) {
+  if (tcb->tx_pending_len == 0)
+    return;
+  tcp_send_segment(tcb, TCP_ACK | TCP_PSH, tcb->tx_pending,
+                   tcb->tx_pending_len);
+  tcb->tx_pending_len = 0;
+}
+
 /* ================= TCP CONNECT (Client) ================= */
 
 extern "C" tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
@@ -228,13 +302,8 @@ extern "C" tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
   tcb->local_port = tcp_htons(local_port);
   tcb->remote_port = tcp_htons(remote_port);
 
-  tcb->snd_nxt = 0x1000; // Initial sequence number
-  tcb->snd_una = tcb->snd_nxt;
   tcb->rcv_nxt = 0;
 
-  tcb->snd_wnd = TCP_DEFAULT_WINDOW;
-  tcb->rcv_wnd = TCP_DEFAULT_WINDOW;
-
   tcb->state = TCP_SYN_SENT;
 
   serial_log("TCP: Initiating connection (sending SYN)...");
@@ -243,6 +312,82 @@ extern "C" tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
   return tcb;
 }
 
+/* ================= TCP LISTEN / ACCEPT (Server) ================= */
+
+extern "C" tcp_tcb_t *tcp_listen(uint32_t local_ip, uint16_t local_port,
+                                 int backlog) {
+  tcp_tcb_t *tcb = tcp_alloc_tcb();
+  if (!tcb) {
+    serial_log("TCP: Failed to allocate listening TCB");
+    return nullptr;
+  }
+
+  tcb->local_ip = local_ip;
+  tcb->local_port = tcp_htons(local_port);
+  if (backlog <= 0)
+    backlog = 1;
+  tcb->backlog = backlog > TCP_MAX_BACKLOG ? TCP_MAX_BACKLOG : backlog;
+  tcb->state = TCP_LISTEN;
+
+  serial_log_hex("TCP: Listening on port ", local_port);
+  return tcb;
+}
+
+extern "C" tcp_tcb_t *tcp_accept(tcp_tcb_t *listener) {
+  if (!listener || listener->state != TCP_LISTEN ||
+      listener->accept_count == 0)
+    return nullptr;
+
+  tcp_tcb_t *child = listener->accept_queue[0];
+  for (int i = 0; i < listener->accept_count - 1; i++)
+    listener->accept_queue[i] = listener->accept_queue[i + 1];
+  listener->accept_count--;
+  child->parent = nullptr;
+  return child;
+}
+
+static int tcp_pending_children(tcp_tcb_t *listener) {
+  int n = listener->accept_count;
+  for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+    if (tcp_table[i].used && tcp_table[i].parent == listener &&
+        tcp_table[i].state == TCP_SYN_RECEIVED)
+      n++;
+  }
+  return n;
+}
+
+// LISTEN state mein SYN aaya: naya child TCB banao aur SYN+ACK bhejo
+static void tcp_passive_open(tcp_tcb_t *listener, uint32_t src_ip,
+                             uint32_t dst_ip, tcp_header_t *tcp) {
+  if (!(tcp->flags & TCP_SYN) || (tcp->flags & (TCP_ACK | TCP_RST)))
+    return;
+
+  if (tcp_pending_children(listener) >= listener->backlog) {
+    serial_log("TCP: Accept backlog full, dropping SYN");
+    return;
+  }
+
+  tcp_tcb_t *child = tcp_alloc_tcb();
+  if (!child)
+    return;
+
+  if (listener->rx_capacity != child->rx_capacity)
+    tcp_set_rcvbuf(child, listener->rx_capacity);
+  child->snd_buf = listener->snd_buf;
+  child->nodelay = listener->nodelay;
+
+  child->local_ip = dst_ip;
+  child->remote_ip = src_ip;
+  child->local_port = tcp->dst_port;
+  child->remote_port = tcp->src_port;
+  child->rcv_nxt = tcp_ntohl(tcp->seq) + 1;
+  child->snd_wnd = tcp_ntohs(tcp->window);
+  child->parent = listener;
+  child->state = TCP_SYN_RECEIVED;
+
+  tcp_send_segment(child, TCP_SYN | TCP_ACK, nullptr, 0);
+}
+
 /* ================= TCP RECEIVE PACKET ================= */
 
 extern "C" void tcp_handle_packet(uint32_t src_ip, uint32_t dst_ip,
@@ -254,24 +399,49 @@ extern "C" void tcp_handle_packet(uint32_t src_ip, uint32_t dst_ip,
 
   tcp_header_t *tcp = (tcp_header_t *)packet;
 
-  serial_log_hex("TCP: Received packet from port ", tcp_ntohs(tcp->src_port));
-  serial_log_hex("TCP: flags=", tcp->flags);
+  uint16_t hdr_len = (tcp->offset_reserved >> 4) * 4;
+  if (hdr_len < sizeof(tcp_header_t) || hdr_len > len)
+    return;
+  uint16_t data_len = len - hdr_len;
+  uint8_t *data = packet + hdr_len;
 
   tcp_tcb_t *tcb = tcp_find(src_ip, dst_ip, tcp->src_port, tcp->dst_port);
 
   if (!tcb) {
-    serial_log("TCP: No matching connection found");
+    if (!(tcp->flags & TCP_RST))
+      tcp_send_reset(src_ip, dst_ip, tcp, data_len);
     return;
   }
 
-  uint16_t hdr_len = (tcp->offset_reserved >> 4) * 4;
-  uint16_t data_len = len - hdr_len;
-  uint8_t *data = packet + hdr_len;
-
   uint32_t seg_seq = tcp_ntohl(tcp->seq);
   uint32_t seg_ack = tcp_ntohl(tcp->ack);
 
-  serial_log_hex("TCP: Current state=", tcb->state);
+  if (tcb->state == TCP_LISTEN) {
+    tcp_passive_open(tcb, src_ip, dst_ip, tcp);
+    return;
+  }
+
+  if (tcp->flags & TCP_RST) {
+    serial_log("TCP: Connection reset by peer");
+    tcb->reset = 1;
+    tcb->state = TCP_CLOSED;
+    if (tcb->parent) {
+      // Accept hone se pehle hi mar gaya: listener ki queue se hatao
+      tcp_tcb_t *l = tcb->parent;
+      for (int i = 0; i < l->accept_count; i++) {
+        if (l->accept_queue[i] == tcb) {
+          for (int j = i; j < l->accept_count - 1; j++)
+            l->accept_queue[j] = l->accept_queue[j + 1];
+          l->accept_count--;
+          break;
+        }
+      }
+      tcb->parent = nullptr;
+    }
+    tcp_notify_owner(tcb);
+    tcp_maybe_free(tcb);
+    return;
+  }
 
   switch (tcb->state) {
   case TCP_SYN_SENT:
@@ -279,82 +449,139 @@ extern "C" void tcp_handle_packet(uint32_t src_ip, uint32_t dst_ip,
     if ((tcp->flags & (TCP_SYN | TCP_ACK)) == (TCP_SYN | TCP_ACK)) {
       tcb->rcv_nxt = seg_seq + 1;
       tcb->snd_una = seg_ack;
+      tcb->snd_wnd = tcp_ntohs(tcp->window);
       tcb->state = TCP_ESTABLISHED;
       serial_log("TCP: Connection ESTABLISHED! Sending ACK...");
       tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
+      tcp_notify_owner(tcb);
     }
-    break;
-
-  case TCP_ESTABLISHED:
-    // Handle incoming data
-    if (data_len > 0 && seg_seq == tcb->rcv_nxt) {
-      serial_log_hex("TCP: Received data, len=", data_len);
+    return;
 
-      // Store data in receive buffer
-      if (tcb->rx_len + data_len <= tcb->rx_capacity) {
-        memcpy(tcb->rx_buffer + tcb->rx_len, data, data_len);
-        tcb->rx_len += data_len;
+  case TCP_SYN_RECEIVED:
+    // Teesra handshake packet: ACK of our SYN
+    if (!(tcp->flags & TCP_ACK) || seg_ack != tcb->snd_nxt)
+      return;
+    tcb->snd_una = seg_ack;
+    tcb->state = TCP_ESTABLISHED;
+    if (tcb->parent) {
+      tcp_tcb_t *l = tcb->parent;
+      if (l->accept_count < TCP_MAX_BACKLOG) {
+        l->accept_queue[l->accept_count++] = tcb;
+        tcp_notify_owner(l);
       }
-
-      tcb->rcv_nxt += data_len;
-      tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
     }
+    break; // Same segment mein data bhi ho sakta hai
 
-    // Handle FIN from peer
-    if (tcp->flags & TCP_FIN) {
-      tcb->rcv_nxt++;
-      tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
-      tcb->state = TCP_CLOSE_WAIT;
-      serial_log("TCP: Received FIN, moving to CLOSE_WAIT");
-    }
+  case TCP_CLOSED:
+    return;
+
+  default:
     break;
+  }
+
+  // ---- Synchronized states: ACK, data, FIN ----
 
-  case TCP_FIN_WAIT_1:
-    if (tcp->flags & TCP_ACK) {
-      tcb->state = TCP_FIN_WAIT_2;
-      serial_log("TCP: Moving to FIN_WAIT_2");
+  if (tcp->flags & TCP_ACK) {
+    if (seq_lt(tcb->snd_una, seg_ack) && seq_le(seg_ack, tcb->snd_nxt))
+      tcb->snd_una = seg_ack;
+    tcb->snd_wnd = tcp_ntohs(tcp->window);
+
+    int all_acked = (tcb->snd_una == tcb->snd_nxt);
+    if (all_acked && tcb->tx_pending_len > 0)
+      tcp_flush_pending(tcb);
+
+    if (all_acked) {
+      if (tcb->state == TCP_FIN_WAIT_1) {
+        tcb->state = TCP_FIN_WAIT_2;
+      } else if (tcb->state == TCP_CLOSING) {
+        tcb->state = TCP_TIME_WAIT;
+      } else if (tcb->state == TCP_LAST_ACK) {
+        tcb->state = TCP_CLOSED;
+        serial_log("TCP: Connection closed");
+      }
     }
-    if (tcp->flags & TCP_FIN) {
-      tcb->rcv_nxt++;
-      tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
-      tcb->state = TCP_TIME_WAIT;
-      serial_log("TCP: Moving to TIME_WAIT");
+  }
+
+  if (data_len > 0 &&
+      (tcb->state == TCP_ESTABLISHED || tcb->state == TCP_FIN_WAIT_1 ||
+       tcb->state == TCP_FIN_WAIT_2)) {
+    if (seg_seq == tcb->rcv_nxt) {
+      // Jitni jagah hai utna hi lo; baaki peer dobara bhejega
+      uint32_t space = tcb->rx_capacity - tcb->rx_len;
+      uint32_t take = data_len < space ? data_len : space;
+      if (take > 0) {
+        memcpy(tcb->rx_buffer + tcb->rx_len, data, take);
+        tcb->rx_len += take;
+        tcb->rcv_nxt += take;
+      }
+      if (take < data_len)
+        data_len = take; // FIN (agar hai) abhi accept nahi hoga
     }
-    break;
+    // Out-of-order ya duplicate ho to bhi ACK bhejo (dup ACK)
+    tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
+  }
 
-  case TCP_FIN_WAIT_2:
-    if (tcp->flags & TCP_FIN) {
-      tcb->rcv_nxt++;
-      tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
+  if ((tcp->flags & TCP_FIN) && seg_seq + data_len == tcb->rcv_nxt &&
+      !tcb->peer_fin) {
+    tcb->rcv_nxt++;
+    tcb->peer_fin = 1;
+    tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
+    switch (tcb->state) {
+    case TCP_SYN_RECEIVED:
+    case TCP_ESTABLISHED:
+      tcb->state = TCP_CLOSE_WAIT;
+      serial_log("TCP: Received FIN, moving to CLOSE_WAIT");
+      break;
+    case TCP_FIN_WAIT_1:
+      tcb->state =
+          (tcb->snd_una == tcb->snd_nxt) ? TCP_TIME_WAIT : TCP_CLOSING;
+      break;
+    case TCP_FIN_WAIT_2:
       tcb->state = TCP_TIME_WAIT;
       serial_log("TCP: Moving to TIME_WAIT");
+      break;
+    default:
+      break;
     }
-    break;
-
-  case TCP_LAST_ACK:
-    if (tcp->flags & TCP_ACK) {
-      tcb->state = TCP_CLOSED;
-      tcp_free_tcb(tcb);
-      serial_log("TCP: Connection closed");
-    }
-    break;
-
-  default:
-    break;
   }
+
+  tcp_notify_owner(tcb);
+  tcp_maybe_free(tcb);
 }
 
 /* ================= TCP SEND DATA ================= */
 
 extern "C" int tcp_send_data(tcp_tcb_t *tcb, void *data, uint16_t len) {
-  if (!tcb || tcb->state != TCP_ESTABLISHED) {
-    serial_log("TCP: Cannot send - not established");
+  if (!tcb || (tcb->state != TCP_ESTABLISHED &&
+               tcb->state != TCP_CLOSE_WAIT)) {
     return -1;
   }
 
-  serial_log_hex("TCP: Sending data, len=", len);
-  tcp_send_segment(tcb, TCP_ACK | TCP_PSH, data, len);
-  return len;
+  uint8_t *src = (uint8_t *)data;
+  uint32_t wnd = tcb->snd_wnd < tcb->snd_buf ? tcb->snd_wnd : tcb->snd_buf;
+  uint16_t sent = 0;
+
+  while (sent < len) {
+    uint32_t used = (tcb->snd_nxt - tcb->snd_una) + tcb->tx_pending_len;
+    if (used >= wnd)
+      break;
+    uint32_t chunk = len - sent;
+    if (chunk > wnd - used)
+      chunk = wnd - used;
+    if (chunk > (uint32_t)(TCP_MSS - tcb->tx_pending_len))
+      chunk = TCP_MSS - tcb->tx_pending_len;
+
+    memcpy(tcb->tx_pending + tcb->tx_pending_len, src + sent, chunk);
+    tcb->tx_pending_len += chunk;
+    sent += chunk;
+
+    // Nagle: full segment, TCP_NODELAY, ya kuch bhi unacked nahi -> abhi bhejo
+    if (tcb->tx_pending_len == TCP_MSS || tcb->nodelay ||
+        tcb->snd_una == tcb->snd_nxt)
+      tcp_flush_pending(tcb);
+  }
+
+  return sent;
 }
 
 /* ================= TCP READ DATA ================= */
@@ -363,26 +590,35 @@ extern "C" int tcp_read_data(tcp_tcb_t *tcb, void *buffer, uint16_t len) {
   if (!tcb)
     return -1;
 
-  uint16_t to_read = len < tcb->rx_len ? len : tcb->rx_len;
+  uint32_t to_read = len < tcb->rx_len ? len : tcb->rx_len;
   if (to_read > 0) {
+    uint16_t old_wnd = tcp_window_free(tcb);
     memcpy(buffer, tcb->rx_buffer, to_read);
     // Shift remaining data (manual memmove since overlapping)
-    uint16_t remaining = tcb->rx_len - to_read;
-    for (uint16_t i = 0; i < remaining; i++) {
+    uint32_t remaining = tcb->rx_len - to_read;
+    for (uint32_t i = 0; i < remaining; i++) {
       tcb->rx_buffer[i] = tcb->rx_buffer[to_read + i];
     }
     tcb->rx_len -= to_read;
+
+    // Window band ho gayi thi to peer ko batao ki jagah khul gayi hai
+    // (koi persist timer nahi hai, warna dono taraf atak jayenge)
+    if (old_wnd < TCP_MSS && tcp_window_free(tcb) >= TCP_MSS &&
+        (tcb->state == TCP_ESTABLISHED || tcb->state == TCP_FIN_WAIT_1 ||
+         tcb->state == TCP_FIN_WAIT_2))
+      tcp_send_segment(tcb, TCP_ACK, nullptr, 0);
   }
   return to_read;
 }
 
 /* ================= TCP CLOSE ================= */
 
-extern "C" void tcp_close(tcp_tcb_t *tcb) {
+extern "C" void tcp_shutdown(tcp_tcb_t *tcb) {
   if (!tcb)
     return;
 
-  if (tcb->state == TCP_ESTABLISHED) {
+  tcp_flush_pending(tcb);
+  if (tcb->state == TCP_ESTABLISHED || tcb->state == TCP_SYN_RECEIVED) {
     tcb->state = TCP_FIN_WAIT_1;
     serial_log("TCP: Closing connection (sending FIN)...");
     tcp_send_segment(tcb, TCP_FIN | TCP_ACK, nullptr, 0);
@@ -392,14 +628,138 @@ extern "C" void tcp_close(tcp_tcb_t *tcb) {
   }
 }
 
+extern "C" void tcp_close(tcp_tcb_t *tcb) {
+  if (!tcb || !tcb->used)
+    return;
+
+  tcb->owner = nullptr;
+  tcb->notify = nullptr;
+
+  if (tcb->state == TCP_LISTEN) {
+    // Listener band: jo children accept nahi hue unhe bhi band karo
+    for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+      if (tcp_table[i].used && tcp_table[i].parent == tcb) {
+        tcp_table[i].parent = nullptr;
+        tcp_close(&tcp_table[i]);
+      }
+    }
+    tcp_free_tcb(tcb);
+    return;
+  }
+
+  if (tcb->state == TCP_SYN_SENT)
+    tcb->state = TCP_CLOSED;
+  else
+    tcp_shutdown(tcb);
+
+  tcp_maybe_free(tcb);
+}
+
+/* ================= TCP OPTIONS ================= */
+
+extern "C" void tcp_set_owner(tcp_tcb_t *tcb, void *owner,
+                              tcp_notify_t notify) {
+  if (!tcb)
+    return;
+  tcb->owner = owner;
+  tcb->notify = notify;
+}
+
+extern "C" int tcp_set_rcvbuf(tcp_tcb_t *tcb, uint32_t size) {
+  if (!tcb)
+    return -1;
+  if (size < TCP_MSS)
+    size = TCP_MSS;
+  if (size > TCP_MAX_RCVBUF)
+    size = TCP_MAX_RCVBUF;
+  if (size < tcb->rx_len)
+    size = tcb->rx_len; // Pada hua data nahi phenk sakte
+
+  uint8_t *buf = (uint8_t *)kmalloc(size);
+  if (!buf)
+    return -1;
+  if (tcb->rx_len)
+    memcpy(buf, tcb->rx_buffer, tcb->rx_len);
+  kfree(tcb->rx_buffer);
+  tcb->rx_buffer = buf;
+  tcb->rx_capacity = size;
+  return 0;
+}
+
+extern "C" void tcp_set_sndbuf(tcp_tcb_t *tcb, uint32_t size) {
+  if (!tcb)
+    return;
+  tcb->snd_buf = size < TCP_MSS ? TCP_MSS : size;
+}
+
+extern "C" void tcp_set_nodelay(tcp_tcb_t *tcb, int on) {
+  if (!tcb)
+    return;
+  tcb->nodelay = on ? 1 : 0;
+  if (tcb->nodelay)
+    tcp_flush_pending(tcb);
+}
+
 /* ================= TCP STATE CHECK ================= */
 
 extern "C" int tcp_is_connected(tcp_tcb_t *tcb) {
   return tcb && tcb->state == TCP_ESTABLISHED;
 }
 
+extern "C" int tcp_is_connecting(tcp_tcb_t *tcb) {
+  return tcb && (tcb->state == TCP_SYN_SENT || tcb->state == TCP_SYN_RECEIVED);
+}
+
 extern "C" int tcp_has_data(tcp_tcb_t *tcb) { return tcb && tcb->rx_len > 0; }
 
+extern "C" uint32_t tcp_rx_available(tcp_tcb_t *tcb) {
+  return tcb ? tcb->rx_len : 0;
+}
+
+extern "C" uint32_t tcp_tx_space(tcp_tcb_t *tcb) {
+  if (!tcb ||
+      (tcb->state != TCP_ESTABLISHED && tcb->state != TCP_CLOSE_WAIT))
+    return 0;
+  uint32_t wnd = tcb->snd_wnd < tcb->snd_buf ? tcb->snd_wnd : tcb->snd_buf;
+  uint32_t used = (tcb->snd_nxt - tcb->snd_una) + tcb->tx_pending_len;
+  return used >= wnd ? 0 : wnd - used;
+}
+
+extern "C" int tcp_can_accept(tcp_tcb_t *tcb) {
+  return tcb && tcb->state == TCP_LISTEN && tcb->accept_count > 0;
+}
+
+extern "C" int tcp_peer_closed(tcp_tcb_t *tcb) {
+  return !tcb || tcb->peer_fin || tcb->state == TCP_CLOSED;
+}
+
+extern "C" int tcp_was_reset(tcp_tcb_t *tcb) { return tcb && tcb->reset; }
+
+extern "C" void tcp_get_endpoints(tcp_tcb_t *tcb, uint32_t *local_ip,
+                                  uint16_t *local_port, uint32_t *remote_ip,
+                                  uint16_t *remote_port) {
+  if (!tcb)
+    return;
+  if (local_ip)
+    *local_ip = tcb->local_ip;
+  if (local_port)
+    *local_port = tcp_ntohs(tcb->local_port);
+  if (remote_ip)
+    *remote_ip = tcb->remote_ip;
+  if (remote_port)
+    *remote_port = tcp_ntohs(tcb->remote_port);
+}
+
+extern "C" int tcp_port_in_use(uint16_t port) {
+  uint16_t nport = tcp_htons(port);
+  for (int i = 0; i < MAX_TCP_CONNECTIONS; i++) {
+    if (tcp_table[i].used && tcp_table[i].local_port == nport &&
+        !tcp_table[i].parent)
+      return 1;
+  }
+  return 0;
+}
+
 /* ================= TCP INIT ================= */
 
 extern "C" void tcp_init() {
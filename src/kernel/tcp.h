@@ -0,0 +1,65 @@
+// tcp.h - Kernel TCP interface
+// Socket layer (inet.cpp) aur tests isi se TCP ko chalate hain.
+#ifndef TCP_H
+#define TCP_H
+
+#include "../include/types.h"
+
+#define TCP_MSS 1400          // ip_send ke 1500 byte frame mein fit hota hai
+#define TCP_DEFAULT_RCVBUF 4096
+#define TCP_DEFAULT_SNDBUF 8192
+#define TCP_MAX_RCVBUF 65535  // No window scaling, so 16-bit window is the cap
+
+// Opaque control block (tcp.cpp ke andar defined)
+typedef struct tcp_tcb tcp_tcb_t;
+
+// Called from the net thread whenever the TCB state, rx data or send window
+// changes. Owner is whatever was passed to tcp_set_owner (usually socket_t).
+typedef void (*tcp_notify_t)(void *owner);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void tcp_init();
+
+// Active open. Ports are in host byte order.
+tcp_tcb_t *tcp_connect(uint32_t local_ip, uint16_t local_port,
+                       uint32_t remote_ip, uint16_t remote_port);
+// Passive open. local_ip 0 means INADDR_ANY.
+tcp_tcb_t *tcp_listen(uint32_t local_ip, uint16_t local_port, int backlog);
+// Pop one established child from a listener's accept queue (or null).
+tcp_tcb_t *tcp_accept(tcp_tcb_t *listener);
+
+void tcp_set_owner(tcp_tcb_t *tcb, void *owner, tcp_notify_t notify);
+int tcp_set_rcvbuf(tcp_tcb_t *tcb, uint32_t size);
+void tcp_set_sndbuf(tcp_tcb_t *tcb, uint32_t size);
+void tcp_set_nodelay(tcp_tcb_t *tcb, int on);
+
+// Returns bytes queued (may be short), 0 when the send window is full,
+// -1 when the connection can no longer send.
+int tcp_send_data(tcp_tcb_t *tcb, void *data, uint16_t len);
+int tcp_read_data(tcp_tcb_t *tcb, void *buffer, uint16_t len);
+
+// Send FIN but keep the TCB attached to its owner (shutdown(SHUT_WR)).
+void tcp_shutdown(tcp_tcb_t *tcb);
+// Detach owner and start/finish the close; the TCB must not be used after.
+void tcp_close(tcp_tcb_t *tcb);
+
+int tcp_is_connected(tcp_tcb_t *tcb);
+int tcp_is_connecting(tcp_tcb_t *tcb);
+int tcp_has_data(tcp_tcb_t *tcb);
+uint32_t tcp_rx_available(tcp_tcb_t *tcb);
+uint32_t tcp_tx_space(tcp_tcb_t *tcb);
+int tcp_can_accept(tcp_tcb_t *tcb);
+int tcp_peer_closed(tcp_tcb_t *tcb); // FIN received, no more data coming
+int tcp_was_reset(tcp_tcb_t *tcb);
+void tcp_get_endpoints(tcp_tcb_t *tcb, uint32_t *local_ip, uint16_t *local_port,
+                       uint32_t *remote_ip, uint16_t *remote_port);
+int tcp_port_in_use(uint16_t port);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,533 @@
+// ============================================================================
+// tmpfs.cpp - RAM filesystem for /tmp
+// File data PMM frames mein, do level radix tree se mapped: koi bhi offset
+// O(1) mein milta hai, bina likhe pages holes hain (sparse, zero padhte hain).
+// Directories ek global (parent, name) hash mein, inodes free list se.
+// ============================================================================
+
+#include "tmpfs.h"
+#include "../drivers/serial.h"
+#include "../include/errno.h"
+#include "../include/string.h"
+#include "heap.h"
+#include "memory.h"
+#include "paging.h"
+#include "pmm.h"
+#include "process.h"
+
+extern "C" {
+
+static tmpfs_inode_t tmpfs_inodes[TMPFS_MAX_INODES]; // 0 = koi inode nahi
+static tmpfs_dirent_t *tmpfs_hash[TMPFS_HASH_SIZE];
+static uint32_t tmpfs_free_head = 0;
+static uint32_t tmpfs_root = 0;
+static uint32_t tmpfs_frames = 0;
+static struct dirent tmpfs_dirent_buf;
+
+uint32_t tmpfs_used_pages() { return tmpfs_frames; }
+
+// ============================================================================
+// PAGES (radix tree)
+// ============================================================================
+
+// Zeroed frame, par kernel ke liye TMPFS_RESERVE_PAGES chhod ke
+static uint32_t tmpfs_frame() {
+  if (pmm_get_free_block_count() <= TMPFS_RESERVE_PAGES)
+    return 0;
+  void *p = pmm_alloc_block();
+  if (!p)
+    return 0;
+  memset((void *)PHYS_TO_VIRT(p), 0, 4096);
+  tmpfs_frames++;
+  return (uint32_t)(uintptr_t)p;
+}
+
+static void tmpfs_frame_free(uint32_t phys) {
+  pmm_free_block((void *)(uintptr_t)phys);
+  tmpfs_frames--;
+}
+
+static inline uint32_t *tmpfs_table(uint32_t phys) {
+  return (uint32_t *)PHYS_TO_VIRT(phys);
+}
+
+// Page index -> data frame. alloc = hole bharo (write). 0 = hole / OOM.
+static uint32_t tmpfs_page(tmpfs_inode_t *in, uint32_t index, bool alloc) {
+  if (!in->radix && (!alloc || !(in->radix = tmpfs_frame())))
+    return 0;
+  uint32_t *slot = &tmpfs_table(in->radix)[index / TMPFS_PTRS];
+  if (!*slot && (!alloc || !(*slot = tmpfs_frame())))
+    return 0;
+  slot = &tmpfs_table(*slot)[index % TMPFS_PTRS];
+  if (!*slot) {
+    if (!alloc || !(*slot = tmpfs_frame()))
+      return 0;
+    in->pages++;
+  }
+  return *slot;
+}
+
+// Index `first` se aage ke saare pages chhodo (truncate / delete)
+static void tmpfs_free_pages(tmpfs_inode_t *in, uint32_t first) {
+  if (!in->radix)
+    return;
+  uint32_t *l1 = tmpfs_table(in->radix);
+  for (uint32_t i = first / TMPFS_PTRS; i < TMPFS_PTRS; i++) {
+    if (!l1[i])
+      continue;
+    uint32_t *leaf = tmpfs_table(l1[i]);
+    uint32_t j = (i == first / TMPFS_PTRS) ? first % TMPFS_PTRS : 0;
+    for (; j < TMPFS_PTRS; j++) {
+      if (leaf[j]) {
+        tmpfs_frame_free(leaf[j]);
+        leaf[j] = 0;
+        in->pages--;
+      }
+    }
+    if (i * TMPFS_PTRS >= first) { // Poori leaf range gayi
+      tmpfs_frame_free(l1[i]);
+      l1[i] = 0;
+    }
+  }
+  if (first == 0) {
+    tmpfs_frame_free(in->radix);
+    in->radix = 0;
+  }
+}
+
+// ============================================================================
+// INODES
+// ============================================================================
+
+static uint32_t tmpfs_alloc_inode(uint8_t type, uint32_t mode) {
+  uint32_t ino = tmpfs_free_head;
+  if (!ino)
+    return 0;
+  tmpfs_inode_t *in = &tmpfs_inodes[ino];
+  tmpfs_free_head = in->next_free;
+
+  uint32_t gen = in->gen;
+  memset(in, 0, sizeof(*in));
+  in->gen = gen;
+  in->used = 1;
+  in->type = type;
+  in->mode = mode;
+  if (current_process) {
+    in->uid = current_process->euid;
+    in->gid = current_process->egid;
+  }
+  return ino;
+}
+
+static void tmpfs_free_inode(uint32_t ino) {
+  tmpfs_inode_t *in = &tmpfs_inodes[ino];
+  tmpfs_free_pages(in, 0);
+  in->used = 0;
+  in->gen++;
+  in->next_free = tmpfs_free_head;
+  tmpfs_free_head = ino;
+}
+
+// vfs node -> inode, agar woh abhi bhi wahi file hai
+static tmpfs_inode_t *tmpfs_get(vfs_node_t *node) {
+  if (!node || node->inode == 0 || node->inode >= TMPFS_MAX_INODES)
+    return nullptr;
+  tmpfs_inode_t *in = &tmpfs_inodes[node->inode];
+  if (!in->used || in->gen != (uint32_t)(uintptr_t)node->impl)
+    return nullptr;
+  return in;
+}
+
+// Is node ne inode ka open count liya hai. vfs_close bina open wale nodes
+// (exec, bmp loader) pe bhi close bulata hai - unka count nahi ghatna chahiye.
+#define TMPFS_NODE_OPENED 0x100
+
+// open/close hooks - har file description pe ek baar (fd_desc_put close
+// bulata hai). Unlink ke baad bhi khuli file chalti rahe, /tmp scratch jaisa.
+static void tmpfs_node_open(vfs_node_t *node) {
+  tmpfs_inode_t *in = tmpfs_get(node);
+  if (!in || (node->flags & TMPFS_NODE_OPENED))
+    return;
+  node->flags |= TMPFS_NODE_OPENED;
+  in->opens++;
+}
+
+static void tmpfs_node_close(vfs_node_t *node) {
+  if (!(node->flags & TMPFS_NODE_OPENED))
+    return;
+  node->flags &= ~TMPFS_NODE_OPENED;
+  tmpfs_inode_t *in = tmpfs_get(node);
+  if (!in || !in->opens)
+    return;
+  if (--in->opens == 0 && in->nlink == 0)
+    tmpfs_free_inode((uint32_t)node->inode);
+}
+
+static vfs_node_t *tmpfs_node(uint32_t ino, const char *name,
+                              vfs_node_t *parent) {
+  tmpfs_inode_t *in = &tmpfs_inodes[ino];
+  vfs_node_t *node = (vfs_node_t *)kmalloc(sizeof(vfs_node_t));
+  if (!node)
+    return nullptr;
+  memset(node, 0, sizeof(vfs_node_t));
+  strncpy(node->name, name, 255);
+  node->type = (in->type == TMPFS_DIR) ? VFS_DIRECTORY : VFS_FILE;
+  node->flags = (in->type == TMPFS_DIR) ? 0x02 : 0x01;
+  node->inode = ino;
+  node->size = in->size;
+  node->mask = in->mode;
+  node->uid = in->uid;
+  node->gid = in->gid;
+  node->ref_count = 1;
+  node->parent = parent;
+  node->fs = &tmpfs;
+  node->impl = (void *)(uintptr_t)in->gen;
+  node->open = tmpfs_node_open;
+  node->close = tmpfs_node_close;
+  return node;
+}
+
+// ============================================================================
+// DIRECTORIES (hashed)
+// ============================================================================
+
+static uint32_t tmpfs_name_hash(uint32_t dir, const char *name) {
+  uint32_t h = 2166136261u ^ dir;
+  while (*name)
+    h = (h ^ (uint8_t)*name++) * 16777619u;
+  return h;
+}
+
+static tmpfs_dirent_t *tmpfs_find(uint32_t dir, const char *name) {
+  uint32_t h = tmpfs_name_hash(dir, name);
+  for (tmpfs_dirent_t *d = tmpfs_hash[h % TMPFS_HASH_SIZE]; d; d = d->hnext)
+    if (d->hash == h && d->parent == dir && strcmp(d->name, name) == 0)
+      return d;
+  return nullptr;
+}
+
+static void tmpfs_hash_insert(tmpfs_dirent_t *d) {
+  d->hash = tmpfs_name_hash(d->parent, d->name);
+  tmpfs_dirent_t **b = &tmpfs_hash[d->hash % TMPFS_HASH_SIZE];
+  d->hnext = *b;
+  *b = d;
+}
+
+static void tmpfs_hash_remove(tmpfs_dirent_t *d) {
+  tmpfs_dirent_t **pp = &tmpfs_hash[d->hash % TMPFS_HASH_SIZE];
+  while (*pp && *pp != d)
+    pp = &(*pp)->hnext;
+  if (*pp)
+    *pp = d->hnext;
+}
+
+static int tmpfs_link(uint32_t dir, const char *name, uint32_t ino) {
+  tmpfs_dirent_t *d = (tmpfs_dirent_t *)kmalloc(sizeof(tmpfs_dirent_t));
+  if (!d)
+    return -ENOMEM;
+  strcpy(d->name, name);
+  d->parent = dir;
+  d->ino = ino;
+  tmpfs_hash_insert(d);
+
+  tmpfs_inode_t *p = &tmpfs_inodes[dir];
+  d->next = nullptr;
+  d->prev = p->last;
+  if (p->last)
+    p->last->next = d;
+  else
+    p->first = d;
+  p->last = d;
+  p->entries++;
+  tmpfs_inodes[ino].nlink++;
+  return 0;
+}
+
+// Entry hatao; inode ka aakhri link tha toh inode bhi - par koi descriptor
+// abhi khula hai toh data aakhri close (tmpfs_node_close) tak rehta hai
+static void tmpfs_unlink_dirent(tmpfs_dirent_t *d) {
+  tmpfs_inode_t *p = &tmpfs_inodes[d->parent];
+  tmpfs_hash_remove(d);
+  if (d->prev)
+    d->prev->next = d->next;
+  else
+    p->first = d->next;
+  if (d->next)
+    d->next->prev = d->prev;
+  else
+    p->last = d->prev;
+  p->entries--;
+  p->rd_cursor = nullptr;
+
+  tmpfs_inode_t *in = &tmpfs_inodes[d->ino];
+  if (--in->nlink == 0 && in->opens == 0)
+    tmpfs_free_inode(d->ino);
+  kfree(d);
+}
+
+static int tmpfs_check_name(const char *name) {
+  if (!name || !name[0] || strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+    return -EINVAL;
+  if (strlen(name) >= TMPFS_NAME_MAX)
+    return -ENAMETOOLONG;
+  return 0;
+}
+
+static int tmpfs_make(vfs_node_t *parent, const char *name, uint8_t type,
+                      uint32_t mode) {
+  tmpfs_inode_t *dir = tmpfs_get(parent);
+  if (!dir)
+    return -ENOENT;
+  if (dir->type != TMPFS_DIR)
+    return -ENOTDIR;
+  int ret = tmpfs_check_name(name);
+  if (ret < 0)
+    return ret;
+  if (tmpfs_find(parent->inode, name))
+    return -EEXIST;
+
+  uint32_t ino = tmpfs_alloc_inode(type, mode);
+  if (!ino)
+    return -ENOSPC;
+  ret = tmpfs_link(parent->inode, name, ino);
+  if (ret < 0)
+    tmpfs_free_inode(ino);
+  return ret;
+}
+
+// ============================================================================
+// VFS CONTRACT
+// ============================================================================
+
+static vfs_node_t *tmpfs_mount(struct filesystem *fs, void *device) {
+  (void)fs;
+  (void)device;
+  if (!tmpfs_root) {
+    // Free list: 1 sabse pehle
+    for (uint32_t i = TMPFS_MAX_INODES - 1; i > 0; i--) {
+      tmpfs_inodes[i].next_free = tmpfs_free_head;
+      tmpfs_free_head = i;
+    }
+    tmpfs_root = tmpfs_alloc_inode(TMPFS_DIR, 01777);
+    tmpfs_inodes[tmpfs_root].nlink = 1;
+    serial_log("TMPFS: Ready");
+  }
+  return tmpfs_node(tmpfs_root, "tmp", nullptr);
+}
+
+static vfs_node_t *tmpfs_lookup(vfs_node_t *dir, const char *name) {
+  if (!tmpfs_get(dir))
+    return nullptr;
+  tmpfs_dirent_t *d = tmpfs_find(dir->inode, name);
+  return d ? tmpfs_node(d->ino, name, dir) : nullptr;
+}
+
+static int tmpfs_create(vfs_node_t *parent, const char *name, int type) {
+  return tmpfs_make(parent, name,
+                    (type == VFS_DIRECTORY) ? TMPFS_DIR : TMPFS_FILE, 0644);
+}
+
+static int tmpfs_mkdir(vfs_node_t *parent, const char *name, uint32_t mode) {
+  return tmpfs_make(parent, name, TMPFS_DIR, mode);
+}
+
+static int tmpfs_read(vfs_node_t *file, uint64_t offset, void *buffer,
+                      uint64_t size) {
+  tmpfs_inode_t *in = tmpfs_get(file);
+  if (!in)
+    return -ENOENT;
+  if (in->type != TMPFS_FILE)
+    return -EISDIR;
+  file->size = in->size;
+  if (offset >= in->size)
+    return 0;
+  if (size > in->size - offset)
+    size = in->size - offset;
+  if (size > 0x7FFFFFFF)
+    size = 0x7FFFFFFF;
+
+  uint8_t *dst = (uint8_t *)buffer;
+  uint32_t len = (uint32_t)size, done = 0;
+  while (done < len) {
+    uint64_t pos = offset + done;
+    uint32_t in_page = (uint32_t)pos & 0xFFF;
+    uint32_t n = 4096 - in_page;
+    if (n > len - done)
+      n = len - done;
+    uint32_t phys = tmpfs_page(in, (uint32_t)(pos >> 12), false);
+    if (phys)
+      memcpy(dst + done, (uint8_t *)PHYS_TO_VIRT(phys) + in_page, n);
+    else
+      memset(dst + done, 0, n); // Hole
+    done += n;
+  }
+  return (int)done;
+}
+
+static int tmpfs_write(vfs_node_t *file, uint64_t offset, const void *buffer,
+                       uint64_t size) {
+  tmpfs_inode_t *in = tmpfs_get(file);
+  if (!in)
+    return -ENOENT;
+  if (in->type != TMPFS_FILE)
+    return -EISDIR;
+  if (offset >= TMPFS_MAX_FILE_SIZE)
+    return -EFBIG;
+  if (size > TMPFS_MAX_FILE_SIZE - offset)
+    size = TMPFS_MAX_FILE_SIZE - offset;
+  if (size > 0x7FFFFFFF)
+    size = 0x7FFFFFFF;
+
+  const uint8_t *src = (const uint8_t *)buffer;
+  uint32_t len = (uint32_t)size, done = 0;
+  while (done < len) {
+    uint64_t pos = offset + done;
+    uint32_t in_page = (uint32_t)pos & 0xFFF;
+    uint32_t n = 4096 - in_page;
+    if (n > len - done)
+      n = len - done;
+    uint32_t phys = tmpfs_page(in, (uint32_t)(pos >> 12), true);
+    if (!phys)
+      break;
+    memcpy((uint8_t *)PHYS_TO_VIRT(phys) + in_page, src + done, n);
+    done += n;
+  }
+  if (done == 0 && len)
+    return -ENOSPC;
+  if (offset + done > in->size)
+    in->size = offset + done;
+  file->size = in->size;
+  return (int)done;
+}
+
+static struct dirent *tmpfs_readdir(vfs_node_t *dir, uint32_t index) {
+  tmpfs_inode_t *in = tmpfs_get(dir);
+  if (!in || in->type != TMPFS_DIR)
+    return nullptr;
+
+  // ls index 0, 1, 2... maangta hai - pichli jagah se aage badho
+  tmpfs_dirent_t *d;
+  uint32_t i;
+  if (in->rd_cursor && in->rd_index <= index) {
+    d = in->rd_cursor;
+    i = in->rd_index;
+  } else {
+    d = in->first;
+    i = 0;
+  }
+  for (; d && i < index; i++)
+    d = d->next;
+  in->rd_cursor = d;
+  in->rd_index = i;
+  if (!d)
+    return nullptr;
+
+  tmpfs_dirent_buf.d_ino = d->ino;
+  strncpy(tmpfs_dirent_buf.d_name, d->name, 255);
+  tmpfs_dirent_buf.d_type =
+      (tmpfs_inodes[d->ino].type == TMPFS_DIR) ? 0x02 : 0x01;
+  return &tmpfs_dirent_buf;
+}
+
+static int tmpfs_unlink(vfs_node_t *parent, const char *name) {
+  if (!tmpfs_get(parent))
+    return -ENOENT;
+  tmpfs_dirent_t *d = tmpfs_find(parent->inode, name);
+  if (!d)
+    return -ENOENT;
+  if (tmpfs_inodes[d->ino].type == TMPFS_DIR)
+    return -EISDIR;
+  tmpfs_unlink_dirent(d);
+  return 0;
+}
+
+static int tmpfs_rmdir(vfs_node_t *parent, const char *name) {
+  if (!tmpfs_get(parent))
+    return -ENOENT;
+  tmpfs_dirent_t *d = tmpfs_find(parent->inode, name);
+  if (!d)
+    return -ENOENT;
+  tmpfs_inode_t *in = &tmpfs_inodes[d->ino];
+  if (in->type != TMPFS_DIR)
+    return -ENOTDIR;
+  if (in->entries)
+    return -ENOTEMPTY;
+  tmpfs_unlink_dirent(d);
+  return 0;
+}
+
+static int tmpfs_rename(vfs_node_t *parent, const char *old_name,
+                        const char *new_name) {
+  if (!tmpfs_get(parent))
+    return -ENOENT;
+  tmpfs_dirent_t *d = tmpfs_find(parent->inode, old_name);
+  if (!d)
+    return -ENOENT;
+  int ret = tmpfs_check_name(new_name);
+  if (ret < 0)
+    return ret;
+  if (strcmp(old_name, new_name) == 0)
+    return 0;
+
+  // Target pehle se hai toh usko replace karo (POSIX rename)
+  tmpfs_dirent_t *old = tmpfs_find(parent->inode, new_name);
+  if (old) {
+    tmpfs_inode_t *src = &tmpfs_inodes[d->ino];
+    tmpfs_inode_t *dst = &tmpfs_inodes[old->ino];
+    if (dst->type == TMPFS_DIR && src->type != TMPFS_DIR)
+      return -EISDIR;
+    if (dst->type != TMPFS_DIR && src->type == TMPFS_DIR)
+      return -ENOTDIR;
+    if (dst->type == TMPFS_DIR && dst->entries)
+      return -ENOTEMPTY;
+    tmpfs_unlink_dirent(old);
+  }
+
+  tmpfs_hash_remove(d);
+  strcpy(d->name, new_name);
+  tmpfs_hash_insert(d);
+  return 0;
+}
+
+static int tmpfs_truncate(vfs_node_t *file, uint64_t length) {
+  tmpfs_inode_t *in = tmpfs_get(file);
+  if (!in)
+    return -ENOENT;
+  if (in->type != TMPFS_FILE)
+    return -EISDIR;
+  if (length > TMPFS_MAX_FILE_SIZE)
+    return -EFBIG;
+
+  if (length < in->size) {
+    // Aadha page bacha toh uski poonch zero karo (baad mein extend = zero)
+    uint32_t tail = (uint32_t)length & 0xFFF;
+    uint32_t first = (uint32_t)((length + 0xFFF) >> 12);
+    if (tail) {
+      uint32_t phys = tmpfs_page(in, (uint32_t)(length >> 12), false);
+      if (phys)
+        memset((uint8_t *)PHYS_TO_VIRT(phys) + tail, 0, 4096 - tail);
+    }
+    tmpfs_free_pages(in, first);
+  }
+  in->size = length; // Bada karna = sparse, koi page nahi
+  file->size = length;
+  return 0;
+}
+
+struct filesystem tmpfs = {
+    .name = "tmpfs",
+    .mount = tmpfs_mount,
+    .lookup = tmpfs_lookup,
+    .create = tmpfs_create,
+    .read = tmpfs_read,
+    .write = tmpfs_write,
+    .close = 0,
+    .readdir = tmpfs_readdir,
+    .mkdir = tmpfs_mkdir,
+    .unlink = tmpfs_unlink,
+    .rmdir = tmpfs_rmdir,
+    .rename = tmpfs_rename,
+    .truncate = tmpfs_truncate,
+};
+
+} // extern "C"
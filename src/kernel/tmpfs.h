@@ -0,0 +1,62 @@
+// tmpfs - RAM-speed scratch filesystem (/tmp pe mount hota hai)
+#ifndef TMPFS_H
+#define TMPFS_H
+
+#include "../include/types.h"
+#include "../include/vfs.h"
+
+#define TMPFS_MAX_INODES 2048
+#define TMPFS_NAME_MAX 128
+#define TMPFS_HASH_SIZE 512 // Saari directories ka ek (parent, name) hash
+#define TMPFS_PTRS 1024     // Ek radix table page mein entries
+// Do level radix: 1024 * 1024 pages = 4GB tak ki file
+#define TMPFS_MAX_FILE_SIZE ((uint64_t)TMPFS_PTRS * TMPFS_PTRS * 4096)
+// Itne PMM frames hamesha kernel ke liye chhod do (16MB)
+#define TMPFS_RESERVE_PAGES 4096
+
+#define TMPFS_FILE 1
+#define TMPFS_DIR 2
+
+typedef struct tmpfs_dirent {
+  char name[TMPFS_NAME_MAX];
+  uint32_t hash;
+  uint32_t parent; // Directory ka inode
+  uint32_t ino;
+  struct tmpfs_dirent *hnext;       // Hash chain
+  struct tmpfs_dirent *prev, *next; // Directory ke andar order (readdir)
+} tmpfs_dirent_t;
+
+typedef struct tmpfs_inode {
+  uint8_t used;
+  uint8_t type;
+  uint16_t nlink;
+  uint32_t opens; // Khule descriptors - nlink 0 pe bhi data tab tak rehta hai
+  uint32_t gen; // Free pe badhta hai - purane vfs nodes isse pakde jaate hain
+  uint32_t mode, uid, gid;
+  uint64_t size;
+  uint32_t pages; // Data frames (sparse holes nahi gine jaate)
+  uint32_t radix; // Level 1 table ka phys (0 = koi page nahi)
+
+  // Directory
+  tmpfs_dirent_t *first, *last;
+  uint32_t entries;
+  tmpfs_dirent_t *rd_cursor; // Sequential readdir: pichla index yaad rakho
+  uint32_t rd_index;
+
+  uint32_t next_free; // Free list (O(1) alloc)
+} tmpfs_inode_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern struct filesystem tmpfs;
+
+// Kitne data/table frames tmpfs ke paas hain
+uint32_t tmpfs_used_pages();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TMPFS_H
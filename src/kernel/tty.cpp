@@ -1,6 +1,7 @@
 // TTY - Terminal ka poora implementation yahan hai
 #include "tty.h"
 #include "../drivers/serial.h"
+#include "../include/poll.h"
 #include "../include/signal.h"
 #include "../include/string.h"
 #include "heap.h"
@@ -132,6 +133,17 @@ void tty_set_flags(tty_t *tty, uint32_t flags) {
     tty->flags = flags;
 }
 
+int tty_poll(tty_t *tty, poll_table_t *pt) {
+  if (!tty)
+    return POLLNVAL;
+  poll_wait(&tty->read_wait, pt);
+
+  int mask = POLLOUT | POLLWRNORM; // Output kabhi block nahi hota
+  if ((tty->flags & TTY_CANON) ? tty->line_ready : tty->input_count > 0)
+    mask |= POLLIN | POLLRDNORM;
+  return mask;
+}
+
 // Basic kernel shell command executor
 // console_execute removed
 
@@ -62,6 +62,9 @@ void tty_input_char(tty_t *tty, char c);
 // Set TTY flags
 void tty_set_flags(tty_t *tty, uint32_t flags);
 
+// Readiness for poll/select/epoll (POLLIN jab line/char ready ho)
+int tty_poll(tty_t *tty, poll_table_t *pt);
+
 #ifdef __cplusplus
 }
 #endif
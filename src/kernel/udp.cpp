@@ -3,7 +3,9 @@
 
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "checksum.h"
 #include "net.h"
+#include "socket.h"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,48 +28,6 @@ typedef void (*udp_handler_t)(uint32_t src_ip, uint16_t src_port, uint8_t *data,
 
 static udp_handler_t udp_port_table[UDP_MAX_PORTS];
 
-/* ===================== CHECKSUM ===================== */
-
-struct udp_pseudo_header {
-  uint32_t src_ip;
-  uint32_t dst_ip;
-  uint8_t zero;
-  uint8_t protocol;
-  uint16_t udp_length;
-} __attribute__((packed));
-
-static uint16_t udp_checksum(uint32_t src_ip, uint32_t dst_ip, udp_hdr *udp,
-                             uint8_t *payload, uint16_t payload_len) {
-  uint32_t sum = 0;
-
-  udp_pseudo_header pseudo;
-  pseudo.src_ip = src_ip;
-  pseudo.dst_ip = dst_ip;
-  pseudo.zero = 0;
-  pseudo.protocol = 17; // UDP
-  pseudo.udp_length = udp->len;
-
-  uint16_t *ptr = (uint16_t *)&pseudo;
-  for (size_t i = 0; i < sizeof(pseudo) / 2; i++)
-    sum += udp_ntohs(ptr[i]);
-
-  ptr = (uint16_t *)udp;
-  for (size_t i = 0; i < sizeof(udp_hdr) / 2; i++)
-    sum += udp_ntohs(ptr[i]);
-
-  ptr = (uint16_t *)payload;
-  for (size_t i = 0; i < payload_len / 2; i++)
-    sum += udp_ntohs(ptr[i]);
-
-  if (payload_len & 1)
-    sum += payload[payload_len - 1] << 8;
-
-  while (sum >> 16)
-    sum = (sum & 0xFFFF) + (sum >> 16);
-
-  return udp_htons(~sum);
-}
-
 /* ===================== PUBLIC API ===================== */
 
 extern "C" void udp_bind(uint16_t port, udp_handler_t handler) {
@@ -108,6 +68,10 @@ extern "C" void udp_receive(uint32_t src_ip, uint32_t dst_ip, uint8_t *packet,
   uint8_t *payload = packet + sizeof(udp_hdr);
   uint16_t payload_len = udp_len - sizeof(udp_hdr);
 
+  // Pehle user sockets (AF_INET SOCK_DGRAM), phir kernel port handlers
+  if (inet_udp_input(src_ip, dst_ip, src_port, dst_port, payload, payload_len))
+    return;
+
   if (dst_port >= UDP_MAX_PORTS || !udp_port_table[dst_port]) {
     serial_log("UDP: No handler for this port");
     return;
@@ -118,9 +82,11 @@ extern "C" void udp_receive(uint32_t src_ip, uint32_t dst_ip, uint8_t *packet,
 
 /* ===================== TX API ===================== */
 
-// Forward declaration - must be implemented in net.cpp
-extern "C" void ip_send(uint32_t dst_ip, uint8_t protocol, uint8_t *data,
-                        uint16_t length);
+// Forward declaration - must be implemented in net.cpp. Checksum field mein
+// pseudo-header seed jaata hai, baaki NIC offload ya software fallback.
+extern "C" void ip_send_csum(uint32_t src_ip, uint32_t dst_ip,
+                             uint8_t protocol, uint8_t *data, uint16_t length,
+                             uint16_t csum_off);
 
 extern "C" void udp_send(uint32_t src_ip, uint16_t src_port, uint32_t dst_ip,
                          uint16_t dst_port, uint8_t *data, uint16_t length) {
@@ -137,15 +103,13 @@ extern "C" void udp_send(uint32_t src_ip, uint16_t src_port, uint32_t dst_ip,
   udp->src = udp_htons(src_port);
   udp->dst = udp_htons(dst_port);
   udp->len = udp_htons(total_len);
-  udp->checksum = 0;
+  udp->checksum = csum_pseudo_seed(src_ip, dst_ip, total_len, 17);
 
   memcpy(buffer + sizeof(udp_hdr), data, length);
 
-  udp->checksum =
-      udp_checksum(src_ip, dst_ip, udp, buffer + sizeof(udp_hdr), length);
-
   serial_log_hex("UDP: Sending packet to port ", dst_port);
-  ip_send(dst_ip, 17, buffer, total_len);
+  ip_send_csum(src_ip, dst_ip, 17, buffer, total_len,
+               offsetof(udp_hdr, checksum));
 }
 
 /* ===================== INIT ===================== */
@@ -1,11 +1,14 @@
 #include "../include/vfs.h"
 #include "../drivers/serial.h"
+#include "../include/epoll.h"
 #include "../include/kernel_fs.h"
 #include "../include/kernel_fs_phase3.h"
 #include "../include/kernel_vfs_phase4.h"
 #include "../include/string.h"
+#include "elf_loader.h"
 #include "heap.h"
 #include "memory.h"
+#include "tmpfs.h"
 
 extern "C" {
 
@@ -112,11 +115,18 @@ struct dirent *ramfs_readdir(vfs_node_t *dir, uint32_t index) {
 }
 
 struct filesystem fs_ram = {.name = "ramfs",
+                            .mount = 0,
                             .lookup = ramfs_lookup,
                             .create = ramfs_create,
                             .read = ramfs_read,
                             .write = ramfs_write,
-                            .readdir = ramfs_readdir};
+                            .close = 0,
+                            .readdir = ramfs_readdir,
+                            .mkdir = 0,
+                            .unlink = 0,
+                            .rmdir = 0,
+                            .rename = 0,
+                            .truncate = 0};
 
 extern "C" int phase_create_in_dir(void *pdir, const char *name, int type);
 
@@ -129,9 +139,18 @@ static int vfs_phase_a_mkdir_bridge(vfs_node_t *parent, const char *name,
 
 struct filesystem fs_phase_a = {
     .name = "phase_a_authority",
+    .mount = 0,
     .lookup = vfs_phase_a_lookup,
     .create = vfs_phase_a_create_bridge,
+    .read = 0,
+    .write = 0,
+    .close = 0,
+    .readdir = 0,
     .mkdir = vfs_phase_a_mkdir_bridge,
+    .unlink = 0,
+    .rmdir = 0,
+    .rename = 0,
+    .truncate = 0,
 };
 
 // ============================================================================
@@ -142,9 +161,12 @@ void vfs_mount(const char *path, struct filesystem *fs, void *device) {
   if (mount_count >= MAX_MOUNTS)
     return;
 
-  // Create root for this mount
-  vfs_node_t *root = alloc_node("root", VFS_DIRECTORY);
-  root->fs = fs;
+  // Create root for this mount (FS apna root de sakta hai)
+  vfs_node_t *root = fs->mount ? fs->mount(fs, device) : 0;
+  if (!root) {
+    root = alloc_node("root", VFS_DIRECTORY);
+    root->fs = fs;
+  }
 
   strncpy(mounts[mount_count].path, path, 255);
   mounts[mount_count].fs = fs;
@@ -255,12 +277,46 @@ static int vfs_phase_a_mkdir_bridge(vfs_node_t *parent, const char *name,
   return vfs_phase_a_create_bridge(parent, name, 0x02); // VFS_DIRECTORY = 2
 }
 
+// Absolute path kisi mount ke neeche hai? Sabse lamba prefix jeetta hai.
+// "/" ka mount vfs_root hi hai, woh yahan nahi aata.
+static vfs_node_t *vfs_mount_lookup(const char *path, const char **rest) {
+  struct mount_point *best = 0;
+  int best_len = 0;
+  for (int i = 0; i < mount_count; i++) {
+    int len = strlen(mounts[i].path);
+    if (len <= 1 || len <= best_len)
+      continue;
+    if (strncmp(path, mounts[i].path, len) == 0 &&
+        (path[len] == 0 || path[len] == '/')) {
+      best = &mounts[i];
+      best_len = len;
+    }
+  }
+  if (!best)
+    return 0;
+  *rest = path + best_len;
+  return best->root;
+}
+
 vfs_node_t *vfs_resolve_path_relative(vfs_node_t *base, const char *path) {
   if (!path)
     return 0;
 
+  // Mount ke neeche ka path us mount ke root se chalta hai
+  vfs_node_t *current = base;
+  const char *rest = 0;
+  vfs_node_t *mount_root = (path[0] == '/') ? vfs_mount_lookup(path, &rest) : 0;
+  if (mount_root) {
+    if (!rest[0] || strcmp(rest, "/") == 0) {
+      mount_root->ref_count++; // Caller ka vfs_close root free na kare
+      return mount_root;
+    }
+    current = mount_root;
+    path = rest;
+  }
+
   // Try Phase A (Authority Layer) first for absolute paths
-  if (path[0] == '/') {
+  if (!mount_root && path[0] == '/') {
     // Optimization: Don't resolve root node as wrapped, use vfs_root (FAT16)
     // for / so lookups can still find things on the physical disk.
     if (strcmp(path, "/") == 0) {
@@ -275,8 +331,9 @@ vfs_node_t *vfs_resolve_path_relative(vfs_node_t *base, const char *path) {
     }
   }
 
-  vfs_node_t *current = base;
-  if (path[0] == '/') {
+  if (mount_root) {
+    // current = mount ka root
+  } else if (path[0] == '/') {
     current = vfs_root; // Absolute path
   } else if (!current) {
     current = vfs_root; // Fallback
@@ -339,10 +396,44 @@ int vfs_read(vfs_node_t *node, uint64_t offset, void *buf, uint64_t size) {
   return 0;
 }
 
+// Pichla read jahan khatam hua wahin se shuru = sequential: window dugni
+// (VFS_RA_MAX tak) aur reader se ek window aage tak background read maango.
+// Kahin aur se = random access: window band.
+int vfs_read_ra(vfs_node_t *node, file_ra_state_t *ra, uint64_t offset,
+                void *buf, uint64_t size) {
+  int n = vfs_read(node, offset, buf, size);
+  if (!node || !ra || !node->readahead || n <= 0)
+    return n;
+
+  if (offset == ra->next) {
+    ra->window = ra->window ? ra->window * 2 : VFS_RA_MIN;
+    if (ra->window > VFS_RA_MAX)
+      ra->window = VFS_RA_MAX;
+  } else {
+    ra->window = 0;
+    ra->issued = 0;
+  }
+  ra->next = offset + n;
+
+  if (ra->window) {
+    uint64_t end = ra->next + ra->window;
+    uint64_t from = ra->issued > ra->next ? ra->issued : ra->next;
+    // Aadhi window khaali ho tab naya batch - har read pe chhota request nahi
+    if (from < end && end - from >= ra->window / 2 && end <= 0xFFFFFFFF) {
+      node->readahead(node, (uint32_t)from, (uint32_t)(end - from));
+      ra->issued = end;
+    }
+  }
+  return n;
+}
+
 int vfs_write(vfs_node_t *node, uint64_t offset, const void *buf,
               uint64_t size) {
   if (!node)
     return 0;
+  int busy = elf_image_invalidate_node(node); // Chalti binary - ETXTBSY
+  if (busy < 0)
+    return busy;
   if (node->write)
     return node->write(node, (uint32_t)offset, (uint32_t)size,
                        (uint8_t *)buf); // Wrapped pointer
@@ -485,6 +576,9 @@ void vfs_init() {
 
   vfs_dev = vfs_resolve_path("/dev"); // Cache dev root
 
+  // Scratch files RAM mein (phase A / FAT16 se alag)
+  vfs_mount("/tmp", &tmpfs, 0);
+
 #include "../include/kernel_vfs_phase4.h"
 
   // ... inside vfs_init ...
@@ -553,6 +647,10 @@ int vfs_unlink(const char *path) {
   if (!node->parent)
     return -1; // Cannot unlink root
 
+  int busy = elf_image_invalidate_node(node);
+  if (busy < 0)
+    return busy;
+  elf_image_invalidate_name(path);
   if (node->parent->unlink)
     return node->parent->unlink(node->parent, node->name);
   if (node->parent->fs && node->parent->fs->unlink)
@@ -566,6 +664,7 @@ void vfs_close(vfs_node_t *node) {
     return;
   node->ref_count--;
   if (node->ref_count == 0 && node != vfs_root && node != vfs_dev) {
+    epoll_node_release(node);
     if (node->close)
       node->close(node);
     if (node->fs && node->fs->close)
@@ -620,6 +719,14 @@ int vfs_rename(const char *oldpath, const char *newpath) {
   if (!parent)
     return -1;
 
+  // Naye naam pe chalti binary thi toh rename use hata dega - ETXTBSY
+  vfs_node_t *target = vfs_resolve_path(newpath);
+  int busy = target ? elf_image_invalidate_node(target) : 0;
+  if (busy < 0)
+    return busy;
+  // Dono naam: purana ab kuch nahi, naye pe doosri file aa gayi
+  elf_image_invalidate_name(oldpath);
+  elf_image_invalidate_name(newpath);
   if (parent->rename)
     return parent->rename(parent, old_name, new_name);
   if (parent->fs && parent->fs->rename)
@@ -629,6 +736,11 @@ int vfs_rename(const char *oldpath, const char *newpath) {
 }
 
 int unlink_vfs(vfs_node_t *node, const char *name) {
+  vfs_node_t *target = vfs_resolve_path_relative(node, name);
+  int busy = target ? elf_image_invalidate_node(target) : 0;
+  if (busy < 0)
+    return busy;
+  elf_image_invalidate_name(name);
   if (node->fs && node->fs->unlink)
     return node->fs->unlink(node, name);
   return -1;
@@ -1,11 +1,20 @@
 #include "vm.h"
 #include "../drivers/serial.h"
 #include "../include/string.h"
+#include "elf_loader.h"
 #include "paging.h"
 #include "pmm.h"
 
 extern uint32_t *kernel_directory;
 
+// PTE hat raha hai: private frame free, shared (page cache) frame ka sirf ref
+static void vm_release_frame(uint32_t pte) {
+  if (pte & PTE_SHARED)
+    elf_page_put(pte & 0xFFFFF000);
+  else
+    pmm_free_block((void *)(uintptr_t)(pte & 0xFFFFF000));
+}
+
 uint32_t *pd_create() {
   uint32_t phys_pd = (uint32_t)pmm_alloc_block();
   uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(phys_pd);
@@ -39,7 +48,11 @@ uint32_t *pd_clone(uint32_t *source_pd_phys) {
     new_pd[i] = phys_dest_pt | (source_pd[i] & 0xFFF);
 
     for (int j = 0; j < 1024; j++) {
-      if (src_pt[j] & 1) {
+      if ((src_pt[j] & 1) && (src_pt[j] & PTE_SHARED)) {
+        // Exec page cache ka frame: copy nahi, bas ek aur PTE
+        dest_pt[j] = src_pt[j];
+        elf_page_share(src_pt[j]);
+      } else if (src_pt[j] & 1) {
         uint32_t src_phys = src_pt[j] & 0xFFFFF000;
         uint32_t dest_phys = (uint32_t)pmm_alloc_block();
 
@@ -63,7 +76,7 @@ void pd_destroy(uint32_t *pd_phys) {
     uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[i] & 0xFFFFF000);
     for (int j = 0; j < 1024; j++) {
       if (pt[j] & 1) {
-        pmm_free_block((void *)(pt[j] & 0xFFFFF000));
+        vm_release_frame(pt[j]);
       }
     }
     pmm_free_block((void *)VIRT_TO_PHYS(pt));
@@ -113,6 +126,18 @@ uint32_t vm_get_phys(uint32_t virt) {
   return (pt[pt_index] & 0xFFFFF000) + (virt & 0xFFF);
 }
 
+uint32_t *vm_get_pte(uint32_t virt) {
+  uint32_t phys_pd;
+  asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
+  uint32_t *pd = (uint32_t *)PHYS_TO_VIRT(phys_pd);
+
+  uint32_t pd_index = virt >> 22;
+  if (!(pd[pd_index] & 1))
+    return 0;
+  uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[pd_index] & 0xFFFFF000);
+  return &pt[(virt >> 12) & 0x03FF];
+}
+
 void vm_unmap_page(uint32_t virt) {
   uint32_t phys_pd;
   asm volatile("mov %%cr3, %0" : "=r"(phys_pd));
@@ -125,7 +150,7 @@ void vm_unmap_page(uint32_t virt) {
     return;
   uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[pd_index] & 0xFFFFF000);
   if (pt[pt_index] & 1) {
-    pmm_free_block((void *)(pt[pt_index] & 0xFFFFF000));
+    vm_release_frame(pt[pt_index]);
     pt[pt_index] = 0;
   }
   asm volatile("invlpg (%0)" ::"r"(virt) : "memory");
@@ -141,7 +166,7 @@ void vm_clear_user_mappings() {
       uint32_t *pt = (uint32_t *)PHYS_TO_VIRT(pd[i] & 0xFFFFF000);
       for (int j = 0; j < 1024; j++) {
         if (pt[j] & 1) {
-          pmm_free_block((void *)(uintptr_t)(pt[j] & 0xFFFFF000));
+          vm_release_frame(pt[j]);
           pt[j] = 0;
         }
       }
@@ -26,6 +26,9 @@ void vm_unmap_page(uint32_t virt);
 // Get physical address for virtual, returns 0 if not mapped
 uint32_t vm_get_phys(uint32_t virt);
 
+// Current directory (CR3) mein virt ka PTE, page table na ho toh 0
+uint32_t *vm_get_pte(uint32_t virt);
+
 void vm_clear_user_mappings();
 
 #endif
@@ -4,6 +4,11 @@
 #include "memory.h"
 #include "process.h"
 
+extern uint32_t tick;
+
+// PIT init_timer(50) pe chalta hai (Kernel.cpp)
+#define TICKS_PER_SEC 50
+
 extern "C" {
 
 void wait_queue_init(wait_queue_t *wq) {
@@ -11,6 +16,27 @@ void wait_queue_init(wait_queue_t *wq) {
   wq->tail = 0;
 }
 
+static void wq_append(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  entry->next = 0;
+  if (!wq->head) {
+    wq->head = entry;
+    wq->tail = entry;
+  } else {
+    wq->tail->next = entry;
+    wq->tail = entry;
+  }
+}
+
+static void wq_unlink(wait_queue_t *wq, wait_queue_entry_t *prev,
+                      wait_queue_entry_t *entry) {
+  if (prev)
+    prev->next = entry->next;
+  else
+    wq->head = entry->next;
+  if (wq->tail == entry)
+    wq->tail = prev;
+}
+
 void sleep_on(wait_queue_t *wq) {
   if (!current_process || !wq)
     return;
@@ -27,15 +53,9 @@ void sleep_on(wait_queue_t *wq) {
   }
 
   entry->proc = current_process;
-  entry->next = 0;
-
-  if (!wq->head) {
-    wq->head = entry;
-    wq->tail = entry;
-  } else {
-    wq->tail->next = entry;
-    wq->tail = entry;
-  }
+  entry->func = 0;
+  entry->priv = 0;
+  wq_append(wq, entry);
 
   // Set process state to sleeping
   current_process->state = PROCESS_WAITING;
@@ -47,50 +67,108 @@ void sleep_on(wait_queue_t *wq) {
   schedule();
 }
 
-void wake_up(wait_queue_t *wq) {
+void wake_up_process(struct process *p) {
+  if (p && (p->state == PROCESS_WAITING || p->state == PROCESS_SLEEPING))
+    p->state = PROCESS_READY;
+}
+
+// Saari callback entries chalao, aur max_procs tak sone wale process jagao
+static void wake_up_common(wait_queue_t *wq, int max_procs) {
   if (!wq || !wq->head)
     return;
 
-  asm volatile("cli");
+  uint32_t flags = irq_save();
 
-  // Remove first entry from queue
+  wait_queue_entry_t *prev = 0;
   wait_queue_entry_t *entry = wq->head;
-  wq->head = entry->next;
-  if (!wq->head)
-    wq->tail = 0;
-
-  // Wake up the process
-  if (entry->proc) {
-    entry->proc->state = PROCESS_READY;
+  while (entry) {
+    wait_queue_entry_t *next = entry->next;
+    if (entry->func) {
+      // Callback apni entry yahin rehne deta hai; hum bas khabar dete hain
+      entry->func(entry);
+      prev = entry;
+    } else if (max_procs != 0) {
+      wq_unlink(wq, prev, entry);
+      if (entry->proc)
+        entry->proc->state = PROCESS_READY;
+      kfree(entry);
+      if (max_procs > 0)
+        max_procs--;
+    } else {
+      prev = entry;
+    }
+    entry = next;
   }
 
-  kfree(entry);
-
-  asm volatile("sti");
+  irq_restore(flags);
 }
 
-void wake_up_all(wait_queue_t *wq) {
-  if (!wq)
-    return;
+void wake_up(wait_queue_t *wq) { wake_up_common(wq, 1); }
 
-  asm volatile("cli");
+void wake_up_all(wait_queue_t *wq) { wake_up_common(wq, -1); }
 
-  while (wq->head) {
-    wait_queue_entry_t *entry = wq->head;
-    wq->head = entry->next;
+int wait_queue_empty(wait_queue_t *wq) { return wq ? (wq->head == 0) : 1; }
 
-    if (entry->proc) {
-      entry->proc->state = PROCESS_READY;
-    }
+void add_wait_queue(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  if (!wq || !entry)
+    return;
+  uint32_t flags = irq_save();
+  wq_append(wq, entry);
+  irq_restore(flags);
+}
 
-    kfree(entry);
+void remove_wait_queue(wait_queue_t *wq, wait_queue_entry_t *entry) {
+  if (!wq || !entry)
+    return;
+  uint32_t flags = irq_save();
+  wait_queue_entry_t *prev = 0;
+  for (wait_queue_entry_t *e = wq->head; e; prev = e, e = e->next) {
+    if (e == entry) {
+      wq_unlink(wq, prev, e);
+      break;
+    }
   }
+  irq_restore(flags);
+}
 
-  wq->tail = 0;
+void poll_wait(wait_queue_t *wq, poll_table_t *pt) {
+  if (wq && pt && pt->qproc)
+    pt->qproc(pt, wq);
+}
 
-  asm volatile("sti");
+uint32_t timeout_to_deadline(int timeout_ms) {
+  if (timeout_ms < 0)
+    return 0;
+  uint32_t ticks = ((uint32_t)timeout_ms * TICKS_PER_SEC + 999) / 1000;
+  if (ticks == 0)
+    ticks = 1;
+  uint32_t deadline = tick + ticks;
+  return deadline ? deadline : 1;
 }
 
-int wait_queue_empty(wait_queue_t *wq) { return wq ? (wq->head == 0) : 1; }
+int schedule_timeout(uint32_t deadline, volatile int *cond) {
+  if (!current_process)
+    return 0;
+  if (deadline && (int32_t)(tick - deadline) >= 0)
+    return 0;
+
+  // cond check aur state badalna ek saath, warna beech ka wake_up kho jayega
+  asm volatile("cli");
+  if (cond && *cond) {
+    asm volatile("sti");
+    return 1;
+  }
+  if (deadline) {
+    // Timer isse deadline pe khud jaga dega
+    current_process->sleep_until = deadline;
+    current_process->state = PROCESS_SLEEPING;
+  } else {
+    current_process->state = PROCESS_WAITING;
+  }
+  asm volatile("sti");
+  schedule();
+
+  return !deadline || (int32_t)(tick - deadline) < 0;
+}
 
 } // extern "C"
@@ -9,6 +9,10 @@ struct process; // Forward declaration
 typedef struct wait_queue_entry {
   struct process *proc;
   struct wait_queue_entry *next;
+  // Callback entries (poll/select/epoll): wake_up inhe queue se hatata nahi,
+  // bas func chalata hai. sleep_on wali entries mein func null hota hai.
+  void (*func)(struct wait_queue_entry *entry);
+  void *priv;
 } wait_queue_entry_t;
 
 typedef struct wait_queue {
@@ -18,6 +22,25 @@ typedef struct wait_queue {
 
 #define WAIT_QUEUE_INIT {0, 0}
 
+// poll op ko diya jaata hai; driver har wait queue ke liye poll_wait bulata hai
+// taaki poll/select/epoll us queue pe apni callback entry laga sakein.
+typedef struct poll_table {
+  void (*qproc)(struct poll_table *pt, wait_queue_t *wq);
+} poll_table_t;
+
+// Interrupts band, purana EFLAGS wapas. Restore sirf tab sti karta hai jab
+// pehle IF on tha - nested save/restore (wake_up callbacks ke andar) safe.
+static inline uint32_t irq_save() {
+  uint32_t eflags;
+  asm volatile("pushf; pop %0; cli" : "=r"(eflags)::"memory");
+  return eflags;
+}
+
+static inline void irq_restore(uint32_t eflags) {
+  if (eflags & 0x200)
+    asm volatile("sti" ::: "memory");
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -28,7 +51,7 @@ void wait_queue_init(wait_queue_t *wq);
 // Put current process to sleep on this wait queue
 void sleep_on(wait_queue_t *wq);
 
-// Wake up one process from the queue
+// Wake up one process from the queue (callback entries always run)
 void wake_up(wait_queue_t *wq);
 
 // Wake up all processes from the queue
@@ -37,6 +60,24 @@ void wake_up_all(wait_queue_t *wq);
 // Check if queue is empty
 int wait_queue_empty(wait_queue_t *wq);
 
+// Callback entries - caller owns the memory and must remove it
+void add_wait_queue(wait_queue_t *wq, wait_queue_entry_t *entry);
+void remove_wait_queue(wait_queue_t *wq, wait_queue_entry_t *entry);
+
+// WAITING/SLEEPING process ko READY karo
+void wake_up_process(struct process *p);
+
+// Driver poll ops se bulao (pt null ho toh kuch nahi karta)
+void poll_wait(wait_queue_t *wq, poll_table_t *pt);
+
+// ms timeout ko absolute tick deadline mein badlo (0 = no deadline)
+uint32_t timeout_to_deadline(int timeout_ms);
+
+// Jab tak *cond zero hai aur deadline nahi aayi, current process ko sulao.
+// Jagane ka kaam callback entries (wake_up_process) karti hain.
+// Returns 0 once the deadline has passed.
+int schedule_timeout(uint32_t deadline, volatile int *cond);
+
 #ifdef __cplusplus
 }
 #endif